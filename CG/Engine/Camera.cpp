@@ -75,13 +75,17 @@ void Camera::Tick(float dt) {
 	// だんだん弱くなる減衰（カーブはお好みで）
 	float atten = 1.0f - t; // 線形減衰
 
-	shakeOfs_.x = unit_(rng_) * shakeAmpPos_ * atten;
-	shakeOfs_.y = unit_(rng_) * shakeAmpPos_ * atten;
-	shakeOfs_.z = unit_(rng_) * shakeAmpPos_ * atten;
+	// -1..1 を 6 個まとめて（位置 xyz, 回転 xyz）
+	float n[6];
+	rng_.FillRange(n, 6, -1.0f, 1.0f);
 
-	shakeRot_.x = unit_(rng_) * shakeAmpRot_ * atten;
-	shakeRot_.y = unit_(rng_) * shakeAmpRot_ * atten;
-	shakeRot_.z = unit_(rng_) * shakeAmpRot_ * atten;
+	shakeOfs_.x = n[0] * shakeAmpPos_ * atten;
+	shakeOfs_.y = n[1] * shakeAmpPos_ * atten;
+	shakeOfs_.z = n[2] * shakeAmpPos_ * atten;
+
+	shakeRot_.x = n[3] * shakeAmpRot_ * atten;
+	shakeRot_.y = n[4] * shakeAmpRot_ * atten;
+	shakeRot_.z = n[5] * shakeAmpRot_ * atten;
 
 	// シェイクは view 再構築に反映されるので、ここで更新
 	UpdateView();
@@ -5,6 +5,7 @@
 //  - SetPosition / LookAt / Tick / StartShake を追加
 // ===============================
 #include "Input.h"
+#include "Random.h"
 #include <DirectXMath.h>
 #include <random>
 
@@ -47,6 +48,8 @@ public:
 	void StartShake(float duration, float ampPos, float ampRot = 0.0f);
 	void StopShake();
 	bool IsShaking() const { return shakeTime_ < shakeDuration_; }
+	// シェイクの乱数のシード（リプレイで同じ揺れにしたいとき）
+	void SetShakeSeed(uint64_t seed) { rng_.Seed(seed); }
 
 private:
 	// 位置・回転(+シェイク)からビューを再計算
@@ -74,9 +77,8 @@ private:
 	DirectX::XMFLOAT3 shakeOfs_{0, 0, 0}; // 直近フレームの位置ノイズ
 	DirectX::XMFLOAT3 shakeRot_{0, 0, 0}; // 直近フレームの回転ノイズ
 
-	// 乱数
-	std::mt19937 rng_{std::random_device{}()};
-	std::uniform_real_distribution<float> unit_{-1.0f, 1.0f};
+	// 乱数（既定のシードは毎回変わる）
+	Random rng_{std::random_device{}()};
 };
 
 } // namespace Engine
@@ -1,19 +1,19 @@
 #pragma once
+// =======================================
+//  ParticleSystem : ParticleBuffer（SoA）の粒をカメラ向きの板としてインスタンス描画する
+//  - 持つのはシミュレーションの状態だけ。板 / PSO / テクスチャ / インスタンスのバッファは
+//    Renderer が配る ParticleRenderer を全エミッタで共用する（エミッタを増やしても GPU リソースは増えない）
+//  - 毎フレーム生きている粒を 24B の ParticleInstance に詰めて共用プールへ書き、1 回の DrawInstanced で描く
+//  - ブレンドは Renderer::GetBlendMode()（Opaque 以外は深度を書かない）
+// =======================================
 #include "Matrix4x4.h"
+#include "ParticleBuffer.h"
+#include "ParticleRenderer.h"
 #include "Renderer.h"
+#include <memory>
 
 namespace Engine {
 
-struct Particle {
-	Vector3 pos;
-	Vector3 vel;
-	Vector3 scale;
-	Vector4 color;
-	float life = 1.0f;
-	float age = 0.0f;
-	bool active = false;
-};
-
 class ParticleSystem {
 public:
 	void Initialize(Renderer& renderer, WindowDX& dx, size_t maxCount = 1000);
@@ -23,9 +23,26 @@ public:
 
 	void Emit(const Vector3& pos, const Vector3& vel, const Vector3& scale, const Vector4& color, float life);
 
+	// まとめて追加：n 粒ぶんのスロットを確保して先頭の番号を返す（確保できた数は granted）。中身は SetParticle で書く
+	size_t EmitN(size_t n, size_t& granted) { return particles_.EmitN(n, granted); }
+	void SetParticle(size_t i, const Vector3& pos, const Vector3& vel, const Vector3& scale, const Vector4& color, float life) { particles_.Set(i, pos, vel, scale, color, life); }
+
+	// 満杯のときの扱い（既定は Drop）
+	void SetOverflow(ParticleOverflow policy) { particles_.SetOverflow(policy); }
+
+	// 生きている粒の数と上限
+	size_t AliveCount() const { return particles_.Count(); }
+	size_t Capacity() const { return particles_.Capacity(); }
+	const ParticleBuffer& Particles() const { return particles_; }
+
+	// 直近の Draw で描いた粒の数とドローコール数（0 か 1）
+	size_t DrawnInstances() const { return drawnInstances_; }
+	unsigned int DrawCalls() const { return drawnInstances_ > 0 ? 1u : 0u; }
+
 private:
 	Renderer* renderer_ = nullptr;
-	int modelHandle_ = -1;
-	std::vector<Particle> particles_;
+	std::shared_ptr<ParticleRenderer> shared_; // 全エミッタ共用の描画リソース
+	ParticleBuffer particles_;                 // SoA。生きている粒は先頭に詰めてある
+	size_t drawnInstances_ = 0;
 };
 } // namespace Engine
@@ -0,0 +1,195 @@
+// Engine/ParticleBuffer.cpp
+#include "ParticleBuffer.h"
+#include <DirectXMath.h>
+#include <algorithm>
+#include <functional>
+
+namespace Engine {
+
+using namespace DirectX;
+
+void ParticleBuffer::Initialize(size_t capacity) {
+	capacity_ = capacity;
+	stride_ = (capacity + 3) & ~size_t(3);
+	count_ = 0;
+	// 端数の空きスロットも計算されるので 0 で埋めておく（NaN を作らない）
+	data_.assign(stride_ * kStreamCount, 0.0f);
+	deadGroups_.clear();
+	deadGroups_.reserve(stride_ / 4);
+}
+
+size_t ParticleBuffer::EmitN(size_t n, size_t& granted) {
+	const size_t room = capacity_ - count_;
+	if (n > room) {
+		switch (overflow_) {
+		case ParticleOverflow::Drop:
+			break;
+		case ParticleOverflow::RecycleOldest:
+			RecycleOldest((std::min)(n, capacity_) - room);
+			break;
+		case ParticleOverflow::Grow: {
+			size_t cap = (std::max)(capacity_, size_t(64));
+			while (cap < count_ + n) {
+				cap *= 2;
+			}
+			Grow(cap);
+			break;
+		}
+		}
+	}
+
+	granted = (std::min)(n, capacity_ - count_);
+	const size_t first = count_;
+	count_ += granted;
+	return first;
+}
+
+void ParticleBuffer::Set(size_t i, const Vector3& pos, const Vector3& vel, const Vector3& scale, const Vector4& color, float life) {
+	Ptr(kPosX)[i] = pos.x;
+	Ptr(kPosY)[i] = pos.y;
+	Ptr(kPosZ)[i] = pos.z;
+	Ptr(kVelX)[i] = vel.x;
+	Ptr(kVelY)[i] = vel.y;
+	Ptr(kVelZ)[i] = vel.z;
+	Ptr(kScaleX)[i] = scale.x;
+	Ptr(kScaleY)[i] = scale.y;
+	Ptr(kScaleZ)[i] = scale.z;
+	Ptr(kColorR)[i] = color.x;
+	Ptr(kColorG)[i] = color.y;
+	Ptr(kColorB)[i] = color.z;
+	Ptr(kColorA)[i] = color.w;
+	Ptr(kAge)[i] = 0.0f;
+	Ptr(kLife)[i] = life;
+	Ptr(kInvLife)[i] = life > 0.0f ? 1.0f / life : 0.0f;
+}
+
+// age/life の大きい n 粒を消す（1 回の EmitN につき選択 1 回 = O(生存数)）
+void ParticleBuffer::RecycleOldest(size_t n) {
+	if (n == 0)
+		return;
+	if (n >= count_) {
+		count_ = 0;
+		return;
+	}
+
+	const float* age = Ptr(kAge);
+	const float* invLife = Ptr(kInvLife);
+	recycle_.resize(count_);
+	for (size_t i = 0; i < count_; ++i) {
+		recycle_[i] = uint32_t(i);
+	}
+	std::nth_element(recycle_.begin(), recycle_.begin() + n, recycle_.end(), [&](uint32_t a, uint32_t b) { return age[a] * invLife[a] > age[b] * invLife[b]; });
+
+	// 後ろの番号から消す（末尾から移ってくる粒は消す対象ではない）
+	std::sort(recycle_.begin(), recycle_.begin() + n, std::greater<uint32_t>());
+	for (size_t k = 0; k < n; ++k) {
+		RemoveAt(recycle_[k]);
+	}
+}
+
+void ParticleBuffer::Grow(size_t capacity) {
+	const size_t stride = (capacity + 3) & ~size_t(3);
+	std::vector<float> data(stride * kStreamCount, 0.0f);
+	for (uint32_t s = 0; s < kStreamCount; ++s) {
+		std::copy_n(Ptr(Stream(s)), count_, data.data() + size_t(s) * stride);
+	}
+	data_.swap(data);
+	capacity_ = capacity;
+	stride_ = stride;
+	deadGroups_.reserve(stride_ / 4);
+}
+
+void ParticleBuffer::RemoveAt(size_t i) {
+	const size_t last = --count_;
+	if (i == last)
+		return;
+	for (uint32_t s = 0; s < kStreamCount; ++s) {
+		float* p = Ptr(Stream(s));
+		p[i] = p[last];
+	}
+}
+
+void ParticleBuffer::Update(float dt) {
+	if (count_ == 0)
+		return;
+
+	float* px = Ptr(kPosX);
+	float* py = Ptr(kPosY);
+	float* pz = Ptr(kPosZ);
+	const float* vx = Ptr(kVelX);
+	const float* vy = Ptr(kVelY);
+	const float* vz = Ptr(kVelZ);
+	float* alpha = Ptr(kColorA);
+	float* age = Ptr(kAge);
+	const float* life = Ptr(kLife);
+	const float* invLife = Ptr(kInvLife);
+
+	// 年齢 → 位置 → フェード。死んだ粒を含む組だけ覚えておく
+	deadGroups_.clear();
+	const XMVECTOR vdt = XMVectorReplicate(dt);
+	const XMVECTOR one = XMVectorReplicate(1.0f);
+	const size_t end = (count_ + 3) & ~size_t(3);
+	for (size_t i = 0; i < end; i += 4) {
+		const XMVECTOR a = XMVectorAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(age + i)), vdt);
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(age + i), a);
+
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(px + i), XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(vx + i)), vdt, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(px + i))));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(py + i), XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(vy + i)), vdt, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(py + i))));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(pz + i), XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(vz + i)), vdt, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(pz + i))));
+
+		const XMVECTOR il = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(invLife + i));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(alpha + i), XMVectorNegativeMultiplySubtract(a, il, one)); // 1 - age/life
+
+		uint32_t cr;
+		XMVectorGreaterOrEqualR(&cr, a, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(life + i)));
+		if (XMComparisonAnyTrue(cr)) {
+			deadGroups_.push_back(uint32_t(i / 4));
+		}
+	}
+
+	// 後ろの組から消す。末尾から移ってくる粒はもう調べ終わった位置にいるので生きている
+	for (auto it = deadGroups_.rbegin(); it != deadGroups_.rend(); ++it) {
+		const size_t base = size_t(*it) * 4;
+		for (size_t k = 4; k-- > 0;) {
+			const size_t i = base + k;
+			if (i < count_ && age[i] >= life[i]) {
+				RemoveAt(i);
+			}
+		}
+	}
+}
+
+namespace {
+
+// 0..1 → 0..255（四捨五入）
+inline uint32_t ToUnorm8(float v) { return uint32_t((std::min)((std::max)(v, 0.0f), 1.0f) * 255.0f + 0.5f); }
+
+} // namespace
+
+size_t ParticleBuffer::PackInstances(ParticleInstance* out, size_t maxCount) const {
+	const size_t n = (std::min)(count_, maxCount);
+	const float* px = Data(kPosX);
+	const float* py = Data(kPosY);
+	const float* pz = Data(kPosZ);
+	const float* sx = Data(kScaleX);
+	const float* sy = Data(kScaleY);
+	const float* cr = Data(kColorR);
+	const float* cg = Data(kColorG);
+	const float* cb = Data(kColorB);
+	const float* ca = Data(kColorA);
+
+	// 書き込み先はアップロードヒープ（書き込み結合）なので、1 粒ぶんを組み立ててから順に書く
+	for (size_t i = 0; i < n; ++i) {
+		ParticleInstance inst;
+		inst.x = px[i];
+		inst.y = py[i];
+		inst.z = pz[i];
+		inst.sizeX = sx[i];
+		inst.sizeY = sy[i];
+		inst.color = ToUnorm8(cr[i]) | (ToUnorm8(cg[i]) << 8) | (ToUnorm8(cb[i]) << 16) | (ToUnorm8(ca[i]) << 24);
+		out[i] = inst;
+	}
+	return n;
+}
+
+} // namespace Engine
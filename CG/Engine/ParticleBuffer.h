@@ -0,0 +1,101 @@
+// Engine/ParticleBuffer.h
+#pragma once
+// =======================================
+//  ParticleBuffer : パーティクルの状態を SoA（成分ごとの float 配列）で持つ
+//  - 生きている粒は先頭 Count() 個に詰める。死んだ粒は末尾と入れ替えて消す（順番は保たない）
+//  - Update は 4 粒ずつ DirectXMath（SSE）で年齢/位置/フェードを進める。空きスロットは見ない
+//  - 配列の長さは容量を 4 の倍数に切り上げたもの（端数の 4 粒もまとめて計算してよい）
+//  - 追加は末尾の生存数を進めるだけ（EmitN で N 粒を O(1) で確保）。満杯のときは ParticleOverflow に従う
+//  - 描画用には PackInstances で 1 粒 24B の ParticleInstance に詰める（インスタンス描画の入力そのまま）
+//  - GPU には触らない（単体で動かして確かめられる）
+// =======================================
+#include "Matrix4x4.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+// 満杯のときの追加の扱い
+enum class ParticleOverflow : uint8_t {
+	Drop,          // 入らない分は捨てる
+	RecycleOldest, // 寿命の進んだ（age/life の大きい = いちばん薄い）粒から消して空ける
+	Grow,          // 容量を倍々に増やす
+};
+
+// インスタンス描画の 1 粒ぶん（VS の入力スロット 1）
+struct ParticleInstance {
+	float x, y, z;      // 中心
+	float sizeX, sizeY; // 板の半分の大きさ（旧 plane.obj の scale と同じ）
+	uint32_t color;     // RGBA8（R が最下位バイト = DXGI_FORMAT_R8G8B8A8_UNORM）
+};
+static_assert(sizeof(ParticleInstance) == 24, "ParticleInstance は 24B（入力レイアウトと合わせる）");
+
+class ParticleBuffer {
+public:
+	// 成分ごとの配列
+	enum Stream : uint32_t {
+		kPosX, kPosY, kPosZ,
+		kVelX, kVelY, kVelZ,
+		kScaleX, kScaleY, kScaleZ,
+		kColorR, kColorG, kColorB, kColorA,
+		kAge, kLife, kInvLife,
+		kStreamCount
+	};
+
+	void Initialize(size_t capacity);
+
+	void SetOverflow(ParticleOverflow policy) { overflow_ = policy; }
+	ParticleOverflow Overflow() const { return overflow_; }
+
+	// 末尾に n 粒ぶんの連続したスロットを確保して先頭の番号を返す。確保できた数は granted
+	// （Drop で満杯に近いときだけ n より少ない）。中身は Set で書く
+	size_t EmitN(size_t n, size_t& granted);
+	void Set(size_t i, const Vector3& pos, const Vector3& vel, const Vector3& scale, const Vector4& color, float life);
+
+	// 1 粒追加。入らなければ false
+	bool Emit(const Vector3& pos, const Vector3& vel, const Vector3& scale, const Vector4& color, float life) {
+		size_t granted;
+		const size_t i = EmitN(1, granted);
+		if (granted == 0)
+			return false;
+		Set(i, pos, vel, scale, color, life);
+		return true;
+	}
+
+	// 年齢と位置を進め、アルファを 1 - age/life にする。寿命の尽きた粒は消す
+	void Update(float dt);
+
+	void Clear() { count_ = 0; }
+
+	size_t Count() const { return count_; }
+	size_t Capacity() const { return capacity_; }
+	bool Full() const { return count_ >= capacity_; }
+
+	// 生きている粒の先頭から最大 maxCount 粒を out に詰めて、詰めた数を返す（色は 0..1 に丸めて 8bit）
+	size_t PackInstances(ParticleInstance* out, size_t maxCount) const;
+
+	// 先頭 Count() 個が生きている粒
+	const float* Data(Stream s) const { return data_.data() + size_t(s) * stride_; }
+
+	Vector3 Position(size_t i) const { return {At(kPosX, i), At(kPosY, i), At(kPosZ, i)}; }
+	Vector3 Scale(size_t i) const { return {At(kScaleX, i), At(kScaleY, i), At(kScaleZ, i)}; }
+	Vector4 Color(size_t i) const { return {At(kColorR, i), At(kColorG, i), At(kColorB, i), At(kColorA, i)}; }
+
+private:
+	float At(Stream s, size_t i) const { return data_[size_t(s) * stride_ + i]; }
+	float* Ptr(Stream s) { return data_.data() + size_t(s) * stride_; }
+	void RemoveAt(size_t i); // 末尾の粒を i へ移す
+	void RecycleOldest(size_t n);
+	void Grow(size_t capacity);
+
+	size_t capacity_ = 0;
+	size_t stride_ = 0; // 配列 1 本の長さ（4 の倍数）
+	size_t count_ = 0;
+	ParticleOverflow overflow_ = ParticleOverflow::Drop;
+	std::vector<float> data_;        // kStreamCount 本の配列をつなげたもの
+	std::vector<uint32_t> deadGroups_; // Update 中に死んだ粒を含む 4 粒組
+	std::vector<uint32_t> recycle_;    // RecycleOldest の作業用
+};
+
+} // namespace Engine
@@ -0,0 +1,311 @@
+#include "ParticleRenderer.h"
+#include "Model.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <d3dcompiler.h>
+#include <d3dx12.h>
+
+#pragma comment(lib, "d3dcompiler.lib")
+
+using namespace DirectX;
+using Microsoft::WRL::ComPtr;
+
+#ifndef HR_CHECK
+#define HR_CHECK(x)                                                                                                                                                                                    \
+	do {                                                                                                                                                                                               \
+		HRESULT __hr__ = (x);                                                                                                                                                                          \
+		if (FAILED(__hr__)) {                                                                                                                                                                          \
+			char buf[256];                                                                                                                                                                             \
+			sprintf_s(buf, "HR failed 0x%08X at %s(%d)\n", (unsigned)__hr__, __FILE__, __LINE__);                                                                                                      \
+			OutputDebugStringA(buf);                                                                                                                                                                   \
+			assert(false && "D3D12 call failed");                                                                                                                                                      \
+			std::abort();                                                                                                                                                                              \
+		}                                                                                                                                                                                              \
+	} while (0)
+#endif
+
+namespace {
+
+// 最初のプールの大きさ（火花 6000 粒 + 剣の軌跡 6000 粒が 1 フレームに収まるくらい）
+constexpr size_t kInitialPoolBytes = 512 * 1024;
+
+// シェーダコンパイルヘルパー（Renderer::Compile と同じイメージ）
+ComPtr<ID3DBlob> CompileShader(const char* src, const char* entry, const char* target) {
+	UINT fl = D3DCOMPILE_ENABLE_STRICTNESS;
+#ifdef _DEBUG
+	fl |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+	ComPtr<ID3DBlob> s, e;
+	HRESULT hr = D3DCompile(src, strlen(src), nullptr, nullptr, nullptr, entry, target, fl, 0, &s, &e);
+	if (FAILED(hr)) {
+		if (e) {
+			MessageBoxA(nullptr, (const char*)e->GetBufferPointer(), "Particle HLSL Compile Error", MB_OK);
+		}
+		std::abort();
+	}
+	return s;
+}
+
+// ---------------- HLSL：パーティクル（インスタンス） ----------------
+// 四隅 (±1, ±1) をカメラの右/上へ展開する。大きさは旧 plane.obj（一辺 2）× scale と同じ
+const char* gVSParticle = R"(
+cbuffer CBParticle : register(b0)
+{
+    float4x4 g_viewProj;
+    float4   g_right;
+    float4   g_up;
+};
+
+struct VSIn {
+    float2 corner : CORNER;  // 四隅 (±1, ±1)
+    float3 center : CENTER;  // インスタンス：中心
+    float2 size   : SIZE;    // インスタンス：半分の大きさ
+    float4 color  : COLOR;   // インスタンス：RGBA8
+};
+
+struct VSOut {
+    float4 sp    : SV_Position;
+    float2 uv    : TEXCOORD;
+    float4 color : COLOR;
+};
+
+VSOut main(VSIn i)
+{
+    float3 w = i.center + g_right.xyz * (i.corner.x * i.size.x) + g_up.xyz * (i.corner.y * i.size.y);
+
+    VSOut o;
+    o.sp    = mul(float4(w, 1.0), g_viewProj);
+    o.uv    = float2(0.5 + 0.5 * i.corner.x, 0.5 - 0.5 * i.corner.y);
+    o.color = i.color;
+    return o;
+}
+)";
+
+const char* gPSParticle = R"(
+Texture2D    g_tex : register(t0);
+SamplerState g_smp : register(s0);
+
+float4 main(float4 sp : SV_Position, float2 uv : TEXCOORD, float4 color : COLOR) : SV_Target
+{
+    return g_tex.Sample(g_smp, uv) * color;
+}
+)";
+
+} // namespace
+
+namespace Engine {
+
+ParticleRenderer::ParticleRenderer() = default;
+
+ParticleRenderer::~ParticleRenderer() {
+	if (pool_ && poolCpu_) {
+		pool_->Unmap(0, nullptr);
+	}
+}
+
+bool ParticleRenderer::Initialize(Renderer& renderer, ID3D12Device* device, ID3D12GraphicsCommandList* cmd) {
+	renderer_ = &renderer;
+	device_ = device;
+
+	// テクスチャ（モデルの CB は要らないので Renderer::LoadModel は通さない）
+	texture_ = std::make_unique<Model>();
+	if (texture_->Load(device, cmd, "Resources/plane.obj")) {
+		const int srv = renderer.AllocateSRV();
+		texture_->CreateSrv(device, renderer.GetSRVHeap(), renderer.GetSRVDescriptorSize(), UINT(srv));
+		textureSrv_ = texture_->GetSrvGpu();
+	}
+
+	return createPipeline_(device) && createQuad_(device) && createPool_(kInitialPoolBytes);
+}
+
+void ParticleRenderer::BeginFrame() {
+	lastUsed_ = cursor_;
+	lastDraws_ = frameDraws_;
+	cursor_ = 0;
+	frameDraws_ = 0;
+	retired_.clear();
+}
+
+ParticleRenderer::Alloc ParticleRenderer::allocate_(size_t bytes, size_t align) {
+	size_t offset = (cursor_ + align - 1) & ~(align - 1);
+	if (offset + bytes > poolSize_) {
+		// 今フレームで積んだ描画はまだ古いプールを読むので、捨てずに次のフレームまで持つ
+		// （直前に確保した分へこれから書くこともあるので Map したままにしておく）
+		retired_.push_back(pool_);
+		size_t size = poolSize_ * 2;
+		while (size < bytes + align) {
+			size *= 2;
+		}
+		if (!createPool_(size)) {
+			return {};
+		}
+		offset = 0;
+	}
+	cursor_ = offset + bytes;
+	return Alloc{poolCpu_ + offset, pool_->GetGPUVirtualAddress() + offset};
+}
+
+size_t ParticleRenderer::Draw(ID3D12GraphicsCommandList* cmd, const Camera& cam, const ParticleBuffer& particles, Renderer::BlendMode mode) {
+	const size_t count = particles.Count();
+	if (count == 0 || !pool_)
+		return 0;
+
+	// ---- b0：ビュー射影とカメラの右/上 ----
+	const Alloc cbMem = allocate_(sizeof(CBParticle), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+	const Alloc instMem = allocate_(sizeof(ParticleInstance) * count, 16);
+	if (!cbMem.cpu || !instMem.cpu)
+		return 0;
+
+	const XMMATRIX V = cam.View();
+	const XMMATRIX invRot = XMMatrixTranspose(V); // 回転部分の逆 = 転置。行 0/1 がワールドの右/上
+	CBParticle cb{};
+	XMStoreFloat4x4(&cb.viewProj, XMMatrixTranspose(V * cam.Proj()));
+	XMStoreFloat4(&cb.right, XMVectorSetW(invRot.r[0], 0.0f));
+	XMStoreFloat4(&cb.up, XMVectorSetW(invRot.r[1], 0.0f));
+	memcpy(cbMem.cpu, &cb, sizeof(cb));
+
+	// ---- インスタンス ----
+	const size_t n = particles.PackInstances(reinterpret_cast<ParticleInstance*>(instMem.cpu), count);
+
+	D3D12_VERTEX_BUFFER_VIEW views[2] = {quadVbv_, {}};
+	views[1].BufferLocation = instMem.gpu;
+	views[1].SizeInBytes = static_cast<UINT>(sizeof(ParticleInstance) * n);
+	views[1].StrideInBytes = sizeof(ParticleInstance);
+
+	ID3D12DescriptorHeap* heaps[] = {renderer_->GetSRVHeap()};
+	cmd->SetDescriptorHeaps(1, heaps);
+	cmd->SetGraphicsRootSignature(renderer_->rs_.Get());
+	cmd->SetPipelineState(pipelineFor_(mode));
+	cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+	cmd->IASetVertexBuffers(0, 2, views);
+	cmd->SetGraphicsRootConstantBufferView(0, cbMem.gpu);
+	if (textureSrv_.ptr)
+		cmd->SetGraphicsRootDescriptorTable(1, textureSrv_);
+
+	cmd->DrawInstanced(4, static_cast<UINT>(n), 0, 0);
+	++frameDraws_;
+	return n;
+}
+
+ID3D12PipelineState* ParticleRenderer::pipelineFor_(Renderer::BlendMode mode) const {
+	switch (mode) {
+	case Renderer::BlendMode::Alpha:
+		return psoAlpha_.Get();
+	case Renderer::BlendMode::Add:
+		return psoAdd_.Get();
+	case Renderer::BlendMode::Subtract:
+		return psoSub_.Get();
+	case Renderer::BlendMode::Multiply:
+		return psoMul_.Get();
+	default:
+		return pso_.Get();
+	}
+}
+
+// ------------ 内部：PSO ------------
+bool ParticleRenderer::createPipeline_(ID3D12Device* device) {
+	auto vs = CompileShader(gVSParticle, "main", "vs_5_0");
+	auto ps = CompileShader(gPSParticle, "main", "ps_5_0");
+
+	// スロット 0：四隅 / スロット 1：ParticleInstance
+	D3D12_INPUT_ELEMENT_DESC il[] = {
+	    {"CORNER", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 0,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,   0},
+	    {"CENTER", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0,  D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	    {"SIZE",   0, DXGI_FORMAT_R32G32_FLOAT,    1, 12, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	    {"COLOR",  0, DXGI_FORMAT_R8G8B8A8_UNORM,  1, 20, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	};
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC base{};
+	base.pRootSignature = renderer_->rs_.Get();
+	base.VS = {vs->GetBufferPointer(), vs->GetBufferSize()};
+	base.PS = {ps->GetBufferPointer(), ps->GetBufferSize()};
+	base.InputLayout = {il, _countof(il)};
+	base.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	base.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	base.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	base.SampleMask = UINT_MAX;
+	base.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	base.NumRenderTargets = 1;
+	base.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+	base.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+	base.SampleDesc.Count = 1;
+
+	// 半透明系は深度テストだけ（粒同士で消し合わない）
+	auto makePSO = [&](const D3D12_BLEND_DESC& bdesc, bool depthWrite, ComPtr<ID3D12PipelineState>& out) {
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC d = base;
+		d.BlendState = bdesc;
+		d.DepthStencilState.DepthWriteMask = depthWrite ? D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ZERO;
+		HR_CHECK(device->CreateGraphicsPipelineState(&d, IID_PPV_ARGS(&out)));
+	};
+
+	// ブレンドは Renderer のスプライトと同じ組み合わせ
+	D3D12_BLEND_DESC blendOpaque = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+
+	D3D12_BLEND_DESC blendAlpha = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+	auto& rtA = blendAlpha.RenderTarget[0];
+	rtA.BlendEnable = TRUE;
+	rtA.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	rtA.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+	rtA.BlendOp = D3D12_BLEND_OP_ADD;
+	rtA.SrcBlendAlpha = D3D12_BLEND_ONE;
+	rtA.DestBlendAlpha = D3D12_BLEND_ZERO;
+	rtA.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	rtA.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+	D3D12_BLEND_DESC blendAdd = blendAlpha;
+	blendAdd.RenderTarget[0].DestBlend = D3D12_BLEND_ONE;
+
+	D3D12_BLEND_DESC blendSub = blendAlpha;
+	blendSub.RenderTarget[0].BlendOp = D3D12_BLEND_OP_REV_SUBTRACT;
+
+	D3D12_BLEND_DESC blendMul = blendAlpha;
+	blendMul.RenderTarget[0].SrcBlend = D3D12_BLEND_DEST_COLOR;
+	blendMul.RenderTarget[0].DestBlend = D3D12_BLEND_ZERO;
+
+	makePSO(blendOpaque, true, pso_);
+	makePSO(blendAlpha, false, psoAlpha_);
+	makePSO(blendAdd, false, psoAdd_);
+	makePSO(blendSub, false, psoSub_);
+	makePSO(blendMul, false, psoMul_);
+	return true;
+}
+
+// ------------ 内部：バッファ ------------
+bool ParticleRenderer::createQuad_(ID3D12Device* device) {
+	// 四隅（ストリップ順：左下, 左上, 右下, 右上）
+	const XMFLOAT2 corners[4] = {
+	    {-1.0f, -1.0f},
+	    {-1.0f, +1.0f},
+	    {+1.0f, -1.0f},
+	    {+1.0f, +1.0f},
+	};
+
+	CD3DX12_HEAP_PROPERTIES hpU(D3D12_HEAP_TYPE_UPLOAD);
+	auto rd = CD3DX12_RESOURCE_DESC::Buffer(sizeof(corners));
+	HR_CHECK(device->CreateCommittedResource(&hpU, D3D12_HEAP_FLAG_NONE, &rd, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&quadVb_)));
+	void* p = nullptr;
+	quadVb_->Map(0, nullptr, &p);
+	memcpy(p, corners, sizeof(corners));
+	quadVb_->Unmap(0, nullptr);
+
+	quadVbv_.BufferLocation = quadVb_->GetGPUVirtualAddress();
+	quadVbv_.SizeInBytes = sizeof(corners);
+	quadVbv_.StrideInBytes = sizeof(XMFLOAT2);
+	return true;
+}
+
+bool ParticleRenderer::createPool_(size_t bytes) {
+	CD3DX12_HEAP_PROPERTIES hpU(D3D12_HEAP_TYPE_UPLOAD);
+	auto rd = CD3DX12_RESOURCE_DESC::Buffer(bytes);
+	HR_CHECK(device_->CreateCommittedResource(&hpU, D3D12_HEAP_FLAG_NONE, &rd, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&pool_)));
+
+	const D3D12_RANGE readRange{0, 0}; // 読み戻しなし
+	void* p = nullptr;
+	HR_CHECK(pool_->Map(0, &readRange, &p));
+	poolCpu_ = static_cast<uint8_t*>(p);
+	poolSize_ = bytes;
+	return true;
+}
+
+} // namespace Engine
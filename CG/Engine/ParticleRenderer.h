@@ -0,0 +1,81 @@
+#pragma once
+// =======================================
+//  ParticleRenderer : 全 ParticleSystem で共用する描画リソース
+//  - 四隅の板（トライアングルストリップ）/ ブレンドモードごとの PSO / テクスチャ（plane.obj のマテリアル）
+//  - フレームごとのアップロードプール：各エミッタの b0 と ParticleInstance を先頭から詰めていく
+//    Renderer::BeginFrame で先頭に戻す（GPU は毎フレーム待っているので上書きしてよい）
+//    足りなくなったら倍の大きさで作り直す。古いバッファはそのフレームの描画が終わるまで持っておく
+//  - Renderer::AcquireParticleRenderer で受け取る（参照カウント。最後の ParticleSystem が手放すと解放）
+// =======================================
+#include "Camera.h"
+#include "ParticleBuffer.h"
+#include "Renderer.h"
+
+#include <d3d12.h>
+#include <memory>
+#include <vector>
+#include <wrl.h>
+
+namespace Engine {
+
+class Model;
+
+class ParticleRenderer {
+public:
+	ParticleRenderer();
+	~ParticleRenderer();
+
+	bool Initialize(Renderer& renderer, ID3D12Device* device, ID3D12GraphicsCommandList* cmd);
+
+	// プールを先頭に戻す（Renderer::BeginFrame から）
+	void BeginFrame();
+
+	// particles の生きている粒をプールに詰めて 1 回で描く。描いた粒の数を返す
+	size_t Draw(ID3D12GraphicsCommandList* cmd, const Camera& cam, const ParticleBuffer& particles, Renderer::BlendMode mode);
+
+	// 直前のフレームのプールの使用量 / 今の大きさ [byte] とドローコール数
+	size_t PoolUsed() const { return lastUsed_; }
+	size_t PoolSize() const { return poolSize_; }
+	unsigned int FrameDrawCalls() const { return lastDraws_; }
+
+private:
+	// b0
+	struct CBParticle {
+		DirectX::XMFLOAT4X4 viewProj;
+		DirectX::XMFLOAT4 right; // xyz: カメラの右（ワールド）
+		DirectX::XMFLOAT4 up;    // xyz: カメラの上（ワールド）
+	};
+
+	struct Alloc {
+		uint8_t* cpu = nullptr;
+		D3D12_GPU_VIRTUAL_ADDRESS gpu = 0;
+	};
+
+	bool createPipeline_(ID3D12Device* device);
+	bool createQuad_(ID3D12Device* device);
+	bool createPool_(size_t bytes);
+	Alloc allocate_(size_t bytes, size_t align);
+	ID3D12PipelineState* pipelineFor_(Renderer::BlendMode mode) const;
+
+	Renderer* renderer_ = nullptr;
+	ID3D12Device* device_ = nullptr;
+
+	// ブレンドモードごとの PSO（ルートシグネチャは Renderer の rs_ と同じ b0 + t0 + s0 を使う）
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> pso_, psoAlpha_, psoAdd_, psoSub_, psoMul_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> quadVb_; // 四隅
+	D3D12_VERTEX_BUFFER_VIEW quadVbv_{};
+	std::unique_ptr<Model> texture_; // plane.obj（テクスチャだけ使う）
+	D3D12_GPU_DESCRIPTOR_HANDLE textureSrv_{};
+
+	// フレームごとのアップロードプール（Map したまま）
+	Microsoft::WRL::ComPtr<ID3D12Resource> pool_;
+	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> retired_; // 今フレームで作り直した古いプール
+	uint8_t* poolCpu_ = nullptr;
+	size_t poolSize_ = 0;
+	size_t cursor_ = 0;
+	unsigned int frameDraws_ = 0;
+	size_t lastUsed_ = 0;
+	unsigned int lastDraws_ = 0;
+};
+
+} // namespace Engine
@@ -0,0 +1,139 @@
+// Engine/Random.cpp
+#include "Random.h"
+#include <DirectXMath.h>
+#include <emmintrin.h>
+
+namespace Engine {
+
+using namespace DirectX;
+
+namespace {
+
+// シード展開用（xoshiro の作者の推奨）
+inline uint64_t SplitMix64(uint64_t& x) {
+	uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+inline void LoadState(const uint32_t (&s)[4][4], __m128i (&st)[4]) {
+	for (int k = 0; k < 4; ++k) {
+		st[k] = _mm_load_si128(reinterpret_cast<const __m128i*>(s[k]));
+	}
+}
+
+inline void StoreState(const __m128i (&st)[4], uint32_t (&s)[4][4]) {
+	for (int k = 0; k < 4; ++k) {
+		_mm_store_si128(reinterpret_cast<__m128i*>(s[k]), st[k]);
+	}
+}
+
+// 4 本の xoshiro128+ を 1 歩進めて、それぞれの出力（s0 + s3）を返す
+inline __m128i Step(__m128i (&s)[4]) {
+	const __m128i result = _mm_add_epi32(s[0], s[3]);
+	const __m128i t = _mm_slli_epi32(s[1], 9);
+	s[2] = _mm_xor_si128(s[2], s[0]);
+	s[3] = _mm_xor_si128(s[3], s[1]);
+	s[1] = _mm_xor_si128(s[1], s[2]);
+	s[0] = _mm_xor_si128(s[0], s[3]);
+	s[2] = _mm_xor_si128(s[2], t);
+	s[3] = _mm_or_si128(_mm_slli_epi32(s[3], 11), _mm_srli_epi32(s[3], 21)); // rotl(s3, 11)
+	return result;
+}
+
+// 上位 24bit → [0, 1)
+inline XMVECTOR ToUnit(__m128i r) { return XMVectorScale(_mm_cvtepi32_ps(_mm_srli_epi32(r, 8)), 1.0f / 16777216.0f); }
+
+} // namespace
+
+void Random::Seed(uint64_t seed) {
+	seed_ = seed;
+	uint64_t x = seed;
+	for (int lane = 0; lane < 4; ++lane) {
+		const uint64_t a = SplitMix64(x);
+		const uint64_t b = SplitMix64(x);
+		s_[0][lane] = uint32_t(a);
+		s_[1][lane] = uint32_t(a >> 32);
+		s_[2][lane] = uint32_t(b);
+		s_[3][lane] = uint32_t(b >> 32);
+		// 全部 0 の状態からは抜け出せない
+		if ((s_[0][lane] | s_[1][lane] | s_[2][lane] | s_[3][lane]) == 0) {
+			s_[0][lane] = 1;
+		}
+	}
+	bufPos_ = 4;
+}
+
+void Random::Next4(uint32_t* out) {
+	__m128i st[4];
+	LoadState(s_, st);
+	_mm_store_si128(reinterpret_cast<__m128i*>(out), Step(st));
+	StoreState(st, s_);
+}
+
+uint32_t Random::NextU32() {
+	if (bufPos_ >= 4) {
+		Next4(buf_);
+		bufPos_ = 0;
+	}
+	return buf_[bufPos_++];
+}
+
+void Random::FillRange(float* out, size_t n, float lo, float hi) {
+	// 1 個ずつ取った残りを先に使う（1 個ずつ取ったときと同じ並びにするため）
+	size_t i = 0;
+	for (; i < n && bufPos_ < 4; ++i) {
+		out[i] = Range(lo, hi);
+	}
+
+	__m128i st[4];
+	LoadState(s_, st);
+
+	const XMVECTOR vlo = XMVectorReplicate(lo);
+	const XMVECTOR vext = XMVectorReplicate(hi - lo);
+	for (; i + 4 <= n; i += 4) {
+		_mm_storeu_ps(out + i, XMVectorMultiplyAdd(ToUnit(Step(st)), vext, vlo));
+	}
+
+	StoreState(st, s_);
+
+	// 端数は 1 個ずつ（余りは buf_ に残って次の呼び出しが続きから使う）
+	for (; i < n; ++i) {
+		out[i] = Range(lo, hi);
+	}
+}
+
+void Random::FillRangeV3(Vector3* out, size_t n, const Vector3& lo, const Vector3& hi) {
+	static_assert(sizeof(Vector3) == 12, "Vector3 は float 3 個を隙間なく並べたもの");
+
+	// Vector3 4 個 = float 12 個 = SSE 3 本。成分の並びは xyzx / yzxy / zxyz の繰り返し
+	const Vector3 ext{hi.x - lo.x, hi.y - lo.y, hi.z - lo.z};
+	const XMVECTOR lo0 = XMVectorSet(lo.x, lo.y, lo.z, lo.x), ext0 = XMVectorSet(ext.x, ext.y, ext.z, ext.x);
+	const XMVECTOR lo1 = XMVectorSet(lo.y, lo.z, lo.x, lo.y), ext1 = XMVectorSet(ext.y, ext.z, ext.x, ext.y);
+	const XMVECTOR lo2 = XMVectorSet(lo.z, lo.x, lo.y, lo.z), ext2 = XMVectorSet(ext.z, ext.x, ext.y, ext.z);
+
+	// 残りが 4 の倍数の区切りに戻るまで 1 個ずつ（3 成分ずつ取るので多くて 3 個）
+	size_t i = 0;
+	for (; i < n && bufPos_ < 4; ++i) {
+		out[i] = RangeV3(lo, hi);
+	}
+
+	__m128i st[4];
+	LoadState(s_, st);
+
+	float* f = reinterpret_cast<float*>(out + i);
+	for (; i + 4 <= n; i += 4, f += 12) {
+		_mm_storeu_ps(f + 0, XMVectorMultiplyAdd(ToUnit(Step(st)), ext0, lo0));
+		_mm_storeu_ps(f + 4, XMVectorMultiplyAdd(ToUnit(Step(st)), ext1, lo1));
+		_mm_storeu_ps(f + 8, XMVectorMultiplyAdd(ToUnit(Step(st)), ext2, lo2));
+	}
+
+	StoreState(st, s_);
+
+	for (; i < n; ++i) {
+		out[i] = RangeV3(lo, hi);
+	}
+}
+
+} // namespace Engine
@@ -0,0 +1,49 @@
+// Engine/Random.h
+#pragma once
+// =======================================
+//  Random : 軽い乱数（xoshiro128+ を 4 本並べて SSE2 で 4 個ずつ作る）
+//  - 状態は 64bit のシード 1 つから splitmix64 で作る。同じシードなら同じ並び（リプレイで同じ演出になる）
+//  - 1 個ずつ取るとき（Float01 / Range）も 4 個まとめて作った残りを順に返すだけ
+//  - FillRange / FillRangeV3 は配列をまとめて埋める（4 個ずつ SIMD。パーティクルの Burst 向け）
+//    並びは 1 個ずつ取ったときと同じ：FillRange(n) は Range を n 回、FillRangeV3(n) は RangeV3 を n 回呼んだのと同じ値を返し、
+//    前後の 1 個ずつの呼び出しとも続きの並びになる（FMA を使うビルドだけ丸めが 1ulp ずれうる）
+//  - 値は 24bit 精度の [0, 1) を lo + (hi - lo) * u に広げたもの。hi < lo でもよい
+//  - 暗号用途ではない。GPU には触らない
+// =======================================
+#include "Matrix4x4.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine {
+
+class Random {
+public:
+	explicit Random(uint64_t seed = 0x853C49E6748FEA9Bull) { Seed(seed); }
+
+	// 状態を作り直す（作り直したあとの並びはシードだけで決まる）
+	void Seed(uint64_t seed);
+	uint64_t GetSeed() const { return seed_; }
+
+	// 1 個ずつ
+	uint32_t NextU32();
+	float Float01() { return float(NextU32() >> 8) * (1.0f / 16777216.0f); } // [0, 1)
+	float Range(float lo, float hi) { return lo + (hi - lo) * Float01(); }
+	Vector3 RangeV3(const Vector3& lo, const Vector3& hi) { return {Range(lo.x, hi.x), Range(lo.y, hi.y), Range(lo.z, hi.z)}; }
+
+	// まとめて：out[0..n) を [lo, hi) の一様乱数で埋める
+	void FillRange(float* out, size_t n, float lo, float hi);
+	// まとめて：out[0..n) の各成分を [lo.c, hi.c) の一様乱数で埋める
+	void FillRangeV3(Vector3* out, size_t n, const Vector3& lo, const Vector3& hi);
+
+private:
+	// 4 本ぶんの 32bit を 4 個作って state を進める（out は 16B 境界）
+	void Next4(uint32_t* out);
+
+	// s_[k][lane]：xoshiro128+ の状態 4 語 × 4 本（1 行が 1 本の SSE レジスタ）
+	alignas(16) uint32_t s_[4][4] = {};
+	alignas(16) uint32_t buf_[4] = {}; // 1 個ずつ取る用の残り
+	uint32_t bufPos_ = 4;
+	uint64_t seed_ = 0;
+};
+
+} // namespace Engine
@@ -1,6 +1,11 @@
 #include "Renderer.h"
+#include "ParticleRenderer.h"
+#include "Terrain/TerrainMesher.h"
+#include "Terrain/TerrainSampler.h"
 #include <DirectXTex.h>
 #include <d3dcompiler.h>
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -263,6 +268,24 @@ static Microsoft::WRL::ComPtr<ID3D12Resource> CreateUploadBuffer(ID3D12Device* d
 	return res;
 }
 
+// アップロードバッファへ書き込む。容量が足りなければ倍々で作り直す
+static void UploadToGrowableBuffer(ID3D12Device* dev, Microsoft::WRL::ComPtr<ID3D12Resource>& buf, UINT64& capacity, const void* src, UINT64 bytes) {
+	const UINT64 need = (std::max)((bytes + 15) & ~UINT64(15), UINT64(16)); // 空でもビューが張れるように最低 16B。4B 単位で読むので切り上げ
+	if (!buf || capacity < need) {
+		capacity = (std::max)(need, capacity * 2);
+		buf = CreateUploadBuffer(dev, capacity);
+	}
+	if (bytes == 0)
+		return;
+
+	void* p = nullptr;
+	const D3D12_RANGE readRange{0, 0};
+	if (SUCCEEDED(buf->Map(0, &readRange, &p)) && p) {
+		memcpy(p, src, size_t(bytes));
+		buf->Unmap(0, nullptr);
+	}
+}
+
 bool Renderer::Initialize(WindowDX& dx) {
 	dx_ = &dx;
 	// SRVヒープ作成
@@ -324,45 +347,66 @@ bool Renderer::Initialize(WindowDX& dx) {
 	InitVoxelCS(dx.Dev());
 	InitVoxelDrawPSO(dx.Dev());
 	voxel_.cbDraw = CreateUploadBuffer(dx.Dev(), 256);
-	// 例: 最大100万頂点（高さ地形なら 512x512 セル → 6頂点/セル = 約1.6M → 適宜調整）
 	constexpr UINT kVoxelGridX = 400;
 	constexpr UINT kVoxelGridZ = 400;
 
-	// 必要頂点数 = gridX * gridZ * 6
-	const UINT maxVerts = kVoxelGridX * kVoxelGridZ * 6;
+	// 必要頂点数 = 格子点数 (gridX+1) * (gridZ+1)。インデックスで共有する
+	const UINT maxVerts = (kVoxelGridX + 1) * (kVoxelGridZ + 1);
 	CreateVoxelBuffers(dx.Dev(), maxVerts);
+	CreateVoxelIndexBuffer(dx.Dev(), kVoxelGridX, kVoxelGridZ);
 
 	// ★ グリッド保存
 	voxelGridX_ = kVoxelGridX;
 	voxelGridZ_ = kVoxelGridZ;
 
-	// ★ 初期生成必要
-	voxelDirty_ = true;
+	// ★ 地形パラメータは CPU 側の高さキャッシュでも使うので先に決めておく
+	voxel_.params.cell = 0.80f; // セルを少し粗くして起伏を見せる
+	voxel_.params.amp = 3.50f;  // （今は未使用だが残しておく）
+	voxel_.params.freq = 0.08f; // （同上）
+	terrainField_.Initialize(kVoxelGridX, kVoxelGridZ, voxel_.params.cell);
+	terrainPyramid_.Build(&terrainField_);
 
-	zeroUpload_ = CreateUploadBuffer(dx.Dev(), 4);
-	void* zp = nullptr;
-	zeroUpload_->Map(0, nullptr, &zp);
-	*reinterpret_cast<UINT*>(zp) = 0;
-	zeroUpload_->Unmap(0, nullptr);
+	// ★ 描画の LOD（ノードの高さの範囲はピラミッドから）
+	voxelLod_.Initialize(&terrainField_, &terrainPyramid_, TerrainLodSelector::Desc{});
 
+	// ★ 凹みは 4m 四方のセルに振り分ける（ボスの凹み半径 4 なら 3x3 セル程度）
 	{
-		auto desc = CD3DX12_RESOURCE_DESC::Buffer(4);
-		auto heap = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK);
-		HR_CHECK(dx.Dev()->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&voxel_.counterReadback)));
-		voxel_.counterReadback->Map(0, nullptr, &voxel_.counterCpuPtr);
+		constexpr float kDentCellSize = 4.0f;
+		const float extentX = kVoxelGridX * voxel_.params.cell;
+		const float extentZ = kVoxelGridZ * voxel_.params.cell;
+		voxel_.dentGrid.Initialize(-0.5f * extentX, -0.5f * extentZ, kDentCellSize, UINT(std::ceil(extentX / kDentCellSize)), UINT(std::ceil(extentZ / kDentCellSize)));
 	}
 
+	// ★ 保存/読み込み用の変形レイヤー（最初は空）
+	voxel_.deformLayer.Initialize(kVoxelGridX, kVoxelGridZ, voxel_.params.cell);
+
+	// ★ 40x40 セルのチャンクに分割（凹みで触られたチャンクだけ作り直す）
+	constexpr UINT kVoxelChunkCells = 40;
+	voxelChunks_.Initialize(kVoxelGridX, kVoxelGridZ, kVoxelChunkCells, voxel_.params.cell);
+
+	// ★ 初期生成必要
+	voxelChunks_.MarkAllDirty();
+
+	// ★ 土/草/岩の重み（凹みやレイヤーが決まってから焼く）
+	CreateVoxelSplatMap(dx.Dev(), kVoxelGridX, kVoxelGridZ);
+
 	return true;
 }
 
 bool Renderer::InitVoxelCS(ID3D12Device* dev) {
 	// ---- RootSignature (CS) ----
-	// b0: CB, [u0,u1]: UAV をテーブルで束ねる（連番2個）
+	// b0: CB, u0: 頂点UAV（テーブル）, b1: チャンク情報（ルート定数）
+	// t0..t2: 凹みテーブル, t3: 変形レイヤー（ルートSRV）
 	CD3DX12_DESCRIPTOR_RANGE rngUAV;
-	rngUAV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, 2, 0); // u0..u1
-	CD3DX12_ROOT_PARAMETER rp[2];
+	rngUAV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, 1, 0); // u0
+	CD3DX12_ROOT_PARAMETER rp[7];
 	rp[0].InitAsConstantBufferView(0);       // b0
 	rp[1].InitAsDescriptorTable(1, &rngUAV); // UAVテーブル
+	rp[2].InitAsConstants(4, 1);             // b1
+	rp[3].InitAsShaderResourceView(0);       // t0: 凹み本体
+	rp[4].InitAsShaderResourceView(1);       // t1: セルごとの (先頭, 個数)
+	rp[5].InitAsShaderResourceView(2);       // t2: 凹み番号の並び
+	rp[6].InitAsShaderResourceView(3);       // t3: 変形レイヤー
 	CD3DX12_ROOT_SIGNATURE_DESC rsd;
 	rsd.Init(_countof(rp), rp, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_NONE);
 
@@ -385,8 +429,6 @@ struct Dent {
     float  depth;
 };
 
-static const uint kMaxDents = 32;
-
 cbuffer CBCS : register(b0) {
     uint2 grid;   // (nx, nz)
     float cell;   // セルサイズ
@@ -395,13 +437,39 @@ cbuffer CBCS : register(b0) {
     float freq;   // 周波数（今回は未使用）
     uint  maxVerts;
     uint  dentCount;
-    float _pad;   // 16B アライン用
+    float layerStep; // 変形レイヤーの量子化の刻み
+
+    float2 dentOrigin;   // 凹みグリッド左下
+    float  dentCellSize; // 凹みグリッド 1 セルの一辺
+    uint   layerEnabled; // 変形レイヤーを足すか
+
+    uint2  dentCells;    // 凹みグリッドのセル数
+    uint2  _pad3;
+};
+
+// 凹みテーブル（TerrainDentGrid を平らにしたもの）
+StructuredBuffer<Dent>  Dents       : register(t0);
+StructuredBuffer<uint2> DentCells   : register(t1); // (先頭, 個数)
+StructuredBuffer<uint>  DentIndices : register(t2);
+
+// 変形レイヤー（格子点ごとの int16 を 2 個ずつ 32bit に詰めたもの）
+ByteAddressBuffer DeformLayer : register(t3);
+
+float layer_delta(uint ix, uint iz)
+{
+    uint i = iz * (grid.x + 1) + ix;
+    uint word = DeformLayer.Load((i >> 1) * 4);
+    int v = (i & 1) ? (int(word) >> 16) : (int(word << 16) >> 16);
+    return v * layerStep;
+}
 
-    Dent dents[kMaxDents];
+// 今回作り直すチャンク（ルート定数）
+cbuffer CBChunk : register(b1) {
+    uint2 chunkOrigin; // 先頭セル
+    uint2 chunkSize;   // 担当する格子点数
 };
 
 RWStructuredBuffer<VOut> OutVerts : register(u0);
-RWByteAddressBuffer      Counter  : register(u1);
 
 // ---- ベースのドーナツ型ステージの高さ関数 ----
 float h_base(float2 xz)
@@ -436,16 +504,47 @@ float h_base(float2 xz)
     return y;
 }
 
-// ---- 凹み込みの高さ関数 ----
-float h(float2 xz)
+// ---- ベース地形の高さと勾配 (y, dH/dx, dH/dz) ----
+float3 h_base_grad(float2 xz)
 {
-    float y = h_base(xz);
+    const float pitRadius        = 40.0;
+    const float outerRingRadius  = 100.0;
+    const float pitFloorY        = -4.0;
+    const float ringY            =  2.5;
+    const float outerBaseY       = -8.0;
+    const float outerBlendWidth  = 10.0;
+
+    float r = length(xz);
+
+    // dH/dx = k * x（穴は r^2 の式なので k は定数）
+    float k = 0.0;
+    if (r < pitRadius)
+    {
+        k = 2.0 * (ringY - pitFloorY) / (pitRadius * pitRadius);
+    }
+    else if (r > outerRingRadius && r < outerRingRadius + outerBlendWidth)
+    {
+        k = (outerBaseY - ringY) / outerBlendWidth / r;
+    }
+
+    return float3(h_base(xz), k * xz);
+}
+
+// ---- 凹み込みの高さと勾配 ----
+float3 h_grad(float2 xz)
+{
+    float3 y = h_base_grad(xz);
+
+    // 自分のセルに載っている凹みだけ適用
+    int2 c = int2(floor((xz - dentOrigin) / dentCellSize));
+    if (any(c < 0) || c.x >= (int)dentCells.x || c.y >= (int)dentCells.y) return y;
+
+    uint2 range = DentCells[c.y * dentCells.x + c.x];
 
-    // すべての凹みを適用
     [loop]
-    for (uint i = 0; i < dentCount; ++i)
+    for (uint i = 0; i < range.y; ++i)
     {
-        Dent d = dents[i];
+        Dent d = Dents[DentIndices[range.x + i]];
 
         float2 dXZ = xz - d.centerXZ;
         float  dist2 = dot(dXZ, dXZ);
@@ -453,94 +552,56 @@ float h(float2 xz)
 
         if (dist2 > r2) continue;
 
-        // 中心ほど大きくへこむ（0～1）
+        // 中心ほど大きくへこむ（0～1）。勾配は 2 * depth * dXZ / r2
         float t = 1.0 - dist2 / r2;
-
-        // 必要なら pow(t,2) とかで形を調整可能
-        float dentY = -d.depth * t;
-
-        y += dentY;
+        y.x  += -d.depth * t;
+        y.yz += (2.0 * d.depth / r2) * dXZ;
     }
 
     return y;
 }
 
-// 1セル=2三角形=6頂点生成（グリッド地形）
+// 1格子点=1頂点生成（インデックスは CPU 側で固定）
+// 1 Dispatch = 1 チャンク。チャンクが担当する格子点だけ書く
 [numthreads(8, 8, 1)]
 void main(uint3 dtid : SV_DispatchThreadID)
 {
-    uint x = dtid.x;
-    uint z = dtid.y;
-    if (x >= grid.x || z >= grid.y) return;
+    if (dtid.x >= chunkSize.x || dtid.y >= chunkSize.y) return;
+    uint ix = chunkOrigin.x + dtid.x;
+    uint iz = chunkOrigin.y + dtid.y;
+
+    uint vi = iz * (grid.x + 1) + ix;
+    if (vi >= maxVerts) return;
 
     // 中心配置（原点センタリング）
-    float x0 = (x    ) * cell - 0.5 * grid.x * cell;
-    float x1 = (x + 1) * cell - 0.5 * grid.x * cell;
-    float z0 = (z    ) * cell - 0.5 * grid.y * cell;
-    float z1 = (z + 1) * cell - 0.5 * grid.y * cell;
-
-    float y00 = h(float2(x0, z0));
-    float y10 = h(float2(x1, z0));
-    float y01 = h(float2(x0, z1));
-    float y11 = h(float2(x1, z1));
-
-    VOut v[6];
-
-    // tri0 (x0,z0)-(x1,z0)-(x0,z1)
-    v[0].pos = float3(x0, y00, z0);
-    v[1].pos = float3(x1, y10, z0);
-    v[2].pos = float3(x0, y01, z1);
-
-    // tri1 (x1,z0)-(x1,z1)-(x0,z1)
-    v[3].pos = float3(x1, y10, z0);
-    v[4].pos = float3(x1, y11, z1);
-    v[5].pos = float3(x0, y01, z1);
-
-    // UV（とりあえず平面投影）
-    v[0].uv = float2(0, 0);
-    v[1].uv = float2(1, 0);
-    v[2].uv = float2(0, 1);
-    v[3].uv = float2(1, 0);
-    v[4].uv = float2(1, 1);
-    v[5].uv = float2(0, 1);
-
-    // 法線（高さ関数から数値微分）
-    float eps = cell;
-
-    float hx00 = h(float2(x0+eps, z0)) - h(float2(x0-eps, z0));
-    float hz00 = h(float2(x0, z0+eps)) - h(float2(x0, z0-eps));
-    float3 n00 = normalize(float3(-hx00, 2*eps, -hz00));
-
-    float hx10 = h(float2(x1+eps, z0)) - h(float2(x1-eps, z0));
-    float hz10 = h(float2(x1, z0+eps)) - h(float2(x1, z0-eps));
-    float3 n10 = normalize(float3(-hx10, 2*eps, -hz10));
-
-    float hx01 = h(float2(x0+eps, z1)) - h(float2(x0-eps, z1));
-    float hz01 = h(float2(x0, z1+eps)) - h(float2(x0, z1-eps));
-    float3 n01 = normalize(float3(-hx01, 2*eps, -hz01));
-
-    float hx11 = h(float2(x1+eps, z1)) - h(float2(x1-eps, z1));
-    float hz11 = h(float2(x1, z1+eps)) - h(float2(x1, z1-eps));
-    float3 n11 = normalize(float3(-hx11, 2*eps, -hz11));
-
-    // tri0
-    v[0].nrm = n00;
-    v[1].nrm = n10;
-    v[2].nrm = n01;
-    // tri1
-    v[3].nrm = n10;
-    v[4].nrm = n11;
-    v[5].nrm = n01;
-
-    // カウンタを6加算してベース取得
-    uint vertBase;
-    Counter.InterlockedAdd(0, 6, vertBase);
-    if (vertBase + 6 > maxVerts) return;
-
-    // 書き込み
-    [unroll] for (int i = 0; i < 6; i++) {
-        OutVerts[vertBase + i] = v[i];
+    float x = ix * cell - 0.5 * grid.x * cell;
+    float z = iz * cell - 0.5 * grid.y * cell;
+
+    // 高さと勾配を 1 回で
+    float3 hg = h_grad(float2(x, z));
+
+    // 変形レイヤー（格子点の値 + 中心差分の勾配）
+    if (layerEnabled != 0)
+    {
+        uint x0 = ix > 0 ? ix - 1 : ix;
+        uint x1 = ix < grid.x ? ix + 1 : ix;
+        uint z0 = iz > 0 ? iz - 1 : iz;
+        uint z1 = iz < grid.y ? iz + 1 : iz;
+        hg.x += layer_delta(ix, iz);
+        hg.y += (layer_delta(x1, iz) - layer_delta(x0, iz)) / ((x1 - x0) * cell);
+        hg.z += (layer_delta(ix, z1) - layer_delta(ix, z0)) / ((z1 - z0) * cell);
     }
+
+    VOut v;
+    v.pos = float3(x, hg.x, z);
+
+    // UV（1セル = 1。テクスチャは WRAP なのでセルごとの 0～1 と同じ見た目）
+    v.uv = float2(ix, iz);
+
+    // 法線（解析的な勾配から）
+    v.nrm = normalize(float3(-hg.y, 1.0, -hg.z));
+
+    OutVerts[vi] = v;
 }
 )",
 	    "main", "cs_5_0");
@@ -552,7 +613,7 @@ void main(uint3 dtid : SV_DispatchThreadID)
 
 	// CS用CB
 	voxel_.cbCS.Reset();
-	voxel_.cbCS = CreateUploadBuffer(dev, sizeof(voxel_.params));
+	voxel_.cbCS = CreateUploadBuffer(dev, (sizeof(voxel_.params) + 255) & ~size_t(255));
 
 	return true;
 }
@@ -592,15 +653,21 @@ bool Renderer::InitVoxelDrawPSO(ID3D12Device* dev) {
 		dev->CreateShaderResourceView(voxel_.tex[i].Get(), &sv, dx_->SRV_CPU(nextSrvIndex_++));
 	}
 
+	// スプラットマップの SRV は t3 として続きに置く（中身は CreateVoxelSplatMap で）
+	nextSrvIndex_++;
+
 	// === RootSig ===
 	CD3DX12_DESCRIPTOR_RANGE rng;
-	rng.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 3, 0); // t0,t1,t2
+	rng.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 4, 0); // t0,t1,t2 + t3: スプラット
 	CD3DX12_ROOT_PARAMETER rp[2];
 	rp[0].InitAsConstantBufferView(0);
 	rp[1].InitAsDescriptorTable(1, &rng, D3D12_SHADER_VISIBILITY_PIXEL);
-	CD3DX12_STATIC_SAMPLER_DESC smp(0);
+	CD3DX12_STATIC_SAMPLER_DESC smp[2] = {
+	    CD3DX12_STATIC_SAMPLER_DESC(0),
+	    CD3DX12_STATIC_SAMPLER_DESC(1, D3D12_FILTER_MIN_MAG_MIP_LINEAR, D3D12_TEXTURE_ADDRESS_MODE_CLAMP, D3D12_TEXTURE_ADDRESS_MODE_CLAMP, D3D12_TEXTURE_ADDRESS_MODE_CLAMP),
+	};
 	CD3DX12_ROOT_SIGNATURE_DESC rsd;
-	rsd.Init(2, rp, 1, &smp, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+	rsd.Init(2, rp, _countof(smp), smp, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
 	Microsoft::WRL::ComPtr<ID3DBlob> sig, err;
 	HR_CHECK(D3D12SerializeRootSignature(&rsd, D3D_ROOT_SIGNATURE_VERSION_1, &sig, &err));
@@ -628,38 +695,25 @@ bool Renderer::InitVoxelDrawPSO(ID3D12Device* dev) {
 Texture2D dirtTex:register(t0);
 Texture2D grassTex:register(t1);
 Texture2D rockTex:register(t2);
+Texture2D splatTex:register(t3); // r=土, g=草, b=岩（CPU で高さと傾きから焼いたもの）
 SamplerState S:register(s0);
+SamplerState SClamp:register(s1);
 
 float4 main(float4 sp:SV_Position, float3 wpos:POSITION, float3 n:NORMAL, float2 uv:TEXCOORD):SV_Target {
 
-    // ===== 高さ基準でレイヤー分け =====
-    float h = wpos.y;
-
-    // 好きに調整可能（例）
-    float rockEnd = -2.0;   // 岩 → 土 の境界
-    float dirtEnd =  1.0;   // 土 → 草 の境界
-
     // ===== 各テクスチャ =====
     float3 colRock  = rockTex.Sample(S,  uv * 5.0).rgb;
     float3 colDirt  = dirtTex.Sample(S,  uv * 5.0).rgb;
     float3 colGrass = grassTex.Sample(S, uv * 5.0).rgb;
 
-    // ===== 高さから重み =====
-    // rock:  h < rockEnd
-    float wRock  = 1.0 - smoothstep(rockEnd - 0.5, rockEnd + 0.5, h);
-
-    // grass: h > dirtEnd
-    float wGrass = smoothstep(dirtEnd - 0.5, dirtEnd + 0.5, h);
-
-    // dirt: 残り全部
-    float wDirt = 1.0 - wRock - wGrass;
-    wDirt = saturate(wDirt);
-
-    // 正規化（任意）
-    float s = wRock + wDirt + wGrass + 1e-5;
-    wRock /= s;
-    wDirt /= s;
-    wGrass /= s;
+    // ===== 重みはスプラットマップから（uv は格子座標なので 1 セル = 1 テクセル）=====
+    float2 splatSize;
+    splatTex.GetDimensions(splatSize.x, splatSize.y);
+    float3 w = splatTex.Sample(SClamp, uv / splatSize).rgb;
+    w /= (w.r + w.g + w.b + 1e-5);
+    float wDirt  = w.r;
+    float wGrass = w.g;
+    float wRock  = w.b;
 
     float3 mixCol = colRock * wRock + colDirt * wDirt + colGrass * wGrass;
 
@@ -717,147 +771,215 @@ bool Renderer::CreateVoxelBuffers(ID3D12Device* dev, UINT maxVertices) {
 	uav.Buffer.StructureByteStride = stride;
 	uav.Format = DXGI_FORMAT_UNKNOWN; // 構造化
 	dev->CreateUnorderedAccessView(voxel_.vbUav.Get(), nullptr, &uav, dx_->SRV_CPU(voxel_.vbUavIndex));
-
-	// 頂点数カウンタ（RWByteAddressBuffer相当だが簡易にR32_UINT UAVで扱う）
-	{
-		// Counter用に32bit uint 1要素のUAVバッファ
-		auto desc = CD3DX12_RESOURCE_DESC::Buffer(4, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
-		auto heap = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
-		HR_CHECK(dev->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&voxel_.counterUav)));
-
-		voxel_.counterSrvIndex = nextSrvIndex_++;
-		D3D12_UNORDERED_ACCESS_VIEW_DESC cuav{};
-		cuav.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
-		cuav.Buffer.NumElements = 1; // 4B = 1要素として扱う
-		cuav.Buffer.StructureByteStride = 0;
-		cuav.Buffer.Flags = D3D12_BUFFER_UAV_FLAG_RAW; // ★RAWが必須
-		cuav.Format = DXGI_FORMAT_R32_TYPELESS;        // ★ByteAddress は typeless + RAW
-		dev->CreateUnorderedAccessView(voxel_.counterUav.Get(), nullptr, &cuav, dx_->SRV_CPU(voxel_.counterSrvIndex));
-	}
+	voxel_.vbState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS; // CreateDefaultBufferUAV の初期状態
 
 	// VBV（描画時に使う）
 	voxel_.vbv = {voxel_.vbUav->GetGPUVirtualAddress(), (UINT)bytes, stride};
 	return true;
 }
 
-void Renderer::DispatchVoxel(ID3D12GraphicsCommandList* cmd, UINT gridX, UINT gridZ) {
+bool Renderer::CreateVoxelIndexBuffer(ID3D12Device* dev, UINT gridX, UINT gridZ) {
+	// 格子のつながりは凹みで変わらないので、最初に 1 回だけ作る
+	voxel_.indexCount = gridX * gridZ * TerrainChunkGrid::kIndicesPerCell;
+	const UINT64 bytes = UINT64(voxel_.indexCount) * sizeof(uint32_t);
+	voxel_.ib = CreateUploadBuffer(dev, bytes);
 
-	const UINT need = gridX * gridZ * 6;
-	if (need > voxel_.maxVertices) {
-		OutputDebugStringA("DispatchVoxel: exceeded maxVertices. skip\n");
+	void* p = nullptr;
+	HR_CHECK(voxel_.ib->Map(0, nullptr, &p));
+	TerrainBuildIndices(gridX, gridZ, static_cast<uint32_t*>(p));
+	voxel_.ib->Unmap(0, nullptr);
+
+	voxel_.ibv = {voxel_.ib->GetGPUVirtualAddress(), (UINT)bytes, DXGI_FORMAT_R32_UINT};
+	return true;
+}
+
+bool Renderer::CreateVoxelSplatMap(ID3D12Device* dev, UINT gridX, UINT gridZ) {
+	// ★ 今の地形（ベース + 凹み + レイヤー）から全面を焼く
+	voxel_.splat.Initialize(gridX, gridZ, voxel_.params.cell);
+	voxel_.splat.BakeAll(&voxel_.dentGrid, &voxel_.deformLayer);
+
+	// テクスチャ本体（更新はコピーで）
+	CD3DX12_HEAP_PROPERTIES hpD(D3D12_HEAP_TYPE_DEFAULT);
+	auto rd = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, gridX, gridZ, 1, 1);
+	HR_CHECK(dev->CreateCommittedResource(&hpD, D3D12_HEAP_FLAG_NONE, &rd, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&voxel_.splatTex)));
+	voxel_.splatState = D3D12_RESOURCE_STATE_COPY_DEST;
+
+	// 全面ぶんのアップロードバッファ（変わった範囲の行だけ書いてコピーする）
+	UINT64 upSize = 0;
+	dev->GetCopyableFootprints(&rd, 0, 1, 0, &voxel_.splatFootprint, nullptr, nullptr, &upSize);
+	voxel_.splatUp = CreateUploadBuffer(dev, upSize);
+
+	// SRV（InitVoxelDrawPSO で t3 の場所を空けてある）
+	D3D12_SHADER_RESOURCE_VIEW_DESC sv{};
+	sv.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	sv.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	sv.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	sv.Texture2D.MipLevels = 1;
+	dev->CreateShaderResourceView(voxel_.splatTex.Get(), &sv, dx_->SRV_CPU(voxel_.texBaseIndex + 3));
+	return true;
+}
+
+void Renderer::UploadVoxelSplat(ID3D12GraphicsCommandList* cmd) {
+	voxel_.splat.TakeDirty(voxel_.splatDirty);
+	if (voxel_.splatDirty.empty() || !voxel_.splatTex)
 		return;
+
+	// 変わった範囲の行だけアップロードバッファへ（毎フレーム GPU 待ちしているので上書きして良い）
+	const auto& fp = voxel_.splatFootprint;
+	const auto& texels = voxel_.splat.Texels();
+	const UINT width = voxel_.splat.Width();
+	uint8_t* map = nullptr;
+	voxel_.splatUp->Map(0, nullptr, reinterpret_cast<void**>(&map));
+	for (const auto& r : voxel_.splatDirty) {
+		const size_t bytes = size_t(r.x1 - r.x0 + 1) * sizeof(uint32_t);
+		for (UINT z = r.z0; z <= r.z1; ++z) {
+			memcpy(map + fp.Offset + size_t(z) * fp.Footprint.RowPitch + r.x0 * sizeof(uint32_t), &texels[size_t(z) * width + r.x0], bytes);
+		}
 	}
+	voxel_.splatUp->Unmap(0, nullptr);
 
-	// ① UNORDERED_ACCESS → COPY_DEST
-	auto toCopy = CD3DX12_RESOURCE_BARRIER::Transition(voxel_.counterUav.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_DEST);
-	cmd->ResourceBarrier(1, &toCopy);
+	if (voxel_.splatState != D3D12_RESOURCE_STATE_COPY_DEST) {
+		auto bar = CD3DX12_RESOURCE_BARRIER::Transition(voxel_.splatTex.Get(), voxel_.splatState, D3D12_RESOURCE_STATE_COPY_DEST);
+		cmd->ResourceBarrier(1, &bar);
+	}
+
+	CD3DX12_TEXTURE_COPY_LOCATION dst(voxel_.splatTex.Get(), 0);
+	CD3DX12_TEXTURE_COPY_LOCATION src(voxel_.splatUp.Get(), fp);
+	for (const auto& r : voxel_.splatDirty) {
+		D3D12_BOX box{r.x0, r.z0, 0, r.x1 + 1, r.z1 + 1, 1};
+		cmd->CopyTextureRegion(&dst, r.x0, r.z0, 0, &src, &box);
+	}
 
-	// ② 4バイトコピー
-	cmd->CopyBufferRegion(
-	    voxel_.counterUav.Get(), 0, // dest
-	    zeroUpload_.Get(), 0,       // src
-	    4);
+	auto bar = CD3DX12_RESOURCE_BARRIER::Transition(voxel_.splatTex.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	cmd->ResourceBarrier(1, &bar);
+	voxel_.splatState = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+}
 
-	// ③ COPY_DEST → UNORDERED_ACCESS
-	auto toUav = CD3DX12_RESOURCE_BARRIER::Transition(voxel_.counterUav.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-	cmd->ResourceBarrier(1, &toUav);
+bool Renderer::DispatchVoxel(ID3D12GraphicsCommandList* cmd, const uint32_t* chunks, UINT chunkCount) {
+	if (chunkCount == 0)
+		return false;
+
+	const UINT need = voxelChunks_.TotalVertices();
+	if (need > voxel_.maxVertices) {
+		OutputDebugStringA("DispatchVoxel: exceeded maxVertices. skip\n");
+		return false;
+	}
 
 	// CSパラメータ
-	voxel_.params.grid = {gridX, gridZ};
-	voxel_.params.cell = 0.80f; // セルを少し粗くして起伏を見せる
-	voxel_.params.amp = 3.50f;  // （今は未使用だが残しておく）
-	voxel_.params.freq = 0.08f; // （同上）
+	voxel_.params.grid = {voxelGridX_, voxelGridZ_};
 	voxel_.params.maxVerts = voxel_.maxVertices;
 
-	// ★ 凹み情報を CB にコピー
-	voxel_.params.dentCount = voxel_.dentCount;
-	if (voxel_.params.dentCount > VoxelGPU::kMaxDents) {
-		voxel_.params.dentCount = VoxelGPU::kMaxDents;
+	// ★ 凹みグリッドの情報を CB に、中身は変わったときだけ SRV 用バッファへ
+	auto& dg = voxel_.dentGrid;
+	voxel_.params.dentCount = dg.Count();
+	voxel_.params.dentOrigin = {dg.OriginX(), dg.OriginZ()};
+	voxel_.params.dentCellSize = dg.CellSize();
+	voxel_.params.dentCells = {dg.CellsX(), dg.CellsZ()};
+	// ★ 変形レイヤーは読み込み/クリアのときだけ上げ直す
+	auto& layer = voxel_.deformLayer;
+	voxel_.params.layerStep = TerrainDeformationLayer::kQuantStep;
+	voxel_.params.layerEnabled = layer.IsEmpty() ? 0u : 1u;
+	if (voxel_.layerVersion != layer.Version() || !voxel_.layerBuf) {
+		UploadToGrowableBuffer(dx_->Dev(), voxel_.layerBuf, voxel_.layerBufBytes, layer.Raw().data(), layer.Raw().size() * sizeof(int16_t));
+		voxel_.layerVersion = layer.Version();
 	}
-	for (UINT i = 0; i < voxel_.params.dentCount; ++i) {
-		voxel_.params.dents[i] = voxel_.dents[i];
+
+	if (dg.BuildFlatTables() || !voxel_.dentBuf) {
+		const auto& dents = dg.Dents();
+		const auto& ranges = dg.FlatRanges();
+		const auto& indices = dg.FlatIndices();
+		UploadToGrowableBuffer(dx_->Dev(), voxel_.dentBuf, voxel_.dentBufBytes, dents.data(), dents.size() * sizeof(TerrainDent));
+		UploadToGrowableBuffer(dx_->Dev(), voxel_.dentRangeBuf, voxel_.dentRangeBufBytes, ranges.data(), ranges.size() * sizeof(TerrainDentGrid::CellRange));
+		UploadToGrowableBuffer(dx_->Dev(), voxel_.dentIndexBuf, voxel_.dentIndexBufBytes, indices.data(), indices.size() * sizeof(uint32_t));
 	}
 
 	void* p = nullptr;
 	const D3D12_RANGE readRange{0, 0};
 	if (!voxel_.cbCS)
-		voxel_.cbCS = CreateUploadBuffer(dx_->Dev(), sizeof(voxel_.params));
+		voxel_.cbCS = CreateUploadBuffer(dx_->Dev(), (sizeof(voxel_.params) + 255) & ~size_t(255));
 	if (SUCCEEDED(voxel_.cbCS->Map(0, &readRange, &p)) && p) {
 		memcpy(p, &voxel_.params, sizeof(voxel_.params));
 		voxel_.cbCS->Unmap(0, nullptr);
 
 	} else {
 		OutputDebugStringA("DispatchVoxel: cbCS->Map failed\n");
-		return; // このフレームは安全にスキップ
+		return false; // このフレームは安全にスキップ
 	}
 
 	// リソース遷移：VB(UAV)を UAV 状態に
-	{
-		auto b = CD3DX12_RESOURCE_BARRIER::Transition(voxel_.vbUav.Get(), D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	if (voxel_.vbState != D3D12_RESOURCE_STATE_UNORDERED_ACCESS) {
+		auto b = CD3DX12_RESOURCE_BARRIER::Transition(voxel_.vbUav.Get(), voxel_.vbState, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 		cmd->ResourceBarrier(1, &b);
+		voxel_.vbState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
 	}
 
 	// CS 実行
 	cmd->SetPipelineState(voxel_.psoCS.Get());
 	cmd->SetComputeRootSignature(voxel_.rsCS.Get());
 	cmd->SetComputeRootConstantBufferView(0, voxel_.cbCS->GetGPUVirtualAddress());
-	// UAVは “連番2個” のディスクリプタテーブルとして渡す
-	// 先頭は vbUav、次が counterUav（CreateVoxelBuffers で連番確保済み）
 	cmd->SetComputeRootDescriptorTable(1, dx_->SRV_GPU(voxel_.vbUavIndex));
-
-	const UINT tgx = (gridX + 7) / 8;
-	const UINT tgz = (gridZ + 7) / 8;
-	cmd->Dispatch(tgx, tgz, 1);
-
-	{
-		D3D12_RESOURCE_BARRIER uavs[] = {
-		    CD3DX12_RESOURCE_BARRIER::UAV(voxel_.vbUav.Get()),
-		    CD3DX12_RESOURCE_BARRIER::UAV(voxel_.counterUav.Get()),
-		};
-		cmd->ResourceBarrier(_countof(uavs), uavs);
-	}
-
-	const UINT needed = gridX * gridZ * 6;
-	if (needed > voxel_.maxVertices) {
-		// 例: グリッドを縮小 or return
-		// （まずはreturnで落ちなくする）
-		return;
+	cmd->SetComputeRootShaderResourceView(3, voxel_.dentBuf->GetGPUVirtualAddress());
+	cmd->SetComputeRootShaderResourceView(4, voxel_.dentRangeBuf->GetGPUVirtualAddress());
+	cmd->SetComputeRootShaderResourceView(5, voxel_.dentIndexBuf->GetGPUVirtualAddress());
+	cmd->SetComputeRootShaderResourceView(6, voxel_.layerBuf->GetGPUVirtualAddress());
+
+	// チャンクごとに書き込み範囲が重ならないので、間の UAV バリアは不要
+	for (UINT i = 0; i < chunkCount; ++i) {
+		const TerrainChunkRect& c = voxelChunks_.Chunk(chunks[i]);
+		const UINT rc[4] = {c.cellX0, c.cellZ0, c.vertsX, c.vertsZ};
+		cmd->SetComputeRoot32BitConstants(2, _countof(rc), rc, 0);
+		cmd->Dispatch((c.vertsX + 7) / 8, (c.vertsZ + 7) / 8, 1);
 	}
 
 	// UAV→VB 用に状態戻し
 	{
 		auto b = CD3DX12_RESOURCE_BARRIER::Transition(voxel_.vbUav.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_GENERIC_READ);
 		cmd->ResourceBarrier(1, &b);
+		voxel_.vbState = D3D12_RESOURCE_STATE_GENERIC_READ;
 	}
-
-	{
-		// UNORDERED_ACCESS → COPY_SOURCE
-		auto toSrc = CD3DX12_RESOURCE_BARRIER::Transition(voxel_.counterUav.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_SOURCE);
-		cmd->ResourceBarrier(1, &toSrc);
-
-		// 4B コピー（READBACK側は常に COPY_DEST）
-		cmd->CopyResource(voxel_.counterReadback.Get(), voxel_.counterUav.Get());
-
-		// COPY_SOURCE → UNORDERED_ACCESS
-		auto backUav = CD3DX12_RESOURCE_BARRIER::Transition(voxel_.counterUav.Get(), D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-		cmd->ResourceBarrier(1, &backUav);
-	}
+	return true;
 }
 
 void Renderer::RebuildVoxelIfNeeded(ID3D12GraphicsCommandList* cmd) {
-	if (!voxelDirty_) {
+	// 焼き直したスプラットマップの範囲を上げる
+	UploadVoxelSplat(cmd);
+
+	if (!voxelChunks_.AnyDirty()) {
 		return;
 	}
 
-	// 必要なときだけ再生成
-	DispatchVoxel(cmd, voxelGridX_, voxelGridZ_);
-	voxelDirty_ = false;
-}
+	const auto t0 = std::chrono::steady_clock::now();
 
-UINT Renderer::ReadbackVoxelVertexCount() { return voxel_.counterCpuPtr ? *reinterpret_cast<const UINT*>(voxel_.counterCpuPtr) : 0u; }
+	// 必要なチャンクだけ再生成
+	voxelChunks_.TakeDirty(voxelDirtyChunks_);
+	if (!DispatchVoxel(cmd, voxelDirtyChunks_.data(), UINT(voxelDirtyChunks_.size()))) {
+		// 失敗したら次のフレームでもう一度
+		for (uint32_t idx : voxelDirtyChunks_) {
+			const TerrainChunkRect& c = voxelChunks_.Chunk(idx);
+			voxelChunks_.MarkCellRect(int(c.cellX0), int(c.cellZ0), int(c.cellX0 + c.cellsX) - 1, int(c.cellZ0 + c.cellsZ) - 1);
+		}
+		return;
+	}
+	voxel_.builtVertices = voxelChunks_.TotalVertices();
+
+	// 統計
+	UINT cells = 0;
+	UINT verts = 0;
+	for (uint32_t idx : voxelDirtyChunks_) {
+		const TerrainChunkRect& c = voxelChunks_.Chunk(idx);
+		cells += c.cellsX * c.cellsZ;
+		verts += c.vertsX * c.vertsZ;
+	}
+	voxelStats_.chunks = UINT(voxelDirtyChunks_.size());
+	voxelStats_.cells = cells;
+	voxelStats_.vertices = verts;
+	voxelStats_.recordMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+	voxelStats_.rebuilds++;
+	voxelStats_.totalChunks += voxelStats_.chunks;
+}
 
 void Renderer::DrawVoxel(ID3D12GraphicsCommandList* cmd, const Camera& cam) {
-	const UINT vertCount = ReadbackVoxelVertexCount();
+	const UINT vertCount = VoxelVertexCount();
 	if (vertCount == 0)
 		return;
 
@@ -881,7 +1003,42 @@ void Renderer::DrawVoxel(ID3D12GraphicsCommandList* cmd, const Camera& cam) {
 	if (voxel_.texBaseIndex != UINT_MAX)
 		cmd->SetGraphicsRootDescriptorTable(1, dx_->SRV_GPU(voxel_.texBaseIndex));
 
-	cmd->DrawInstanced(vertCount, 1, 0, 0);
+	// ★ LOD で間引いたインデックス（作れなかったらフル解像度）
+	UpdateVoxelLod(cam);
+	if (voxel_.lodIb) {
+		if (voxel_.lodIndexCount == 0)
+			return; // 視錐台に何も入っていない
+		cmd->IASetIndexBuffer(&voxel_.lodIbv);
+		cmd->DrawIndexedInstanced(voxel_.lodIndexCount, 1, 0, 0, 0);
+	} else {
+		cmd->IASetIndexBuffer(&voxel_.ibv);
+		cmd->DrawIndexedInstanced(voxel_.indexCount, 1, 0, 0, 0);
+	}
+}
+
+void Renderer::UpdateVoxelLod(const Camera& cam) {
+	DirectX::XMFLOAT4 planes[6];
+	TerrainLodSelector::ExtractFrustumPlanes(cam.View() * cam.Proj(), planes);
+	voxelLod_.Select(cam.Position(), planes, voxelPatches_);
+
+	voxelStats_.lodPatches = UINT(voxelPatches_.size());
+	voxelStats_.fullTriangles = voxel_.indexCount / 3;
+
+	// 寄せ具合（morph）以外が前回と同じならインデックスはそのまま
+	auto same = [](const TerrainLodPatch& a, const TerrainLodPatch& b) {
+		return a.cellX0 == b.cellX0 && a.cellZ0 == b.cellZ0 && a.cellsX == b.cellsX && a.cellsZ == b.cellsZ && a.lod == b.lod && memcmp(a.edgeLod, b.edgeLod, sizeof(a.edgeLod)) == 0;
+	};
+	if (voxel_.lodIb && voxelPatches_.size() == voxelPrevPatches_.size() && std::equal(voxelPatches_.begin(), voxelPatches_.end(), voxelPrevPatches_.begin(), same))
+		return;
+
+	// 毎フレーム GPU 待ちしているのでアップロードバッファへ直接書いて良い
+	TerrainLodSelector::BuildIndices(voxelPatches_, voxelGridX_, voxelLodIndices_);
+	const UINT64 bytes = UINT64(voxelLodIndices_.size()) * sizeof(uint32_t);
+	UploadToGrowableBuffer(dx_->Dev(), voxel_.lodIb, voxel_.lodIbBytes, voxelLodIndices_.data(), bytes);
+	voxel_.lodIbv = {voxel_.lodIb->GetGPUVirtualAddress(), (UINT)(std::max)(bytes, UINT64(sizeof(uint32_t))), DXGI_FORMAT_R32_UINT};
+	voxel_.lodIndexCount = UINT(voxelLodIndices_.size());
+	voxelStats_.lodTriangles = voxel_.lodIndexCount / 3;
+	voxelPrevPatches_.swap(voxelPatches_);
 }
 
 void Renderer::DrawSkybox(const Camera& cam, ID3D12GraphicsCommandList* cmd) {
@@ -953,15 +1110,33 @@ void Renderer::Shutdown() {
 
 	// ▼Voxel 関連
 	voxel_.vbUav.Reset();
-	voxel_.counterUav.Reset();
+	voxel_.ib.Reset();
+	voxel_.ibv = {};
+	voxel_.indexCount = 0;
+	voxel_.lodIb.Reset();
+	voxel_.lodIbBytes = 0;
+	voxel_.lodIbv = {};
+	voxel_.lodIndexCount = 0;
+	voxelPrevPatches_.clear();
 	voxel_.cbCS.Reset();
 	voxel_.cbDraw.Reset();
+	voxel_.dentBuf.Reset();
+	voxel_.dentRangeBuf.Reset();
+	voxel_.dentIndexBuf.Reset();
+	voxel_.dentBufBytes = voxel_.dentRangeBufBytes = voxel_.dentIndexBufBytes = 0;
+	voxel_.layerBuf.Reset();
+	voxel_.layerBufBytes = 0;
+	voxel_.layerVersion = UINT32_MAX;
+	voxel_.splatTex.Reset();
+	voxel_.splatUp.Reset();
+	voxel_.splatDirty.clear();
 	voxel_.rsCS.Reset();
 	voxel_.psoCS.Reset();
 	voxel_.rsVoxelDraw.Reset();
 	voxel_.psoVoxelDraw.Reset();
 	voxel_.vbv = {};
 	voxel_.maxVertices = 0;
+	voxel_.builtVertices = 0;
 
 	// ---- 球体 ----
 	sph_.vb.Reset();
@@ -1246,6 +1421,24 @@ void Renderer::BeginFrame(ID3D12GraphicsCommandList* cmd) {
 	assert(cmd && srvHeap_);
 	ID3D12DescriptorHeap* heaps[] = {srvHeap_.Get()};
 	cmd->SetDescriptorHeaps(1, heaps);
+
+	// パーティクルのフレームごとのプールを先頭に戻す
+	if (auto pr = particleRenderer_.lock()) {
+		pr->BeginFrame();
+	}
+}
+
+std::shared_ptr<ParticleRenderer> Renderer::AcquireParticleRenderer(ID3D12Device* device, ID3D12GraphicsCommandList* cmd) {
+	if (auto pr = particleRenderer_.lock()) {
+		return pr;
+	}
+	auto pr = std::make_shared<ParticleRenderer>();
+	if (!pr->Initialize(*this, device, cmd)) {
+		OutputDebugStringA("Renderer::AcquireParticleRenderer: initialize failed\n");
+		return nullptr;
+	}
+	particleRenderer_ = pr;
+	return pr;
 }
 
 void Renderer::EndFrame(ID3D12GraphicsCommandList* /*cmd*/) {}
@@ -2149,113 +2342,102 @@ bool Renderer::InitLaserPSO(ID3D12Device* device, ID3D12RootSignature* rs) {
 	return SUCCEEDED(hr);
 }
 
-// CS内の h(xz) と同じ式をCPUにも再現
-static inline float VoxelHeightFunc_CPU(float x, float z, float amp, float freq) {
-	(void)amp;
-	(void)freq;
+void Renderer::AddTerrainDent(const DirectX::XMFLOAT3& position, float radius, float depth) {
+	TerrainDent d;
+	d.centerXZ = DirectX::XMFLOAT2(position.x, position.z);
+	d.radius = radius;
+	d.depth = depth;
 
-	float r = std::sqrt(x * x + z * z);
+	// ★ 覆われた凹みと古い凹みは変形レイヤーに焼き込むので、セルあたりの凹みの数は上限で止まる
+	const auto r = voxel_.dentGrid.Add(d, &voxel_.deformLayer);
+	const float normalEps = 0.0f; // 法線も解析的に求めるので、半径の外の頂点は変わらない
 
-	const float pitRadius = 40.0f;
-	const float outerRingRadius = 100.0f;
-	const float pitFloorY = -4.0f;
-	const float ringY = 2.5f; // 岩の高さ
-	const float outerBaseY = -8.0f;
-	const float outerBlendWidth = 10.0f;
+	// ★ 焼き込んだ凹みは格子点の高さ（高さキャッシュ）はそのままで、勾配が格子の差分になるので色とメッシュだけ作り直す
+	for (const TerrainDent& f : r.folded) {
+		voxel_.splat.BakeDent(f, &voxel_.dentGrid, &voxel_.deformLayer);
+		voxelChunks_.MarkDent(f, normalEps);
+	}
 
-	float y;
+	// ★ 高さキャッシュには影響範囲だけ焼き込む
+	const TerrainDent& cur = voxel_.dentGrid.Dent(r.index);
+	terrainField_.StampDent(cur);
+	terrainPyramid_.RefitDent(cur);
+	voxel_.splat.BakeDent(cur, &voxel_.dentGrid, &voxel_.deformLayer);
 
-	if (r < pitRadius) {
-		float t = r / pitRadius; // 0～1
-		y = pitFloorY + (ringY - pitFloorY) * (t * t);
-	} else if (r < outerRingRadius) {
-		y = ringY; // ドーナツ枠：完全にフラット
-	} else {
-		float t = (r - outerRingRadius) / outerBlendWidth;
-		t = (std::max)(0.0f, (std::min)(1.0f, t)); // saturate 相当
-		y = ringY + (outerBaseY - ringY) * t;
+	// ★ メッシュも影響範囲のチャンクだけ作り直す
+	voxelChunks_.MarkDent(cur, normalEps);
+}
+
+float Renderer::TerrainHeightAt(float x, float z) const {
+	if (terrainField_.IsValid()) {
+		return terrainField_.HeightAt(x, z);
 	}
 
-	return y;
+	// 初期化前はその場で求める（CS の h() と同じロジック）
+	return TerrainBaseHeight(x, z) + voxel_.dentGrid.OffsetAt(x, z);
 }
 
-void Renderer::AddTerrainDent(const DirectX::XMFLOAT3& position, float radius, float depth) {
-	auto& vox = voxel_;
-	voxelDirty_ = true;
-	if (vox.dentCount >= VoxelGPU::kMaxDents) {
-		// いっぱいになったら、とりあえずこれ以上追加しない（必要なら上書きロジックにする）
-		OutputDebugStringA("AddTerrainDent: kMaxDents reached, skipping.\n");
-		return;
-	}
+Vector3 Renderer::TerrainNormalAt(float x, float z) const {
+	// 勾配は解析的に求まるので中心差分はいらない
+	return TerrainSampleAt(x, z).Normal();
+}
 
-	auto& d = vox.dents[vox.dentCount++];
-	d.centerXZ = DirectX::XMFLOAT2(position.x, position.z);
-	d.radius = radius;
-	d.depth = depth;
+TerrainSample Renderer::TerrainSampleAt(float x, float z) const { return Engine::TerrainSampleAt(&voxel_.dentGrid, x, z, &voxel_.deformLayer); }
+
+void Renderer::TerrainSampleBatch(const float* xs, const float* zs, size_t count, TerrainSample* out) const {
+	Engine::TerrainSampleBatch(&voxel_.dentGrid, xs, zs, count, out, &voxel_.deformLayer);
 }
 
-float Renderer::TerrainHeightAt(float x, float z) const {
-	const float amp = voxel_.params.amp;
-	const float freq = voxel_.params.freq;
-
-	// ベースの地形高さ
-	float y = VoxelHeightFunc_CPU(x, z, amp, freq);
-
-	// 凹みを適用（CS の h() と同じロジック）
-	for (UINT i = 0; i < voxel_.dentCount; ++i) {
-		const auto& d = voxel_.dents[i];
-		float dx = x - d.centerXZ.x;
-		float dz = z - d.centerXZ.y;
-		float dist2 = dx * dx + dz * dz;
-		float r2 = d.radius * d.radius;
-		if (dist2 > r2)
-			continue;
+bool Renderer::TerrainRaycast(const Vector3& origin, const Vector3& dir, float maxDist, TerrainRayHit& hit) const { return terrainPyramid_.Raycast(origin, dir, maxDist, hit); }
 
-		float t = 1.0f - dist2 / r2;
-		float dentY = -d.depth * t;
-		y += dentY;
-	}
+bool Renderer::TerrainSphereCast(const Vector3& origin, const Vector3& dir, float radius, float maxDist, TerrainRayHit& hit) const {
+	return terrainPyramid_.SphereCast(origin, dir, radius, maxDist, hit);
+}
 
-	return y;
+void Renderer::CaptureTerrainDeformation(std::vector<uint8_t>& out) const {
+	// 今の高さキャッシュ（ベース + レイヤー + 凹み）から差分を取る。稼働中のレイヤーは変えない
+	out.clear();
+	if (!terrainField_.IsValid())
+		return;
+	TerrainDeformationLayer snapshot;
+	snapshot.Initialize(voxelGridX_, voxelGridZ_, voxel_.params.cell);
+	snapshot.CaptureFrom(terrainField_);
+	snapshot.Encode(out);
 }
 
-Vector3 Renderer::TerrainNormalAt(float x, float z) const {
-	const float cell = voxel_.params.cell;
-	const float amp = voxel_.params.amp;
-	const float freq = voxel_.params.freq;
-	const float eps = cell;
-
-	auto h = [&](float X, float Z) {
-		float y = VoxelHeightFunc_CPU(X, Z, amp, freq);
-
-		for (UINT i = 0; i < voxel_.dentCount; ++i) {
-			const auto& d = voxel_.dents[i];
-			float dx = X - d.centerXZ.x;
-			float dz = Z - d.centerXZ.y;
-			float dist2 = dx * dx + dz * dz;
-			float r2 = d.radius * d.radius;
-			if (dist2 > r2)
-				continue;
-
-			float t = 1.0f - dist2 / r2;
-			float dentY = -d.depth * t;
-			y += dentY;
-		}
+bool Renderer::RestoreTerrainDeformation(const void* data, size_t bytes) {
+	if (!voxel_.deformLayer.Decode(data, bytes))
+		return false;
+	RebakeTerrainFromLayer();
+	return true;
+}
 
-		return y;
-	};
+bool Renderer::SaveTerrainDeformation(const std::string& path) const {
+	TerrainDeformationLayer snapshot;
+	snapshot.Initialize(voxelGridX_, voxelGridZ_, voxel_.params.cell);
+	snapshot.CaptureFrom(terrainField_);
+	return snapshot.SaveToFile(path);
+}
 
-	float hx = h(x + eps, z) - h(x - eps, z);
-	float hz = h(x, z + eps) - h(x, z - eps);
-	Vector3 n = {-hx, 2.0f * eps, -hz};
+bool Renderer::LoadTerrainDeformation(const std::string& path) {
+	if (!voxel_.deformLayer.LoadFromFile(path))
+		return false;
+	RebakeTerrainFromLayer();
+	return true;
+}
 
-	const float len = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
-	if (len > 1e-6f) {
-		n.x /= len;
-		n.y /= len;
-		n.z /= len;
-	}
-	return n;
+void Renderer::RebakeTerrainFromLayer() {
+	// 凹みはレイヤーに含まれているので捨てる
+	voxel_.dentGrid.Clear();
+
+	// 高さキャッシュ = ベース + レイヤー
+	terrainField_.Initialize(voxelGridX_, voxelGridZ_, voxel_.params.cell);
+	voxel_.deformLayer.ApplyTo(terrainField_);
+	terrainPyramid_.Build(&terrainField_);
+	voxel_.splat.BakeAll(&voxel_.dentGrid, &voxel_.deformLayer);
+
+	// メッシュは全チャンク作り直し
+	voxelChunks_.MarkAllDirty();
 }
 
 int Renderer::AllocateSRV() {
@@ -6,6 +6,13 @@
 #include "Camera.h"
 #include "Matrix4x4.h"
 #include "Model.h"
+#include "Terrain/TerrainChunkGrid.h"
+#include "Terrain/TerrainDeformationLayer.h"
+#include "Terrain/TerrainDentGrid.h"
+#include "Terrain/TerrainHeightField.h"
+#include "Terrain/TerrainHeightPyramid.h"
+#include "Terrain/TerrainLodSelector.h"
+#include "Terrain/TerrainSplatBaker.h"
 #include "Transform.h"
 #include "WindowDX.h"
 
@@ -18,6 +25,8 @@
 
 namespace Engine {
 
+class ParticleRenderer;
+
 class Renderer {
 public:
 	// ---- 定数（CBは256Bアライン）----
@@ -84,6 +93,12 @@ public:
 	void UpdateModelCBWithColorAt(int handle, size_t slot, const Camera& cam, const Transform& tf, const Vector4& mulColor);
 	void DrawModelAt(int handle, ID3D12GraphicsCommandList* cmd, size_t slot);
 
+	// パーティクルの共用描画リソース（板 / PSO / テクスチャ / フレームごとのプール）
+	// 最初の呼び出しで作り、使っている ParticleSystem がいなくなったら解放される
+	std::shared_ptr<ParticleRenderer> AcquireParticleRenderer(ID3D12Device* device, ID3D12GraphicsCommandList* cmd);
+	// 統計表示用（誰も使っていなければ null）
+	std::shared_ptr<const ParticleRenderer> SharedParticleRenderer() const { return particleRenderer_.lock(); }
+
 	// カメラを使ってスカイボックスを描画する
 	void DrawSkybox(const Camera& cam, ID3D12GraphicsCommandList* cmd);
 
@@ -107,8 +122,11 @@ public:
 	bool InitVoxelCS(ID3D12Device* dev);
 	bool InitVoxelDrawPSO(ID3D12Device* dev);
 	bool CreateVoxelBuffers(ID3D12Device* dev, UINT maxVertices);
-	void DispatchVoxel(ID3D12GraphicsCommandList* cmd, UINT gridX, UINT gridZ);
-	UINT ReadbackVoxelVertexCount();
+	bool CreateVoxelIndexBuffer(ID3D12Device* dev, UINT gridX, UINT gridZ);
+	bool CreateVoxelSplatMap(ID3D12Device* dev, UINT gridX, UINT gridZ);
+	void UploadVoxelSplat(ID3D12GraphicsCommandList* cmd);
+	bool DispatchVoxel(ID3D12GraphicsCommandList* cmd, const uint32_t* chunks, UINT chunkCount);
+	UINT VoxelVertexCount() const { return voxel_.builtVertices; }
 	void DrawVoxel(ID3D12GraphicsCommandList* cmd, const Camera& cam);
 
 	// ==== モデルまとめ ====
@@ -227,13 +245,19 @@ public: // （外からも参照することが多いので public に）
 		Microsoft::WRL::ComPtr<ID3D12Resource> vbUav;
 		D3D12_VERTEX_BUFFER_VIEW vbv{};
 		UINT maxVertices = 0;
+		UINT builtVertices = 0; // 生成済み頂点数（= 格子点数）
+		D3D12_RESOURCE_STATES vbState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
 
-		// 頂点数カウンタ
-		Microsoft::WRL::ComPtr<ID3D12Resource> counterUav; // RAW R32
-		int counterSrvIndex = -1;
+		// インデックス（格子のつながりは固定なので最初に 1 回だけ作る）
+		Microsoft::WRL::ComPtr<ID3D12Resource> ib;
+		D3D12_INDEX_BUFFER_VIEW ibv{};
+		UINT indexCount = 0;
 
-		Microsoft::WRL::ComPtr<ID3D12Resource> counterReadback;
-		void* counterCpuPtr = nullptr;
+		// LOD で間引いたインデックス（選ぶパッチが変わった時だけ書き直す）
+		Microsoft::WRL::ComPtr<ID3D12Resource> lodIb;
+		UINT64 lodIbBytes = 0;
+		D3D12_INDEX_BUFFER_VIEW lodIbv{};
+		UINT lodIndexCount = 0;
 
 		// SRV/UAVテーブル用の先頭インデックス
 		int vbUavIndex = -1;
@@ -253,20 +277,30 @@ public: // （外からも参照することが多いので public に）
 
 		// （将来のトライプラナ用）テクスチャ
 		Microsoft::WRL::ComPtr<ID3D12Resource> tex[3], texUp[3];
-		UINT texBaseIndex = UINT_MAX; // t0.t2
+		UINT texBaseIndex = UINT_MAX; // t0..t3（t3 はスプラットマップ）
+
+		// 土/草/岩の重み（CPU で焼いて、変わった範囲だけ上げる）
+		TerrainSplatBaker splat;
+		Microsoft::WRL::ComPtr<ID3D12Resource> splatTex, splatUp;
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT splatFootprint{};
+		D3D12_RESOURCE_STATES splatState = D3D12_RESOURCE_STATE_COPY_DEST;
+		std::vector<TerrainSplatBaker::Rect> splatDirty;
 
 		// ---- 凹み情報（ボス攻撃）----
-		struct Dent {
-			DirectX::XMFLOAT2 centerXZ; // 凹み中心 (x,z)
-			float radius;               // 半径
-			float depth;                // 深さ（正の値、下方向にへこませる）
-		};
+		using Dent = TerrainDent;
 
-		// 凹み回数上限
-		static constexpr UINT kMaxDents = 1000;
+		// 登録済み凹み（XZ グリッドに振り分け。セルに上限を超えた分は deformLayer に焼き込む）
+		TerrainDentGrid dentGrid;
 
-		Dent dents[kMaxDents]{}; // 登録済み凹み
-		UINT dentCount = 0;      // 有効な凹み数
+		// CS に渡す凹みテーブル（アップロードヒープ、足りなくなったら作り直す）
+		Microsoft::WRL::ComPtr<ID3D12Resource> dentBuf, dentRangeBuf, dentIndexBuf;
+		UINT64 dentBufBytes = 0, dentRangeBufBytes = 0, dentIndexBufBytes = 0;
+
+		// 保存/読み込みできる変形レイヤー（凹みはこの上に乗る）
+		TerrainDeformationLayer deformLayer;
+		Microsoft::WRL::ComPtr<ID3D12Resource> layerBuf;
+		UINT64 layerBufBytes = 0;
+		uint32_t layerVersion = UINT32_MAX; // GPU に上げた版
 
 		// ---- CS に渡す定数バッファ ----
 		struct CBCS {
@@ -277,20 +311,58 @@ public: // （外からも参照することが多いので public に）
 			float freq;
 			UINT maxVerts;
 			UINT dentCount;
-			float pad; // 16B アライン用
+			float layerStep; // 変形レイヤーの量子化の刻み
+
+			DirectX::XMFLOAT2 dentOrigin; // 凹みグリッド左下
+			float dentCellSize;           // 凹みグリッド 1 セルの一辺
+			UINT layerEnabled;            // 変形レイヤーを足すか
 
-			Dent dents[kMaxDents];
+			DirectX::XMUINT2 dentCells; // 凹みグリッドのセル数
+			DirectX::XMUINT2 pad3;
 		} params{};
 	} voxel_;
 
-	// === Voxel Dirty フラグ（地形再生成が必要か？） ===
-	bool voxelDirty_ = true;
+	// === Voxel チャンク（dirty なチャンクだけ再生成する） ===
+	TerrainChunkGrid voxelChunks_;
+	std::vector<uint32_t> voxelDirtyChunks_; // 作業用
 	UINT voxelGridX_ = 0;
 	UINT voxelGridZ_ = 0;
 
+	// 再生成コストの記録（直近 1 回ぶん + 累計）
+	struct VoxelRebuildStats {
+		UINT chunks = 0;        // 再生成したチャンク数
+		UINT cells = 0;         // 再生成したセル数
+		UINT vertices = 0;      // 書き込んだ頂点（格子点）数
+		float recordMs = 0.0f;  // コマンド記録にかかった CPU 時間
+		UINT rebuilds = 0;      // 累計回数
+		UINT totalChunks = 0;   // 累計チャンク数
+
+		// 描画（直近のフレーム）
+		UINT lodPatches = 0;    // 選ばれたパッチ数
+		UINT lodTriangles = 0;  // 描いた三角形数
+		UINT fullTriangles = 0; // 全部フル解像度で描いた場合の三角形数
+	} voxelStats_;
+	const VoxelRebuildStats& VoxelStats() const { return voxelStats_; }
+
 	// DispatchVoxel を必要な時だけ行う
 	void RebuildVoxelIfNeeded(ID3D12GraphicsCommandList* cmd);
 
+	// カメラからパッチを選び、変わっていればインデックスを作り直す（DrawVoxel から）
+	void UpdateVoxelLod(const Camera& cam);
+	TerrainLodSelector voxelLod_;
+	std::vector<TerrainLodPatch> voxelPatches_, voxelPrevPatches_;
+	std::vector<uint32_t> voxelLodIndices_; // 作業用
+
+	// 変形レイヤーを読み込んだ後に高さキャッシュとメッシュを作り直す
+	void RebakeTerrainFromLayer();
+
+	// CPU 側の高さキャッシュ（TerrainHeightAt 用）
+	TerrainHeightField terrainField_;
+	TerrainHeightPyramid terrainPyramid_; // レイ/球キャスト用の min/max
+
+	// 全 ParticleSystem で共用（持ち主は ParticleSystem 側）
+	std::weak_ptr<ParticleRenderer> particleRenderer_;
+
 	struct SkyboxData {
 		// 頂点バッファ（キューブ形状）
 		Microsoft::WRL::ComPtr<ID3D12Resource> vb;
@@ -314,11 +386,28 @@ public: // （外からも参照することが多いので public に）
 	float TerrainHeightAt(float x, float z) const;
 	Vector3 TerrainNormalAt(float x, float z) const;
 
+	// 高さ + 解析的な勾配（CS と同じ式）。バッチ版は点が多いとき用
+	TerrainSample TerrainSampleAt(float x, float z) const;
+	void TerrainSampleBatch(const float* xs, const float* zs, size_t count, TerrainSample* out) const;
+
+	// 地形（メッシュと同じ三角形）へのレイ/球キャスト。dir は正規化不要、格子の外は当たらない
+	// カメラの遮蔽、視線、弾の着弾など「2 点の間で地形をまたぐか」を見たいとき用
+	bool TerrainRaycast(const Vector3& origin, const Vector3& dir, float maxDist, TerrainRayHit& hit) const;
+	bool TerrainSphereCast(const Vector3& origin, const Vector3& dir, float radius, float maxDist, TerrainRayHit& hit) const;
+
+	// XZ 矩形に掛かる地形の最低の高さ（控えめな見積もり）。格子からはみ出すなら false（水面のカリング用）
+	bool TerrainMinHeightIn(float x0, float z0, float x1, float z1, float& lo) const { return terrainPyramid_.MinHeightInRect(x0, z0, x1, z1, lo); }
+
 	// ボス攻撃などで「この位置をへこませたい」という情報を登録
 	void AddTerrainDent(const DirectX::XMFLOAT3& position, float radius, float depth);
-
-	// 4B の 0 を置いたアップロード（UAVカウンタ初期化に使う）
-	Microsoft::WRL::ComPtr<ID3D12Resource> zeroUpload_;
+	const TerrainDentGrid& TerrainDents() const { return voxel_.dentGrid; }
+
+	// 地形の変形を丸ごと保存/復元する（凹みの履歴ではなく格子 1 枚ぶんの差分）
+	// 復元すると登録済みの凹みはレイヤーに置き換わる
+	void CaptureTerrainDeformation(std::vector<uint8_t>& out) const;
+	bool RestoreTerrainDeformation(const void* data, size_t bytes);
+	bool SaveTerrainDeformation(const std::string& path) const;
+	bool LoadTerrainDeformation(const std::string& path);
 };
 
 } // namespace Engine
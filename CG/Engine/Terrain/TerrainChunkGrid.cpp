@@ -0,0 +1,101 @@
+// Engine/Terrain/TerrainChunkGrid.cpp
+#include "TerrainChunkGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+void TerrainChunkGrid::Initialize(uint32_t gridX, uint32_t gridZ, uint32_t chunkCells, float cell) {
+	gridX_ = gridX;
+	gridZ_ = gridZ;
+	chunkCells_ = (std::max)(1u, chunkCells);
+	cell_ = cell;
+	originX_ = -0.5f * gridX_ * cell_;
+	originZ_ = -0.5f * gridZ_ * cell_;
+
+	chunksX_ = (gridX_ + chunkCells_ - 1) / chunkCells_;
+	chunksZ_ = (gridZ_ + chunkCells_ - 1) / chunkCells_;
+
+	chunks_.clear();
+	chunks_.reserve(size_t(chunksX_) * chunksZ_);
+
+	for (uint32_t cz = 0; cz < chunksZ_; ++cz) {
+		for (uint32_t cx = 0; cx < chunksX_; ++cx) {
+			TerrainChunkRect c;
+			c.cellX0 = cx * chunkCells_;
+			c.cellZ0 = cz * chunkCells_;
+			c.cellsX = (std::min)(chunkCells_, gridX_ - c.cellX0);
+			c.cellsZ = (std::min)(chunkCells_, gridZ_ - c.cellZ0);
+			// 格子点 i は i / chunkCells のチャンクが担当。最後の列/行は端のチャンクへ
+			c.vertsX = c.cellsX + (cx + 1 == chunksX_ ? 1 : 0);
+			c.vertsZ = c.cellsZ + (cz + 1 == chunksZ_ ? 1 : 0);
+			chunks_.push_back(c);
+		}
+	}
+
+	dirty_.assign(chunks_.size(), 0);
+	dirtyCount_ = 0;
+}
+
+void TerrainChunkGrid::MarkAllDirty() {
+	std::fill(dirty_.begin(), dirty_.end(), uint8_t(1));
+	dirtyCount_ = uint32_t(dirty_.size());
+}
+
+uint32_t TerrainChunkGrid::MarkCellRect(int x0, int z0, int x1, int z1) {
+	if (chunks_.empty())
+		return 0;
+
+	x0 = (std::max)(x0, 0);
+	z0 = (std::max)(z0, 0);
+	x1 = (std::min)(x1, int(gridX_) - 1);
+	z1 = (std::min)(z1, int(gridZ_) - 1);
+	if (x0 > x1 || z0 > z1)
+		return 0;
+
+	uint32_t added = 0;
+	for (uint32_t cz = uint32_t(z0) / chunkCells_; cz <= uint32_t(z1) / chunkCells_; ++cz) {
+		for (uint32_t cx = uint32_t(x0) / chunkCells_; cx <= uint32_t(x1) / chunkCells_; ++cx) {
+			uint8_t& f = dirty_[size_t(cz) * chunksX_ + cx];
+			if (!f) {
+				f = 1;
+				++added;
+			}
+		}
+	}
+	dirtyCount_ += added;
+	return added;
+}
+
+uint32_t TerrainChunkGrid::MarkDent(const TerrainDent& d, float normalEps) {
+	if (d.radius <= 0.0f)
+		return 0;
+
+	// 高さが変わる頂点 + 法線の差分で参照される頂点（eps 外側まで）
+	const float reach = d.radius + normalEps;
+	const int vx0 = int(std::ceil((d.centerXZ.x - reach - originX_) / cell_));
+	const int vx1 = int(std::floor((d.centerXZ.x + reach - originX_) / cell_));
+	const int vz0 = int(std::ceil((d.centerXZ.y - reach - originZ_) / cell_));
+	const int vz1 = int(std::floor((d.centerXZ.y + reach - originZ_) / cell_));
+
+	// 格子点 i を担当するチャンクはセル i（最後の格子点はセル i-1）を含むので、
+	// セル範囲 [vx0-1, vx1] を見れば取りこぼさない
+	return MarkCellRect(vx0 - 1, vz0 - 1, vx1, vz1);
+}
+
+void TerrainChunkGrid::TakeDirty(std::vector<uint32_t>& out) {
+	out.clear();
+	if (dirtyCount_ == 0)
+		return;
+
+	out.reserve(dirtyCount_);
+	for (uint32_t i = 0; i < uint32_t(dirty_.size()); ++i) {
+		if (dirty_[i]) {
+			out.push_back(i);
+			dirty_[i] = 0;
+		}
+	}
+	dirtyCount_ = 0;
+}
+
+} // namespace Engine
@@ -0,0 +1,77 @@
+// Engine/Terrain/TerrainChunkGrid.h
+#pragma once
+// =======================================
+//  TerrainChunkGrid : ボクセル地形を固定サイズのチャンクに分けて
+//  「どこを作り直すか」を管理する
+//  - チャンクごとに dirty フラグ
+//  - 凹み 1 回ぶんの影響セル矩形からチャンクを割り出す
+//  - 頂点は格子点で共有（(gridX+1)*(gridZ+1) 個）。各格子点はちょうど
+//    1 つのチャンクが担当する（端のチャンクが最後の列/行も持つ）
+// =======================================
+#include "TerrainHeight.h"
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+// チャンク 1 個ぶんの範囲（セル単位）と担当する格子点
+struct TerrainChunkRect {
+	uint32_t cellX0 = 0; // 先頭セル（= 先頭の格子点）
+	uint32_t cellZ0 = 0;
+	uint32_t cellsX = 0; // セル数（端のチャンクは小さくなる）
+	uint32_t cellsZ = 0;
+	uint32_t vertsX = 0; // 担当する格子点数（右端/奥端のチャンクは +1）
+	uint32_t vertsZ = 0;
+};
+
+class TerrainChunkGrid {
+public:
+	// 1セル = 2三角形 = 6インデックス
+	static constexpr uint32_t kIndicesPerCell = 6;
+
+	// gridX/gridZ : 全体のセル数、chunkCells : チャンク 1 辺のセル数
+	void Initialize(uint32_t gridX, uint32_t gridZ, uint32_t chunkCells, float cell);
+
+	// 全チャンクを作り直し対象にする（初回生成など）
+	void MarkAllDirty();
+
+	// セル矩形 [x0,x1]×[z0,z1]（両端含む）に掛かるチャンクを dirty にする
+	// 戻り値：新しく dirty になったチャンク数
+	uint32_t MarkCellRect(int x0, int z0, int x1, int z1);
+
+	// 凹みの影響範囲を dirty にする
+	// normalEps : 法線を数値微分で求める場合はその幅（この分だけ外側の頂点も変わる）
+	uint32_t MarkDent(const TerrainDent& d, float normalEps);
+
+	// dirty なチャンク番号を out に詰めてフラグをクリア
+	void TakeDirty(std::vector<uint32_t>& out);
+
+	bool AnyDirty() const { return dirtyCount_ > 0; }
+	uint32_t DirtyCount() const { return dirtyCount_; }
+
+	uint32_t ChunksX() const { return chunksX_; }
+	uint32_t ChunksZ() const { return chunksZ_; }
+	uint32_t ChunkCount() const { return uint32_t(chunks_.size()); }
+	const TerrainChunkRect& Chunk(uint32_t index) const { return chunks_[index]; }
+
+	// 頂点数（= 格子点数）とインデックス数
+	uint32_t TotalVertices() const { return (gridX_ + 1) * (gridZ_ + 1); }
+	uint32_t TotalIndices() const { return gridX_ * gridZ_ * kIndicesPerCell; }
+	uint32_t VertexIndex(uint32_t ix, uint32_t iz) const { return iz * (gridX_ + 1) + ix; }
+
+private:
+	uint32_t gridX_ = 0;
+	uint32_t gridZ_ = 0;
+	uint32_t chunkCells_ = 1;
+	uint32_t chunksX_ = 0;
+	uint32_t chunksZ_ = 0;
+	float cell_ = 1.0f;
+	float originX_ = 0.0f; // 格子点 (0,0) のワールド座標
+	float originZ_ = 0.0f;
+
+	std::vector<TerrainChunkRect> chunks_;
+	std::vector<uint8_t> dirty_;
+	uint32_t dirtyCount_ = 0;
+};
+
+} // namespace Engine
@@ -0,0 +1,257 @@
+// Engine/Terrain/TerrainChunkStreamer.cpp
+#include "TerrainChunkStreamer.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace Engine {
+
+void TerrainChunkStreamer::Initialize(const Desc& desc, Generator generator) {
+	Shutdown();
+
+	desc_ = desc;
+	desc_.chunkCells = (std::max)(desc_.chunkCells, 1u);
+	desc_.ringRadius = (std::max)(desc_.ringRadius, 0);
+	generator_ = generator ? std::move(generator) : Generator([](float x, float z) { return TerrainBaseHeight(x, z); });
+
+	const uint32_t workers = (std::max)(desc_.workerCount, 1u);
+	for (uint32_t i = 0; i < workers; ++i) {
+		workers_.emplace_back(&TerrainChunkStreamer::WorkerMain, this);
+	}
+}
+
+void TerrainChunkStreamer::Shutdown() {
+	if (!workers_.empty()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		jobCv_.notify_all();
+		for (auto& t : workers_) {
+			t.join();
+		}
+		workers_.clear();
+	}
+
+	stop_ = false;
+	jobs_.clear();
+	results_.clear();
+	busy_ = 0;
+	chunks_.clear();
+	lru_.clear();
+	pending_.clear();
+	hasCenter_ = false;
+	stats_ = {};
+}
+
+void TerrainChunkStreamer::WorkerMain() {
+	for (;;) {
+		uint64_t key;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			jobCv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+			if (stop_)
+				return;
+			key = jobs_.front();
+			jobs_.pop_front();
+			++busy_;
+		}
+
+		// 生成はロックの外で
+		Result r;
+		r.key = key;
+		Generate(key, r.heights);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			results_.push_back(std::move(r));
+			--busy_;
+		}
+		doneCv_.notify_all();
+	}
+}
+
+void TerrainChunkStreamer::Generate(uint64_t key, std::vector<float>& heights) const {
+	const uint32_t n = desc_.chunkCells + 1;
+	const float x0 = KeyX(key) * ChunkSize();
+	const float z0 = KeyZ(key) * ChunkSize();
+
+	heights.resize(size_t(n) * n);
+	for (uint32_t iz = 0; iz < n; ++iz) {
+		const float z = z0 + iz * desc_.cell;
+		for (uint32_t ix = 0; ix < n; ++ix) {
+			heights[size_t(iz) * n + ix] = generator_(x0 + ix * desc_.cell, z);
+		}
+	}
+}
+
+void TerrainChunkStreamer::TakeResults() {
+	std::vector<Result> done;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		done.swap(results_);
+	}
+
+	for (Result& r : done) {
+		pending_.erase(r.key);
+		if (chunks_.count(r.key))
+			continue;
+
+		// 依頼後に範囲から外れたものは真っ先に捨てられるよう末尾へ
+		Chunk& c = chunks_[r.key];
+		c.heights = std::move(r.heights);
+		if (InRing(r.key)) {
+			lru_.push_front(r.key);
+			c.lruIt = lru_.begin();
+		} else {
+			lru_.push_back(r.key);
+			c.lruIt = std::prev(lru_.end());
+		}
+		stats_.bytes += ChunkBytes();
+		++stats_.generated;
+	}
+}
+
+bool TerrainChunkStreamer::InRing(uint64_t key) const {
+	return hasCenter_ && std::abs(KeyX(key) - centerX_) <= desc_.ringRadius && std::abs(KeyZ(key) - centerZ_) <= desc_.ringRadius;
+}
+
+void TerrainChunkStreamer::Evict() {
+	// 後ろ（使っていない順）から、周囲のチャンク以外を予算に収まるまで捨てる
+	auto it = lru_.end();
+	while (stats_.bytes > desc_.memoryBudgetBytes && it != lru_.begin()) {
+		--it;
+		if (InRing(*it))
+			continue;
+		chunks_.erase(*it);
+		it = lru_.erase(it);
+		stats_.bytes -= ChunkBytes();
+		++stats_.evicted;
+	}
+}
+
+void TerrainChunkStreamer::Update(float x, float z) {
+	if (workers_.empty())
+		return;
+
+	TakeResults();
+
+	const int cx = int(std::floor(x / ChunkSize()));
+	const int cz = int(std::floor(z / ChunkSize()));
+	const bool moved = !hasCenter_ || cx != centerX_ || cz != centerZ_;
+	centerX_ = cx;
+	centerZ_ = cz;
+	hasCenter_ = true;
+
+	// 周囲のチャンクを近い順に見て、持っていれば LRU の先頭へ、無ければ依頼
+	const int R = desc_.ringRadius;
+	std::vector<uint64_t> want;
+	for (int d = 0; d <= R; ++d) {
+		for (int dz = -d; dz <= d; ++dz) {
+			for (int dx = -d; dx <= d; ++dx) {
+				if ((std::max)(std::abs(dx), std::abs(dz)) != d)
+					continue;
+				const uint64_t key = Key(cx + dx, cz + dz);
+				auto found = chunks_.find(key);
+				if (found != chunks_.end()) {
+					lru_.splice(lru_.begin(), lru_, found->second.lruIt);
+				} else if (!pending_.count(key)) {
+					want.push_back(key);
+				}
+			}
+		}
+	}
+
+	if (moved || !want.empty()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			// 範囲から外れた依頼は取り消す（生成中のものは届いてから LRU で捨てる）
+			if (moved) {
+				for (auto it = jobs_.begin(); it != jobs_.end();) {
+					if (!InRing(*it)) {
+						pending_.erase(*it);
+						it = jobs_.erase(it);
+					} else {
+						++it;
+					}
+				}
+			}
+			for (uint64_t key : want) {
+				jobs_.push_back(key);
+				pending_.insert(key);
+			}
+		}
+		jobCv_.notify_all();
+	}
+
+	Evict();
+	stats_.resident = uint32_t(chunks_.size());
+	stats_.pending = uint32_t(pending_.size());
+	stats_.peakBytes = (std::max)(stats_.peakBytes, stats_.bytes);
+}
+
+void TerrainChunkStreamer::Flush() {
+	if (workers_.empty())
+		return;
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		doneCv_.wait(lock, [this] { return jobs_.empty() && busy_ == 0; });
+	}
+
+	TakeResults();
+	Evict();
+	stats_.resident = uint32_t(chunks_.size());
+	stats_.pending = uint32_t(pending_.size());
+	stats_.peakBytes = (std::max)(stats_.peakBytes, stats_.bytes);
+}
+
+const TerrainChunkStreamer::Chunk* TerrainChunkStreamer::Locate(float x, float z, float& fx, float& fz) const {
+	const float size = ChunkSize();
+	const float cx = std::floor(x / size);
+	const float cz = std::floor(z / size);
+	auto it = chunks_.find(Key(int(cx), int(cz)));
+	if (it == chunks_.end())
+		return nullptr;
+
+	const float cells = float(desc_.chunkCells);
+	fx = std::clamp((x - cx * size) / desc_.cell, 0.0f, cells);
+	fz = std::clamp((z - cz * size) / desc_.cell, 0.0f, cells);
+	return &it->second;
+}
+
+bool TerrainChunkStreamer::HeightAt(float x, float z, float& height) const {
+	TerrainSample s;
+	if (!SampleAt(x, z, s))
+		return false;
+	height = s.height;
+	return true;
+}
+
+bool TerrainChunkStreamer::SampleAt(float x, float z, TerrainSample& s) const {
+	float fx, fz;
+	const Chunk* c = Locate(x, z, fx, fz);
+	if (!c)
+		return false;
+
+	// 右端/下端ちょうどでも [ix, ix+1] が取れるように 1 つ手前へ寄せる
+	const uint32_t n = desc_.chunkCells + 1;
+	const uint32_t ix = (std::min)(uint32_t(fx), desc_.chunkCells - 1);
+	const uint32_t iz = (std::min)(uint32_t(fz), desc_.chunkCells - 1);
+	const float tx = fx - float(ix);
+	const float tz = fz - float(iz);
+
+	const float* p = &c->heights[size_t(iz) * n + ix];
+	const float h00 = p[0];
+	const float h10 = p[1];
+	const float h01 = p[n];
+	const float h11 = p[n + 1];
+
+	const float h0 = h00 + (h10 - h00) * tx;
+	const float h1 = h01 + (h11 - h01) * tx;
+	s.height = h0 + (h1 - h0) * tz;
+	s.dHdx = ((h10 - h00) * (1.0f - tz) + (h11 - h01) * tz) / desc_.cell;
+	s.dHdz = (h1 - h0) / desc_.cell;
+	return true;
+}
+
+} // namespace Engine
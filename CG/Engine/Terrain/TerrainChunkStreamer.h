@@ -0,0 +1,118 @@
+// Engine/Terrain/TerrainChunkStreamer.h
+#pragma once
+// =======================================
+//  TerrainChunkStreamer : プレイヤーの周りのチャンクだけ高さを持つストリーマー
+//  - ワールドを chunkCells x chunkCells セルのチャンクに区切る（格子は原点合わせ）
+//  - 周囲 (2*ringRadius+1)^2 チャンクを常に持つ。足りないものはワーカースレッドで生成
+//  - 使わなくなったチャンクは LRU で、合計がメモリ予算を超えた分だけ捨てる
+//  - 高さ/勾配の問い合わせは持っているチャンクの格子から（無ければ false）
+//  - GPU には触らない（ヘッドレスでも動く）
+// =======================================
+#include "TerrainHeight.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Engine {
+
+class TerrainChunkStreamer {
+public:
+	struct Desc {
+		uint32_t chunkCells = 64;                   // 1 チャンクのセル数（一辺）
+		float cell = 0.8f;                          // 格子間隔
+		int ringRadius = 2;                         // 中心チャンクから何チャンク先まで持つか
+		size_t memoryBudgetBytes = 4u * 1024 * 1024; // 高さデータの合計の上限（周囲のチャンクは超えても捨てない）
+		uint32_t workerCount = 2;                   // 生成スレッド数
+	};
+
+	// 高さの生成関数（ワーカースレッドから呼ばれるのでスレッドセーフであること）
+	using Generator = std::function<float(float x, float z)>;
+
+	struct Stats {
+		uint32_t resident = 0;  // 持っているチャンク数
+		uint32_t pending = 0;   // 生成待ち/生成中
+		uint32_t generated = 0; // 累計生成数
+		uint32_t evicted = 0;   // 累計破棄数
+		size_t bytes = 0;       // 持っている高さデータの合計
+		size_t peakBytes = 0;   // bytes の最大
+	};
+
+	TerrainChunkStreamer() = default;
+	~TerrainChunkStreamer() { Shutdown(); }
+	TerrainChunkStreamer(const TerrainChunkStreamer&) = delete;
+	TerrainChunkStreamer& operator=(const TerrainChunkStreamer&) = delete;
+
+	// generator を省略するとベース地形（TerrainBaseHeight）
+	void Initialize(const Desc& desc, Generator generator = nullptr);
+	void Shutdown();
+
+	// 中心位置を渡す（毎フレーム）。出来上がったチャンクの取り込み、足りないチャンクの依頼、破棄を行う
+	void Update(float x, float z);
+
+	// 依頼済みのチャンクがすべて届くまで待つ（ロード画面/テスト用）
+	void Flush();
+
+	// 持っているチャンクから双線形補間で求める。無ければ false
+	bool HeightAt(float x, float z, float& height) const;
+	bool SampleAt(float x, float z, TerrainSample& s) const;
+
+	bool IsResident(int cx, int cz) const { return chunks_.count(Key(cx, cz)) != 0; }
+	float ChunkSize() const { return desc_.chunkCells * desc_.cell; }
+	size_t ChunkBytes() const { return size_t(desc_.chunkCells + 1) * (desc_.chunkCells + 1) * sizeof(float); }
+	const Desc& GetDesc() const { return desc_; }
+	const Stats& GetStats() const { return stats_; }
+
+private:
+	static uint64_t Key(int cx, int cz) { return (uint64_t(uint32_t(cx)) << 32) | uint32_t(cz); }
+	static int KeyX(uint64_t key) { return int(uint32_t(key >> 32)); }
+	static int KeyZ(uint64_t key) { return int(uint32_t(key)); }
+
+	struct Chunk {
+		std::vector<float> heights;          // (chunkCells+1)^2
+		std::list<uint64_t>::iterator lruIt; // lru_ 内の位置
+	};
+	struct Result {
+		uint64_t key;
+		std::vector<float> heights;
+	};
+
+	void WorkerMain();
+	void Generate(uint64_t key, std::vector<float>& heights) const;
+	void TakeResults();
+	void Evict();
+	bool InRing(uint64_t key) const;
+
+	// (x,z) を含むチャンクとその中の格子座標
+	const Chunk* Locate(float x, float z, float& fx, float& fz) const;
+
+	Desc desc_{};
+	Generator generator_;
+
+	// ---- メインスレッドだけが触る ----
+	std::unordered_map<uint64_t, Chunk> chunks_;
+	std::list<uint64_t> lru_; // 先頭が最近使ったもの
+	std::unordered_set<uint64_t> pending_;
+	int centerX_ = 0;
+	int centerZ_ = 0;
+	bool hasCenter_ = false;
+	Stats stats_{};
+
+	// ---- ワーカーと共有（mutex_ で守る） ----
+	std::mutex mutex_;
+	std::condition_variable jobCv_;
+	std::condition_variable doneCv_;
+	std::deque<uint64_t> jobs_;
+	std::vector<Result> results_;
+	uint32_t busy_ = 0; // 生成中のワーカー数
+	bool stop_ = false;
+	std::vector<std::thread> workers_;
+};
+
+} // namespace Engine
@@ -0,0 +1,289 @@
+// Engine/Terrain/TerrainDeformationLayer.cpp
+#include "TerrainDeformationLayer.h"
+#include "TerrainHeightField.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace Engine {
+
+namespace {
+
+// RLE のトークン
+//   0x00..0x7F : 続く (c+1) 個の値をそのまま
+//   0x80..0xFF : 続く 1 個の値を (c-0x80+kMinRun) 回繰り返す
+constexpr uint32_t kMaxLiteral = 128;
+constexpr uint32_t kMinRun = 3;
+constexpr uint32_t kMaxRun = 127 + kMinRun;
+
+void PutU16(std::vector<uint8_t>& out, uint16_t v) {
+	out.push_back(uint8_t(v & 0xFF));
+	out.push_back(uint8_t(v >> 8));
+}
+
+uint16_t GetU16(const uint8_t* p) { return uint16_t(p[0] | (p[1] << 8)); }
+
+void EncodeRle(const uint16_t* v, size_t n, std::vector<uint8_t>& out) {
+	size_t i = 0;
+	while (i < n) {
+		// 同じ値の連続を数える
+		size_t run = 1;
+		while (i + run < n && run < kMaxRun && v[i + run] == v[i]) {
+			++run;
+		}
+		if (run >= kMinRun) {
+			out.push_back(uint8_t(0x80 + (run - kMinRun)));
+			PutU16(out, v[i]);
+			i += run;
+			continue;
+		}
+
+		// 次の連続が始まるまでをそのまま書く
+		size_t lit = 0;
+		while (i + lit < n && lit < kMaxLiteral) {
+			const size_t j = i + lit;
+			if (j + kMinRun <= n && v[j] == v[j + 1] && v[j] == v[j + 2])
+				break;
+			++lit;
+		}
+		out.push_back(uint8_t(lit - 1));
+		for (size_t k = 0; k < lit; ++k) {
+			PutU16(out, v[i + k]);
+		}
+		i += lit;
+	}
+}
+
+bool DecodeRle(const uint8_t* p, size_t bytes, uint16_t* v, size_t n) {
+	const uint8_t* end = p + bytes;
+	size_t i = 0;
+	while (i < n) {
+		if (p >= end)
+			return false;
+		const uint8_t c = *p++;
+		if (c & 0x80) {
+			const size_t run = size_t(c - 0x80) + kMinRun;
+			if (end - p < 2 || i + run > n)
+				return false;
+			const uint16_t value = GetU16(p);
+			p += 2;
+			std::fill(v + i, v + i + run, value);
+			i += run;
+		} else {
+			const size_t lit = size_t(c) + 1;
+			if (size_t(end - p) < lit * 2 || i + lit > n)
+				return false;
+			for (size_t k = 0; k < lit; ++k, p += 2) {
+				v[i + k] = GetU16(p);
+			}
+			i += lit;
+		}
+	}
+	return p == end;
+}
+
+} // namespace
+
+void TerrainDeformationLayer::Initialize(uint32_t gridX, uint32_t gridZ, float cell) {
+	samplesX_ = gridX + 1;
+	samplesZ_ = gridZ + 1;
+	cell_ = cell;
+	originX_ = -0.5f * gridX * cell;
+	originZ_ = -0.5f * gridZ * cell;
+	Clear();
+}
+
+void TerrainDeformationLayer::Clear() {
+	deltas_.assign(size_t(samplesX_) * samplesZ_, 0);
+	nonZero_ = 0;
+	++version_;
+}
+
+void TerrainDeformationLayer::CountNonZero() { nonZero_ = size_t(std::count_if(deltas_.begin(), deltas_.end(), [](int16_t d) { return d != 0; })); }
+
+bool TerrainDeformationLayer::CaptureFrom(const TerrainHeightField& field) {
+	if (field.SamplesX() != samplesX_ || field.SamplesZ() != samplesZ_)
+		return false;
+
+	for (uint32_t iz = 0; iz < samplesZ_; ++iz) {
+		const float z = field.SampleZ(iz);
+		int16_t* row = &deltas_[size_t(iz) * samplesX_];
+		for (uint32_t ix = 0; ix < samplesX_; ++ix) {
+			const float d = field.Sample(ix, iz) - TerrainBaseHeight(field.SampleX(ix), z);
+			const float q = std::round(d / kQuantStep);
+			row[ix] = int16_t(std::clamp(q, -32768.0f, 32767.0f));
+		}
+	}
+	CountNonZero();
+	++version_;
+	return true;
+}
+
+void TerrainDeformationLayer::StampDent(const TerrainDent& d) {
+	const int ix0 = (std::max)(int(std::ceil((d.centerXZ.x - d.radius - originX_) / cell_)), 0);
+	const int ix1 = (std::min)(int(std::floor((d.centerXZ.x + d.radius - originX_) / cell_)), int(samplesX_) - 1);
+	const int iz0 = (std::max)(int(std::ceil((d.centerXZ.y - d.radius - originZ_) / cell_)), 0);
+	const int iz1 = (std::min)(int(std::floor((d.centerXZ.y + d.radius - originZ_) / cell_)), int(samplesZ_) - 1);
+	if (ix0 > ix1 || iz0 > iz1)
+		return;
+
+	for (int iz = iz0; iz <= iz1; ++iz) {
+		const float z = originZ_ + iz * cell_;
+		int16_t* row = &deltas_[size_t(iz) * samplesX_];
+		for (int ix = ix0; ix <= ix1; ++ix) {
+			const float off = TerrainDentOffset(originX_ + ix * cell_, z, d);
+			if (off == 0.0f)
+				continue;
+			// 今の値に足してから丸める（丸めの誤差はこの 1 回ぶんだけ）
+			const bool wasZero = row[ix] == 0;
+			const float q = std::round(float(row[ix]) + off / kQuantStep);
+			row[ix] = int16_t(std::clamp(q, -32768.0f, 32767.0f));
+			if (wasZero && row[ix] != 0) {
+				++nonZero_;
+			} else if (!wasZero && row[ix] == 0) {
+				--nonZero_;
+			}
+		}
+	}
+	++version_;
+}
+
+void TerrainDeformationLayer::ApplyTo(TerrainHeightField& field) const {
+	if (field.SamplesX() != samplesX_ || field.SamplesZ() != samplesZ_ || IsEmpty())
+		return;
+
+	for (uint32_t iz = 0; iz < samplesZ_; ++iz) {
+		for (uint32_t ix = 0; ix < samplesX_; ++ix) {
+			const int16_t d = deltas_[size_t(iz) * samplesX_ + ix];
+			if (d != 0) {
+				field.AddSample(ix, iz, d * kQuantStep);
+			}
+		}
+	}
+}
+
+void TerrainDeformationLayer::GradientAt(uint32_t ix, uint32_t iz, float& dHdx, float& dHdz) const {
+	// 端は片側差分（CS と同じく添字をクランプ）
+	const uint32_t x0 = ix > 0 ? ix - 1 : ix;
+	const uint32_t x1 = ix + 1 < samplesX_ ? ix + 1 : ix;
+	const uint32_t z0 = iz > 0 ? iz - 1 : iz;
+	const uint32_t z1 = iz + 1 < samplesZ_ ? iz + 1 : iz;
+	dHdx = (DeltaAt(x1, iz) - DeltaAt(x0, iz)) / (float(x1 - x0) * cell_);
+	dHdz = (DeltaAt(ix, z1) - DeltaAt(ix, z0)) / (float(z1 - z0) * cell_);
+}
+
+void TerrainDeformationLayer::Accumulate(float x, float z, TerrainSample& s) const {
+	if (IsEmpty())
+		return;
+
+	const float fx = (x - originX_) / cell_;
+	const float fz = (z - originZ_) / cell_;
+	if (fx < 0.0f || fz < 0.0f || fx > float(samplesX_ - 1) || fz > float(samplesZ_ - 1))
+		return;
+
+	const uint32_t ix = (std::min)(uint32_t(fx), samplesX_ - 2);
+	const uint32_t iz = (std::min)(uint32_t(fz), samplesZ_ - 2);
+	const float tx = fx - float(ix);
+	const float tz = fz - float(iz);
+	const float w00 = (1.0f - tx) * (1.0f - tz);
+	const float w10 = tx * (1.0f - tz);
+	const float w01 = (1.0f - tx) * tz;
+	const float w11 = tx * tz;
+
+	s.height += DeltaAt(ix, iz) * w00 + DeltaAt(ix + 1, iz) * w10 + DeltaAt(ix, iz + 1) * w01 + DeltaAt(ix + 1, iz + 1) * w11;
+
+	// 勾配は格子点の中心差分を補間（格子点上では CS の法線と一致）
+	float gx00, gz00, gx10, gz10, gx01, gz01, gx11, gz11;
+	GradientAt(ix, iz, gx00, gz00);
+	GradientAt(ix + 1, iz, gx10, gz10);
+	GradientAt(ix, iz + 1, gx01, gz01);
+	GradientAt(ix + 1, iz + 1, gx11, gz11);
+	s.dHdx += gx00 * w00 + gx10 * w10 + gx01 * w01 + gx11 * w11;
+	s.dHdz += gz00 * w00 + gz10 * w10 + gz01 * w01 + gz11 * w11;
+}
+
+void TerrainDeformationLayer::Encode(std::vector<uint8_t>& out) const {
+	out.clear();
+	out.resize(sizeof(FileHeader));
+
+	// 行ごとに左隣との差分（16bit で回り込ませるので桁あふれしない）
+	std::vector<uint16_t> diff(deltas_.size());
+	for (uint32_t iz = 0; iz < samplesZ_; ++iz) {
+		uint16_t prev = 0;
+		for (uint32_t ix = 0; ix < samplesX_; ++ix) {
+			const size_t i = size_t(iz) * samplesX_ + ix;
+			const uint16_t v = uint16_t(deltas_[i]);
+			diff[i] = uint16_t(v - prev);
+			prev = v;
+		}
+	}
+	EncodeRle(diff.data(), diff.size(), out);
+
+	FileHeader h{};
+	std::memcpy(h.magic, "TDEF", 4);
+	h.version = kFileVersion;
+	h.samplesX = samplesX_;
+	h.samplesZ = samplesZ_;
+	h.cell = cell_;
+	h.quantStep = kQuantStep;
+	h.payloadBytes = uint32_t(out.size() - sizeof(FileHeader));
+	std::memcpy(out.data(), &h, sizeof(h));
+}
+
+bool TerrainDeformationLayer::Decode(const void* data, size_t bytes) {
+	if (!data || bytes < sizeof(FileHeader))
+		return false;
+
+	FileHeader h;
+	std::memcpy(&h, data, sizeof(h));
+	if (std::memcmp(h.magic, "TDEF", 4) != 0 || h.version != kFileVersion || h.quantStep != kQuantStep)
+		return false;
+	if (h.samplesX != samplesX_ || h.samplesZ != samplesZ_ || h.cell != cell_ || h.payloadBytes != bytes - sizeof(FileHeader))
+		return false;
+
+	// 展開は一時バッファに（壊れていたら今の中身を残す）
+	std::vector<int16_t> next(deltas_.size());
+	uint16_t* v = reinterpret_cast<uint16_t*>(next.data());
+	if (!DecodeRle(static_cast<const uint8_t*>(data) + sizeof(FileHeader), h.payloadBytes, v, next.size()))
+		return false;
+
+	// 行方向の差分を戻す
+	for (uint32_t iz = 0; iz < samplesZ_; ++iz) {
+		uint16_t* row = v + size_t(iz) * samplesX_;
+		for (uint32_t ix = 1; ix < samplesX_; ++ix) {
+			row[ix] = uint16_t(row[ix] + row[ix - 1]);
+		}
+	}
+
+	deltas_.swap(next);
+	CountNonZero();
+	++version_;
+	return true;
+}
+
+bool TerrainDeformationLayer::SaveToFile(const std::string& path) const {
+	std::vector<uint8_t> bytes;
+	Encode(bytes);
+
+	std::ofstream ofs(path, std::ios::binary);
+	if (!ofs)
+		return false;
+	ofs.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+	return bool(ofs);
+}
+
+bool TerrainDeformationLayer::LoadFromFile(const std::string& path) {
+	std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+	if (!ifs)
+		return false;
+	const std::streamsize size = ifs.tellg();
+	ifs.seekg(0);
+
+	std::vector<uint8_t> bytes(size_t((std::max)(size, std::streamsize(0))));
+	if (!ifs.read(reinterpret_cast<char*>(bytes.data()), size))
+		return false;
+	return Decode(bytes.data(), bytes.size());
+}
+
+} // namespace Engine
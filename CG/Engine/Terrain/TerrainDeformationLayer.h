@@ -0,0 +1,91 @@
+// Engine/Terrain/TerrainDeformationLayer.h
+#pragma once
+// =======================================
+//  TerrainDeformationLayer : 地形の変形（ベース地形との差分）を
+//  格子点ごとの int16 に量子化して持つ永続レイヤー
+//  - 凹みを何回入れたかに関係なく、格子 1 枚ぶんで状態を表せる
+//  - 保存形式：ヘッダ + 行方向の差分 → RLE（ほとんどが 0 なので小さくなる）
+//  - 読み込みはメモリ上のデータから 1 パスで展開（ファイルでも、マップしたメモリでも可）
+//  - 格子点の並びは TerrainHeightField / Voxel CS と同じ
+// =======================================
+#include "TerrainHeight.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+class TerrainHeightField;
+
+class TerrainDeformationLayer {
+public:
+	// 量子化の刻み（1/512 m → ±64 m まで表せる）
+	static constexpr float kQuantStep = 1.0f / 512.0f;
+
+	// ---- 保存形式のヘッダ ----
+	struct FileHeader {
+		char magic[4];         // "TDEF"
+		uint32_t version;      // kFileVersion
+		uint32_t samplesX;     // 格子点数
+		uint32_t samplesZ;
+		float cell;            // 格子間隔
+		float quantStep;       // 量子化の刻み
+		uint32_t payloadBytes; // ヘッダの後ろの圧縮データ
+		uint32_t reserved;
+	};
+	static constexpr uint32_t kFileVersion = 1;
+
+	// gridX/gridZ はセル数（格子点は +1 個）
+	void Initialize(uint32_t gridX, uint32_t gridZ, float cell);
+	void Clear();
+
+	// 高さキャッシュ（ベース + 凹み + 既存レイヤー）からベースとの差分を取り込む。格子の大きさが違えば false（中身は変えない）
+	bool CaptureFrom(const TerrainHeightField& field);
+
+	// 凹みを格子点の差分に足す（範囲外の格子点は捨てる）。格子点ごとの誤差は量子化の刻みの半分まで
+	void StampDent(const TerrainDent& d);
+
+	// 差分を高さキャッシュに足す（ベースだけ焼いた直後に呼ぶ想定）
+	void ApplyTo(TerrainHeightField& field) const;
+
+	// 格子点の差分（m）
+	float DeltaAt(uint32_t ix, uint32_t iz) const { return deltas_[size_t(iz) * samplesX_ + ix] * kQuantStep; }
+
+	// 格子点の勾配（中心差分。CS と同じ）
+	void GradientAt(uint32_t ix, uint32_t iz, float& dHdx, float& dHdz) const;
+
+	// 任意点の高さ/勾配に足し込む（高さも勾配も格子点の値を双線形補間）
+	void Accumulate(float x, float z, TerrainSample& s) const;
+
+	bool IsEmpty() const { return nonZero_ == 0; }
+	uint32_t SamplesX() const { return samplesX_; }
+	uint32_t SamplesZ() const { return samplesZ_; }
+	const std::vector<int16_t>& Raw() const { return deltas_; }
+
+	// 変更のたびに増える（GPU 側の更新判定用）
+	uint32_t Version() const { return version_; }
+
+	// ---- 保存 / 読み込み ----
+	// ヘッダ込みのバイト列にする
+	void Encode(std::vector<uint8_t>& out) const;
+	// ヘッダ込みのバイト列から戻す。格子の大きさが違う/壊れている場合は false（中身は変えない）
+	bool Decode(const void* data, size_t bytes);
+
+	bool SaveToFile(const std::string& path) const;
+	bool LoadFromFile(const std::string& path);
+
+private:
+	void CountNonZero();
+
+	uint32_t samplesX_ = 0;
+	uint32_t samplesZ_ = 0;
+	float cell_ = 1.0f;
+	float originX_ = 0.0f; // 格子点 (0,0) のワールド座標
+	float originZ_ = 0.0f;
+
+	std::vector<int16_t> deltas_;
+	size_t nonZero_ = 0;
+	uint32_t version_ = 0;
+};
+
+} // namespace Engine
@@ -0,0 +1,238 @@
+// Engine/Terrain/TerrainDentGrid.cpp
+#include "TerrainDentGrid.h"
+#include "TerrainDeformationLayer.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace Engine {
+
+void TerrainDentGrid::Initialize(float originX, float originZ, float cellSize, uint32_t cellsX, uint32_t cellsZ) {
+	originX_ = originX;
+	originZ_ = originZ;
+	cellSize_ = cellSize;
+	cellsX_ = cellsX;
+	cellsZ_ = cellsZ;
+	Clear();
+}
+
+void TerrainDentGrid::Clear() {
+	dents_.clear();
+	serials_.clear();
+	nextSerial_ = 0;
+	cells_.assign(size_t(cellsX_) * cellsZ_, {});
+	mergedCount_ = 0;
+	foldedCount_ = 0;
+	++version_;
+}
+
+bool TerrainDentGrid::CellRect(const TerrainDent& d, uint32_t& x0, uint32_t& z0, uint32_t& x1, uint32_t& z1) const {
+	const int ix0 = int(std::floor((d.centerXZ.x - d.radius - originX_) / cellSize_));
+	const int ix1 = int(std::floor((d.centerXZ.x + d.radius - originX_) / cellSize_));
+	const int iz0 = int(std::floor((d.centerXZ.y - d.radius - originZ_) / cellSize_));
+	const int iz1 = int(std::floor((d.centerXZ.y + d.radius - originZ_) / cellSize_));
+	if (ix1 < 0 || iz1 < 0 || ix0 >= int(cellsX_) || iz0 >= int(cellsZ_))
+		return false;
+
+	x0 = uint32_t((std::max)(ix0, 0));
+	z0 = uint32_t((std::max)(iz0, 0));
+	x1 = uint32_t((std::min)(ix1, int(cellsX_) - 1));
+	z1 = uint32_t((std::min)(iz1, int(cellsZ_) - 1));
+	return true;
+}
+
+void TerrainDentGrid::Insert(uint32_t index) {
+	uint32_t x0, z0, x1, z1;
+	if (!CellRect(dents_[index], x0, z0, x1, z1))
+		return;
+	for (uint32_t z = z0; z <= z1; ++z) {
+		for (uint32_t x = x0; x <= x1; ++x) {
+			cells_[size_t(z) * cellsX_ + x].push_back(index);
+		}
+	}
+}
+
+void TerrainDentGrid::Remove(uint32_t index) {
+	uint32_t x0, z0, x1, z1;
+	if (!CellRect(dents_[index], x0, z0, x1, z1))
+		return;
+	for (uint32_t z = z0; z <= z1; ++z) {
+		for (uint32_t x = x0; x <= x1; ++x) {
+			auto& list = cells_[size_t(z) * cellsX_ + x];
+			list.erase(std::remove(list.begin(), list.end(), index), list.end());
+		}
+	}
+}
+
+int TerrainDentGrid::FindMergeTarget(const TerrainDent& d) const {
+	const int cx = int(std::floor((d.centerXZ.x - originX_) / cellSize_));
+	const int cz = int(std::floor((d.centerXZ.y - originZ_) / cellSize_));
+	if (cx < 0 || cz < 0 || cx >= int(cellsX_) || cz >= int(cellsZ_))
+		return -1;
+
+	// 中心が近い凹みは中心セルに必ず載っている（半径 >= 距離のため）
+	int best = -1;
+	float bestDist2 = 0.0f;
+	for (uint32_t idx : cells_[size_t(cz) * cellsX_ + cx]) {
+		const TerrainDent& e = dents_[idx];
+		const float dx = e.centerXZ.x - d.centerXZ.x;
+		const float dz = e.centerXZ.y - d.centerXZ.y;
+		const float dist2 = dx * dx + dz * dz;
+		const float rMin = (std::min)(e.radius, d.radius), rMax = (std::max)(e.radius, d.radius);
+		const float limit = rMin * kMergeDistanceRatio;
+		// 大きさが違う凹み（浅く広い凹みの中の小さな一撃など）は和が 1 個の放物面にならないのでまとめない
+		if (rMin < rMax * kMergeRadiusRatio)
+			continue;
+		if (dist2 <= limit * limit && (best < 0 || dist2 < bestDist2)) {
+			best = int(idx);
+			bestDist2 = dist2;
+		}
+	}
+	return best;
+}
+
+uint32_t TerrainDentGrid::Erase(uint32_t index) {
+	const uint32_t last = uint32_t(dents_.size() - 1);
+	Remove(index);
+	if (index != last) {
+		Remove(last);
+		dents_[index] = dents_[last];
+		serials_[index] = serials_[last];
+		Insert(index);
+	}
+	dents_.pop_back();
+	serials_.pop_back();
+	return last;
+}
+
+void TerrainDentGrid::Fold(uint32_t index, TerrainDeformationLayer& layer, AddResult& r) {
+	layer.StampDent(dents_[index]);
+	r.folded.push_back(dents_[index]);
+	if (Erase(index) == r.index) {
+		r.index = index;
+	}
+	++foldedCount_;
+}
+
+TerrainDentGrid::AddResult TerrainDentGrid::Add(const TerrainDent& d, TerrainDeformationLayer* foldInto) {
+	AddResult r;
+	++version_;
+
+	if (foldInto) {
+		r.index = uint32_t(dents_.size());
+		dents_.push_back(d);
+		serials_.push_back(nextSerial_++);
+		Insert(r.index);
+
+		uint32_t x0, z0, x1, z1;
+		if (!CellRect(d, x0, z0, x1, z1))
+			return r;
+
+		// 新しい凹みの円にすっぽり入る凹み（どれも新しい凹みより古い）
+		std::vector<uint32_t> covered;
+		for (uint32_t z = z0; z <= z1; ++z) {
+			for (uint32_t x = x0; x <= x1; ++x) {
+				for (uint32_t idx : cells_[size_t(z) * cellsX_ + x]) {
+					const TerrainDent& e = dents_[idx];
+					const float dx = e.centerXZ.x - d.centerXZ.x, dz = e.centerXZ.y - d.centerXZ.y;
+					if (idx != r.index && std::sqrt(dx * dx + dz * dz) + e.radius <= d.radius) {
+						covered.push_back(idx);
+					}
+				}
+			}
+		}
+		// 後ろから外せば、末尾から詰める凹みはもう外した番号と重ならない
+		std::sort(covered.begin(), covered.end(), std::greater<uint32_t>());
+		covered.erase(std::unique(covered.begin(), covered.end()), covered.end());
+		for (uint32_t idx : covered) {
+			Fold(idx, *foldInto, r);
+		}
+
+		// 上限を超えたセルは古いものから焼き込む（新しい凹みはいちばん新しいので残る）
+		for (uint32_t z = z0; z <= z1; ++z) {
+			for (uint32_t x = x0; x <= x1; ++x) {
+				const std::vector<uint32_t>& list = cells_[size_t(z) * cellsX_ + x];
+				while (list.size() > kMaxDentsPerCell) {
+					uint32_t oldest = list[0];
+					for (uint32_t idx : list) {
+						if (serials_[idx] < serials_[oldest]) {
+							oldest = idx;
+						}
+					}
+					Fold(oldest, *foldInto, r);
+				}
+			}
+		}
+		return r;
+	}
+
+	const int target = FindMergeTarget(d);
+	if (target < 0) {
+		r.index = uint32_t(dents_.size());
+		dents_.push_back(d);
+		serials_.push_back(nextSerial_++);
+		Insert(r.index);
+		return r;
+	}
+
+	// 既存の凹みに近似でまとめる：深さは合計、中心と半径は深さで重み付け（2 個の和とは少し違う形になる）
+	r.index = uint32_t(target);
+	r.merged = true;
+	r.previous = dents_[r.index];
+
+	const TerrainDent& e = r.previous;
+	const float depth = e.depth + d.depth;
+	const float we = depth != 0.0f ? e.depth / depth : 0.5f;
+	TerrainDent m;
+	m.centerXZ.x = e.centerXZ.x * we + d.centerXZ.x * (1.0f - we);
+	m.centerXZ.y = e.centerXZ.y * we + d.centerXZ.y * (1.0f - we);
+	m.radius = e.radius * we + d.radius * (1.0f - we);
+	m.depth = depth;
+
+	Remove(r.index);
+	dents_[r.index] = m;
+	serials_[r.index] = nextSerial_++;
+	Insert(r.index);
+	++mergedCount_;
+	return r;
+}
+
+float TerrainDentGrid::OffsetAt(float x, float z) const {
+	const int cx = int(std::floor((x - originX_) / cellSize_));
+	const int cz = int(std::floor((z - originZ_) / cellSize_));
+	if (cx < 0 || cz < 0 || cx >= int(cellsX_) || cz >= int(cellsZ_))
+		return 0.0f;
+
+	float y = 0.0f;
+	for (uint32_t idx : cells_[size_t(cz) * cellsX_ + cx]) {
+		y += TerrainDentOffset(x, z, dents_[idx]);
+	}
+	return y;
+}
+
+void TerrainDentGrid::Accumulate(float x, float z, TerrainSample& s) const {
+	const int cx = int(std::floor((x - originX_) / cellSize_));
+	const int cz = int(std::floor((z - originZ_) / cellSize_));
+	if (cx < 0 || cz < 0 || cx >= int(cellsX_) || cz >= int(cellsZ_))
+		return;
+
+	for (uint32_t idx : cells_[size_t(cz) * cellsX_ + cx]) {
+		TerrainDentAccumulate(x, z, dents_[idx], s);
+	}
+}
+
+bool TerrainDentGrid::BuildFlatTables() {
+	if (flatVersion_ == version_)
+		return false;
+	flatVersion_ = version_;
+
+	flatRanges_.resize(cells_.size());
+	flatIndices_.clear();
+	for (size_t i = 0; i < cells_.size(); ++i) {
+		flatRanges_[i] = {uint32_t(flatIndices_.size()), uint32_t(cells_[i].size())};
+		flatIndices_.insert(flatIndices_.end(), cells_[i].begin(), cells_[i].end());
+	}
+	return true;
+}
+
+} // namespace Engine
@@ -0,0 +1,107 @@
+// Engine/Terrain/TerrainDentGrid.h
+#pragma once
+// =======================================
+//  TerrainDentGrid : 凹みを XZ の一様グリッドに振り分けて持つ
+//  - 凹みは外接矩形が掛かるセルすべてに登録
+//  - 高さのサンプルは自分のセルに載っている凹みだけ見ればよい
+//  - 変形レイヤーを渡して Add すると、新しい凹みにすっぽり覆われた凹みと、セルに kMaxDentsPerCell 個を
+//    超えた分の古い凹みをレイヤーに焼き込んでグリッドから外す（セルあたりの数が頭打ちになる）
+//    格子点の高さは焼き込むたびに量子化の刻みの半分までしか変わらない
+//  - レイヤーなしのときは、ほぼ同じ場所・同じ大きさの凹みを 1 個に近似してまとめる
+//    （近似なので形は少し変わる。ぎりぎりの 2 個で深さの合計の 1 割弱）
+//  - GPU 用に「セルごとの (先頭, 個数)」と「凹み番号の並び」を平らにして出す
+// =======================================
+#include "TerrainHeight.h"
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+class TerrainDeformationLayer;
+
+class TerrainDentGrid {
+public:
+	// 中心距離が min(半径) * この比率以内で、半径の比（小 / 大）がこれ以上なら同じ凹みとしてまとめる
+	// 両方ぎりぎりでも、まとめた凹みと 2 個の和との差は深さの合計の 9% ほど
+	static constexpr float kMergeDistanceRatio = 0.1f;
+	static constexpr float kMergeRadiusRatio = 0.9f;
+
+	// レイヤーに焼き込むときのセルあたりの凹みの上限
+	static constexpr uint32_t kMaxDentsPerCell = 8;
+
+	// originX/originZ : グリッド左下のワールド座標、cellSize : 1セルの一辺
+	void Initialize(float originX, float originZ, float cellSize, uint32_t cellsX, uint32_t cellsZ);
+	void Clear();
+
+	// Add の結果（まとめた場合は元の凹みを previous に返す）
+	struct AddResult {
+		uint32_t index = 0;      // 追加/更新された凹みの番号
+		bool merged = false;     // 既存の凹みにまとめたか
+		TerrainDent previous{};  // まとめる前の既存の凹み（merged のときだけ有効）
+		std::vector<TerrainDent> folded; // レイヤーに焼き込んでグリッドから外した凹み
+	};
+	// foldInto があれば覆われた凹み / 古い凹みをそこへ焼き込む（近似のまとめはしない）。なければ近いものをまとめる
+	AddResult Add(const TerrainDent& d, TerrainDeformationLayer* foldInto = nullptr);
+
+	// (x,z) に掛かる凹みの高さ変化の合計
+	float OffsetAt(float x, float z) const;
+
+	// (x,z) に掛かる凹みを高さ/勾配に足し込む
+	void Accumulate(float x, float z, TerrainSample& s) const;
+
+	uint32_t Count() const { return uint32_t(dents_.size()); }
+	const TerrainDent& Dent(uint32_t index) const { return dents_[index]; }
+	const std::vector<TerrainDent>& Dents() const { return dents_; }
+	uint32_t MergedCount() const { return mergedCount_; }
+	uint32_t FoldedCount() const { return foldedCount_; }
+
+	float OriginX() const { return originX_; }
+	float OriginZ() const { return originZ_; }
+	float CellSize() const { return cellSize_; }
+	uint32_t CellsX() const { return cellsX_; }
+	uint32_t CellsZ() const { return cellsZ_; }
+
+	// ---- GPU 用の平らな表 ----
+	struct CellRange {
+		uint32_t first; // indices 内の先頭
+		uint32_t count; // 個数
+	};
+	// 変更があったときだけ作り直す。戻り値は作り直したかどうか
+	bool BuildFlatTables();
+	const std::vector<CellRange>& FlatRanges() const { return flatRanges_; }
+	const std::vector<uint32_t>& FlatIndices() const { return flatIndices_; }
+
+	// 変更のたびに増える（GPU 側の更新判定用）
+	uint32_t Version() const { return version_; }
+
+private:
+	// 凹み d の外接矩形が掛かるセル範囲（範囲外なら false）
+	bool CellRect(const TerrainDent& d, uint32_t& x0, uint32_t& z0, uint32_t& x1, uint32_t& z1) const;
+	void Insert(uint32_t index);
+	void Remove(uint32_t index);
+	int FindMergeTarget(const TerrainDent& d) const;
+	// index を外して末尾の凹みを詰める（詰めた凹みの元の番号を返す）
+	uint32_t Erase(uint32_t index);
+	// index をレイヤーに焼き込んで外す（r.index が詰められたら付け替える）
+	void Fold(uint32_t index, TerrainDeformationLayer& layer, AddResult& r);
+
+	float originX_ = 0.0f;
+	float originZ_ = 0.0f;
+	float cellSize_ = 1.0f;
+	uint32_t cellsX_ = 0;
+	uint32_t cellsZ_ = 0;
+
+	std::vector<TerrainDent> dents_;
+	std::vector<uint32_t> serials_; // 追加した順番（小さいほど古い）
+	uint32_t nextSerial_ = 0;
+	std::vector<std::vector<uint32_t>> cells_; // セルごとの凹み番号
+	uint32_t mergedCount_ = 0;
+	uint32_t foldedCount_ = 0;
+
+	uint32_t version_ = 0;
+	uint32_t flatVersion_ = UINT32_MAX;
+	std::vector<CellRange> flatRanges_;
+	std::vector<uint32_t> flatIndices_;
+};
+
+} // namespace Engine
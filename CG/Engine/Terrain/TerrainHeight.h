@@ -0,0 +1,129 @@
+// Engine/Terrain/TerrainHeight.h
+#pragma once
+// =======================================
+//  ボクセル地形の高さ関数（CPU 版）
+//  ※ Renderer の Voxel CS 内 h() と同じ式
+//  - 高さと一緒に勾配 (dH/dx, dH/dz) も解析的に求められる
+// =======================================
+#include "Matrix4x4.h"
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+// ---- 凹み情報（ボス攻撃）----
+// GPU の CB にそのままコピーするので 16B レイアウトを崩さないこと
+struct TerrainDent {
+	DirectX::XMFLOAT2 centerXZ; // 凹み中心 (x,z)
+	float radius;               // 半径
+	float depth;                // 深さ（正の値、下方向にへこませる）
+};
+
+// 地形の定数（CS の h_base と同じ値）
+namespace TerrainShape {
+constexpr float kPitRadius = 40.0f;
+constexpr float kOuterRingRadius = 100.0f;
+constexpr float kPitFloorY = -4.0f;
+constexpr float kRingY = 2.5f; // 岩の高さ
+constexpr float kOuterBaseY = -8.0f;
+constexpr float kOuterBlendWidth = 10.0f;
+} // namespace TerrainShape
+
+// 高さ + 勾配
+struct TerrainSample {
+	float height = 0.0f;
+	float dHdx = 0.0f;
+	float dHdz = 0.0f;
+
+	// 勾配から法線（normalize(-dHdx, 1, -dHdz)）
+	Vector3 Normal() const { return Normalize(Vector3{-dHdx, 1.0f, -dHdz}); }
+};
+
+// ベースのドーナツ型ステージの高さ（CS の h_base と同じ）
+inline float TerrainBaseHeight(float x, float z) {
+	float r = std::sqrt(x * x + z * z);
+
+	const float pitRadius = TerrainShape::kPitRadius;
+	const float outerRingRadius = TerrainShape::kOuterRingRadius;
+	const float pitFloorY = TerrainShape::kPitFloorY;
+	const float ringY = TerrainShape::kRingY;
+	const float outerBaseY = TerrainShape::kOuterBaseY;
+	const float outerBlendWidth = TerrainShape::kOuterBlendWidth;
+
+	float y;
+
+	if (r < pitRadius) {
+		float t = r / pitRadius; // 0～1
+		y = pitFloorY + (ringY - pitFloorY) * (t * t);
+	} else if (r < outerRingRadius) {
+		y = ringY; // ドーナツ枠：完全にフラット
+	} else {
+		float t = (r - outerRingRadius) / outerBlendWidth;
+		t = (std::max)(0.0f, (std::min)(1.0f, t)); // saturate 相当
+		y = ringY + (outerBaseY - ringY) * t;
+	}
+
+	return y;
+}
+
+// 凹み 1 個ぶんの高さ変化（範囲外なら 0）
+inline float TerrainDentOffset(float x, float z, const TerrainDent& d) {
+	float dx = x - d.centerXZ.x;
+	float dz = z - d.centerXZ.y;
+	float dist2 = dx * dx + dz * dz;
+	float r2 = d.radius * d.radius;
+	if (dist2 > r2)
+		return 0.0f;
+
+	// 中心ほど大きくへこむ（0～1）
+	float t = 1.0f - dist2 / r2;
+	return -d.depth * t;
+}
+
+// ベース地形の高さと勾配（CS の h_base_grad と同じ）
+inline TerrainSample TerrainBaseSample(float x, float z) {
+	using namespace TerrainShape;
+
+	TerrainSample s;
+	s.height = TerrainBaseHeight(x, z);
+
+	// dH/dx = dH/dr * x / r。穴の中は r^2 の式なので r で割らずに済む
+	const float r = std::sqrt(x * x + z * z);
+	float k = 0.0f; // dH/dx = k * x
+	if (r < kPitRadius) {
+		k = 2.0f * (kRingY - kPitFloorY) / (kPitRadius * kPitRadius);
+	} else if (r > kOuterRingRadius && r < kOuterRingRadius + kOuterBlendWidth) {
+		k = (kOuterBaseY - kRingY) / kOuterBlendWidth / r;
+	}
+	s.dHdx = k * x;
+	s.dHdz = k * z;
+	return s;
+}
+
+// 凹み 1 個ぶんを高さと勾配に足し込む
+inline void TerrainDentAccumulate(float x, float z, const TerrainDent& d, TerrainSample& s) {
+	float dx = x - d.centerXZ.x;
+	float dz = z - d.centerXZ.y;
+	float dist2 = dx * dx + dz * dz;
+	float r2 = d.radius * d.radius;
+	if (dist2 > r2)
+		return;
+
+	// -depth * (1 - dist2/r2) を微分すると 2 * depth * dx / r2
+	const float g = 2.0f * d.depth / r2;
+	s.height += -d.depth * (1.0f - dist2 / r2);
+	s.dHdx += g * dx;
+	s.dHdz += g * dz;
+}
+
+// ベース + 全凹み（解析解。ベイク結果の検証やグリッド外で使う）
+inline float TerrainHeightAnalytic(float x, float z, const TerrainDent* dents, unsigned count) {
+	float y = TerrainBaseHeight(x, z);
+	for (unsigned i = 0; i < count; ++i) {
+		y += TerrainDentOffset(x, z, dents[i]);
+	}
+	return y;
+}
+
+} // namespace Engine
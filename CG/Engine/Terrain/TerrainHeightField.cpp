@@ -0,0 +1,97 @@
+// Engine/Terrain/TerrainHeightField.cpp
+#include "TerrainHeightField.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+void TerrainHeightField::Initialize(uint32_t gridX, uint32_t gridZ, float cell) {
+	gridX_ = gridX;
+	gridZ_ = gridZ;
+	cell_ = cell;
+	originX_ = SampleX(0);
+	originZ_ = SampleZ(0);
+
+	samples_.resize(size_t(SamplesX()) * SamplesZ());
+
+	// ベース地形をベイク
+	for (uint32_t iz = 0; iz < SamplesZ(); ++iz) {
+		const float z = SampleZ(iz);
+		float* row = &samples_[size_t(iz) * SamplesX()];
+		for (uint32_t ix = 0; ix < SamplesX(); ++ix) {
+			row[ix] = TerrainBaseHeight(SampleX(ix), z);
+		}
+	}
+}
+
+bool TerrainHeightField::DentSampleRect(const TerrainDent& d, uint32_t& x0, uint32_t& z0, uint32_t& x1, uint32_t& z1) const {
+	if (!IsValid() || d.radius <= 0.0f)
+		return false;
+
+	// 影響する格子点の範囲（外接矩形）
+	const int maxX = int(gridX_);
+	const int maxZ = int(gridZ_);
+	const int ix0 = int(std::ceil((d.centerXZ.x - d.radius - originX_) / cell_));
+	const int ix1 = int(std::floor((d.centerXZ.x + d.radius - originX_) / cell_));
+	const int iz0 = int(std::ceil((d.centerXZ.y - d.radius - originZ_) / cell_));
+	const int iz1 = int(std::floor((d.centerXZ.y + d.radius - originZ_) / cell_));
+	if (ix1 < 0 || iz1 < 0 || ix0 > maxX || iz0 > maxZ)
+		return false;
+
+	x0 = uint32_t(std::clamp(ix0, 0, maxX));
+	x1 = uint32_t(std::clamp(ix1, 0, maxX));
+	z0 = uint32_t(std::clamp(iz0, 0, maxZ));
+	z1 = uint32_t(std::clamp(iz1, 0, maxZ));
+	return x0 <= x1 && z0 <= z1;
+}
+
+void TerrainHeightField::StampDent(const TerrainDent& d) {
+	uint32_t x0, z0, x1, z1;
+	if (!DentSampleRect(d, x0, z0, x1, z1))
+		return;
+
+	for (uint32_t iz = z0; iz <= z1; ++iz) {
+		const float z = SampleZ(iz);
+		float* row = &samples_[size_t(iz) * SamplesX()];
+		for (uint32_t ix = x0; ix <= x1; ++ix) {
+			row[ix] += TerrainDentOffset(SampleX(ix), z, d);
+		}
+	}
+}
+
+bool TerrainHeightField::Contains(float x, float z) const {
+	if (!IsValid())
+		return false;
+	const float fx = (x - originX_) / cell_;
+	const float fz = (z - originZ_) / cell_;
+	return fx >= 0.0f && fz >= 0.0f && fx <= float(gridX_) && fz <= float(gridZ_);
+}
+
+float TerrainHeightField::HeightAt(float x, float z) const {
+	if (!Contains(x, z)) {
+		// 格子外（メッシュも無い範囲）はベース地形のみ
+		return TerrainBaseHeight(x, z);
+	}
+
+	const float fx = (x - originX_) / cell_;
+	const float fz = (z - originZ_) / cell_;
+
+	// 右端/下端ちょうどでも [ix, ix+1] が取れるように 1 つ手前へ寄せる
+	const uint32_t ix = (std::min)(uint32_t(fx), gridX_ - 1);
+	const uint32_t iz = (std::min)(uint32_t(fz), gridZ_ - 1);
+	const float tx = fx - float(ix);
+	const float tz = fz - float(iz);
+
+	const size_t stride = SamplesX();
+	const float* p = &samples_[size_t(iz) * stride + ix];
+	const float h00 = p[0];
+	const float h10 = p[1];
+	const float h01 = p[stride];
+	const float h11 = p[stride + 1];
+
+	const float h0 = h00 + (h10 - h00) * tx;
+	const float h1 = h01 + (h11 - h01) * tx;
+	return h0 + (h1 - h0) * tz;
+}
+
+} // namespace Engine
@@ -0,0 +1,63 @@
+// Engine/Terrain/TerrainHeightField.h
+#pragma once
+// =======================================
+//  TerrainHeightField : ボクセル地形の高さを格子にベイクしたキャッシュ
+//  - 格子点は Voxel CS の頂点と同じ位置（原点センタリング / cell 間隔）
+//  - 凹みは影響範囲の格子点だけに加算（インクリメンタル）
+//  - 高さ/法線の問い合わせは凹みの数に関係なく O(1)
+// =======================================
+#include "Matrix4x4.h"
+#include "TerrainHeight.h"
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+class TerrainHeightField {
+public:
+	// gridX/gridZ はセル数（格子点は +1 個）
+	void Initialize(uint32_t gridX, uint32_t gridZ, float cell);
+
+	// 凹みを影響範囲の格子点へ焼き込む
+	void StampDent(const TerrainDent& d);
+
+	// 焼き込んだ凹みを取り消す（凹みをまとめ直すとき用）
+	void UnstampDent(const TerrainDent& d) {
+		TerrainDent n = d;
+		n.depth = -d.depth;
+		StampDent(n);
+	}
+
+	// 凹みが掛かる格子点の範囲（掛からなければ false）
+	bool DentSampleRect(const TerrainDent& d, uint32_t& x0, uint32_t& z0, uint32_t& x1, uint32_t& z1) const;
+
+	// 双線形補間で高さを返す（格子外はベース地形の解析値）
+	float HeightAt(float x, float z) const;
+
+	bool IsValid() const { return !samples_.empty(); }
+	bool Contains(float x, float z) const;
+
+	uint32_t GridX() const { return gridX_; }
+	uint32_t GridZ() const { return gridZ_; }
+	uint32_t SamplesX() const { return gridX_ + 1; }
+	uint32_t SamplesZ() const { return gridZ_ + 1; }
+	float Cell() const { return cell_; }
+
+	// 格子点 (ix,iz) のワールド座標（CS と同じ式）
+	float SampleX(uint32_t ix) const { return ix * cell_ - 0.5f * gridX_ * cell_; }
+	float SampleZ(uint32_t iz) const { return iz * cell_ - 0.5f * gridZ_ * cell_; }
+
+	float Sample(uint32_t ix, uint32_t iz) const { return samples_[size_t(iz) * SamplesX() + ix]; }
+	void AddSample(uint32_t ix, uint32_t iz, float dy) { samples_[size_t(iz) * SamplesX() + ix] += dy; }
+
+private:
+	uint32_t gridX_ = 0;
+	uint32_t gridZ_ = 0;
+	float cell_ = 1.0f;
+	float originX_ = 0.0f; // 格子点 (0,0) のワールド座標
+	float originZ_ = 0.0f;
+
+	std::vector<float> samples_; // (gridX+1) * (gridZ+1)
+};
+
+} // namespace Engine
@@ -0,0 +1,358 @@
+// Engine/Terrain/TerrainHeightPyramid.cpp
+#include "TerrainHeightPyramid.h"
+#include "TerrainHeightField.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iterator>
+
+namespace Engine {
+
+namespace {
+
+// 1 軸ぶんのスラブ判定。[tEnter, tExit] を狭める
+bool Slab(float o, float d, float lo, float hi, float& tEnter, float& tExit) {
+	if (std::fabs(d) < 1e-8f) {
+		// 軸に平行：始点が範囲内なら制限なし
+		return o >= lo && o <= hi;
+	}
+	const float inv = 1.0f / d;
+	float t0 = (lo - o) * inv;
+	float t1 = (hi - o) * inv;
+	if (t0 > t1)
+		std::swap(t0, t1);
+	tEnter = (std::max)(tEnter, t0);
+	tExit = (std::min)(tExit, t1);
+	return tEnter <= tExit;
+}
+
+// 点 p が三角形 abc の中か（raw は abc の向きのままの法線。共有辺で隙間ができないよう少し甘く）
+bool InsideTriangle(const Vector3& p, const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& raw) {
+	const float eps = -1e-5f * Dot(raw, raw);
+	return Dot(Cross(b - a, p - a), raw) >= eps && Dot(Cross(c - b, p - b), raw) >= eps && Dot(Cross(a - c, p - c), raw) >= eps;
+}
+
+// 球（半径 r）を辺 ab に向けて動かす
+bool SweepEdge(const Vector3& a, const Vector3& b, const Vector3& o, const Vector3& d, float r, float& best, Vector3& normal) {
+	const Vector3 e = b - a;
+	const Vector3 m = o - a;
+	const float ee = Dot(e, e);
+	const float ed = Dot(e, d);
+	const float em = Dot(e, m);
+
+	// 辺を軸にした無限円柱との交差（d は正規化済み）
+	const float A = ee - ed * ed;
+	const float B = ee * Dot(m, d) - em * ed;
+	const float C = ee * (Dot(m, m) - r * r) - em * em;
+	if (A < 1e-8f * ee || C < 0.0f)
+		return false; // 平行、または始点で重なっている
+	const float disc = B * B - A * C;
+	if (disc < 0.0f)
+		return false;
+
+	const float t = (-B - std::sqrt(disc)) / A;
+	if (t < 0.0f || t >= best)
+		return false;
+	const float f = (em + ed * t) / ee;
+	if (f < 0.0f || f > 1.0f)
+		return false;
+
+	const Vector3 center = o + d * t;
+	best = t;
+	normal = Normalize(center - (a + e * f));
+	return true;
+}
+
+// 球（半径 r）を点 v に向けて動かす
+bool SweepPoint(const Vector3& v, const Vector3& o, const Vector3& d, float r, float& best, Vector3& normal) {
+	const Vector3 m = o - v;
+	const float b = Dot(m, d);
+	const float c = Dot(m, m) - r * r;
+	if (c < 0.0f || b > 0.0f)
+		return false; // 始点で重なっている、または離れていく
+	const float disc = b * b - c;
+	if (disc < 0.0f)
+		return false;
+
+	const float t = -b - std::sqrt(disc);
+	if (t >= best)
+		return false;
+
+	best = t;
+	normal = Normalize(o + d * t - v);
+	return true;
+}
+
+// 球（r = 0 ならレイ）を三角形 abc に向けて動かす。表側から当たるものだけ
+bool SweepTriangle(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& o, const Vector3& d, float r, float& best, Vector3& normal) {
+	const Vector3 raw = Cross(b - a, c - a);
+	Vector3 n = Normalize(raw);
+	if (n.y < 0.0f)
+		n = n * -1.0f;
+
+	// 面：平面までの距離が r になる時刻
+	const float s0 = Dot(n, o - a);
+	const float ndv = Dot(n, d);
+	if (ndv < -1e-6f && s0 >= r) {
+		const float t = (s0 - r) / -ndv;
+		if (t < best && InsideTriangle(o + d * t - n * r, a, b, c, raw)) {
+			// 面の内側で触れたなら辺/頂点より先
+			best = t;
+			normal = n;
+			return true;
+		}
+	}
+	if (r <= 0.0f)
+		return false;
+
+	// 辺と頂点（面の外側で触れる場合）
+	bool hit = false;
+	hit |= SweepEdge(a, b, o, d, r, best, normal);
+	hit |= SweepEdge(b, c, o, d, r, best, normal);
+	hit |= SweepEdge(c, a, o, d, r, best, normal);
+	hit |= SweepPoint(a, o, d, r, best, normal);
+	hit |= SweepPoint(b, o, d, r, best, normal);
+	hit |= SweepPoint(c, o, d, r, best, normal);
+	return hit;
+}
+
+} // namespace
+
+void TerrainHeightPyramid::Build(const TerrainHeightField* field) {
+	field_ = field;
+	levels_.clear();
+	if (!field_ || !field_->IsValid())
+		return;
+
+	// レベル 0 = セル、上は 1x1 になるまで半分ずつ
+	uint32_t w = field_->GridX();
+	uint32_t h = field_->GridZ();
+	for (;;) {
+		Level lv;
+		lv.w = w;
+		lv.h = h;
+		lv.nodes.resize(size_t(w) * h);
+		levels_.push_back(std::move(lv));
+		if (w == 1 && h == 1)
+			break;
+		w = (w + 1) / 2;
+		h = (h + 1) / 2;
+	}
+
+	Refit(0, 0, field_->GridX(), field_->GridZ());
+}
+
+bool TerrainHeightPyramid::MinHeightInRect(float x0, float z0, float x1, float z1, float& lo) const {
+	if (!IsValid())
+		return false;
+
+	// 掛かるセルの範囲（両端を含む）
+	const float inv = 1.0f / field_->Cell();
+	const float fx0 = std::floor((x0 - field_->SampleX(0)) * inv);
+	const float fz0 = std::floor((z0 - field_->SampleZ(0)) * inv);
+	const float fx1 = std::floor((x1 - field_->SampleX(0)) * inv);
+	const float fz1 = std::floor((z1 - field_->SampleZ(0)) * inv);
+	if (fx0 < 0.0f || fz0 < 0.0f || fx1 >= float(field_->GridX()) || fz1 >= float(field_->GridZ()))
+		return false;
+	uint32_t cx0 = uint32_t(fx0), cz0 = uint32_t(fz0), cx1 = uint32_t(fx1), cz1 = uint32_t(fz1);
+
+	// 矩形が 2x2 ノード以内に収まるレベルまで上がる（最上段なら全ノード）
+	uint32_t level = 0;
+	while (level + 1 < LevelCount() && ((cx1 >> level) - (cx0 >> level) > 1 || (cz1 >> level) - (cz0 >> level) > 1)) {
+		++level;
+	}
+	cx0 >>= level;
+	cz0 >>= level;
+	cx1 >>= level;
+	cz1 >>= level;
+
+	lo = FLT_MAX;
+	for (uint32_t z = cz0; z <= cz1; ++z) {
+		for (uint32_t x = cx0; x <= cx1; ++x) {
+			float nlo, nhi;
+			NodeMinMax(level, x, z, nlo, nhi);
+			lo = (std::min)(lo, nlo);
+		}
+	}
+	return true;
+}
+
+void TerrainHeightPyramid::RefitDent(const TerrainDent& d) {
+	uint32_t x0, z0, x1, z1;
+	if (IsValid() && field_->DentSampleRect(d, x0, z0, x1, z1)) {
+		Refit(x0, z0, x1, z1);
+	}
+}
+
+void TerrainHeightPyramid::Refit(uint32_t x0, uint32_t z0, uint32_t x1, uint32_t z1) {
+	if (!IsValid())
+		return;
+
+	// 格子点 [x0,x1] に触れるセルは [x0-1, x1]
+	const Level& base = levels_[0];
+	uint32_t cx0 = x0 > 0 ? x0 - 1 : 0;
+	uint32_t cz0 = z0 > 0 ? z0 - 1 : 0;
+	uint32_t cx1 = (std::min)(x1, base.w - 1);
+	uint32_t cz1 = (std::min)(z1, base.h - 1);
+	if (cx0 > cx1 || cz0 > cz1)
+		return;
+
+	// レベル 0：セルの格子点 4 つ
+	auto& nodes = levels_[0].nodes;
+	for (uint32_t iz = cz0; iz <= cz1; ++iz) {
+		for (uint32_t ix = cx0; ix <= cx1; ++ix) {
+			const float h00 = field_->Sample(ix, iz);
+			const float h10 = field_->Sample(ix + 1, iz);
+			const float h01 = field_->Sample(ix, iz + 1);
+			const float h11 = field_->Sample(ix + 1, iz + 1);
+			MinMax& m = nodes[size_t(iz) * base.w + ix];
+			m.lo = (std::min)((std::min)(h00, h10), (std::min)(h01, h11));
+			m.hi = (std::max)((std::max)(h00, h10), (std::max)(h01, h11));
+		}
+	}
+
+	// 上のレベルは範囲を半分にしながら作り直す
+	for (uint32_t level = 1; level < levels_.size(); ++level) {
+		cx0 >>= 1;
+		cz0 >>= 1;
+		cx1 >>= 1;
+		cz1 >>= 1;
+		ReduceRect(level, cx0, cz0, cx1, cz1);
+	}
+}
+
+void TerrainHeightPyramid::ReduceRect(uint32_t level, uint32_t x0, uint32_t z0, uint32_t x1, uint32_t z1) {
+	const Level& child = levels_[level - 1];
+	Level& lv = levels_[level];
+	for (uint32_t iz = z0; iz <= z1; ++iz) {
+		for (uint32_t ix = x0; ix <= x1; ++ix) {
+			MinMax m{FLT_MAX, -FLT_MAX};
+			// 端では子が 1 つしか無いことがある
+			for (uint32_t cz = iz * 2; cz < (std::min)(iz * 2 + 2, child.h); ++cz) {
+				for (uint32_t cx = ix * 2; cx < (std::min)(ix * 2 + 2, child.w); ++cx) {
+					const MinMax& c = child.nodes[size_t(cz) * child.w + cx];
+					m.lo = (std::min)(m.lo, c.lo);
+					m.hi = (std::max)(m.hi, c.hi);
+				}
+			}
+			lv.nodes[size_t(iz) * lv.w + ix] = m;
+		}
+	}
+}
+
+bool TerrainHeightPyramid::CastCell(uint32_t ix, uint32_t iz, const Vector3& o, const Vector3& d, float radius, float& best, Vector3& normal) const {
+	const float x0 = field_->SampleX(ix);
+	const float x1 = field_->SampleX(ix + 1);
+	const float z0 = field_->SampleZ(iz);
+	const float z1 = field_->SampleZ(iz + 1);
+	const Vector3 p00{x0, field_->Sample(ix, iz), z0};
+	const Vector3 p10{x1, field_->Sample(ix + 1, iz), z0};
+	const Vector3 p01{x0, field_->Sample(ix, iz + 1), z1};
+	const Vector3 p11{x1, field_->Sample(ix + 1, iz + 1), z1};
+
+	// メッシュと同じ分け方：(x0,z0)-(x1,z0)-(x0,z1) / (x1,z0)-(x1,z1)-(x0,z1)
+	bool hit = SweepTriangle(p00, p10, p01, o, d, radius, best, normal);
+	hit |= SweepTriangle(p10, p11, p01, o, d, radius, best, normal);
+	return hit;
+}
+
+bool TerrainHeightPyramid::Cast(const Vector3& origin, const Vector3& dir, float radius, float maxDist, TerrainRayHit& hit) const {
+	if (!IsValid() || maxDist <= 0.0f)
+		return false;
+	const float len = std::sqrt(Dot(dir, dir));
+	if (len < 1e-6f)
+		return false;
+	const Vector3 d = dir / len;
+
+	const float cell = field_->Cell();
+	const float originX = field_->SampleX(0);
+	const float originZ = field_->SampleZ(0);
+	const uint32_t gridX = field_->GridX();
+	const uint32_t gridZ = field_->GridZ();
+
+	// ノードの箱（球の半径ぶん膨らませる）に入る距離。当たらなければ false
+	auto enter = [&](uint32_t level, uint32_t nx, uint32_t nz, float tMax, float& t) {
+		const MinMax& m = levels_[level].nodes[size_t(nz) * levels_[level].w + nx];
+		const float bx0 = originX + float(nx << level) * cell - radius;
+		const float bx1 = originX + float((std::min)((nx + 1) << level, gridX)) * cell + radius;
+		const float bz0 = originZ + float(nz << level) * cell - radius;
+		const float bz1 = originZ + float((std::min)((nz + 1) << level, gridZ)) * cell + radius;
+		float t0 = 0.0f;
+		float t1 = tMax;
+		if (!Slab(origin.x, d.x, bx0, bx1, t0, t1) || !Slab(origin.y, d.y, m.lo - radius, m.hi + radius, t0, t1) || !Slab(origin.z, d.z, bz0, bz1, t0, t1))
+			return false;
+		t = t0;
+		return true;
+	};
+
+	struct Entry {
+		uint32_t level;
+		uint32_t x;
+		uint32_t z;
+		float t;
+	};
+	// 1 段降りるごとに高々 3 個ずつ増えるだけなので 64 で足りる（レベル数 <= 21）
+	Entry stack[64];
+	int sp = 0;
+
+	float best = maxDist;
+	Vector3 normal{0.0f, 1.0f, 0.0f};
+	bool found = false;
+
+	const uint32_t top = uint32_t(levels_.size()) - 1;
+	float t;
+	if (enter(top, 0, 0, best, t)) {
+		stack[sp++] = {top, 0, 0, t};
+	}
+
+	while (sp > 0) {
+		const Entry e = stack[--sp];
+		if (e.t >= best)
+			continue; // もっと近い当たりが見つかっている
+
+		if (e.level == 0) {
+			found |= CastCell(e.x, e.z, origin, d, radius, best, normal);
+			continue;
+		}
+
+		// 子を入る距離の近い順に積む（遠い方から push）
+		const uint32_t cl = e.level - 1;
+		const Level& child = levels_[cl];
+		Entry kids[4];
+		int n = 0;
+		for (uint32_t cz = e.z * 2; cz < (std::min)(e.z * 2 + 2, child.h); ++cz) {
+			for (uint32_t cx = e.x * 2; cx < (std::min)(e.x * 2 + 2, child.w); ++cx) {
+				if (enter(cl, cx, cz, best, t)) {
+					kids[n++] = {cl, cx, cz, t};
+				}
+			}
+		}
+		// 高々 4 個なので挿入ソート（遠い順）
+		for (int i = 1; i < n; ++i) {
+			const Entry k = kids[i];
+			int j = i;
+			for (; j > 0 && kids[j - 1].t < k.t; --j) {
+				kids[j] = kids[j - 1];
+			}
+			kids[j] = k;
+		}
+		for (int i = 0; i < n && sp < int(std::size(stack)); ++i) {
+			stack[sp++] = kids[i];
+		}
+	}
+
+	if (!found)
+		return false;
+	hit.distance = best;
+	hit.position = origin + d * best;
+	hit.normal = normal;
+	return true;
+}
+
+bool TerrainHeightPyramid::Raycast(const Vector3& origin, const Vector3& dir, float maxDist, TerrainRayHit& hit) const { return Cast(origin, dir, 0.0f, maxDist, hit); }
+
+bool TerrainHeightPyramid::SphereCast(const Vector3& origin, const Vector3& dir, float radius, float maxDist, TerrainRayHit& hit) const {
+	return Cast(origin, dir, (std::max)(radius, 0.0f), maxDist, hit);
+}
+
+} // namespace Engine
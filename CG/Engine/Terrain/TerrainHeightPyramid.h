@@ -0,0 +1,81 @@
+// Engine/Terrain/TerrainHeightPyramid.h
+#pragma once
+// =======================================
+//  TerrainHeightPyramid : 高さキャッシュの min/max ピラミッドと、それを使ったレイ/球キャスト
+//  - レベル 0 は 1 セル（格子点 4 つ）の min/max、上のレベルは 2x2 をまとめたもの
+//  - キャストはピラミッドを上から降りて、当たらないノードは丸ごと飛ばす
+//    （子は入る距離の近い順に見るので、最初に見つかった当たりがほぼ最短）
+//  - 当たり判定はメッシュと同じ三角形 2 枚/セル
+//  - 凹みを入れたら Refit で掛かるノードだけ作り直す
+// =======================================
+#include "Matrix4x4.h"
+#include "TerrainHeight.h"
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+class TerrainHeightField;
+
+// キャストの結果
+struct TerrainRayHit {
+	float distance = 0.0f; // 始点からの距離
+	Vector3 position{};    // 当たった時の位置（球キャストなら球の中心）
+	Vector3 normal{};      // 当たった面の法線（球キャストなら接触点から中心へ）
+};
+
+class TerrainHeightPyramid {
+public:
+	// field の中身から全レベルを作る（field はこのクラスより長生きすること）
+	void Build(const TerrainHeightField* field);
+
+	// 格子点 [x0,x1] x [z0,z1] の高さが変わったときに、掛かるノードだけ作り直す
+	void Refit(uint32_t x0, uint32_t z0, uint32_t x1, uint32_t z1);
+	void RefitDent(const TerrainDent& d);
+
+	// origin から dir（正規化不要）へ maxDist までのレイ。格子の外は見ない
+	bool Raycast(const Vector3& origin, const Vector3& dir, float maxDist, TerrainRayHit& hit) const;
+
+	// 半径 radius の球を動かしたときに最初に地形に触れる位置
+	// 始点で既に重なっている面は無視する（中から外へは抜けられる）
+	bool SphereCast(const Vector3& origin, const Vector3& dir, float radius, float maxDist, TerrainRayHit& hit) const;
+
+	bool IsValid() const { return field_ != nullptr && !levels_.empty(); }
+	uint32_t LevelCount() const { return uint32_t(levels_.size()); }
+
+	// ワールドの XZ 矩形 [x0,x1] x [z0,z1] に掛かるセルの最低の高さ（低めに見積もることはあっても高くはならない）
+	// 矩形が格子からはみ出すなら false（格子の外の地形は分からない）
+	bool MinHeightInRect(float x0, float z0, float x1, float z1, float& lo) const;
+
+	// レベル level のノード (x,z)（セル [x<<level, (x+1)<<level) を覆う）の高さの範囲
+	void NodeMinMax(uint32_t level, uint32_t x, uint32_t z, float& lo, float& hi) const {
+		const Level& lv = levels_[level];
+		const MinMax& m = lv.nodes[size_t(z) * lv.w + x];
+		lo = m.lo;
+		hi = m.hi;
+	}
+
+private:
+	struct MinMax {
+		float lo;
+		float hi;
+	};
+	struct Level {
+		uint32_t w = 0; // ノード数
+		uint32_t h = 0;
+		std::vector<MinMax> nodes;
+	};
+
+	bool Cast(const Vector3& origin, const Vector3& dir, float radius, float maxDist, TerrainRayHit& hit) const;
+
+	// 1 セル（三角形 2 枚）とのキャスト。best より近ければ更新して true
+	bool CastCell(uint32_t ix, uint32_t iz, const Vector3& o, const Vector3& d, float radius, float& best, Vector3& normal) const;
+
+	// レベル 1 以上のノードを下のレベルから作り直す
+	void ReduceRect(uint32_t level, uint32_t x0, uint32_t z0, uint32_t x1, uint32_t z1);
+
+	const TerrainHeightField* field_ = nullptr;
+	std::vector<Level> levels_;
+};
+
+} // namespace Engine
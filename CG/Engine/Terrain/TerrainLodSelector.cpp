@@ -0,0 +1,290 @@
+// Engine/Terrain/TerrainLodSelector.cpp
+#include "TerrainLodSelector.h"
+#include "TerrainHeightField.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+using DirectX::XMFLOAT3;
+using DirectX::XMFLOAT4;
+
+namespace {
+
+// 点と箱の距離の 2 乗
+float DistSqToBox(const XMFLOAT3& p, const XMFLOAT3& lo, const XMFLOAT3& hi) {
+	const float dx = (std::max)((std::max)(lo.x - p.x, 0.0f), p.x - hi.x);
+	const float dy = (std::max)((std::max)(lo.y - p.y, 0.0f), p.y - hi.y);
+	const float dz = (std::max)((std::max)(lo.z - p.z, 0.0f), p.z - hi.z);
+	return dx * dx + dy * dy + dz * dz;
+}
+
+// 値を step の倍数に切り下げ
+uint32_t SnapDown(uint32_t v, uint32_t step) { return v / step * step; }
+
+} // namespace
+
+void TerrainLodSelector::Initialize(const TerrainHeightField* field, const TerrainHeightPyramid* pyramid, const Desc& desc) {
+	field_ = field;
+	pyramid_ = pyramid;
+	desc_ = desc;
+
+	// 葉のセル数は 2 のべき乗に切り下げ
+	leafShift_ = 0;
+	while ((2u << leafShift_) <= (std::max)(desc_.leafCells, 1u)) {
+		++leafShift_;
+	}
+	desc_.leafCells = 1u << leafShift_;
+
+	// 頂点間隔 2^lod が格子を割り切り、ピラミッドにそのレベルがある段までに抑える
+	const uint32_t gridX = field_->GridX();
+	const uint32_t gridZ = field_->GridZ();
+	lodCount_ = 0;
+	while (lodCount_ < (std::max)(desc_.lodCount, 1u)) {
+		const uint32_t step = 1u << lodCount_;
+		if (gridX % step != 0 || gridZ % step != 0 || leafShift_ + lodCount_ >= pyramid_->LevelCount())
+			break;
+		++lodCount_;
+	}
+
+	ranges_.resize(lodCount_);
+	for (uint32_t i = 0; i < lodCount_; ++i) {
+		ranges_[i] = desc_.lod0Range * float(1u << i);
+	}
+
+	leavesX_ = (gridX + desc_.leafCells - 1) >> leafShift_;
+	leavesZ_ = (gridZ + desc_.leafCells - 1) >> leafShift_;
+}
+
+void TerrainLodSelector::MorphRange(uint32_t lod, float& start, float& end) const {
+	end = ranges_[lod];
+	const float prev = lod > 0 ? ranges_[lod - 1] : 0.0f;
+	start = prev + (end - prev) * desc_.morphStartRatio;
+}
+
+void TerrainLodSelector::ExtractFrustumPlanes(DirectX::FXMMATRIX viewProj, XMFLOAT4 planes[6]) {
+	DirectX::XMFLOAT4X4 m;
+	DirectX::XMStoreFloat4x4(&m, viewProj);
+
+	// clip = v * M なので列ベクトルの組み合わせ（内側が正）
+	const XMFLOAT4 c0{m._11, m._21, m._31, m._41};
+	const XMFLOAT4 c1{m._12, m._22, m._32, m._42};
+	const XMFLOAT4 c2{m._13, m._23, m._33, m._43};
+	const XMFLOAT4 c3{m._14, m._24, m._34, m._44};
+	planes[0] = {c3.x + c0.x, c3.y + c0.y, c3.z + c0.z, c3.w + c0.w}; // 左
+	planes[1] = {c3.x - c0.x, c3.y - c0.y, c3.z - c0.z, c3.w - c0.w}; // 右
+	planes[2] = {c3.x + c1.x, c3.y + c1.y, c3.z + c1.z, c3.w + c1.w}; // 下
+	planes[3] = {c3.x - c1.x, c3.y - c1.y, c3.z - c1.z, c3.w - c1.w}; // 上
+	planes[4] = c2;                                                   // 近（z >= 0）
+	planes[5] = {c3.x - c2.x, c3.y - c2.y, c3.z - c2.z, c3.w - c2.w}; // 遠
+}
+
+bool TerrainLodSelector::NodeBox(const Node& n, XMFLOAT3& lo, XMFLOAT3& hi) const {
+	const uint32_t shift = leafShift_ + n.level;
+	const uint32_t cx0 = n.x << shift;
+	const uint32_t cz0 = n.z << shift;
+	if (cx0 >= field_->GridX() || cz0 >= field_->GridZ())
+		return false;
+	const uint32_t cx1 = (std::min)((n.x + 1) << shift, field_->GridX());
+	const uint32_t cz1 = (std::min)((n.z + 1) << shift, field_->GridZ());
+
+	pyramid_->NodeMinMax(shift, n.x, n.z, lo.y, hi.y);
+	lo.x = field_->SampleX(cx0);
+	lo.z = field_->SampleZ(cz0);
+	hi.x = field_->SampleX(cx1);
+	hi.z = field_->SampleZ(cz1);
+	return true;
+}
+
+bool TerrainLodSelector::InFrustum(const XMFLOAT3& lo, const XMFLOAT3& hi) const {
+	if (!planes_)
+		return true;
+	for (int i = 0; i < 6; ++i) {
+		const XMFLOAT4& p = planes_[i];
+		// 平面の法線方向にいちばん進んだ角が外なら箱全体が外
+		const float x = p.x >= 0.0f ? hi.x : lo.x;
+		const float y = p.y >= 0.0f ? hi.y : lo.y;
+		const float z = p.z >= 0.0f ? hi.z : lo.z;
+		if (p.x * x + p.y * y + p.z * z + p.w < 0.0f)
+			return false;
+	}
+	return true;
+}
+
+void TerrainLodSelector::Emit(const Node& n, uint32_t lod, std::vector<TerrainLodPatch>& out) const {
+	const uint32_t shift = leafShift_ + n.level;
+	const uint32_t cx0 = n.x << shift;
+	const uint32_t cz0 = n.z << shift;
+	const uint32_t cx1 = (std::min)((n.x + 1) << shift, field_->GridX());
+	const uint32_t cz1 = (std::min)((n.z + 1) << shift, field_->GridZ());
+
+	TerrainLodPatch p{};
+	p.cellX0 = uint16_t(cx0);
+	p.cellZ0 = uint16_t(cz0);
+	p.cellsX = uint16_t(cx1 - cx0);
+	p.cellsZ = uint16_t(cz1 - cz0);
+	p.lod = uint8_t(lod);
+
+	// パッチ中心の距離で次の LOD への寄り具合（最上段は寄せる先がない）
+	if (lod + 1 < lodCount_) {
+		float lo, hi;
+		pyramid_->NodeMinMax(shift, n.x, n.z, lo, hi);
+		const float dx = 0.5f * (field_->SampleX(cx0) + field_->SampleX(cx1)) - eye_.x;
+		const float dy = 0.5f * (lo + hi) - eye_.y;
+		const float dz = 0.5f * (field_->SampleZ(cz0) + field_->SampleZ(cz1)) - eye_.z;
+		float start, end;
+		MorphRange(lod, start, end);
+		p.morph = std::clamp((std::sqrt(dx * dx + dy * dy + dz * dz) - start) / (end - start), 0.0f, 1.0f);
+	}
+	out.push_back(p);
+}
+
+bool TerrainLodSelector::SelectNode(const Node& n, std::vector<TerrainLodPatch>& out) {
+	XMFLOAT3 lo, hi;
+	if (!NodeBox(n, lo, hi))
+		return true; // 格子の外：描くものはない
+
+	// この LOD の範囲に掛からなければ親の LOD で描いてもらう
+	const float r = ranges_[n.level];
+	if (DistSqToBox(eye_, lo, hi) > r * r)
+		return false;
+
+	if (!InFrustum(lo, hi))
+		return true;
+
+	// 葉、または 1 段細かい範囲に掛からなければこのまま
+	const float rc = n.level > 0 ? ranges_[n.level - 1] : 0.0f;
+	if (n.level == 0 || DistSqToBox(eye_, lo, hi) > rc * rc) {
+		Emit(n, n.level, out);
+		return true;
+	}
+
+	// 子を見る。子の LOD の範囲外の部分はこの LOD で描く
+	for (uint32_t j = 0; j < 2; ++j) {
+		for (uint32_t i = 0; i < 2; ++i) {
+			const Node c{n.x * 2 + i, n.z * 2 + j, n.level - 1};
+			if (!SelectNode(c, out)) {
+				Emit(c, n.level, out);
+			}
+		}
+	}
+	return true;
+}
+
+void TerrainLodSelector::FillEdges(std::vector<TerrainLodPatch>& out) {
+	leafLod_.assign(size_t(leavesX_) * leavesZ_, 0xFF);
+	for (const auto& p : out) {
+		const uint32_t lx0 = p.cellX0 >> leafShift_;
+		const uint32_t lz0 = p.cellZ0 >> leafShift_;
+		const uint32_t lx1 = (p.cellX0 + p.cellsX - 1u) >> leafShift_;
+		const uint32_t lz1 = (p.cellZ0 + p.cellsZ - 1u) >> leafShift_;
+		for (uint32_t z = lz0; z <= lz1; ++z) {
+			for (uint32_t x = lx0; x <= lx1; ++x) {
+				leafLod_[size_t(z) * leavesX_ + x] = p.lod;
+			}
+		}
+	}
+
+	// 辺の外側 1 列の葉のうち、いちばん粗い LOD（描かない葉は無視）
+	auto coarsest = [&](int x0, int z0, int x1, int z1, uint8_t own) {
+		uint8_t m = own;
+		if (x0 < 0 || z0 < 0 || x1 >= int(leavesX_) || z1 >= int(leavesZ_))
+			return m;
+		for (int z = z0; z <= z1; ++z) {
+			for (int x = x0; x <= x1; ++x) {
+				const uint8_t l = leafLod_[size_t(z) * leavesX_ + x];
+				if (l != 0xFF)
+					m = (std::max)(m, l);
+			}
+		}
+		return m;
+	};
+
+	for (auto& p : out) {
+		const int lx0 = p.cellX0 >> leafShift_;
+		const int lz0 = p.cellZ0 >> leafShift_;
+		const int lx1 = (p.cellX0 + p.cellsX - 1) >> leafShift_;
+		const int lz1 = (p.cellZ0 + p.cellsZ - 1) >> leafShift_;
+		p.edgeLod[0] = coarsest(lx0 - 1, lz0, lx0 - 1, lz1, p.lod);
+		p.edgeLod[1] = coarsest(lx1 + 1, lz0, lx1 + 1, lz1, p.lod);
+		p.edgeLod[2] = coarsest(lx0, lz0 - 1, lx1, lz0 - 1, p.lod);
+		p.edgeLod[3] = coarsest(lx0, lz1 + 1, lx1, lz1 + 1, p.lod);
+	}
+}
+
+void TerrainLodSelector::Select(const XMFLOAT3& eye, const XMFLOAT4* planes, std::vector<TerrainLodPatch>& out) {
+	out.clear();
+	if (!field_ || !pyramid_ || !pyramid_->IsValid() || lodCount_ == 0)
+		return;
+
+	eye_ = eye;
+	planes_ = planes;
+
+	// 最上段のノードを並べて、範囲外のものは最上段の LOD のまま描く
+	const uint32_t top = lodCount_ - 1;
+	const uint32_t topCells = desc_.leafCells << top;
+	const uint32_t topX = (field_->GridX() + topCells - 1) / topCells;
+	const uint32_t topZ = (field_->GridZ() + topCells - 1) / topCells;
+	for (uint32_t z = 0; z < topZ; ++z) {
+		for (uint32_t x = 0; x < topX; ++x) {
+			const Node n{x, z, top};
+			XMFLOAT3 lo, hi;
+			if (!SelectNode(n, out) && NodeBox(n, lo, hi) && InFrustum(lo, hi)) {
+				Emit(n, top, out);
+			}
+		}
+	}
+
+	FillEdges(out);
+	planes_ = nullptr;
+}
+
+void TerrainLodSelector::BuildIndices(const std::vector<TerrainLodPatch>& patches, uint32_t gridX, std::vector<uint32_t>& out) {
+	out.clear();
+	const uint32_t stride = gridX + 1;
+
+	for (const auto& p : patches) {
+		const uint32_t s = 1u << p.lod;
+		const uint32_t x0 = p.cellX0;
+		const uint32_t z0 = p.cellZ0;
+		const uint32_t x1 = x0 + p.cellsX;
+		const uint32_t z1 = z0 + p.cellsZ;
+		const uint32_t e[4] = {1u << p.edgeLod[0], 1u << p.edgeLod[1], 1u << p.edgeLod[2], 1u << p.edgeLod[3]};
+
+		// 粗い隣と接する辺の上の頂点は、辺に沿って隣の間隔へ切り下げる
+		auto vertex = [&](uint32_t gx, uint32_t gz) {
+			uint32_t sx = gx;
+			uint32_t sz = gz;
+			if (gx == x0 && e[0] > s)
+				sz = SnapDown(gz, e[0]);
+			else if (gx == x1 && e[1] > s)
+				sz = SnapDown(gz, e[1]);
+			if (gz == z0 && e[2] > s)
+				sx = SnapDown(gx, e[2]);
+			else if (gz == z1 && e[3] > s)
+				sx = SnapDown(gx, e[3]);
+			return sz * stride + sx;
+		};
+		auto tri = [&](uint32_t a, uint32_t b, uint32_t c) {
+			if (a == b || b == c || c == a)
+				return; // 寄せて潰れたものは出さない
+			out.push_back(a);
+			out.push_back(b);
+			out.push_back(c);
+		};
+
+		// 向きはフル解像度のインデックス（TerrainBuildIndices）と同じ
+		for (uint32_t z = z0; z < z1; z += s) {
+			for (uint32_t x = x0; x < x1; x += s) {
+				const uint32_t i00 = vertex(x, z);
+				const uint32_t i10 = vertex(x + s, z);
+				const uint32_t i01 = vertex(x, z + s);
+				const uint32_t i11 = vertex(x + s, z + s);
+				tri(i00, i10, i01);
+				tri(i10, i11, i01);
+			}
+		}
+	}
+}
+
+} // namespace Engine
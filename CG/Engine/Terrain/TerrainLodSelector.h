@@ -0,0 +1,88 @@
+// Engine/Terrain/TerrainLodSelector.h
+#pragma once
+// =======================================
+//  TerrainLodSelector : CDLOD 風の四分木で、カメラ位置と視錐台から描くパッチを選ぶ
+//  - 葉ノード = leafCells 四方のセル。LOD が 1 上がるごとにノードの一辺と頂点間隔が 2 倍
+//    （どの LOD のパッチも leafCells x leafCells の四角形になる）
+//  - LOD i の範囲は lod0Range * 2^i。範囲の外側 morphStartRatio から先で次の LOD へ寄せる
+//  - ノードの高さの範囲は TerrainHeightPyramid から（凹みも反映済み）
+//  - 頂点はフル解像度の頂点バッファを間引いて使う。粗い隣と接する辺は
+//    頂点を隣の間隔に寄せて継ぎ目の隙間をなくす（BuildIndices）
+//  - GPU には触らない（単体で動かして確かめられる）
+// =======================================
+#include "TerrainHeightPyramid.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+class TerrainHeightField;
+
+// 選ばれたパッチ（1 個 20B）
+struct TerrainLodPatch {
+	uint16_t cellX0, cellZ0; // 左下のセル
+	uint16_t cellsX, cellsZ; // セル数（格子の端では切れる）
+	uint8_t lod;             // 0 = フル解像度。頂点間隔は 2^lod セル
+	uint8_t edgeLod[4];      // -X, +X, -Z, +Z 側の隣の LOD（自分より細かい/無い場合は自分と同じ）
+	float morph;             // パッチ中心での次の LOD への寄り具合（0..1）
+};
+
+class TerrainLodSelector {
+public:
+	struct Desc {
+		uint32_t leafCells = 8;        // 葉ノードの一辺のセル数（2 のべき乗）
+		uint32_t lodCount = 5;         // LOD の段数（格子が割り切れる段数までに抑える）
+		float lod0Range = 24.0f;       // LOD 0 で描く距離
+		float morphStartRatio = 0.7f;  // 範囲のこの割合から次の LOD へ寄せ始める
+	};
+
+	void Initialize(const TerrainHeightField* field, const TerrainHeightPyramid* pyramid, const Desc& desc);
+
+	// 視点と視錐台（ExtractFrustumPlanes の 6 面。null なら視錐台カリングなし）からパッチを選ぶ
+	void Select(const DirectX::XMFLOAT3& eye, const DirectX::XMFLOAT4* planes, std::vector<TerrainLodPatch>& out);
+
+	// LOD ごとの寄せ始め/寄せ終わりの距離（VS で頂点ごとに寄せる場合用）
+	void MorphRange(uint32_t lod, float& start, float& end) const;
+
+	uint32_t LodCount() const { return lodCount_; }
+	const Desc& GetDesc() const { return desc_; }
+
+	// view * proj（行ベクトル、DirectX の LH / z 0..1）から内向きの 6 平面
+	static void ExtractFrustumPlanes(DirectX::FXMMATRIX viewProj, DirectX::XMFLOAT4 planes[6]);
+
+	// パッチからフル解像度の頂点バッファ（行優先 gridX+1 個ずつ）を引くインデックスを作る
+	// 粗い隣と接する辺の頂点は隣の間隔に切り下げる（潰れた三角形は出さない）
+	static void BuildIndices(const std::vector<TerrainLodPatch>& patches, uint32_t gridX, std::vector<uint32_t>& out);
+
+private:
+	struct Node {
+		uint32_t x, z;  // 四分木上の位置（レベル内のノード番号）
+		uint32_t level; // = LOD
+	};
+
+	// ノードの箱（XZ はセル範囲を格子で切ったもの、Y は min/max）
+	bool NodeBox(const Node& n, DirectX::XMFLOAT3& lo, DirectX::XMFLOAT3& hi) const;
+	bool InFrustum(const DirectX::XMFLOAT3& lo, const DirectX::XMFLOAT3& hi) const;
+	bool SelectNode(const Node& n, std::vector<TerrainLodPatch>& out);
+	void Emit(const Node& n, uint32_t lod, std::vector<TerrainLodPatch>& out) const;
+	void FillEdges(std::vector<TerrainLodPatch>& out);
+
+	const TerrainHeightField* field_ = nullptr;
+	const TerrainHeightPyramid* pyramid_ = nullptr;
+	Desc desc_{};
+	uint32_t leafShift_ = 3; // log2(leafCells)
+	uint32_t lodCount_ = 0;
+	std::vector<float> ranges_; // LOD ごとの距離
+
+	// 今回の選択の入力
+	DirectX::XMFLOAT3 eye_{};
+	const DirectX::XMFLOAT4* planes_ = nullptr;
+
+	// 葉ごとの LOD（継ぎ目用。0xFF = 描かない）
+	uint32_t leavesX_ = 0;
+	uint32_t leavesZ_ = 0;
+	std::vector<uint8_t> leafLod_;
+};
+
+} // namespace Engine
@@ -0,0 +1,61 @@
+// Engine/Terrain/TerrainMesher.cpp
+#include "TerrainMesher.h"
+#include "TerrainSampler.h"
+
+namespace Engine {
+
+void TerrainMeshChunk(const TerrainMeshDesc& desc, const TerrainChunkRect& chunk, TerrainVertex* vertices) {
+	const float cell = desc.cell;
+	const uint32_t stride = desc.gridX + 1;
+
+	for (uint32_t lz = 0; lz < chunk.vertsZ; ++lz) {
+		for (uint32_t lx = 0; lx < chunk.vertsX; ++lx) {
+			const uint32_t ix = chunk.cellX0 + lx;
+			const uint32_t iz = chunk.cellZ0 + lz;
+
+			// 中心配置（原点センタリング）
+			const float x = ix * cell - 0.5f * desc.gridX * cell;
+			const float z = iz * cell - 0.5f * desc.gridZ * cell;
+
+			// CS と同じく高さと勾配を 1 回で
+			TerrainSample s = TerrainSampleAt(desc.dents, x, z);
+
+			// 変形レイヤーは格子点の値をそのまま（CS と同じ）
+			if (desc.layer && !desc.layer->IsEmpty()) {
+				float gx, gz;
+				desc.layer->GradientAt(ix, iz, gx, gz);
+				s.height += desc.layer->DeltaAt(ix, iz);
+				s.dHdx += gx;
+				s.dHdz += gz;
+			}
+			const Vector3 n = s.Normal();
+
+			TerrainVertex& v = vertices[size_t(iz) * stride + ix];
+			v.pos = {x, s.height, z};
+			v.uv = {float(ix), float(iz)}; // 1セル = UV 1（テクスチャは WRAP）
+			v.nrm = {n.x, n.y, n.z};
+		}
+	}
+}
+
+void TerrainBuildIndices(uint32_t gridX, uint32_t gridZ, uint32_t* out) {
+	const uint32_t stride = gridX + 1;
+	for (uint32_t z = 0; z < gridZ; ++z) {
+		for (uint32_t x = 0; x < gridX; ++x) {
+			const uint32_t i00 = z * stride + x;
+			const uint32_t i10 = i00 + 1;
+			const uint32_t i01 = i00 + stride;
+			const uint32_t i11 = i01 + 1;
+
+			// tri0 (x0,z0)-(x1,z0)-(x0,z1) / tri1 (x1,z0)-(x1,z1)-(x0,z1)
+			*out++ = i00;
+			*out++ = i10;
+			*out++ = i01;
+			*out++ = i10;
+			*out++ = i11;
+			*out++ = i01;
+		}
+	}
+}
+
+} // namespace Engine
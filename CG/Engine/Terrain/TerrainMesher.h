@@ -0,0 +1,40 @@
+// Engine/Terrain/TerrainMesher.h
+#pragma once
+// =======================================
+//  TerrainMesher : Voxel CS と同じ頂点を CPU で作る参照実装
+//  - GPU 出力との突き合わせ / 再生成コストの計測用
+//  - 頂点は格子点ごとに 1 個（行優先 (gridX+1) 個ずつ）、インデックスは固定
+// =======================================
+#include "TerrainChunkGrid.h"
+#include "TerrainDeformationLayer.h"
+#include "TerrainDentGrid.h"
+#include "TerrainHeight.h"
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace Engine {
+
+// CS の VOut と同じレイアウト（32B）
+struct TerrainVertex {
+	DirectX::XMFLOAT3 pos;
+	DirectX::XMFLOAT2 uv;
+	DirectX::XMFLOAT3 nrm;
+};
+static_assert(sizeof(TerrainVertex) == 32, "TerrainVertex must match VOut");
+
+// 地形全体の形（CS の CB と同じ値を渡す）
+struct TerrainMeshDesc {
+	uint32_t gridX = 0;
+	uint32_t gridZ = 0;
+	float cell = 1.0f;
+	const TerrainDentGrid* dents = nullptr;         // null なら凹みなし
+	const TerrainDeformationLayer* layer = nullptr; // null なら変形レイヤーなし
+};
+
+// チャンクが担当する格子点（vertsX * vertsZ 個）を地形全体の頂点配列 vertices に書く
+void TerrainMeshChunk(const TerrainMeshDesc& desc, const TerrainChunkRect& chunk, TerrainVertex* vertices);
+
+// 地形全体のインデックス（gridX * gridZ * 6 個）を out に書く。高さに依存しないので 1 回だけでよい
+void TerrainBuildIndices(uint32_t gridX, uint32_t gridZ, uint32_t* out);
+
+} // namespace Engine
@@ -0,0 +1,76 @@
+// Engine/Terrain/TerrainSampler.cpp
+#include "TerrainSampler.h"
+
+namespace Engine {
+
+namespace {
+
+// ベース地形を 4 点同時に（TerrainBaseSample と同じ式）
+void BaseSample4(FXMVECTOR x, FXMVECTOR z, XMVECTOR& h, XMVECTOR& dhdx, XMVECTOR& dhdz) {
+	using namespace TerrainShape;
+
+	const XMVECTOR r2 = XMVectorAdd(XMVectorMultiply(x, x), XMVectorMultiply(z, z));
+	const XMVECTOR r = XMVectorSqrt(r2);
+
+	// 穴：floor + (ring - floor) * (r / pitR)^2、勾配係数は定数
+	const XMVECTOR t = XMVectorDivide(r, XMVectorReplicate(kPitRadius));
+	const XMVECTOR hPit = XMVectorMultiplyAdd(XMVectorReplicate(kRingY - kPitFloorY), XMVectorMultiply(t, t), XMVectorReplicate(kPitFloorY));
+	const XMVECTOR kPit = XMVectorReplicate(2.0f * (kRingY - kPitFloorY) / (kPitRadius * kPitRadius));
+
+	// 外側：ring → outerBase へ線形、勾配は傾き / r（r >= outerR なので 0 割りなし）
+	const XMVECTOR slope = XMVectorReplicate((kOuterBaseY - kRingY) / kOuterBlendWidth);
+	const XMVECTOR tOut = XMVectorSaturate(XMVectorMultiply(XMVectorSubtract(r, XMVectorReplicate(kOuterRingRadius)), XMVectorReplicate(1.0f / kOuterBlendWidth)));
+	const XMVECTOR hOut = XMVectorMultiplyAdd(XMVectorReplicate(kOuterBaseY - kRingY), tOut, XMVectorReplicate(kRingY));
+	const XMVECTOR rSafe = XMVectorMax(r, XMVectorReplicate(kOuterRingRadius));
+	const XMVECTOR onRamp = XMVectorAndInt(XMVectorGreater(r, XMVectorReplicate(kOuterRingRadius)), XMVectorLess(r, XMVectorReplicate(kOuterRingRadius + kOuterBlendWidth)));
+	const XMVECTOR kOut = XMVectorSelect(XMVectorZero(), XMVectorDivide(slope, rSafe), onRamp);
+
+	// 区間ごとに選ぶ（枠の上は高さ ring、勾配 0）
+	const XMVECTOR inPit = XMVectorLess(r, XMVectorReplicate(kPitRadius));
+	const XMVECTOR inRing = XMVectorLess(r, XMVectorReplicate(kOuterRingRadius));
+	h = XMVectorSelect(XMVectorSelect(hOut, XMVectorReplicate(kRingY), inRing), hPit, inPit);
+	const XMVECTOR k = XMVectorSelect(XMVectorSelect(kOut, XMVectorZero(), inRing), kPit, inPit);
+	dhdx = XMVectorMultiply(k, x);
+	dhdz = XMVectorMultiply(k, z);
+}
+
+} // namespace
+
+void TerrainSampleBatch(const TerrainDentGrid* dents, const float* xs, const float* zs, size_t count, TerrainSample* out, const TerrainDeformationLayer* layer) {
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const XMVECTOR x = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(xs + i));
+		const XMVECTOR z = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(zs + i));
+
+		XMVECTOR h, dhdx, dhdz;
+		BaseSample4(x, z, h, dhdx, dhdz);
+
+		XMFLOAT4 hh, gx, gz;
+		XMStoreFloat4(&hh, h);
+		XMStoreFloat4(&gx, dhdx);
+		XMStoreFloat4(&gz, dhdz);
+		out[i + 0] = {hh.x, gx.x, gz.x};
+		out[i + 1] = {hh.y, gx.y, gz.y};
+		out[i + 2] = {hh.z, gx.z, gz.z};
+		out[i + 3] = {hh.w, gx.w, gz.w};
+
+		// 変形レイヤー/凹みは点ごとに参照先が違うのでスカラーで
+		if (layer && !layer->IsEmpty()) {
+			for (size_t k = i; k < i + 4; ++k) {
+				layer->Accumulate(xs[k], zs[k], out[k]);
+			}
+		}
+		if (dents) {
+			for (size_t k = i; k < i + 4; ++k) {
+				dents->Accumulate(xs[k], zs[k], out[k]);
+			}
+		}
+	}
+
+	// 端数
+	for (; i < count; ++i) {
+		out[i] = TerrainSampleAt(dents, xs[i], zs[i], layer);
+	}
+}
+
+} // namespace Engine
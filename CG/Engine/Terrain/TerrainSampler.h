@@ -0,0 +1,33 @@
+// Engine/Terrain/TerrainSampler.h
+#pragma once
+// =======================================
+//  TerrainSampler : 地形の高さ + 勾配をまとめて引く
+//  - 勾配は解析解なので中心差分の追加サンプルがいらない
+//  - バッチ版はベース地形を 4 点ずつ DirectXMath（SSE）で計算し、
+//    凹みは各点のセルに載っているものだけ足す
+//  - パーティクル / 敵 / カメラのプローブなど、点が多いとき用
+//  - 変形レイヤー（保存/読み込みした差分）があればそれも足す
+// =======================================
+#include "TerrainDeformationLayer.h"
+#include "TerrainDentGrid.h"
+#include "TerrainHeight.h"
+#include <cstddef>
+
+namespace Engine {
+
+// 1 点ぶん（dents / layer が null ならその分はなし）
+inline TerrainSample TerrainSampleAt(const TerrainDentGrid* dents, float x, float z, const TerrainDeformationLayer* layer = nullptr) {
+	TerrainSample s = TerrainBaseSample(x, z);
+	if (layer) {
+		layer->Accumulate(x, z, s);
+	}
+	if (dents) {
+		dents->Accumulate(x, z, s);
+	}
+	return s;
+}
+
+// count 点ぶん。xs/zs/out のアラインは不要
+void TerrainSampleBatch(const TerrainDentGrid* dents, const float* xs, const float* zs, size_t count, TerrainSample* out, const TerrainDeformationLayer* layer = nullptr);
+
+} // namespace Engine
@@ -0,0 +1,144 @@
+// Engine/Terrain/TerrainSplatBaker.cpp
+#include "TerrainSplatBaker.h"
+#include "TerrainSampler.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace Engine {
+
+namespace {
+
+// これより少ない行数ならスレッドを立てない
+constexpr uint32_t kMinRowsPerThread = 16;
+
+float Smoothstep(float e0, float e1, float x) {
+	const float t = std::clamp((x - e0) / (e1 - e0), 0.0f, 1.0f);
+	return t * t * (3.0f - 2.0f * t);
+}
+
+} // namespace
+
+void TerrainSplatBaker::Initialize(uint32_t gridX, uint32_t gridZ, float cell) {
+	width_ = gridX;
+	height_ = gridZ;
+	cell_ = cell;
+	originX_ = -0.5f * gridX * cell;
+	originZ_ = -0.5f * gridZ * cell;
+	texels_.assign(size_t(width_) * height_, 0);
+	dirty_.clear();
+}
+
+uint32_t TerrainSplatBaker::Weights(float height, float slope, const Rule& rule) {
+	// 高さの帯（今までのピクセルシェーダと同じ分け方）
+	float rock = 1.0f - Smoothstep(rule.rockEnd - rule.bandBlend, rule.rockEnd + rule.bandBlend, height);
+	float grass = Smoothstep(rule.dirtEnd - rule.bandBlend, rule.dirtEnd + rule.bandBlend, height);
+	float dirt = std::clamp(1.0f - rock - grass, 0.0f, 1.0f);
+
+	// 急な斜面は岩に寄せる
+	const float steep = Smoothstep(rule.slopeRockStart, rule.slopeRockFull, slope);
+	rock = rock + (1.0f - rock) * steep;
+	grass *= 1.0f - steep;
+	dirt *= 1.0f - steep;
+
+	// 合計がちょうど 255 になるように量子化（残りは岩）
+	const float sum = rock + grass + dirt + 1e-5f;
+	const uint32_t r = uint32_t(std::lround(dirt / sum * 255.0f));
+	const uint32_t g = (std::min)(uint32_t(std::lround(grass / sum * 255.0f)), 255u - r);
+	const uint32_t b = 255u - r - g;
+	return r | (g << 8) | (b << 16);
+}
+
+void TerrainSplatBaker::BakeRows(const Rect& r, uint32_t zBegin, uint32_t zEnd, const TerrainDentGrid* dents, const TerrainDeformationLayer* layer) {
+	const uint32_t w = r.x1 - r.x0 + 1;
+	std::vector<float> xs(w), zs(w);
+	std::vector<TerrainSample> s(w);
+	for (uint32_t x = 0; x < w; ++x) {
+		xs[x] = originX_ + (float(r.x0 + x) + 0.5f) * cell_;
+	}
+
+	for (uint32_t z = zBegin; z < zEnd; ++z) {
+		std::fill(zs.begin(), zs.end(), originZ_ + (float(z) + 0.5f) * cell_);
+		TerrainSampleBatch(dents, xs.data(), zs.data(), w, s.data(), layer);
+
+		uint32_t* row = &texels_[size_t(z) * width_ + r.x0];
+		for (uint32_t x = 0; x < w; ++x) {
+			const float slope = std::sqrt(s[x].dHdx * s[x].dHdx + s[x].dHdz * s[x].dHdz);
+			row[x] = Weights(s[x].height, slope, rule_);
+		}
+	}
+}
+
+void TerrainSplatBaker::BakeRect(const Rect& r, const TerrainDentGrid* dents, const TerrainDeformationLayer* layer, uint32_t threads) {
+	if (texels_.empty() || r.x0 > r.x1 || r.z0 > r.z1 || r.x1 >= width_ || r.z1 >= height_)
+		return;
+
+	// 行をスレッドに分ける（各スレッドは別の行にしか書かない）
+	const uint32_t rows = r.z1 - r.z0 + 1;
+	if (threads == 0) {
+		threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+	}
+	threads = std::clamp(rows / kMinRowsPerThread, 1u, threads);
+
+	if (threads == 1) {
+		BakeRows(r, r.z0, r.z1 + 1, dents, layer);
+	} else {
+		std::vector<std::thread> workers;
+		workers.reserve(threads - 1);
+		const uint32_t per = (rows + threads - 1) / threads;
+		for (uint32_t i = 1; i < threads; ++i) {
+			const uint32_t zb = r.z0 + i * per;
+			const uint32_t ze = (std::min)(zb + per, r.z1 + 1);
+			if (zb < ze) {
+				workers.emplace_back([this, &r, zb, ze, dents, layer] { BakeRows(r, zb, ze, dents, layer); });
+			}
+		}
+		BakeRows(r, r.z0, (std::min)(r.z0 + per, r.z1 + 1), dents, layer);
+		for (auto& t : workers) {
+			t.join();
+		}
+	}
+
+	PushDirty(r);
+}
+
+void TerrainSplatBaker::BakeAll(const TerrainDentGrid* dents, const TerrainDeformationLayer* layer, uint32_t threads) {
+	if (texels_.empty())
+		return;
+	dirty_.clear();
+	BakeRect({0, 0, width_ - 1, height_ - 1}, dents, layer, threads);
+}
+
+void TerrainSplatBaker::BakeDent(const TerrainDent& d, const TerrainDentGrid* dents, const TerrainDeformationLayer* layer) {
+	if (texels_.empty() || d.radius <= 0.0f)
+		return;
+
+	// テクセル中心が半径に入る範囲（外側は高さも勾配も変わらない）
+	const int x0 = int(std::ceil((d.centerXZ.x - d.radius - originX_) / cell_ - 0.5f));
+	const int x1 = int(std::floor((d.centerXZ.x + d.radius - originX_) / cell_ - 0.5f));
+	const int z0 = int(std::ceil((d.centerXZ.y - d.radius - originZ_) / cell_ - 0.5f));
+	const int z1 = int(std::floor((d.centerXZ.y + d.radius - originZ_) / cell_ - 0.5f));
+	if (x1 < 0 || z1 < 0 || x0 >= int(width_) || z0 >= int(height_) || x0 > x1 || z0 > z1)
+		return;
+
+	Rect r;
+	r.x0 = uint32_t((std::max)(x0, 0));
+	r.z0 = uint32_t((std::max)(z0, 0));
+	r.x1 = uint32_t((std::min)(x1, int(width_) - 1));
+	r.z1 = uint32_t((std::min)(z1, int(height_) - 1));
+	BakeRect(r, dents, layer);
+}
+
+void TerrainSplatBaker::PushDirty(const Rect& r) {
+	// 全面が入っていれば足すものはない
+	if (!dirty_.empty() && dirty_.front().x0 == 0 && dirty_.front().z0 == 0 && dirty_.front().x1 == width_ - 1 && dirty_.front().z1 == height_ - 1)
+		return;
+	dirty_.push_back(r);
+}
+
+void TerrainSplatBaker::TakeDirty(std::vector<Rect>& out) {
+	out.swap(dirty_);
+	dirty_.clear();
+}
+
+} // namespace Engine
@@ -0,0 +1,75 @@
+// Engine/Terrain/TerrainSplatBaker.h
+#pragma once
+// =======================================
+//  TerrainSplatBaker : 地形の高さと傾きから「どのテクスチャをどれだけ使うか」を焼く
+//  - 1 セル = 1 テクセル（中心はセルの中央）。RGBA8 の R=土, G=草, B=岩, A=予備
+//  - 高さと勾配は Voxel CS と同じ式（ベース + 凹み + 変形レイヤー）
+//  - 全面は行を分けてマルチスレッドで、凹みの後はその下だけ焼き直す
+//  - 焼いた範囲は TakeDirty で取り出してテクスチャに上げる
+// =======================================
+#include "TerrainHeight.h"
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+class TerrainDentGrid;
+class TerrainDeformationLayer;
+
+class TerrainSplatBaker {
+public:
+	// 重みの決め方（高さの帯 + 斜面は岩）
+	struct Rule {
+		float rockEnd = -2.0f;       // これより低いと岩
+		float dirtEnd = 1.0f;        // これより高いと草
+		float bandBlend = 0.5f;      // 帯の境目のぼかし幅（片側）
+		float slopeRockStart = 0.7f; // 勾配（tan）がここを超えると岩が混ざり始める
+		float slopeRockFull = 1.2f;  // ここで岩だけになる
+	};
+
+	// テクセルの範囲（両端含む）
+	struct Rect {
+		uint32_t x0, z0, x1, z1;
+	};
+
+	// gridX/gridZ はセル数（= テクセル数）
+	void Initialize(uint32_t gridX, uint32_t gridZ, float cell);
+	void SetRule(const Rule& rule) { rule_ = rule; }
+
+	// 全面を焼く。threads = 0 ならハードウェアスレッド数
+	void BakeAll(const TerrainDentGrid* dents, const TerrainDeformationLayer* layer, uint32_t threads = 0);
+
+	// 凹みの下だけ焼き直す（掛からなければ何もしない）
+	void BakeDent(const TerrainDent& d, const TerrainDentGrid* dents, const TerrainDeformationLayer* layer);
+
+	// 範囲を焼く。小さい範囲は呼んだスレッドだけで
+	void BakeRect(const Rect& r, const TerrainDentGrid* dents, const TerrainDeformationLayer* layer, uint32_t threads = 0);
+
+	// 前回から焼いた範囲を取り出す（テクスチャ更新用）
+	void TakeDirty(std::vector<Rect>& out);
+
+	// 高さと勾配（tan）から RGBA8（R=土, G=草, B=岩, 合計 255）
+	static uint32_t Weights(float height, float slope, const Rule& rule);
+
+	uint32_t Width() const { return width_; }
+	uint32_t Height() const { return height_; }
+	const std::vector<uint32_t>& Texels() const { return texels_; }
+	uint32_t Texel(uint32_t x, uint32_t z) const { return texels_[size_t(z) * width_ + x]; }
+	const Rule& GetRule() const { return rule_; }
+
+private:
+	void BakeRows(const Rect& r, uint32_t zBegin, uint32_t zEnd, const TerrainDentGrid* dents, const TerrainDeformationLayer* layer);
+	void PushDirty(const Rect& r);
+
+	uint32_t width_ = 0;
+	uint32_t height_ = 0;
+	float cell_ = 1.0f;
+	float originX_ = 0.0f; // テクセル (0,0) の左下のワールド座標
+	float originZ_ = 0.0f;
+	Rule rule_{};
+
+	std::vector<uint32_t> texels_;
+	std::vector<Rect> dirty_;
+};
+
+} // namespace Engine
@@ -1,37 +1,42 @@
 // TerrainManager.h
 #pragma once
-#include "Renderer.h"
+#include "Matrix4x4.h"
+#include "Terrain/TerrainChunkStreamer.h"
 #include <DirectXMath.h>
 
 namespace Engine {
 
+class Renderer;
+
+// =======================================
+//  TerrainManager : プレイヤーの周りの地形チャンクをストリーミングする
+//  - ボクセル地形（Renderer の 400x400 格子）の中は凹み込みの高さキャッシュを優先
+//  - その外は TerrainChunkStreamer が別スレッドで作ったチャンクから答える
+//  - どちらにも無ければベース地形の解析値
+//  ※ 今のステージは格子の外がベース地形（平ら）だけで、外側を描く仕組みもまだ無いので GameScene では動かしていない
+//    格子の外に地形を作る/描く段になったら、その生成関数を Desc と一緒に渡して使う
+// =======================================
 class TerrainManager {
 public:
-	struct Desc {
-		UINT chunkX = 64;
-		UINT chunkZ = 64;
-		UINT chunkCountX = 1;
-		UINT chunkCountZ = 1;
-		float cell = 1.0f;
-		float chunkSizeX = 64.0f;
-		float chunkSizeZ = 64.0f;
-		DirectX::XMFLOAT2 worldCenter{0.0f, 0.0f};
-	};
+	using Desc = TerrainChunkStreamer::Desc;
 
 public:
+	// renderer は省略可（ヘッドレスではチャンクとベース地形だけで答える）
 	void Initialize(Renderer* renderer, const Desc& desc);
+	void Shutdown();
 	void Update(const DirectX::XMFLOAT3& playerPos);
 	float HeightAt(float x, float z) const;
 	Vector3 NormalAt(float x, float z) const;
 
-	const Desc& GetDesc() const { return desc_; }
+	const Desc& GetDesc() const { return streamer_.GetDesc(); }
+	const TerrainChunkStreamer::Stats& GetStats() const { return streamer_.GetStats(); }
 
 private:
-	Renderer* renderer_ = nullptr;
-	Desc desc_{};
+	// ボクセル地形の格子内なら Renderer に聞く
+	bool InVoxelGrid(float x, float z) const;
 
-	// いま中心にしているチャンク座標（チャンク単位のインデックス）
-	DirectX::XMINT2 centerChunk_{0, 0};
+	Renderer* renderer_ = nullptr;
+	TerrainChunkStreamer streamer_;
 };
 
 } // namespace Engine
@@ -0,0 +1,408 @@
+// Engine/Water/OceanFFT.cpp
+#include "OceanFFT.h"
+#include "WaterParallel.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace Engine {
+
+using namespace DirectX;
+
+namespace {
+
+constexpr float kGravity = 9.81f;
+constexpr float kPi = 3.14159265358979f;
+
+// これより少ない行数ならスレッドを立てない
+constexpr uint32_t kMinLinesPerThread = 32;
+
+// 列方向の変換で一度に通す列数
+constexpr uint32_t kColumnTile = 64;
+
+} // namespace
+
+bool OceanFFT::Initialize(const Desc& desc) {
+	n_ = 0;
+	const uint32_t n = desc.resolution;
+	if (n < 16 || n > 1024 || (n & (n - 1)) != 0 || desc.patchSize <= 0.0f)
+		return false;
+	desc_ = desc;
+	log2n_ = 0;
+	while ((1u << log2n_) < n) {
+		++log2n_;
+	}
+
+	// 波数（自然順）
+	kx_.resize(n);
+	for (uint32_t m = 0; m < n; ++m) {
+		const int i = m < n / 2 ? int(m) : int(m) - int(n);
+		kx_[m] = 2.0f * kPi * float(i) / desc_.patchSize;
+	}
+	kz_ = kx_;
+
+	// ビット反転と回転因子（逆変換なので e^{+iθ}）
+	bitrev_.resize(n);
+	for (uint32_t i = 0; i < n; ++i) {
+		uint32_t r = 0;
+		for (uint32_t b = 0; b < log2n_; ++b) {
+			r |= ((i >> b) & 1u) << (log2n_ - 1 - b);
+		}
+		bitrev_[i] = r;
+	}
+	twRe_.resize(n - 1);
+	twIm_.resize(n - 1);
+	for (uint32_t half = 1; half < n; half <<= 1) {
+		for (uint32_t j = 0; j < half; ++j) {
+			const double a = kPi * double(j) / double(half);
+			twRe_[half - 1 + j] = float(std::cos(a));
+			twIm_[half - 1 + j] = float(std::sin(a));
+		}
+	}
+
+	// 初期スペクトル h0 = ξ * √(P/2)（ξ は複素正規乱数）
+	const size_t count = size_t(n) * n;
+	h0Re_.assign(count, 0.0f);
+	h0Im_.assign(count, 0.0f);
+	omega_.assign(count, 0.0f);
+	std::mt19937 rng(desc_.seed);
+	std::normal_distribution<float> gauss(0.0f, 1.0f);
+	double sum = 0.0;
+	for (uint32_t x = 0; x < n; ++x) {
+		for (uint32_t z = 0; z < n; ++z) {
+			const size_t i = size_t(x) * n + z;
+			const float xr = gauss(rng);
+			const float xi = gauss(rng);
+			// ナイキスト（-n/2）は -k が自分自身になって実数にできないので使わない。k = 0 も無し
+			if (x == n / 2 || z == n / 2 || (x == 0 && z == 0))
+				continue;
+			const float kx = kx_[x];
+			const float kz = kz_[z];
+			const float a = std::sqrt(0.5f * SpectrumAt(kx, kz));
+			h0Re_[i] = xr * a;
+			h0Im_[i] = xi * a;
+			omega_[i] = std::sqrt(kGravity * std::sqrt(kx * kx + kz * kz));
+			sum += double(h0Re_[i]) * h0Re_[i] + double(h0Im_[i]) * h0Im_[i];
+		}
+	}
+
+	// 高さの分散の期待値は 2Σ|h0|²。有義波高 = 4σ になるように振幅をそろえる
+	const double scale = sum > 0.0 ? (desc_.waveHeight * 0.25) / std::sqrt(2.0 * sum) : 0.0;
+	for (size_t i = 0; i < count; ++i) {
+		h0Re_[i] = float(h0Re_[i] * scale);
+		h0Im_[i] = float(h0Im_[i] * scale);
+	}
+	expectedVariance_ = 0.0;
+	for (size_t i = 0; i < count; ++i) {
+		expectedVariance_ += 2.0 * (double(h0Re_[i]) * h0Re_[i] + double(h0Im_[i]) * h0Im_[i]);
+	}
+
+	// h0(-k) を k の位置に並べ替えておく（毎フレームの計算を連続アクセスにする）と 1/|k|
+	h0mRe_.resize(count);
+	h0mIm_.resize(count);
+	invK_.resize(count);
+	for (uint32_t x = 0; x < n; ++x) {
+		for (uint32_t z = 0; z < n; ++z) {
+			const size_t i = size_t(x) * n + z;
+			const size_t im = size_t((n - x) & (n - 1)) * n + ((n - z) & (n - 1));
+			h0mRe_[i] = h0Re_[im];
+			h0mIm_[i] = h0Im_[im];
+			const float k = std::sqrt(kx_[x] * kx_[x] + kz_[z] * kz_[z]);
+			invK_[i] = k > 0.0f ? 1.0f / k : 0.0f;
+		}
+	}
+
+	for (uint32_t p = 0; p < kPlanes; ++p) {
+		re_[p].assign(count, 0.0f);
+		im_[p].assign(count, 0.0f);
+		tre_[p].assign(count, 0.0f);
+		tim_[p].assign(count, 0.0f);
+	}
+	disp_.assign(count, XMFLOAT4(0, 0, 0, 0));
+	normal_.assign(count, XMFLOAT4(0, 1, 0, 1));
+	rowEnergy_.assign(n, 0.0);
+	rowMax_.assign(n, XMFLOAT2(0.0f, 0.0f));
+	spectrumEnergy_ = 0.0;
+
+	// 一番細かく分ける段でも kMinLinesPerThread 行ずつになる本数まで
+	const uint32_t hw = (std::max)(std::thread::hardware_concurrency(), 1u);
+	pool_.Start(std::clamp(n / kMinLinesPerThread, 1u, desc_.threads == 0 ? hw : desc_.threads));
+
+	n_ = n;
+	return true;
+}
+
+float OceanFFT::SpectrumAt(float kx, float kz) const {
+	const float k2 = kx * kx + kz * kz;
+	const float k = std::sqrt(k2);
+	float wx = desc_.windDir.x, wz = desc_.windDir.y;
+	const float wl = std::sqrt(wx * wx + wz * wz);
+	wx = wl > 0.0f ? wx / wl : 1.0f;
+	wz = wl > 0.0f ? wz / wl : 0.0f;
+	const float cosT = (kx * wx + kz * wz) / k;
+	const float V = (std::max)(desc_.windSpeed, 0.1f);
+
+	if (desc_.spectrum == Spectrum::Phillips) {
+		// P = exp(-1/(kL)²) / k⁴ * (k̂・ŵ)² * exp(-(kl)²)、L = V²/g、l = L/1000
+		const float L = V * V / kGravity;
+		const float l = L * 0.001f;
+		float p = std::exp(-1.0f / (k2 * L * L)) / (k2 * k2) * cosT * cosT * std::exp(-k2 * l * l);
+		if (cosT < 0.0f) {
+			p *= 0.07f; // 風上へ向かう波は弱く
+		}
+		return p;
+	}
+
+	// JONSWAP S(ω) を方向分布 (2/π)cos²θ と dω/dk = g/(2ω) で k 平面へ
+	const float F = (std::max)(desc_.fetch, 1.0f);
+	const float omega = std::sqrt(kGravity * k);
+	const float wp = 22.0f * std::cbrt(kGravity * kGravity / (V * F));
+	const float sigma = omega <= wp ? 0.07f : 0.09f;
+	const float r = std::exp(-(omega - wp) * (omega - wp) / (2.0f * sigma * sigma * wp * wp));
+	const float s = kGravity * kGravity / std::pow(omega, 5.0f) * std::exp(-1.25f * std::pow(wp / omega, 4.0f)) * std::pow(desc_.peakGamma, r);
+	const float dir = cosT > 0.0f ? (2.0f / kPi) * cosT * cosT : 0.0f;
+	return s * dir * (kGravity / (2.0f * omega)) / k;
+}
+
+void OceanFFT::BuildSpectrumRows(uint32_t xBegin, uint32_t xEnd, float time) {
+	// スペクトルは [kx][kz] の並び（1 行 = kx 1 つ）
+	const uint32_t n = n_;
+	const XMVECTOR vt = XMVectorReplicate(time);
+	for (uint32_t x = xBegin; x < xEnd; ++x) {
+		const size_t row = size_t(x) * n;
+		const XMVECTOR kx = XMVectorReplicate(kx_[x]);
+		XMVECTOR energy = XMVectorZero();
+
+		// n >= 16 なので 4 の倍数ずつで割り切れる
+		for (uint32_t z = 0; z < n; z += 4) {
+			const size_t i = row + z;
+			auto load = [i](const std::vector<float>& v) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&v[i])); };
+			auto store = [i](std::vector<float>& v, FXMVECTOR a) { XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&v[i]), a); };
+
+			XMVECTOR s, c;
+			XMVectorSinCos(&s, &c, XMVectorMultiply(load(omega_), vt));
+
+			// h = h0(k) e^{iωt} + conj(h0(-k)) e^{-iωt}（ω(-k) = ω(k)、h0(-k) は並べ替え済み）
+			const XMVECTOR ar = load(h0Re_), ai = load(h0Im_);
+			const XMVECTOR br = load(h0mRe_), bi = load(h0mIm_);
+			const XMVECTOR hr = XMVectorAdd(XMVectorSubtract(XMVectorMultiply(ar, c), XMVectorMultiply(ai, s)), XMVectorSubtract(XMVectorMultiply(br, c), XMVectorMultiply(bi, s)));
+			const XMVECTOR hi = XMVectorSubtract(XMVectorAdd(XMVectorMultiply(ar, s), XMVectorMultiply(ai, c)), XMVectorAdd(XMVectorMultiply(br, s), XMVectorMultiply(bi, c)));
+			energy = XMVectorAdd(energy, XMVectorAdd(XMVectorMultiply(hr, hr), XMVectorMultiply(hi, hi)));
+
+			// 横ずれ D = i k̂ h（波頭へ寄せる向き。h = A cos(kx) なら D = -A sin(kx)）、傾き = i k h
+			// ヤコビアン用の ∂D/∂ = i k D = -(k k / |k|) h
+			const XMVECTOR kz = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&kz_[z]));
+			const XMVECTOR ik = load(invK_);
+			const XMVECTOR ux = XMVectorMultiply(kx, ik), uz = XMVectorMultiply(kz, ik);
+			const XMVECTOR dxr = XMVectorNegate(XMVectorMultiply(ux, hi)), dxi = XMVectorMultiply(ux, hr);
+			const XMVECTOR dzr = XMVectorNegate(XMVectorMultiply(uz, hi)), dzi = XMVectorMultiply(uz, hr);
+			const XMVECTOR sxr = XMVectorNegate(XMVectorMultiply(kx, hi)), sxi = XMVectorMultiply(kx, hr);
+			const XMVECTOR szr = XMVectorNegate(XMVectorMultiply(kz, hi)), szi = XMVectorMultiply(kz, hr);
+			const XMVECTOR jxx = XMVectorNegate(XMVectorMultiply(kx, ux)), jzz = XMVectorNegate(XMVectorMultiply(kz, uz)), jxz = XMVectorNegate(XMVectorMultiply(kx, uz));
+
+			// P = X + iY（X, Y の逆変換がどちらも実数なので、結果の実部 = x, 虚部 = y）
+			auto pack = [&](uint32_t p, FXMVECTOR xr, FXMVECTOR xi, FXMVECTOR yr, FXMVECTOR yi) {
+				store(re_[p], XMVectorSubtract(xr, yi));
+				store(im_[p], XMVectorAdd(xi, yr));
+			};
+			pack(0, hr, hi, dxr, dxi);
+			pack(1, dzr, dzi, sxr, sxi);
+			pack(2, szr, szi, XMVectorMultiply(jxx, hr), XMVectorMultiply(jxx, hi));
+			pack(3, XMVectorMultiply(jzz, hr), XMVectorMultiply(jzz, hi), XMVectorMultiply(jxz, hr), XMVectorMultiply(jxz, hi));
+		}
+
+		XMFLOAT4 e;
+		XMStoreFloat4(&e, energy);
+		rowEnergy_[x] = double(e.x) + e.y + e.z + e.w;
+	}
+}
+
+void OceanFFT::TransformColumns(Planes& planeRe, Planes& planeIm, uint32_t xBegin, uint32_t xEnd) {
+	// 列方向は行どうしのバタフライなので、隣り合う 4 列ずつ SSE で（行はメモリ上で連続）
+	// kColumnTile 列ずつ全段を通す（その幅 x n 行 x 2 がキャッシュに収まる程度）
+	const uint32_t n = n_;
+	for (uint32_t x0 = xBegin; x0 < xEnd; x0 += kColumnTile) {
+		const uint32_t x1 = (std::min)(x0 + kColumnTile, xEnd);
+		for (uint32_t p = 0; p < kPlanes; ++p) {
+			float* re = planeRe[p].data();
+			float* im = planeIm[p].data();
+
+			for (uint32_t z = 0; z < n; ++z) {
+				const uint32_t j = bitrev_[z];
+				if (z < j) {
+					std::swap_ranges(re + size_t(z) * n + x0, re + size_t(z) * n + x1, re + size_t(j) * n + x0);
+					std::swap_ranges(im + size_t(z) * n + x0, im + size_t(z) * n + x1, im + size_t(j) * n + x0);
+				}
+			}
+
+			for (uint32_t half = 1; half < n; half <<= 1) {
+				for (uint32_t base = 0; base < n; base += 2 * half) {
+					for (uint32_t j = 0; j < half; ++j) {
+						const float wr = twRe_[half - 1 + j];
+						const float wi = twIm_[half - 1 + j];
+						float* ar = re + size_t(base + j) * n;
+						float* ai = im + size_t(base + j) * n;
+						float* br = ar + size_t(half) * n;
+						float* bi = ai + size_t(half) * n;
+
+						const XMVECTOR vwr = XMVectorReplicate(wr);
+						const XMVECTOR vwi = XMVectorReplicate(wi);
+						uint32_t x = x0;
+						for (; x + 4 <= x1; x += 4) {
+							const XMVECTOR vbr = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(br + x));
+							const XMVECTOR vbi = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(bi + x));
+							const XMVECTOR var = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(ar + x));
+							const XMVECTOR vai = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(ai + x));
+							const XMVECTOR tr = XMVectorSubtract(XMVectorMultiply(vbr, vwr), XMVectorMultiply(vbi, vwi));
+							const XMVECTOR ti = XMVectorAdd(XMVectorMultiply(vbr, vwi), XMVectorMultiply(vbi, vwr));
+							XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(ar + x), XMVectorAdd(var, tr));
+							XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(ai + x), XMVectorAdd(vai, ti));
+							XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(br + x), XMVectorSubtract(var, tr));
+							XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(bi + x), XMVectorSubtract(vai, ti));
+						}
+						for (; x < x1; ++x) {
+							const float tr = br[x] * wr - bi[x] * wi;
+							const float ti = br[x] * wi + bi[x] * wr;
+							br[x] = ar[x] - tr;
+							bi[x] = ai[x] - ti;
+							ar[x] += tr;
+							ai[x] += ti;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void OceanFFT::TransposeBlocks(uint32_t blockBegin, uint32_t blockEnd) {
+	// t[b][a] = s[a][b] を 4x4 ずつ（転置先の 4 行 = 1 ブロック行）
+	const uint32_t n = n_;
+	for (uint32_t p = 0; p < kPlanes; ++p) {
+		for (int k = 0; k < 2; ++k) {
+			const float* src = (k == 0 ? re_[p] : im_[p]).data();
+			float* dst = (k == 0 ? tre_[p] : tim_[p]).data();
+			for (uint32_t bb = blockBegin; bb < blockEnd; ++bb) {
+				const uint32_t b = bb * 4;
+				for (uint32_t a = 0; a < n; a += 4) {
+					XMMATRIX m;
+					for (uint32_t r = 0; r < 4; ++r) {
+						m.r[r] = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(src + size_t(a + r) * n + b));
+					}
+					m = XMMatrixTranspose(m);
+					for (uint32_t r = 0; r < 4; ++r) {
+						XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(dst + size_t(b + r) * n + a), m.r[r]);
+					}
+				}
+			}
+		}
+	}
+}
+
+void OceanFFT::ResolveRows(uint32_t zBegin, uint32_t zEnd) {
+	// 変換後の値は転置側に [z][x] で入っている
+	const float chop = desc_.choppiness;
+	for (uint32_t z = zBegin; z < zEnd; ++z) {
+		float maxH = 0.0f, maxD2 = 0.0f;
+		for (uint32_t x = 0; x < n_; ++x) {
+			const size_t i = size_t(z) * n_ + x;
+			const float h = tre_[0][i], dx = tim_[0][i];
+			const float dz = tre_[1][i], sx = tim_[1][i];
+			const float sz = tre_[2][i], jxx = tim_[2][i];
+			const float jzz = tre_[3][i], jxz = tim_[3][i];
+
+			disp_[i] = {chop * dx, h, chop * dz, 0.0f};
+			maxH = (std::max)(maxH, std::fabs(h));
+			maxD2 = (std::max)(maxD2, chop * chop * (dx * dx + dz * dz));
+
+			const float inv = 1.0f / std::sqrt(sx * sx + 1.0f + sz * sz);
+			// J = det(I + chop ∂D/∂x)。波頭では ∂D/∂x < 0 なので 1 より小さくなる
+			const float jac = (1.0f + chop * jxx) * (1.0f + chop * jzz) - chop * chop * jxz * jxz;
+			normal_[i] = {-sx * inv, inv, -sz * inv, jac};
+		}
+		rowMax_[z] = XMFLOAT2(maxH, std::sqrt(maxD2));
+	}
+}
+
+void OceanFFT::Update(float time) {
+	if (n_ == 0)
+		return;
+
+	// 段ごとに全スレッドがそろうのを待つ（スレッドは Initialize で立てたものを使い回す）
+	// [kx][kz] の列方向（kx → x）を変換 → 転置 → もう一度列方向（kz → z）で [z][x] になる
+	// どちらの変換も行どうしのバタフライなので SSE が連続アクセスで効く
+	pool_.For(n_, kMinLinesPerThread, [&](uint32_t b, uint32_t e) { BuildSpectrumRows(b, e, time); });
+	pool_.For(n_, kMinLinesPerThread, [&](uint32_t b, uint32_t e) { TransformColumns(re_, im_, b, e); });
+	pool_.For(n_ / 4, kMinLinesPerThread, [&](uint32_t b, uint32_t e) { TransposeBlocks(b, e); });
+	pool_.For(n_, kMinLinesPerThread, [&](uint32_t b, uint32_t e) { TransformColumns(tre_, tim_, b, e); });
+	pool_.For(n_, kMinLinesPerThread, [&](uint32_t b, uint32_t e) { ResolveRows(b, e); });
+
+	spectrumEnergy_ = std::accumulate(rowEnergy_.begin(), rowEnergy_.end(), 0.0);
+	maxHeight_ = 0.0f;
+	maxHorizontal_ = 0.0f;
+	for (const XMFLOAT2& m : rowMax_) {
+		maxHeight_ = (std::max)(maxHeight_, m.x);
+		maxHorizontal_ = (std::max)(maxHorizontal_, m.y);
+	}
+}
+
+XMFLOAT3 OceanFFT::DisplacementAt(float x, float z) const {
+	if (n_ == 0)
+		return {0.0f, 0.0f, 0.0f};
+	const float scale = float(n_) / desc_.patchSize;
+	const float fx = x * scale, fz = z * scale;
+	const float x0f = std::floor(fx), z0f = std::floor(fz);
+	const float tx = fx - x0f, tz = fz - z0f;
+	const uint32_t mask = n_ - 1;
+	const uint32_t x0 = uint32_t(int64_t(x0f)) & mask, z0 = uint32_t(int64_t(z0f)) & mask;
+	const uint32_t x1 = (x0 + 1) & mask, z1 = (z0 + 1) & mask;
+
+	const XMFLOAT4& a = disp_[size_t(z0) * n_ + x0];
+	const XMFLOAT4& b = disp_[size_t(z0) * n_ + x1];
+	const XMFLOAT4& c = disp_[size_t(z1) * n_ + x0];
+	const XMFLOAT4& d = disp_[size_t(z1) * n_ + x1];
+	auto lerp2 = [&](float va, float vb, float vc, float vd) { return (va + (vb - va) * tx) + ((vc + (vd - vc) * tx) - (va + (vb - va) * tx)) * tz; };
+	return {lerp2(a.x, b.x, c.x, d.x), lerp2(a.y, b.y, c.y, d.y), lerp2(a.z, b.z, c.z, d.z)};
+}
+
+XMFLOAT3 OceanFFT::NormalAt(float x, float z) const {
+	if (n_ == 0)
+		return {0.0f, 1.0f, 0.0f};
+	const float scale = float(n_) / desc_.patchSize;
+	const float fx = x * scale, fz = z * scale;
+	const float x0f = std::floor(fx), z0f = std::floor(fz);
+	const float tx = fx - x0f, tz = fz - z0f;
+	const uint32_t mask = n_ - 1;
+	const uint32_t x0 = uint32_t(int64_t(x0f)) & mask, z0 = uint32_t(int64_t(z0f)) & mask;
+	const uint32_t x1 = (x0 + 1) & mask, z1 = (z0 + 1) & mask;
+
+	XMVECTOR a = XMLoadFloat4(&normal_[size_t(z0) * n_ + x0]);
+	XMVECTOR b = XMLoadFloat4(&normal_[size_t(z0) * n_ + x1]);
+	XMVECTOR c = XMLoadFloat4(&normal_[size_t(z1) * n_ + x0]);
+	XMVECTOR d = XMLoadFloat4(&normal_[size_t(z1) * n_ + x1]);
+	const XMVECTOR top = XMVectorLerp(a, b, tx);
+	const XMVECTOR bottom = XMVectorLerp(c, d, tx);
+	XMFLOAT3 n;
+	XMStoreFloat3(&n, XMVector3Normalize(XMVectorLerp(top, bottom, tz)));
+	return n;
+}
+
+XMFLOAT2 OceanFFT::SourcePoint(float x, float z) const {
+	// ずれは波長より十分小さいので数回で収まる
+	float px = x, pz = z;
+	for (int i = 0; i < 4; ++i) {
+		const XMFLOAT3 d = DisplacementAt(px, pz);
+		px = x - d.x;
+		pz = z - d.z;
+	}
+	return {px, pz};
+}
+
+float OceanFFT::HeightAt(float x, float z) const {
+	const XMFLOAT2 s = SourcePoint(x, z);
+	return DisplacementAt(s.x, s.y).y;
+}
+
+} // namespace Engine
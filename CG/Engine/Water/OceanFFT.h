@@ -0,0 +1,116 @@
+// Engine/Water/OceanFFT.h
+#pragma once
+// =======================================
+//  OceanFFT : Tessendorf 式の FFT 海面（CPU）
+//  - 初期スペクトル h0(k) を Phillips / JONSWAP から作り、毎フレーム
+//    h(k,t) = h0(k) e^{iωt} + conj(h0(-k)) e^{-iωt}（深水の分散 ω = √(g|k|)）で進める
+//  - 逆 FFT は 2 のべき乗の基数 2（SoA）。列方向に変換 → 4x4 ブロックで転置 → もう一度列方向、として
+//    隣り合う 4 列のバタフライをまとめて SSE で。列（行）の範囲をスレッドに分ける（スレッドは Initialize で立てて使い回す）
+//  - 実数の出力を 2 つずつ 1 回の複素 FFT に詰める（高さ+横ずれ X、横ずれ Z+傾き X、...）
+//  - 出力は patchSize 四方で繰り返すタイル
+//      Displacement : (dx, h, dz, 0)     dx/dz はチョッピー（choppiness 掛け済み。格子点を波頭へ寄せる向き）
+//      Normals      : (nx, ny, nz, J)    J はヤコビアン（< 1 で波頭が折れかけ → 泡）
+//  - 波の高さは有義波高（4σ）で指定する。スペクトルの式は形だけ使う
+// =======================================
+#include "WaterParallel.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+class OceanFFT {
+public:
+	enum class Spectrum {
+		Phillips, // Tessendorf の元の式
+		Jonswap,  // 吹送距離のある風浪（ピークが鋭い）
+	};
+
+	struct Desc {
+		uint32_t resolution = 256;            // 一辺の格子数（2 のべき乗、16..1024）
+		float patchSize = 200.0f;             // タイル一辺 [m]
+		float windSpeed = 10.0f;              // [m/s]
+		DirectX::XMFLOAT2 windDir{1.0f, 0.3f}; // XZ（正規化不要）
+		float waveHeight = 1.0f;              // 有義波高 Hs [m]（= 4 * 高さの標準偏差）
+		float choppiness = 1.0f;              // 横ずれの強さ（0 で上下だけ）
+		Spectrum spectrum = Spectrum::Phillips;
+		float fetch = 100000.0f;              // JONSWAP の吹送距離 [m]
+		float peakGamma = 3.3f;               // JONSWAP のピーク強調
+		uint32_t seed = 1;
+		uint32_t threads = 0;                 // 0 ならハードウェアスレッド数
+	};
+
+	// 解像度が 2 のべき乗でないなどは false
+	bool Initialize(const Desc& desc);
+
+	// 時刻 time [s] の海面を計算して出力マップを更新する
+	void Update(float time);
+
+	bool IsValid() const { return n_ != 0; }
+	uint32_t Resolution() const { return n_; }
+	float PatchSize() const { return desc_.patchSize; }
+	const Desc& GetDesc() const { return desc_; }
+
+	// 行優先 n*n。格子点 (ix,iz) はタイル内の (ix, iz) * patchSize / n
+	const std::vector<DirectX::XMFLOAT4>& Displacement() const { return disp_; }
+	const std::vector<DirectX::XMFLOAT4>& Normals() const { return normal_; }
+
+	// 双線形補間（タイルで繰り返す）。x,z は格子上の位置（横ずれ前）
+	DirectX::XMFLOAT3 DisplacementAt(float x, float z) const;
+	DirectX::XMFLOAT3 NormalAt(float x, float z) const;
+
+	// 横ずれ後に (x,z) へ来る格子上の位置（横ずれを数回の反復で戻す）
+	DirectX::XMFLOAT2 SourcePoint(float x, float z) const;
+
+	// 横ずれ後の面で (x,z) の真上/真下にある高さ
+	float HeightAt(float x, float z) const;
+
+	// 高さの分散の期待値（時間平均）= Σ(|h0(k)|² + |h0(-k)|²)
+	double ExpectedVariance() const { return expectedVariance_; }
+
+	// 直近の Update の |高さ| と横ずれの大きさの最大（カリングの箱用）
+	float MaxHeight() const { return maxHeight_; }
+	float MaxHorizontal() const { return maxHorizontal_; }
+
+	// 直近の Update の高さのスペクトルのエネルギー Σ|h(k,t)|²（パーセバルの確認用）
+	double SpectrumEnergy() const { return spectrumEnergy_; }
+
+private:
+	static constexpr uint32_t kPlanes = 4; // 実数 8 枚を複素 4 枚に詰める
+	using Planes = std::vector<float>[kPlanes];
+
+	float SpectrumAt(float kx, float kz) const;
+	void BuildSpectrumRows(uint32_t xBegin, uint32_t xEnd, float time);
+	void TransformColumns(Planes& planeRe, Planes& planeIm, uint32_t xBegin, uint32_t xEnd); // 逆 FFT（1/n は掛けない）
+	void TransposeBlocks(uint32_t blockBegin, uint32_t blockEnd); // 4 行ずつ
+	void ResolveRows(uint32_t zBegin, uint32_t zEnd);
+
+	Desc desc_{};
+	uint32_t n_ = 0;
+	uint32_t log2n_ = 0;
+
+	// 初期スペクトルと角周波数。[kx][kz] の並び（k は自然順：インデックス m は波数 m (< n/2) か m - n）
+	std::vector<float> h0Re_, h0Im_, omega_;
+	std::vector<float> h0mRe_, h0mIm_, invK_; // h0(-k) を k の位置に並べたものと 1/|k|
+	std::vector<float> kx_, kz_; // 格子の波数（行/列で共通）
+
+	// FFT の表
+	std::vector<uint32_t> bitrev_;
+	std::vector<float> twRe_, twIm_; // 段 half ごとに [half - 1, 2*half - 1)
+
+	// 複素平面 kPlanes 枚（SoA）と、その転置（最終結果は転置側に [z][x] で入る）
+	Planes re_, im_;
+	Planes tre_, tim_;
+
+	std::vector<DirectX::XMFLOAT4> disp_, normal_;
+	double expectedVariance_ = 0.0;
+	double spectrumEnergy_ = 0.0;
+	std::vector<double> rowEnergy_; // スペクトルの行ごと（スレッドで足し合わせないため）
+	std::vector<DirectX::XMFLOAT2> rowMax_; // 出力の行ごとの |高さ|、横ずれの最大
+	float maxHeight_ = 0.0f;
+	float maxHorizontal_ = 0.0f;
+
+	WaterWorkerPool pool_;
+};
+
+} // namespace Engine
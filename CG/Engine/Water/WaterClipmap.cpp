@@ -0,0 +1,173 @@
+// Engine/Water/WaterClipmap.cpp
+#include "WaterClipmap.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+using DirectX::XMFLOAT2;
+using DirectX::XMFLOAT3;
+using DirectX::XMFLOAT4;
+
+namespace {
+
+// 点と箱の距離の 2 乗
+float DistSqToBox(const XMFLOAT3& p, const XMFLOAT3& lo, const XMFLOAT3& hi) {
+	const float dx = (std::max)((std::max)(lo.x - p.x, 0.0f), p.x - hi.x);
+	const float dy = (std::max)((std::max)(lo.y - p.y, 0.0f), p.y - hi.y);
+	const float dz = (std::max)((std::max)(lo.z - p.z, 0.0f), p.z - hi.z);
+	return dx * dx + dy * dy + dz * dz;
+}
+
+} // namespace
+
+void WaterClipmap::Initialize(const Desc& desc) {
+	desc_ = desc;
+
+	// セル数は 2 のべき乗に切り下げ（寄せで奇数番目の頂点を偶数番目に重ねるため）
+	uint32_t cells = 2;
+	while (cells * 2 <= (std::max)(desc_.patchCells, 2u)) {
+		cells *= 2;
+	}
+	desc_.patchCells = cells;
+	desc_.lodCount = std::clamp(desc_.lodCount, 1u, 16u);
+
+	// 継ぎ目が閉じる条件（隣が 2 段以上違わず、境で粗い側がまだ寄せ始めていない）
+	desc_.rangeScale = (std::max)(desc_.rangeScale, kSeamProduct / kMaxMorphStartRatio);
+	desc_.morphStartRatio = std::clamp(desc_.morphStartRatio, kSeamProduct / desc_.rangeScale, kMaxMorphStartRatio);
+	patchSize0_ = desc_.finestCell * float(desc_.patchCells);
+
+	ranges_.resize(desc_.lodCount);
+	for (uint32_t i = 0; i < desc_.lodCount; ++i) {
+		ranges_[i] = desc_.rangeScale * PatchSize(i);
+	}
+}
+
+void WaterClipmap::MorphRange(uint32_t lod, float& start, float& end) const {
+	end = ranges_[lod];
+	const float prev = lod > 0 ? ranges_[lod - 1] : 0.0f;
+	start = prev + (end - prev) * desc_.morphStartRatio;
+}
+
+void WaterClipmap::BuildPatchMesh(std::vector<XMFLOAT2>& verts, std::vector<uint32_t>& indices) const {
+	const uint32_t n = desc_.patchCells;
+	const uint32_t stride = n + 1;
+
+	verts.resize(size_t(stride) * stride);
+	for (uint32_t z = 0; z <= n; ++z) {
+		for (uint32_t x = 0; x <= n; ++x) {
+			verts[size_t(z) * stride + x] = XMFLOAT2(float(x), float(z));
+		}
+	}
+
+	// 頂点順は i0, i2, i1 / i1, i2, i3（対角線は寄せたあとの粗い格子と同じ向き）
+	indices.clear();
+	indices.reserve(size_t(n) * n * 6);
+	for (uint32_t z = 0; z < n; ++z) {
+		for (uint32_t x = 0; x < n; ++x) {
+			const uint32_t i0 = z * stride + x;
+			const uint32_t i1 = z * stride + (x + 1);
+			const uint32_t i2 = (z + 1) * stride + x;
+			const uint32_t i3 = (z + 1) * stride + (x + 1);
+			indices.insert(indices.end(), {i0, i2, i1, i1, i2, i3});
+		}
+	}
+}
+
+void WaterClipmap::NodeBox(const Node& n, XMFLOAT3& lo, XMFLOAT3& hi) const {
+	const float size = PatchSize(n.level);
+	lo = XMFLOAT3(float(n.x) * size - margin_, yLo_, float(n.z) * size - margin_);
+	hi = XMFLOAT3(float(n.x + 1) * size + margin_, yHi_, float(n.z + 1) * size + margin_);
+}
+
+bool WaterClipmap::InFrustum(const XMFLOAT3& lo, const XMFLOAT3& hi) const {
+	if (!planes_)
+		return true;
+	for (int i = 0; i < 6; ++i) {
+		const XMFLOAT4& p = planes_[i];
+		// 平面の法線方向にいちばん進んだ角が外なら箱全体が外
+		const float x = p.x >= 0.0f ? hi.x : lo.x;
+		const float y = p.y >= 0.0f ? hi.y : lo.y;
+		const float z = p.z >= 0.0f ? hi.z : lo.z;
+		if (p.x * x + p.y * y + p.z * z + p.w < 0.0f)
+			return false;
+	}
+	return true;
+}
+
+bool WaterClipmap::UnderTerrain(const XMFLOAT3& lo, const XMFLOAT3& hi) const {
+	if (!terrainQuery_)
+		return false;
+	float minY;
+	return terrainQuery_(lo.x, lo.z, hi.x, hi.z, minY) && hi.y < minY;
+}
+
+void WaterClipmap::SelectNode(const Node& n, std::vector<WaterPatch>& out, uint32_t* culled) {
+	// 覆う範囲の外（格子の位置そのもので判定。横ずれの余白は含めない）
+	const float size = PatchSize(n.level);
+	const float hx = 0.5f * desc_.extentX, hz = 0.5f * desc_.extentZ;
+	if (float(n.x + 1) * size <= center_.x - hx || float(n.x) * size >= center_.x + hx || float(n.z + 1) * size <= center_.y - hz || float(n.z) * size >= center_.y + hz)
+		return;
+
+	XMFLOAT3 lo, hi;
+	NodeBox(n, lo, hi);
+	if (!culled) {
+		if (!InFrustum(lo, hi)) {
+			culled = &stats_.frustumCulled;
+		} else if (UnderTerrain(lo, hi)) {
+			culled = &stats_.terrainCulled;
+		}
+	}
+
+	// 葉、または 1 段細かい範囲に掛からなければこのまま
+	// 箱は格子の位置で測る（VS が寄せに使う距離と同じ物差し）
+	const XMFLOAT3 gLo(float(n.x) * size, yLo_, float(n.z) * size);
+	const XMFLOAT3 gHi(float(n.x + 1) * size, yHi_, float(n.z + 1) * size);
+	const float rc = n.level > 0 ? ranges_[n.level - 1] : 0.0f;
+	if (n.level == 0 || DistSqToBox(eye_, gLo, gHi) > rc * rc) {
+		if (culled) {
+			++*culled;
+		} else {
+			out.push_back(WaterPatch{gLo.x, gLo.z, desc_.finestCell * float(1u << n.level), float(n.level)});
+		}
+		return;
+	}
+
+	for (int32_t j = 0; j < 2; ++j) {
+		for (int32_t i = 0; i < 2; ++i) {
+			SelectNode(Node{n.x * 2 + i, n.z * 2 + j, n.level - 1}, out, culled);
+		}
+	}
+}
+
+void WaterClipmap::Select(const XMFLOAT3& eye, const XMFLOAT4* planes, float baseHeight, float amplitude, float margin, std::vector<WaterPatch>& out) {
+	out.clear();
+	stats_ = WaterCullStats{};
+	if (ranges_.empty())
+		return;
+
+	eye_ = eye;
+	planes_ = planes;
+	amplitude = std::fabs(amplitude);
+	yLo_ = baseHeight - amplitude;
+	yHi_ = baseHeight + amplitude;
+	margin_ = std::fabs(margin);
+	center_ = XMFLOAT2(eye.x, eye.z);
+
+	// 範囲に掛かる最上段のノードを並べる
+	const uint32_t top = desc_.lodCount - 1;
+	const float topSize = PatchSize(top);
+	const int32_t x0 = int32_t(std::floor((center_.x - 0.5f * desc_.extentX) / topSize));
+	const int32_t x1 = int32_t(std::floor((center_.x + 0.5f * desc_.extentX) / topSize));
+	const int32_t z0 = int32_t(std::floor((center_.y - 0.5f * desc_.extentZ) / topSize));
+	const int32_t z1 = int32_t(std::floor((center_.y + 0.5f * desc_.extentZ) / topSize));
+	for (int32_t z = z0; z <= z1; ++z) {
+		for (int32_t x = x0; x <= x1; ++x) {
+			SelectNode(Node{x, z, top}, out, nullptr);
+		}
+	}
+	stats_.drawn = uint32_t(out.size());
+	planes_ = nullptr;
+}
+
+} // namespace Engine
@@ -0,0 +1,108 @@
+// Engine/Water/WaterClipmap.h
+#pragma once
+// =======================================
+//  WaterClipmap : カメラ中心の入れ子の LOD で水面のパッチを選ぶ（CDLOD 風の四分木）
+//  - どのパッチも patchCells x patchCells の同じメッシュ。LOD が 1 上がるごとに頂点間隔が 2 倍
+//  - ノードはワールドの格子に固定（カメラが動いても頂点は泳がない）。覆う範囲はカメラの周り extentX x extentZ
+//  - LOD i の範囲は rangeScale * (LOD i のパッチ一辺)。範囲の外側 morphStartRatio から先で
+//    頂点を次の LOD の格子へ寄せる（VS）。範囲の境では寄せ切っているので継ぎ目に隙間が出ない
+//  - 視錐台の外のノードと、地形より下に沈んでいるノードは CPU で捨てる
+//    （箱は水面の高さ ± 波の振幅、XZ は横ずれの分だけ広げたもの）
+//  - GPU には触らない（単体で動かして確かめられる）
+// =======================================
+#include <DirectXMath.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Engine {
+
+// 選ばれたパッチ（1 個 16B。そのままインスタンスデータとして VS に渡す）
+struct WaterPatch {
+	float x0, z0; // 左下のワールド位置
+	float cell;   // 頂点間隔 [m]
+	float lod;    // LOD（VS で寄せる範囲を出す）
+};
+
+// 直近の Select の内訳（パッチ数。カリングしなかったら描いていた数 = drawn + 2 つの culled）
+struct WaterCullStats {
+	uint32_t drawn = 0;
+	uint32_t frustumCulled = 0;
+	uint32_t terrainCulled = 0;
+};
+
+class WaterClipmap {
+public:
+	// XZ 矩形に掛かる地形の最低の高さ。分からない（地形の外など）なら false
+	using TerrainMinQuery = std::function<bool(float x0, float z0, float x1, float z1, float& minY)>;
+
+	struct Desc {
+		float extentX = 1000.0f;       // カメラの周りに覆う広さ [m]
+		float extentZ = 1000.0f;
+		float finestCell = 1.0f;       // LOD 0 の頂点間隔 [m]
+		uint32_t patchCells = 16;      // パッチ一辺のセル数（2 のべき乗）
+		uint32_t lodCount = 7;         // LOD の段数
+		float rangeScale = 4.0f;       // LOD i の範囲 = rangeScale * パッチ一辺
+		float morphStartRatio = 0.75f; // 範囲のこの割合から次の LOD へ寄せ始める
+		// 継ぎ目が閉じる条件：細かい側の境で粗い側がまだ寄せ始めていないこと
+		//   morphStartRatio * rangeScale >= 2√2（親ノードの対角線ぶん）
+		// 満たさなければ Initialize が直す（GetDesc で直した値が見える）
+	};
+
+	// 継ぎ目が閉じる morphStartRatio * rangeScale の下限（2√2）と、寄せる幅を残すための morphStartRatio の上限
+	static constexpr float kSeamProduct = 2.8284271f;
+	static constexpr float kMaxMorphStartRatio = 0.95f;
+
+	// 継ぎ目の条件を満たすように寄せ始めを遅らせ、それでも足りなければ範囲を広げる
+	void Initialize(const Desc& desc);
+
+	// 地形の下に沈んだノードを捨てるための問い合わせ（空なら地形カリングなし）
+	void SetTerrainQuery(TerrainMinQuery query) { terrainQuery_ = std::move(query); }
+
+	// 視点と視錐台（TerrainLodSelector::ExtractFrustumPlanes の 6 面。null なら視錐台カリングなし）からパッチを選ぶ
+	// 水面は baseHeight ± amplitude の板、頂点は XZ に margin まで横ずれするものとして扱う
+	void Select(const DirectX::XMFLOAT3& eye, const DirectX::XMFLOAT4* planes, float baseHeight, float amplitude, float margin, std::vector<WaterPatch>& out);
+
+	const WaterCullStats& Stats() const { return stats_; }
+
+	// LOD ごとの寄せ始め/寄せ終わりの距離（VS と同じ式）
+	void MorphRange(uint32_t lod, float& start, float& end) const;
+
+	// 0..patchCells の格子点（x, z）と三角形リスト（WaterSurface の旧メッシュと同じ巻き順）
+	void BuildPatchMesh(std::vector<DirectX::XMFLOAT2>& verts, std::vector<uint32_t>& indices) const;
+
+	uint32_t LodCount() const { return desc_.lodCount; }
+	float PatchSize(uint32_t lod) const { return patchSize0_ * float(1u << lod); }
+	const Desc& GetDesc() const { return desc_; }
+
+	// 直近の Select で覆った範囲の中心（カメラの XZ）
+	DirectX::XMFLOAT2 Center() const { return center_; }
+
+private:
+	struct Node {
+		int32_t x, z;   // レベル内のノード番号（ワールド原点から）
+		uint32_t level; // = LOD
+	};
+
+	void NodeBox(const Node& n, DirectX::XMFLOAT3& lo, DirectX::XMFLOAT3& hi) const;
+	bool InFrustum(const DirectX::XMFLOAT3& lo, const DirectX::XMFLOAT3& hi) const;
+	bool UnderTerrain(const DirectX::XMFLOAT3& lo, const DirectX::XMFLOAT3& hi) const;
+	// culled が null でなければ描かずに数えるだけ（カリングで捨てたパッチ数の内訳用）
+	void SelectNode(const Node& n, std::vector<WaterPatch>& out, uint32_t* culled);
+
+	Desc desc_{};
+	float patchSize0_ = 16.0f;
+	std::vector<float> ranges_; // LOD ごとの距離
+
+	// 今回の選択の入力
+	DirectX::XMFLOAT3 eye_{};
+	const DirectX::XMFLOAT4* planes_ = nullptr;
+	float yLo_ = 0.0f, yHi_ = 0.0f;
+	float margin_ = 0.0f; // 横ずれの分だけ箱を広げる
+	DirectX::XMFLOAT2 center_{};
+
+	TerrainMinQuery terrainQuery_;
+	WaterCullStats stats_{};
+};
+
+} // namespace Engine
@@ -0,0 +1,128 @@
+// Engine/Water/WaterParallel.cpp
+#include "WaterParallel.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine {
+
+struct WaterWorkerPool::State {
+	std::mutex mutex;
+	std::condition_variable jobCv;
+	std::condition_variable doneCv;
+	std::vector<std::thread> workers;
+	bool stop = false;
+
+	// 今の仕事（mutex で守る）
+	uint64_t generation = 0; // 仕事を出すたびに進める
+	Job job = nullptr;
+	void* ctx = nullptr;
+	uint32_t count = 0;
+	uint32_t per = 0;
+	uint32_t parts = 0;
+	uint32_t remaining = 0; // まだ終わっていないワーカーの数
+};
+
+WaterWorkerPool::WaterWorkerPool() = default;
+
+WaterWorkerPool::~WaterWorkerPool() { Stop(); }
+
+WaterWorkerPool::WaterWorkerPool(WaterWorkerPool&& o) noexcept : state_(std::move(o.state_)), threads_(o.threads_) { o.threads_ = 1; }
+
+WaterWorkerPool& WaterWorkerPool::operator=(WaterWorkerPool&& o) noexcept {
+	if (this != &o) {
+		Stop();
+		state_ = std::move(o.state_);
+		threads_ = o.threads_;
+		o.threads_ = 1;
+	}
+	return *this;
+}
+
+void WaterWorkerPool::Start(uint32_t threads) {
+	Stop();
+	if (threads == 0) {
+		threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+	}
+	if (threads <= 1)
+		return;
+
+	state_ = std::make_unique<State>();
+	state_->workers.reserve(threads - 1);
+	for (uint32_t i = 1; i < threads; ++i) {
+		state_->workers.emplace_back(&WaterWorkerPool::WorkerMain, state_.get(), i);
+	}
+	threads_ = threads;
+}
+
+void WaterWorkerPool::Stop() {
+	if (!state_)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		state_->stop = true;
+	}
+	state_->jobCv.notify_all();
+	for (auto& t : state_->workers) {
+		t.join();
+	}
+	state_.reset();
+	threads_ = 1;
+}
+
+void WaterWorkerPool::Run(uint32_t count, uint32_t minPerThread, Job job, void* ctx) {
+	const uint32_t parts = std::clamp(count / (std::max)(minPerThread, 1u), 1u, threads_);
+	if (!state_ || parts == 1) {
+		job(ctx, 0u, count);
+		return;
+	}
+
+	State& s = *state_;
+	const uint32_t per = (count + parts - 1) / parts;
+	{
+		std::lock_guard<std::mutex> lock(s.mutex);
+		s.job = job;
+		s.ctx = ctx;
+		s.count = count;
+		s.per = per;
+		s.parts = parts;
+		s.remaining = parts - 1;
+		++s.generation;
+	}
+	s.jobCv.notify_all();
+
+	job(ctx, 0u, (std::min)(per, count));
+
+	std::unique_lock<std::mutex> lock(s.mutex);
+	s.doneCv.wait(lock, [&s] { return s.remaining == 0; });
+}
+
+void WaterWorkerPool::WorkerMain(State* s, uint32_t index) {
+	uint64_t seen = 0;
+	std::unique_lock<std::mutex> lock(s->mutex);
+	for (;;) {
+		s->jobCv.wait(lock, [&] { return s->stop || s->generation != seen; });
+		if (s->stop)
+			return;
+		seen = s->generation;
+		if (index >= s->parts)
+			continue; // 今回は出番なし
+
+		const Job job = s->job;
+		void* ctx = s->ctx;
+		const uint32_t b = (std::min)(index * s->per, s->count);
+		const uint32_t e = (std::min)(b + s->per, s->count);
+		lock.unlock();
+		if (b < e) {
+			job(ctx, b, e);
+		}
+		lock.lock();
+		if (--s->remaining == 0) {
+			s->doneCv.notify_one();
+		}
+	}
+}
+
+} // namespace Engine
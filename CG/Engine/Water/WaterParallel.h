@@ -0,0 +1,49 @@
+// Engine/Water/WaterParallel.h
+#pragma once
+// =======================================
+//  WaterWorkerPool : 行などの範囲をスレッドに分けて回す（OceanFFT / WaterRipples 用）
+//  - スレッドは Start で立てて使い回す（毎フレーム何度呼んでも作り直さない）
+//  - 呼んだスレッドも 1 本ぶん働く。minPerThread より細かくは分けない
+//  - threads = 0 ならハードウェアスレッド数。1 ならスレッドは立てない
+//  - For は分けた範囲が全部終わってから戻る（段の間の待ち合わせを兼ねる）
+// =======================================
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace Engine {
+
+class WaterWorkerPool {
+public:
+	WaterWorkerPool();
+	~WaterWorkerPool();
+	WaterWorkerPool(WaterWorkerPool&& o) noexcept;
+	WaterWorkerPool& operator=(WaterWorkerPool&& o) noexcept;
+	WaterWorkerPool(const WaterWorkerPool&) = delete;
+	WaterWorkerPool& operator=(const WaterWorkerPool&) = delete;
+
+	// 呼んだスレッドを含めて threads 本にする（立て直す前に今のスレッドは止める）
+	void Start(uint32_t threads);
+	void Stop();
+
+	// 呼んだスレッドを含めた本数
+	uint32_t ThreadCount() const { return threads_; }
+
+	// [0, count) を分けて f(begin, end) を呼ぶ
+	template <class F> void For(uint32_t count, uint32_t minPerThread, F&& f) {
+		using Fn = std::remove_reference_t<F>;
+		Run(count, minPerThread, [](void* ctx, uint32_t b, uint32_t e) { (*static_cast<Fn*>(ctx))(b, e); }, const_cast<void*>(static_cast<const void*>(&f)));
+	}
+
+private:
+	struct State;
+	using Job = void (*)(void* ctx, uint32_t begin, uint32_t end);
+
+	void Run(uint32_t count, uint32_t minPerThread, Job job, void* ctx);
+	static void WorkerMain(State* s, uint32_t index);
+
+	std::unique_ptr<State> state_; // ワーカーと共有（ムーブしても場所が変わらないようにヒープに置く）
+	uint32_t threads_ = 1;
+};
+
+} // namespace Engine
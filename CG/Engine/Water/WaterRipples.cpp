@@ -0,0 +1,260 @@
+// Engine/Water/WaterRipples.cpp
+#include "WaterRipples.h"
+#include "WaterParallel.h"
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace Engine {
+
+using namespace DirectX;
+
+namespace {
+
+constexpr float kPi = 3.14159265358979f;
+
+// 1 ステップの幅を決める CFL 数（2 次元の安定限界 1/√2 より余裕を持たせる）
+constexpr float kCourant = 0.5f;
+
+// これより少ない行数ならスレッドを立てない
+constexpr uint32_t kMinRowsPerThread = 32;
+
+// 吸収層のいちばん外側での 1 ステップの減衰
+constexpr float kSpongeStrength = 0.2f;
+
+} // namespace
+
+bool WaterRipples::Initialize(const Desc& desc) {
+	desc_ = desc;
+	n_ = 0;
+	if (desc_.cellSize <= 0.0f || desc_.waveSpeed <= 0.0f) {
+		return false;
+	}
+
+	// 4 セルずつ回すので 4 の倍数に切り下げ
+	const uint32_t n = (std::max)(desc_.resolution, 16u) & ~3u;
+	desc_.resolution = n;
+
+	step_ = (std::min)(desc_.fixedStep, kCourant * desc_.cellSize / desc_.waveSpeed);
+	const float courant = desc_.waveSpeed * step_ / desc_.cellSize;
+	courant2_ = courant * courant;
+	// 速度に掛ける。振幅は 1 ステップで √stepDamp_ 倍になるので 2 倍しておく
+	stepDamp_ = std::exp(-2.0f * desc_.damping * step_);
+	accum_ = 0.0f;
+	lastSteps_ = 0;
+
+	// 縁は固定端（0）。その内側 spongeCells は外へ行くほど強く減衰
+	edge_.assign(n, 1.0f);
+	for (uint32_t i = 0; i < n; ++i) {
+		const uint32_t d = (std::min)(i, n - 1 - i);
+		if (d == 0) {
+			edge_[i] = 0.0f;
+		} else if (d < desc_.spongeCells) {
+			const float t = 1.0f - float(d) / float(desc_.spongeCells);
+			edge_[i] = 1.0f - kSpongeStrength * t * t;
+		}
+	}
+
+	cur_.assign(size_t(n) * n, 0.0f);
+	prev_.assign(size_t(n) * n, 0.0f);
+	scratch_.resize(size_t(n) * n);
+	originX_ = -int32_t(n / 2);
+	originZ_ = -int32_t(n / 2);
+
+	const uint32_t hw = (std::max)(std::thread::hardware_concurrency(), 1u);
+	pool_.Start(std::clamp(n / kMinRowsPerThread, 1u, desc_.threads == 0 ? hw : desc_.threads));
+
+	n_ = n;
+	return true;
+}
+
+void WaterRipples::Clear() {
+	std::fill(cur_.begin(), cur_.end(), 0.0f);
+	std::fill(prev_.begin(), prev_.end(), 0.0f);
+	accum_ = 0.0f;
+}
+
+void WaterRipples::SetCenter(float x, float z) {
+	if (n_ == 0)
+		return;
+	const int32_t ox = int32_t(std::floor(x / desc_.cellSize)) - int32_t(n_ / 2);
+	const int32_t oz = int32_t(std::floor(z / desc_.cellSize)) - int32_t(n_ / 2);
+	if (ox != originX_ || oz != originZ_) {
+		Shift(ox - originX_, oz - originZ_);
+		originX_ = ox;
+		originZ_ = oz;
+	}
+}
+
+void WaterRipples::Shift(int32_t dx, int32_t dz) {
+	const int32_t n = int32_t(n_);
+	if (std::abs(dx) >= n || std::abs(dz) >= n) {
+		Clear();
+		return;
+	}
+
+	// 新しい (ix,iz) = 古い (ix+dx, iz+dz)。はみ出した所は 0
+	for (std::vector<float>* buf : {&cur_, &prev_}) {
+		std::fill(scratch_.begin(), scratch_.end(), 0.0f);
+		const int32_t x0 = (std::max)(0, -dx), x1 = (std::min)(n, n - dx);
+		const int32_t z0 = (std::max)(0, -dz), z1 = (std::min)(n, n - dz);
+		for (int32_t iz = z0; iz < z1; ++iz) {
+			const float* src = buf->data() + size_t(iz + dz) * n_ + (x0 + dx);
+			std::copy(src, src + (x1 - x0), scratch_.data() + size_t(iz) * n_ + x0);
+		}
+		buf->swap(scratch_);
+	}
+}
+
+void WaterRipples::AddImpulse(float x, float z, float radius, float strength) {
+	if (n_ == 0 || radius <= 0.0f)
+		return;
+
+	const float inv = 1.0f / desc_.cellSize;
+	const int32_t ix0 = (std::max)(int32_t(std::ceil((x - radius) * inv)) - originX_, 1);
+	const int32_t ix1 = (std::min)(int32_t(std::floor((x + radius) * inv)) - originX_, int32_t(n_) - 2);
+	const int32_t iz0 = (std::max)(int32_t(std::ceil((z - radius) * inv)) - originZ_, 1);
+	const int32_t iz1 = (std::min)(int32_t(std::floor((z + radius) * inv)) - originZ_, int32_t(n_) - 2);
+
+	// cos の山（縁で 0、傾きも 0）。今とひとつ前を同じだけ動かす = 速度 0 で持ち上げる
+	for (int32_t iz = iz0; iz <= iz1; ++iz) {
+		const float wz = float(originZ_ + iz) * desc_.cellSize - z;
+		for (int32_t ix = ix0; ix <= ix1; ++ix) {
+			const float wx = float(originX_ + ix) * desc_.cellSize - x;
+			const float r = std::sqrt(wx * wx + wz * wz);
+			if (r >= radius)
+				continue;
+			const float h = strength * 0.5f * (1.0f + std::cos(kPi * r / radius));
+			const size_t i = size_t(iz) * n_ + ix;
+			cur_[i] += h;
+			prev_[i] += h;
+		}
+	}
+}
+
+void WaterRipples::Update(float deltaSeconds) {
+	lastSteps_ = 0;
+	if (n_ == 0 || deltaSeconds <= 0.0f)
+		return;
+
+	accum_ += deltaSeconds;
+	uint32_t steps = uint32_t(accum_ / step_);
+	if (steps > desc_.maxSteps) {
+		// 追いつけない分は捨てる（ヒッチのあとにまとめて進めない）
+		steps = desc_.maxSteps;
+		accum_ = 0.0f;
+	} else {
+		accum_ -= float(steps) * step_;
+	}
+
+	for (uint32_t s = 0; s < steps; ++s) {
+		// 新しい高さは prev_ に上書きしてから入れ替える（同じセルしか読まないので行ごとに独立）
+		pool_.For(n_, kMinRowsPerThread, [&](uint32_t b, uint32_t e) { StepRows(b, e); });
+		cur_.swap(prev_);
+	}
+	lastSteps_ = steps;
+}
+
+void WaterRipples::StepRows(uint32_t zBegin, uint32_t zEnd) {
+	const uint32_t n = n_;
+	const float k = courant2_;
+
+	for (uint32_t z = zBegin; z < zEnd; ++z) {
+		float* out = prev_.data() + size_t(z) * n;
+		if (z == 0 || z == n - 1) {
+			std::fill(out, out + n, 0.0f);
+			continue;
+		}
+		const float* c = cur_.data() + size_t(z) * n;
+		const float* up = c - n;
+		const float* dn = c + n;
+		const float vd = stepDamp_;
+		const float ez = edge_[z];
+
+		// h' = (h + (h - h_prev) * 減衰 + k * ∇²h) * 吸収層
+		auto scalar = [&](uint32_t x) {
+			if (x == 0 || x == n - 1) {
+				out[x] = 0.0f;
+				return;
+			}
+			const float lap = c[x - 1] + c[x + 1] + up[x] + dn[x] - 4.0f * c[x];
+			out[x] = (c[x] + (c[x] - out[x]) * vd + k * lap) * ez * edge_[x];
+		};
+
+		for (uint32_t x = 0; x < 4; ++x) {
+			scalar(x);
+		}
+
+		const XMVECTOR vk = XMVectorReplicate(k);
+		const XMVECTOR vvd = XMVectorReplicate(vd);
+		const XMVECTOR vez = XMVectorReplicate(ez);
+		const XMVECTOR four = XMVectorReplicate(4.0f);
+		for (uint32_t x = 4; x < n - 4; x += 4) {
+			const XMVECTOR h = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(c + x));
+			const XMVECTOR l = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(c + x - 1));
+			const XMVECTOR r = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(c + x + 1));
+			const XMVECTOR u = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(up + x));
+			const XMVECTOR d = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(dn + x));
+			const XMVECTOR p = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(out + x));
+			const XMVECTOR e = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(edge_.data() + x));
+
+			const XMVECTOR lap = XMVectorSubtract(XMVectorAdd(XMVectorAdd(l, r), XMVectorAdd(u, d)), XMVectorMultiply(four, h));
+			XMVECTOR v = XMVectorAdd(XMVectorAdd(h, XMVectorMultiply(XMVectorSubtract(h, p), vvd)), XMVectorMultiply(vk, lap));
+			v = XMVectorMultiply(XMVectorMultiply(v, vez), e);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(out + x), v);
+		}
+
+		for (uint32_t x = n - 4; x < n; ++x) {
+			scalar(x);
+		}
+	}
+}
+
+float WaterRipples::Cell(int32_t ix, int32_t iz) const {
+	if (ix < 0 || iz < 0 || ix >= int32_t(n_) || iz >= int32_t(n_))
+		return 0.0f;
+	return cur_[size_t(iz) * n_ + ix];
+}
+
+float WaterRipples::HeightAt(float x, float z) const {
+	if (n_ == 0)
+		return 0.0f;
+	const float fx = x / desc_.cellSize - float(originX_);
+	const float fz = z / desc_.cellSize - float(originZ_);
+	const float x0f = std::floor(fx), z0f = std::floor(fz);
+	const float tx = fx - x0f, tz = fz - z0f;
+	const int32_t ix = int32_t(x0f), iz = int32_t(z0f);
+
+	const float a = Cell(ix, iz) + (Cell(ix + 1, iz) - Cell(ix, iz)) * tx;
+	const float b = Cell(ix, iz + 1) + (Cell(ix + 1, iz + 1) - Cell(ix, iz + 1)) * tx;
+	return a + (b - a) * tz;
+}
+
+void WaterRipples::SlopeAt(float x, float z, float& dhdx, float& dhdz) const {
+	const float e = desc_.cellSize;
+	dhdx = (HeightAt(x + e, z) - HeightAt(x - e, z)) / (2.0f * e);
+	dhdz = (HeightAt(x, z + e) - HeightAt(x, z - e)) / (2.0f * e);
+}
+
+double WaterRipples::Energy() const {
+	if (n_ == 0)
+		return 0.0;
+	const double invDt = 1.0 / step_;
+	const double c2 = double(desc_.waveSpeed) * desc_.waveSpeed;
+	const double invDx2 = 1.0 / (double(desc_.cellSize) * desc_.cellSize);
+
+	double e = 0.0;
+	for (uint32_t z = 0; z + 1 < n_; ++z) {
+		for (uint32_t x = 0; x + 1 < n_; ++x) {
+			const size_t i = size_t(z) * n_ + x;
+			const double v = (double(cur_[i]) - prev_[i]) * invDt;
+			const double gx = double(cur_[i + 1]) - cur_[i];
+			const double gz = double(cur_[i + n_]) - cur_[i];
+			e += 0.5 * v * v + 0.5 * c2 * (gx * gx + gz * gz) * invDx2;
+		}
+	}
+	return e;
+}
+
+} // namespace Engine
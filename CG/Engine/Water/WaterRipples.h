@@ -0,0 +1,87 @@
+// Engine/Water/WaterRipples.h
+#pragma once
+// =======================================
+//  WaterRipples : プレイヤーの周りだけの波紋（2 次元の波動方程式の高さ場）
+//  - 固定ステップの陽解法（リープフロッグ）。1 ステップの幅は CFL 条件 c*dt/dx <= 0.5 に収まるよう
+//    自動で決めるので、大きな dt を渡しても発散しない（溜まりすぎた時間は捨てる）
+//  - 4 セルずつ SSE。行の範囲をスレッドに分けることもできる（小さい格子では 1 本の方が速い。スレッドは Initialize で立てる）
+//  - 格子は SetCenter でセル単位にスクロールする。縁の spongeCells 幅で波を吸収する
+//  - 出力は waterHeight からの高さのずれ [m]。手続きの波に足して使う
+//  - GPU には触らない（単体で動かして確かめられる）
+// =======================================
+#include "WaterParallel.h"
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+class WaterRipples {
+public:
+	struct Desc {
+		uint32_t resolution = 256;   // 一辺のセル数（4 の倍数）
+		float cellSize = 0.25f;      // [m]
+		float waveSpeed = 4.0f;      // 波の速さ [m/s]
+		float damping = 0.8f;        // 振幅の減衰（e^{-damping t}）
+		float fixedStep = 1.0f / 60; // ステップの上限 [s]
+		uint32_t maxSteps = 8;       // 1 回の Update で進めるステップ数の上限
+		uint32_t spongeCells = 12;   // 縁の吸収層の幅（0 なら縁で反射）
+		uint32_t threads = 1;        // 0 ならハードウェアスレッド数
+	};
+
+	bool Initialize(const Desc& desc);
+
+	// 格子の中心をワールドの (x,z) に寄せる（セル単位。はみ出した波は消える）
+	void SetCenter(float x, float z);
+
+	// 半径 radius の範囲を strength [m] だけ持ち上げる（負で凹ませる。中心ほど強い）
+	void AddImpulse(float x, float z, float radius, float strength);
+
+	// deltaSeconds ぶん進める
+	void Update(float deltaSeconds);
+
+	void Clear();
+
+	// 双線形補間の高さと傾き（格子の外は 0）
+	float HeightAt(float x, float z) const;
+	void SlopeAt(float x, float z, float& dhdx, float& dhdz) const;
+
+	bool IsValid() const { return n_ != 0; }
+	uint32_t Resolution() const { return n_; }
+	float CellSize() const { return desc_.cellSize; }
+	const Desc& GetDesc() const { return desc_; }
+
+	// 行優先 n*n の高さ。格子点 (ix,iz) のワールド位置は Origin + (ix, iz) * cellSize
+	const std::vector<float>& Heights() const { return cur_; }
+	float OriginX() const { return float(originX_) * desc_.cellSize; }
+	float OriginZ() const { return float(originZ_) * desc_.cellSize; }
+
+	// 1 ステップの幅と、直近の Update で進めたステップ数
+	float StepSeconds() const { return step_; }
+	uint32_t LastSteps() const { return lastSteps_; }
+
+	// 離散エネルギー Σ(速度² + c²|∇h|²)/2（減衰の確認用）
+	double Energy() const;
+
+private:
+	void StepRows(uint32_t zBegin, uint32_t zEnd);
+	void Shift(int32_t dx, int32_t dz);
+	float Cell(int32_t ix, int32_t iz) const;
+
+	Desc desc_{};
+	uint32_t n_ = 0;
+	float step_ = 0.0f;      // 1 ステップ [s]
+	float courant2_ = 0.0f;  // (c*dt/dx)²
+	float stepDamp_ = 1.0f;  // 1 ステップで速度に掛ける減衰
+	float accum_ = 0.0f;     // 進めていない時間
+	uint32_t lastSteps_ = 0;
+
+	int32_t originX_ = 0, originZ_ = 0; // 格子の左下（セル番号）
+
+	std::vector<float> cur_, prev_; // 今とひとつ前の高さ（ステップごとに入れ替え）
+	std::vector<float> scratch_;    // スクロール用
+	std::vector<float> edge_;       // 縁からの距離による減衰（行/列で共通）
+
+	WaterWorkerPool pool_; // Initialize で立てて使い回す
+};
+
+} // namespace Engine
@@ -1,9 +1,12 @@
 // Engine/Water/WaterSurface.cpp
 #include "WaterSurface.h"
 #include "Camera.h"
+#include "Terrain/TerrainLodSelector.h"
 #include "WindowDX.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <d3dcompiler.h>
 #include <d3dx12.h>
 #include <vector>
@@ -29,14 +32,14 @@ using Microsoft::WRL::ComPtr;
 
 namespace {
 
-// シェーダコンパイルヘルパー（Renderer::Compile と同じイメージ）
-ComPtr<ID3DBlob> CompileShader(const char* src, const char* entry, const char* target) {
+// シェーダコンパイルヘルパー（Renderer::Compile と同じイメージ）。defines は null 終端の配列
+ComPtr<ID3DBlob> CompileShader(const char* src, const char* entry, const char* target, const D3D_SHADER_MACRO* defines = nullptr) {
 	UINT fl = D3DCOMPILE_ENABLE_STRICTNESS;
 #ifdef _DEBUG
 	fl |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
 #endif
 	ComPtr<ID3DBlob> s, e;
-	HRESULT hr = D3DCompile(src, strlen(src), nullptr, nullptr, nullptr, entry, target, fl, 0, &s, &e);
+	HRESULT hr = D3DCompile(src, strlen(src), nullptr, defines, nullptr, entry, target, fl, 0, &s, &e);
 	if (FAILED(hr)) {
 		if (e) {
 			MessageBoxA(nullptr, (const char*)e->GetBufferPointer(), "Water HLSL Compile Error", MB_OK);
@@ -49,9 +52,12 @@ ComPtr<ID3DBlob> CompileShader(const char* src, const char* entry, const char* t
 // ---------------- HLSL：水面 ----------------
 //
 // 第一段階：
+//  - メッシュは WaterClipmap のパッチのインスタンス。VS で LOD の境へ向けて頂点を粗い格子に寄せる
 //  - 頂点シェーダで 2 つの波による高さを計算
 //  - 法線を数値微分で求める
 //  - ピクセルシェーダで簡単なフレネル＋ライティング
+//  - OCEAN_FFT 付きでコンパイルした版は、式の代わりに OceanFFT のマップを引く
+//  - 最後にプレイヤーの周りの波紋（WaterRipples）を足す
 //
 static const char* gVSWater = R"(
 
@@ -60,6 +66,7 @@ cbuffer CBCommon : register(b0)
     float4x4 g_mvp;
     float4   g_color;
     float4   g_camPos; // PS とレイアウトをそろえる用
+    float4   g_lod;    // LOD 0 の範囲, morphStartRatio, LOD の段数, パッチのセル数
 };
 
 cbuffer CBWave : register(b1)
@@ -69,9 +76,63 @@ cbuffer CBWave : register(b1)
     float4 g_misc;  // time, waterHeight, _, _
 };
 
+#ifdef OCEAN_FFT
+cbuffer CBOcean : register(b2)
+{
+    float4 g_ocean; // patchSize, resolution, _, _
+};
+
+StructuredBuffer<float4> g_oceanDisp : register(t0); // dx, h, dz, 0
+StructuredBuffer<float4> g_oceanNrm  : register(t1); // nx, ny, nz, J
+
+// タイルで繰り返す双線形補間（OceanFFT::DisplacementAt と同じ）
+float4 oceanFetch(StructuredBuffer<float4> buf, float2 xz)
+{
+    int    n  = (int)g_ocean.y;
+    float2 g  = xz * (g_ocean.y / g_ocean.x);
+    float2 g0 = floor(g);
+    float2 t  = g - g0;
+    int2   i0 = int2(g0) & (n - 1);
+    int2   i1 = (i0 + 1) & (n - 1);
+
+    float4 a = lerp(buf[i0.y * n + i0.x], buf[i0.y * n + i1.x], t.x);
+    float4 b = lerp(buf[i1.y * n + i0.x], buf[i1.y * n + i1.x], t.x);
+    return lerp(a, b, t.y);
+}
+#endif
+
+cbuffer CBRipple : register(b3)
+{
+    float4 g_ripple; // originX, originZ, cellSize, resolution（0 なら波紋なし）
+};
+
+StructuredBuffer<float> g_ripples : register(t2);
+
+float rippleCell(int2 i)
+{
+    int n = (int)g_ripple.w;
+    return (any(i < 0) || any(i >= n)) ? 0.0 : g_ripples[i.y * n + i.x];
+}
+
+// 双線形補間（WaterRipples::HeightAt と同じ。格子の外は 0）
+float rippleAt(float2 xz)
+{
+    if (g_ripple.w <= 0.0) {
+        return 0.0;
+    }
+    float2 g  = (xz - g_ripple.xy) / g_ripple.z;
+    float2 g0 = floor(g);
+    float2 t  = g - g0;
+    int2   i  = int2(g0);
+
+    float a = lerp(rippleCell(i),              rippleCell(i + int2(1, 0)), t.x);
+    float b = lerp(rippleCell(i + int2(0, 1)), rippleCell(i + int2(1, 1)), t.x);
+    return lerp(a, b, t.y);
+}
+
 struct VSIn {
-    float3 pos : POSITION;
-    float2 uv  : TEXCOORD;
+    float2 grid  : POSITION; // パッチ内の格子点 0..patchCells
+    float4 patch : PATCH;    // インスタンス：左下 x,z / 頂点間隔 / LOD
 };
 
 struct VSOut {
@@ -82,6 +143,7 @@ struct VSOut {
 };
 
 // ===== 多周波の高さ関数 =====
+// ※ CPU 側（WaterWaves.cpp）にも同じ式がある。変えたら両方直す
 float heightAt(float2 xz)
 {
     float t = g_misc.x;
@@ -152,20 +214,46 @@ VSOut main(VSIn i)
 {
     VSOut o;
 
-    float3 p = i.pos;
-
+    // パッチの格子 → ワールド。範囲の外側では次の LOD の格子へ寄せる（WaterClipmap::MorphRange と同じ式）
+    float2 g     = i.grid;
+    float2 xz    = i.patch.xy + g * i.patch.z;
+    float  end   = g_lod.x * exp2(i.patch.w);
+    float  prev  = (i.patch.w > 0.0) ? end * 0.5 : 0.0;
+    float  start = prev + (end - prev) * g_lod.y;
+    float  k     = saturate((distance(g_camPos.xyz, float3(xz.x, g_misc.y, xz.y)) - start) / (end - start));
+    k  = (i.patch.w + 1.0 < g_lod.z) ? k : 0.0; // 最上段は寄せる先がない
+    g -= frac(g * 0.5) * 2.0 * k;
+
+    float3 p = float3(i.patch.x + g.x * i.patch.z, 0.0, i.patch.y + g.y * i.patch.z);
+
+#ifdef OCEAN_FFT
+    // FFT 海面：横ずれ + 高さと法線をマップから（d.xz は格子点を波頭へ寄せる向きで入っている）
+    float4 d = oceanFetch(g_oceanDisp, p.xz);
+    float3 n = normalize(oceanFetch(g_oceanNrm, p.xz).xyz);
+    p = float3(p.x + d.x, g_misc.y + d.y, p.z + d.z);
+#else
     // 高さを計算（多周波）
     p.y = heightAt(p.xz);
 
-    // 数値微分で法線（高さ関数と整合するように）
+    // 数値微分で法線（高さ関数と整合するように。幅は kWaterNormalEps と同じ）
     float eps = 0.4;
     float h_dx = heightAt(p.xz + float2(eps, 0.0)) - heightAt(p.xz - float2(eps, 0.0));
     float h_dz = heightAt(p.xz + float2(0.0, eps)) - heightAt(p.xz - float2(0.0, eps));
     float3 n = normalize(float3(-h_dx, 2.0 * eps, -h_dz));
+#endif
+
+    // 波紋を足す（高さ場どうしなので傾きも足し算。n / n.y = (-dh/dx, 1, -dh/dz)）
+    {
+        float  re = g_ripple.z;
+        float2 rs = float2(rippleAt(p.xz + float2(re, 0.0)) - rippleAt(p.xz - float2(re, 0.0)),
+                           rippleAt(p.xz + float2(0.0, re)) - rippleAt(p.xz - float2(0.0, re))) / (2.0 * re);
+        p.y += rippleAt(p.xz);
+        n = normalize(n / max(n.y, 1e-3) - float3(rs.x, 0.0, rs.y));
+    }
 
     o.worldPos = p;
     o.normal   = n;
-    o.uv       = i.uv;
+    o.uv       = i.grid / g_lod.w;
 
     o.sp = mul(float4(p, 1.0f), g_mvp);
     return o;
@@ -317,21 +405,49 @@ bool WaterSurface::Initialize(WindowDX& dx, const WaterSurfaceDesc& desc) {
 	waveParam_.wave2 = DirectX::XMFLOAT4(-0.4f, 1.0f, 0.30f, 0.15f); // amp を 0.30 に
 	waveParam_.misc = DirectX::XMFLOAT4(0.0f, desc_.height, 0.0f, 0.0f);
 
+	WaterClipmap::Desc cd{};
+	cd.extentX = desc_.sizeX;
+	cd.extentZ = desc_.sizeZ;
+	cd.finestCell = desc_.finestCell;
+	cd.patchCells = desc_.patchCells;
+	cd.lodCount = desc_.lodCount;
+	clipmap_.Initialize(cd);
+
 	if (!createMesh_(dx))
 		return false;
 	if (!createPipeline_(dx))
 		return false;
 
+	// FFT 海面（作れなければ式の波のまま）
+	if (desc_.useOceanFFT && !createOcean_(dx)) {
+		OutputDebugStringA("WaterSurface: OceanFFT init failed, using analytic waves\n");
+	}
+	if (!createRipples_(dx)) {
+		return false;
+	}
+
 	return true;
 }
 
 void WaterSurface::Shutdown() {
 	vb_.Reset();
 	ib_.Reset();
+	instanceVb_.Reset();
+	instanceCapacity_ = 0;
+	patches_.clear();
 	cbCommon_.Reset();
 	cbWave_.Reset();
 	rs_.Reset();
 	pso_.Reset();
+	psoOcean_.Reset();
+	oceanDisp_.Reset();
+	oceanNrm_.Reset();
+	cbOcean_.Reset();
+	ocean_ = OceanFFT{};
+	rippleBuf_.Reset();
+	cbRipple_.Reset();
+	ripples_ = WaterRipples{};
+	rippleMax_ = 0.0f;
 	indexCount_ = 0;
 	dx_ = nullptr;
 }
@@ -340,6 +456,78 @@ void WaterSurface::Shutdown() {
 void WaterSurface::Update(float deltaSeconds) {
 	time_ += deltaSeconds;
 	waveParam_.misc.x = time_;
+
+	// FFT 海面：CPU で計算してそのまま upload バッファへ（GPU は毎フレーム待っているので上書きしてよい）
+	if (ocean_.IsValid()) {
+		ocean_.Update(time_);
+		uploadOcean_();
+	}
+
+	// 波紋は固定ステップで進める（大きな dt でも発散しない）
+	if (ripples_.IsValid()) {
+		ripples_.Update(deltaSeconds);
+	}
+	uploadRipples_();
+}
+
+namespace {
+
+// 高さ場の法線に波紋の傾きを足す（VS と同じ）
+XMFLOAT3 AddSlope(const XMFLOAT3& n, float dhdx, float dhdz) {
+	const float inv = 1.0f / (std::max)(n.y, 1e-3f);
+	XMFLOAT3 r(n.x * inv - dhdx, 1.0f, n.z * inv - dhdz);
+	XMStoreFloat3(&r, XMVector3Normalize(XMLoadFloat3(&r)));
+	return r;
+}
+
+} // namespace
+
+float WaterSurface::SampleHeight(float x, float z) const {
+	const float ripple = ripples_.HeightAt(x, z);
+	if (ocean_.IsValid()) {
+		return desc_.height + ocean_.HeightAt(x, z) + ripple;
+	}
+	return WaterHeightAt(waveParam_, x, z) + ripple;
+}
+
+XMFLOAT3 WaterSurface::SampleNormal(float x, float z) const {
+	XMFLOAT3 n;
+	if (ocean_.IsValid()) {
+		const XMFLOAT2 s = ocean_.SourcePoint(x, z);
+		n = ocean_.NormalAt(s.x, s.y);
+	} else {
+		n = WaterNormalAt(waveParam_, x, z);
+	}
+	float dhdx, dhdz;
+	ripples_.SlopeAt(x, z, dhdx, dhdz);
+	return AddSlope(n, dhdx, dhdz);
+}
+
+void WaterSurface::SampleBatch(const float* xs, const float* zs, size_t count, float* heights, XMFLOAT3* normals) const {
+	if (!ocean_.IsValid()) {
+		WaterSampleBatch(waveParam_, xs, zs, count, heights, normals);
+	} else {
+		for (size_t i = 0; i < count; ++i) {
+			const XMFLOAT2 s = ocean_.SourcePoint(xs[i], zs[i]);
+			heights[i] = desc_.height + ocean_.DisplacementAt(s.x, s.y).y;
+			if (normals) {
+				normals[i] = ocean_.NormalAt(s.x, s.y);
+			}
+		}
+	}
+
+	// 波紋
+	if (!ripples_.IsValid()) {
+		return;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		heights[i] += ripples_.HeightAt(xs[i], zs[i]);
+		if (normals) {
+			float dhdx, dhdz;
+			ripples_.SlopeAt(xs[i], zs[i], dhdx, dhdz);
+			normals[i] = AddSlope(normals[i], dhdx, dhdz);
+		}
+	}
 }
 
 void WaterSurface::Draw(ID3D12GraphicsCommandList* cmd, const Camera& cam) {
@@ -362,7 +550,37 @@ void WaterSurface::Draw(ID3D12GraphicsCommandList* cmd, const Camera& cam) {
 	auto camPos = cam.Position();
 	cb.camPos = XMFLOAT4(camPos.x, camPos.y, camPos.z, 1.0f);
 
+	float lodStart, lodEnd;
+	clipmap_.MorphRange(0, lodStart, lodEnd);
+	cb.lod = XMFLOAT4(lodEnd, clipmap_.GetDesc().morphStartRatio, float(clipmap_.LodCount()), float(clipmap_.GetDesc().patchCells));
+
+	// ---- パッチの選択（視錐台の外と地形の下は捨てる）----
+	XMFLOAT4 planes[6];
+	TerrainLodSelector::ExtractFrustumPlanes(MVP, planes);
+	clipmap_.Select(camPos, planes, desc_.height, waveBound_(), waveMargin_(), patches_);
+	if (patches_.empty()) {
+		return;
+	}
+
+	// インスタンスバッファ（GPU は毎フレーム待っているので作り直し/上書きしてよい）
+	if (patches_.size() > instanceCapacity_) {
+		instanceCapacity_ = (std::max)(instanceCapacity_ * 2, (std::max)(patches_.size(), size_t(64)));
+		CD3DX12_HEAP_PROPERTIES hpU(D3D12_HEAP_TYPE_UPLOAD);
+		auto rd = CD3DX12_RESOURCE_DESC::Buffer(sizeof(WaterPatch) * instanceCapacity_);
+		instanceVb_.Reset();
+		HR_CHECK(dx_->Dev()->CreateCommittedResource(&hpU, D3D12_HEAP_FLAG_NONE, &rd, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&instanceVb_)));
+	}
+
 	void* p = nullptr;
+	instanceVb_->Map(0, nullptr, &p);
+	memcpy(p, patches_.data(), sizeof(WaterPatch) * patches_.size());
+	instanceVb_->Unmap(0, nullptr);
+
+	D3D12_VERTEX_BUFFER_VIEW views[2] = {vbv_, {}};
+	views[1].BufferLocation = instanceVb_->GetGPUVirtualAddress();
+	views[1].SizeInBytes = static_cast<UINT>(sizeof(WaterPatch) * patches_.size());
+	views[1].StrideInBytes = sizeof(WaterPatch);
+
 	cbCommon_->Map(0, nullptr, &p);
 	memcpy(p, &cb, sizeof(cb));
 	cbCommon_->Unmap(0, nullptr);
@@ -372,68 +590,40 @@ void WaterSurface::Draw(ID3D12GraphicsCommandList* cmd, const Camera& cam) {
 	memcpy(p, &waveParam_, sizeof(waveParam_));
 	cbWave_->Unmap(0, nullptr);
 
-	cmd->SetPipelineState(pso_.Get());
+	const bool ocean = ocean_.IsValid() && psoOcean_;
+	cmd->SetPipelineState(ocean ? psoOcean_.Get() : pso_.Get());
 	cmd->SetGraphicsRootSignature(rs_.Get());
 
 	cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	cmd->IASetVertexBuffers(0, 1, &vbv_);
+	cmd->IASetVertexBuffers(0, 2, views);
 	cmd->IASetIndexBuffer(&ibv_);
 
 	cmd->SetGraphicsRootConstantBufferView(0, cbCommon_->GetGPUVirtualAddress());
 	cmd->SetGraphicsRootConstantBufferView(1, cbWave_->GetGPUVirtualAddress());
 
-	cmd->DrawIndexedInstanced(indexCount_, 1, 0, 0, 0);
+	// 使わないルート引数も未設定にはしない（シェーダは読まないのでどのバッファでもよい）
+	const D3D12_GPU_VIRTUAL_ADDRESS unused = cbWave_->GetGPUVirtualAddress();
+	cmd->SetGraphicsRootConstantBufferView(2, ocean ? cbOcean_->GetGPUVirtualAddress() : unused);
+	cmd->SetGraphicsRootShaderResourceView(3, ocean ? oceanDisp_->GetGPUVirtualAddress() : unused);
+	cmd->SetGraphicsRootShaderResourceView(4, ocean ? oceanNrm_->GetGPUVirtualAddress() : unused);
+	cmd->SetGraphicsRootConstantBufferView(5, cbRipple_->GetGPUVirtualAddress());
+	cmd->SetGraphicsRootShaderResourceView(6, rippleBuf_ ? rippleBuf_->GetGPUVirtualAddress() : unused);
+
+	cmd->DrawIndexedInstanced(indexCount_, static_cast<UINT>(patches_.size()), 0, 0, 0);
 }
 
 // ------------ 内部：メッシュ生成 ------------
+// パッチ 1 枚ぶん（全 LOD で共用。位置と間隔はインスタンスで与える）
 bool WaterSurface::createMesh_(WindowDX& dx) {
-	const unsigned int vxCountX = desc_.tessX + 1;
-	const unsigned int vxCountZ = desc_.tessZ + 1;
-
-	const float halfX = desc_.sizeX * 0.5f;
-	const float halfZ = desc_.sizeZ * 0.5f;
-
-	std::vector<Vertex> verts;
-	verts.resize(static_cast<size_t>(vxCountX) * vxCountZ);
-
-	// X,Z 平面を原点中心で作成（Y=0。高さはシェーダで）
-	for (unsigned int z = 0; z < vxCountZ; ++z) {
-		float tz = static_cast<float>(z) / desc_.tessZ;
-		float posZ = -halfZ + desc_.sizeZ * tz;
-
-		for (unsigned int x = 0; x < vxCountX; ++x) {
-			float tx = static_cast<float>(x) / desc_.tessX;
-			float posX = -halfX + desc_.sizeX * tx;
-
-			Vertex v{};
-			v.pos = XMFLOAT3(posX, 0.0f, posZ);
-			v.uv = XMFLOAT2(tx, tz);
-
-			verts[z * vxCountX + x] = v;
-		}
-	}
-
-	// インデックス
+	std::vector<XMFLOAT2> grid;
 	std::vector<uint32_t> indices;
-	indices.reserve(static_cast<size_t>(desc_.tessX) * desc_.tessZ * 6);
-
-	for (unsigned int z = 0; z < desc_.tessZ; ++z) {
-		for (unsigned int x = 0; x < desc_.tessX; ++x) {
-			uint32_t i0 = z * vxCountX + x;
-			uint32_t i1 = z * vxCountX + (x + 1);
-			uint32_t i2 = (z + 1) * vxCountX + x;
-			uint32_t i3 = (z + 1) * vxCountX + (x + 1);
-
-			// 頂点順を i0, i2, i1 / i1, i2, i3 に変更
-			indices.push_back(i0);
-			indices.push_back(i2);
-			indices.push_back(i1);
-
-			indices.push_back(i1);
-			indices.push_back(i2);
-			indices.push_back(i3);
-		}
+	clipmap_.BuildPatchMesh(grid, indices);
+
+	std::vector<Vertex> verts(grid.size());
+	for (size_t i = 0; i < grid.size(); ++i) {
+		verts[i].grid = grid[i];
 	}
+	patchVertexCount_ = static_cast<unsigned int>(verts.size());
 
 	indexCount_ = static_cast<unsigned int>(indices.size());
 
@@ -486,10 +676,15 @@ bool WaterSurface::createMesh_(WindowDX& dx) {
 
 // ------------ 内部：PSO 生成 ------------
 bool WaterSurface::createPipeline_(WindowDX& dx) {
-	// RootSignature: b0, b1 (CBV 2つだけ)
-	CD3DX12_ROOT_PARAMETER rp[2];
+	// RootSignature: b0, b1, b2 (CBV) + t0, t1 (ルート SRV。FFT 海面のときだけ使う) + b3, t2 (波紋)
+	CD3DX12_ROOT_PARAMETER rp[7];
 	rp[0].InitAsConstantBufferView(0); // CBCommon
 	rp[1].InitAsConstantBufferView(1); // CBWave
+	rp[2].InitAsConstantBufferView(2, 0, D3D12_SHADER_VISIBILITY_VERTEX);   // CBOcean
+	rp[3].InitAsShaderResourceView(0, 0, D3D12_SHADER_VISIBILITY_VERTEX);   // 横ずれ + 高さ
+	rp[4].InitAsShaderResourceView(1, 0, D3D12_SHADER_VISIBILITY_VERTEX);   // 法線 + ヤコビアン
+	rp[5].InitAsConstantBufferView(3, 0, D3D12_SHADER_VISIBILITY_VERTEX);   // CBRipple
+	rp[6].InitAsShaderResourceView(2, 0, D3D12_SHADER_VISIBILITY_VERTEX);   // 波紋の高さ
 
 	CD3DX12_ROOT_SIGNATURE_DESC rsd;
 	rsd.Init(_countof(rp), rp, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
@@ -502,10 +697,10 @@ bool WaterSurface::createPipeline_(WindowDX& dx) {
 	auto vs = CompileShader(gVSWater, "main", "vs_5_0");
 	auto ps = CompileShader(gPSWater, "main", "ps_5_0");
 
-	// 入力レイアウト
+	// 入力レイアウト（スロット 1 はパッチごとの WaterPatch）
 	D3D12_INPUT_ELEMENT_DESC il[] = {
-	    {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-	    {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {"POSITION", 0, DXGI_FORMAT_R32G32_FLOAT,       0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,   0},
+	    {"PATCH",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
 	};
 
 	// PSO
@@ -538,7 +733,108 @@ bool WaterSurface::createPipeline_(WindowDX& dx) {
 
 	HR_CHECK(dx.Dev()->CreateGraphicsPipelineState(&d, IID_PPV_ARGS(&pso_)));
 
+	// FFT 海面版（VS だけ差し替え）
+	if (desc_.useOceanFFT) {
+		const D3D_SHADER_MACRO defines[] = {
+		    {"OCEAN_FFT", "1"},
+		    {nullptr,     nullptr},
+		};
+		auto vsOcean = CompileShader(gVSWater, "main", "vs_5_0", defines);
+		d.VS = {vsOcean->GetBufferPointer(), vsOcean->GetBufferSize()};
+		HR_CHECK(dx.Dev()->CreateGraphicsPipelineState(&d, IID_PPV_ARGS(&psoOcean_)));
+	}
+
+	return true;
+}
+
+// ------------ 内部：FFT 海面 ------------
+bool WaterSurface::createOcean_(WindowDX& dx) {
+	if (!ocean_.Initialize(desc_.ocean)) {
+		return false;
+	}
+
+	const uint32_t n = ocean_.Resolution();
+	const UINT64 bytes = sizeof(XMFLOAT4) * n * n;
+
+	CD3DX12_HEAP_PROPERTIES hpU(D3D12_HEAP_TYPE_UPLOAD);
+	auto rd = CD3DX12_RESOURCE_DESC::Buffer(bytes);
+	HR_CHECK(dx.Dev()->CreateCommittedResource(&hpU, D3D12_HEAP_FLAG_NONE, &rd, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&oceanDisp_)));
+	HR_CHECK(dx.Dev()->CreateCommittedResource(&hpU, D3D12_HEAP_FLAG_NONE, &rd, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&oceanNrm_)));
+
+	auto rdCb = CD3DX12_RESOURCE_DESC::Buffer(256);
+	HR_CHECK(dx.Dev()->CreateCommittedResource(&hpU, D3D12_HEAP_FLAG_NONE, &rdCb, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&cbOcean_)));
+
+	CBOcean cb{};
+	cb.params = XMFLOAT4(ocean_.PatchSize(), float(n), 0.0f, 0.0f);
+	void* p = nullptr;
+	cbOcean_->Map(0, nullptr, &p);
+	memcpy(p, &cb, sizeof(cb));
+	cbOcean_->Unmap(0, nullptr);
+
+	// 最初のフレームの分
+	ocean_.Update(time_);
+	uploadOcean_();
 	return true;
 }
 
+// 高さの上限。FFT 海面は直近の Update の実測値（マップの双線形補間はこれを超えない）
+float WaterSurface::waveBound_() const {
+	if (ocean_.IsValid()) {
+		return ocean_.MaxHeight() + rippleMax_;
+	}
+	return WaterWaveAmplitude(waveParam_) + rippleMax_;
+}
+
+// 横ずれの上限。手続きの波は高さだけ動かすので 0
+float WaterSurface::waveMargin_() const {
+	return ocean_.IsValid() ? ocean_.MaxHorizontal() : 0.0f;
+}
+
+// ------------ 内部：波紋 ------------
+// 無効でも CBRipple は作る（resolution = 0 で VS が読まない）
+bool WaterSurface::createRipples_(WindowDX& dx) {
+	CD3DX12_HEAP_PROPERTIES hpU(D3D12_HEAP_TYPE_UPLOAD);
+	auto rdCb = CD3DX12_RESOURCE_DESC::Buffer(256);
+	HR_CHECK(dx.Dev()->CreateCommittedResource(&hpU, D3D12_HEAP_FLAG_NONE, &rdCb, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&cbRipple_)));
+
+	if (desc_.useRipples && ripples_.Initialize(desc_.ripples)) {
+		const uint32_t n = ripples_.Resolution();
+		auto rd = CD3DX12_RESOURCE_DESC::Buffer(sizeof(float) * n * n);
+		HR_CHECK(dx.Dev()->CreateCommittedResource(&hpU, D3D12_HEAP_FLAG_NONE, &rd, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&rippleBuf_)));
+	}
+	uploadRipples_();
+	return true;
+}
+
+void WaterSurface::uploadRipples_() {
+	CBRipple cb{};
+	void* p = nullptr;
+	if (ripples_.IsValid() && rippleBuf_) {
+		const auto& h = ripples_.Heights();
+		rippleBuf_->Map(0, nullptr, &p);
+		memcpy(p, h.data(), sizeof(float) * h.size());
+		rippleBuf_->Unmap(0, nullptr);
+
+		const auto mm = std::minmax_element(h.begin(), h.end());
+		rippleMax_ = (std::max)(-*mm.first, *mm.second);
+		cb.params = XMFLOAT4(ripples_.OriginX(), ripples_.OriginZ(), ripples_.CellSize(), float(ripples_.Resolution()));
+	}
+
+	cbRipple_->Map(0, nullptr, &p);
+	memcpy(p, &cb, sizeof(cb));
+	cbRipple_->Unmap(0, nullptr);
+}
+
+void WaterSurface::uploadOcean_() {
+	const size_t bytes = sizeof(XMFLOAT4) * ocean_.Displacement().size();
+	void* p = nullptr;
+	oceanDisp_->Map(0, nullptr, &p);
+	memcpy(p, ocean_.Displacement().data(), bytes);
+	oceanDisp_->Unmap(0, nullptr);
+
+	oceanNrm_->Map(0, nullptr, &p);
+	memcpy(p, ocean_.Normals().data(), bytes);
+	oceanNrm_->Unmap(0, nullptr);
+}
+
 } // namespace Engine
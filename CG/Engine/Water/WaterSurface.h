@@ -1,8 +1,14 @@
 // Engine/Water/WaterSurface.h
 #pragma once
 
+#include "OceanFFT.h"
+#include "WaterClipmap.h"
+#include "WaterRipples.h"
+#include "WaterWaves.h"
 #include <DirectXMath.h>
+#include <cstddef>
 #include <d3d12.h>
+#include <vector>
 #include <wrl/client.h>
 
 namespace Engine {
@@ -12,11 +18,22 @@ class Camera;   // 既存
 
 // 水面の基本設定
 struct WaterSurfaceDesc {
-	float sizeX = 400.0f;     // X方向の広さ
-	float sizeZ = 400.0f;     // Z方向の広さ
-	unsigned int tessX = 200; // 分割数（多いほど細かい）
-	unsigned int tessZ = 200;
-	float height = 0.0f; // 水面の Y 位置
+	float sizeX = 400.0f; // X方向の広さ（カメラを中心に覆う）
+	float sizeZ = 400.0f; // Z方向の広さ
+	float height = 0.0f;  // 水面の Y 位置
+
+	// カメラ中心の LOD メッシュ（WaterClipmap）。近くは finestCell 間隔、遠くほど 2 倍ずつ粗く
+	float finestCell = 1.0f;      // いちばん細かい頂点間隔 [m]
+	unsigned int patchCells = 16; // パッチ一辺のセル数（2 のべき乗）
+	unsigned int lodCount = 7;    // LOD の段数
+
+	// true なら sin の重ね合わせの代わりに FFT 海面（OceanFFT）のマップを VS で引く
+	bool useOceanFFT = false;
+	OceanFFT::Desc ocean{};
+
+	// true ならプレイヤーの周りの波紋（WaterRipples）を上に足す
+	bool useRipples = true;
+	WaterRipples::Desc ripples{};
 };
 
 class WaterSurface {
@@ -33,10 +50,53 @@ public:
 	// Camera は既存のものを使う（Skybox / Voxel と同じ）
 	void Draw(ID3D12GraphicsCommandList* cmd, const Camera& cam);
 
+	// ---- CPU 側の問い合わせ（今の time_ で VS と同じ波を計算する）----
+	// 浮かせる / しぶき / 水中判定など。メッシュの外でも同じ式で返す（FFT 海面ならタイルの繰り返し）
+	float SampleHeight(float x, float z) const;
+	DirectX::XMFLOAT3 SampleNormal(float x, float z) const;
+
+	// 点が多いとき用（normals は null なら高さだけ）
+	void SampleBatch(const float* xs, const float* zs, size_t count, float* heights, DirectX::XMFLOAT3* normals = nullptr) const;
+
+	// 水面メッシュが張られている範囲か（直近の Draw のカメラ中心）
+	bool Contains(float x, float z) const {
+		const DirectX::XMFLOAT2 c = clipmap_.Center();
+		return x >= c.x - 0.5f * desc_.sizeX && x <= c.x + 0.5f * desc_.sizeX && z >= c.y - 0.5f * desc_.sizeZ && z <= c.y + 0.5f * desc_.sizeZ;
+	}
+
+	float Time() const { return time_; }
+	const WaterWaveParams& WaveParams() const { return waveParam_; }
+
+	// ---- 波紋 ----
+	// 波紋の格子の中心（毎フレームプレイヤー位置を渡す）
+	void SetRippleCenter(float x, float z) { ripples_.SetCenter(x, z); }
+	// 着水/叩きつけなど。strength [m] は持ち上げる量（負で凹む）。格子の外は無視
+	void AddRipple(float x, float z, float radius, float strength) { ripples_.AddImpulse(x, z, radius, strength); }
+	const WaterRipples& Ripples() const { return ripples_; }
+
+	bool UsesOceanFFT() const { return ocean_.IsValid(); }
+	const OceanFFT& Ocean() const { return ocean_; }
+
+	// ---- カリング ----
+	// XZ 矩形の地形の最低の高さ（Renderer::TerrainMinHeightIn など）。水面より地形が高いパッチは描かない
+	void SetTerrainQuery(WaterClipmap::TerrainMinQuery query) { clipmap_.SetTerrainQuery(std::move(query)); }
+	// 直近の Draw のパッチの内訳（描いた / 視錐台の外 / 地形の下）
+	const WaterCullStats& CullStats() const { return clipmap_.Stats(); }
+
+	// 直近の Draw で描いたパッチ数と頂点数、送ったインデックス数
+	unsigned int DrawnPatches() const { return static_cast<unsigned int>(patches_.size()); }
+	unsigned int DrawnVertices() const { return static_cast<unsigned int>(patches_.size()) * patchVertexCount_; }
+	unsigned int SubmittedIndices() const { return static_cast<unsigned int>(patches_.size()) * indexCount_; }
+	// カリングしなかった場合のインデックス数
+	unsigned int CandidateIndices() const {
+		const WaterCullStats& s = clipmap_.Stats();
+		return (s.drawn + s.frustumCulled + s.terrainCulled) * indexCount_;
+	}
+
 private:
+	// パッチの格子点（0..patchCells）。ワールド位置はインスタンスの WaterPatch から
 	struct Vertex {
-		DirectX::XMFLOAT3 pos; // x,z 平面の頂点
-		DirectX::XMFLOAT2 uv;
+		DirectX::XMFLOAT2 grid;
 	};
 
 	// b0: WVP + 色
@@ -44,21 +104,30 @@ private:
 		DirectX::XMFLOAT4X4 mvp;
 		DirectX::XMFLOAT4 color;
 		DirectX::XMFLOAT4 camPos; // xyz: カメラ位置
+		DirectX::XMFLOAT4 lod;    // LOD 0 の範囲, morphStartRatio, LOD の段数, パッチのセル数
 	};
 
-	// b1: 波パラメータ + 時間
-	//
-	// wave1 : dirX, dirZ, amplitude, frequency
-	// wave2 : dirX, dirZ, amplitude, frequency
-	// misc  : time, waterHeight, reserved, reserved
-	struct CBWave {
-		DirectX::XMFLOAT4 wave1;
-		DirectX::XMFLOAT4 wave2;
-		DirectX::XMFLOAT4 misc;
+	// b1: 波パラメータ + 時間（CPU 側の問い合わせと共用）
+	using CBWave = WaterWaveParams;
+
+	// b2: FFT 海面のタイル
+	struct CBOcean {
+		DirectX::XMFLOAT4 params; // patchSize, resolution, _, _
+	};
+
+	// b3: 波紋の格子
+	struct CBRipple {
+		DirectX::XMFLOAT4 params; // originX, originZ, cellSize, resolution（0 なら波紋なし）
 	};
 
 	bool createMesh_(WindowDX& dx);
+	float waveBound_() const;   // 水面の高さからのずれの上限
+	float waveMargin_() const;  // XZ の横ずれの上限
 	bool createPipeline_(WindowDX& dx);
+	bool createOcean_(WindowDX& dx);
+	void uploadOcean_();
+	bool createRipples_(WindowDX& dx);
+	void uploadRipples_();
 
 private:
 	WindowDX* dx_ = nullptr;
@@ -70,6 +139,13 @@ private:
 	D3D12_VERTEX_BUFFER_VIEW vbv_{};
 	D3D12_INDEX_BUFFER_VIEW ibv_{};
 	unsigned int indexCount_ = 0;
+	unsigned int patchVertexCount_ = 0;
+
+	// LOD の選択とインスタンス（WaterPatch をそのまま並べる。足りなくなったら倍に作り直す）
+	WaterClipmap clipmap_;
+	std::vector<WaterPatch> patches_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> instanceVb_;
+	size_t instanceCapacity_ = 0;
 
 	// 定数バッファ
 	Microsoft::WRL::ComPtr<ID3D12Resource> cbCommon_;
@@ -78,6 +154,19 @@ private:
 	// ルートシグネチャ / PSO
 	Microsoft::WRL::ComPtr<ID3D12RootSignature> rs_;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> pso_;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> psoOcean_; // OCEAN_FFT 版の VS
+
+	// FFT 海面（t0: 横ずれ+高さ, t1: 法線+ヤコビアン。StructuredBuffer<float4> n*n）
+	OceanFFT ocean_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> oceanDisp_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> oceanNrm_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> cbOcean_;
+
+	// 波紋（t2: StructuredBuffer<float> n*n の高さ）
+	WaterRipples ripples_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> rippleBuf_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> cbRipple_;
+	float rippleMax_ = 0.0f; // 直近の |高さ| の最大（カリングの箱用）
 
 	// 内部状態
 	float time_ = 0.0f;
@@ -0,0 +1,185 @@
+// Engine/Water/WaterWaves.cpp
+#include "WaterWaves.h"
+#include <cmath>
+
+namespace Engine {
+
+using namespace DirectX;
+
+namespace {
+
+// heightAt の中の固定値（gVSWater と同じ）
+constexpr float kMidAmp = 0.18f;
+constexpr float kMidK = 0.35f;
+constexpr float kMidSpeed = 0.9f;
+constexpr float kSmallAmp = 0.06f;
+constexpr float kSmallK1 = 0.90f;
+constexpr float kSmallK2 = 1.30f;
+constexpr float kTinyAmp = 0.04f;
+constexpr float kTinyK1 = 1.9f;
+constexpr float kTinyK2 = 2.5f;
+
+// 点によらない値（方向の正規化と時間の位相）を 1 回だけ計算しておく
+struct WaveConsts {
+	float base;
+	float d1x, d1z, f1, a1, ph1;
+	float d2x, d2z, f2, a2, ph2;
+	float d3x, d3z, ph3;
+	float d4x, d4z, ph4;
+	float r1x, r1z, r2x, r2z; // さざ波のずれ
+	float s1x, s1z, s2x, s2z; // 極小の波のずれ
+};
+
+void Normalize2(float x, float z, float& ox, float& oz) {
+	const float inv = 1.0f / std::sqrt(x * x + z * z);
+	ox = x * inv;
+	oz = z * inv;
+}
+
+WaveConsts MakeConsts(const WaterWaveParams& p) {
+	const float t = p.misc.x;
+	WaveConsts c{};
+	c.base = p.misc.y;
+
+	Normalize2(p.wave1.x, p.wave1.y, c.d1x, c.d1z);
+	c.a1 = p.wave1.z;
+	c.f1 = p.wave1.w;
+	c.ph1 = t * c.f1;
+
+	Normalize2(p.wave2.x, p.wave2.y, c.d2x, c.d2z);
+	c.a2 = p.wave2.z;
+	c.f2 = p.wave2.w;
+	c.ph2 = t * c.f2 * 1.1f;
+
+	Normalize2(0.8f, 0.6f, c.d3x, c.d3z);
+	Normalize2(-0.6f, 0.9f, c.d4x, c.d4z);
+	c.ph3 = t * kMidSpeed;
+	c.ph4 = t * (kMidSpeed * 1.2f);
+
+	c.r1x = t * 1.3f;
+	c.r1z = t * 0.9f;
+	c.r2x = -t * 1.0f;
+	c.r2z = t * 1.2f;
+
+	c.s1x = t * 1.4f;
+	c.s1z = t * 1.0f;
+	c.s2x = -t * 1.1f;
+	c.s2z = t * 1.6f;
+	return c;
+}
+
+float Height(const WaveConsts& c, float x, float z) {
+	float h = c.base;
+
+	// 1) 大きいうねり
+	h += std::sin((c.d1x * x + c.d1z * z) * c.f1 + c.ph1) * c.a1;
+	h += std::sin((c.d2x * x + c.d2z * z) * c.f2 + c.ph2) * c.a2;
+
+	// 2) 中くらいの波
+	h += std::sin((c.d3x * x + c.d3z * z) * kMidK + c.ph3) * kMidAmp;
+	h += std::sin((c.d4x * x + c.d4z * z) * kMidK * 1.3f + c.ph4) * kMidAmp;
+
+	// 3) さざ波
+	{
+		const float r1x = x * kSmallK1 + c.r1x;
+		const float r1z = z * kSmallK1 + c.r1z;
+		const float r2x = x * kSmallK2 + c.r2x;
+		const float r2z = z * kSmallK2 + c.r2z;
+		const float sr1 = std::sin(r1x) * std::cos(r1z * 1.3f);
+		const float sr2 = std::cos(r2x * 1.2f) * std::sin(r2z);
+		h += (sr1 + sr2) * 0.5f * kSmallAmp;
+	}
+
+	// 4) 極小の速い波
+	{
+		const float s1x = x * kTinyK1 + c.s1x;
+		const float s1z = z * kTinyK1 + c.s1z;
+		const float s2x = x * kTinyK2 + c.s2x;
+		const float s2z = z * kTinyK2 + c.s2z;
+		const float tw1 = std::sin(s1x) * std::cos(s1z * 1.1f);
+		const float tw2 = std::cos(s2x * 1.3f) * std::sin(s2z);
+		h += (tw1 + tw2) * 0.5f * kTinyAmp;
+	}
+	return h;
+}
+
+// Height の 4 点版（演算の順番は同じ）
+XMVECTOR Height4(const WaveConsts& c, FXMVECTOR x, FXMVECTOR z) {
+	auto rep = [](float v) { return XMVectorReplicate(v); };
+	auto dot = [&](float dx, float dz) { return XMVectorAdd(XMVectorMultiply(rep(dx), x), XMVectorMultiply(rep(dz), z)); };
+
+	XMVECTOR h = rep(c.base);
+	h = XMVectorAdd(h, XMVectorMultiply(XMVectorSin(XMVectorAdd(XMVectorMultiply(dot(c.d1x, c.d1z), rep(c.f1)), rep(c.ph1))), rep(c.a1)));
+	h = XMVectorAdd(h, XMVectorMultiply(XMVectorSin(XMVectorAdd(XMVectorMultiply(dot(c.d2x, c.d2z), rep(c.f2)), rep(c.ph2))), rep(c.a2)));
+
+	h = XMVectorAdd(h, XMVectorMultiply(XMVectorSin(XMVectorAdd(XMVectorMultiply(dot(c.d3x, c.d3z), rep(kMidK)), rep(c.ph3))), rep(kMidAmp)));
+	h = XMVectorAdd(h, XMVectorMultiply(XMVectorSin(XMVectorAdd(XMVectorMultiply(XMVectorMultiply(dot(c.d4x, c.d4z), rep(kMidK)), rep(1.3f)), rep(c.ph4))), rep(kMidAmp)));
+
+	// sin(a) * cos(b * kb) + cos(c * kc) * sin(d) を半分にして振幅を掛ける
+	auto cross = [&](float k1, float o1x, float o1z, float kb, float k2, float o2x, float o2z, float kc, float amp) {
+		const XMVECTOR ax = XMVectorAdd(XMVectorMultiply(x, rep(k1)), rep(o1x));
+		const XMVECTOR az = XMVectorAdd(XMVectorMultiply(z, rep(k1)), rep(o1z));
+		const XMVECTOR bx = XMVectorAdd(XMVectorMultiply(x, rep(k2)), rep(o2x));
+		const XMVECTOR bz = XMVectorAdd(XMVectorMultiply(z, rep(k2)), rep(o2z));
+		const XMVECTOR w1 = XMVectorMultiply(XMVectorSin(ax), XMVectorCos(XMVectorMultiply(az, rep(kb))));
+		const XMVECTOR w2 = XMVectorMultiply(XMVectorCos(XMVectorMultiply(bx, rep(kc))), XMVectorSin(bz));
+		return XMVectorMultiply(XMVectorMultiply(XMVectorAdd(w1, w2), rep(0.5f)), rep(amp));
+	};
+	h = XMVectorAdd(h, cross(kSmallK1, c.r1x, c.r1z, 1.3f, kSmallK2, c.r2x, c.r2z, 1.2f, kSmallAmp));
+	h = XMVectorAdd(h, cross(kTinyK1, c.s1x, c.s1z, 1.1f, kTinyK2, c.s2x, c.s2z, 1.3f, kTinyAmp));
+	return h;
+}
+
+// VS と同じ normalize(float3(-h_dx, 2 * eps, -h_dz))
+XMFLOAT3 NormalFromDiff(float hdx, float hdz) {
+	const float ny = 2.0f * kWaterNormalEps;
+	const float inv = 1.0f / std::sqrt(hdx * hdx + ny * ny + hdz * hdz);
+	return {-hdx * inv, ny * inv, -hdz * inv};
+}
+
+} // namespace
+
+float WaterWaveAmplitude(const WaterWaveParams& p) { return std::fabs(p.wave1.z) + std::fabs(p.wave2.z) + 2.0f * kMidAmp + kSmallAmp + kTinyAmp; }
+
+float WaterHeightAt(const WaterWaveParams& p, float x, float z) { return Height(MakeConsts(p), x, z); }
+
+XMFLOAT3 WaterNormalAt(const WaterWaveParams& p, float x, float z) {
+	const WaveConsts c = MakeConsts(p);
+	const float e = kWaterNormalEps;
+	const float hdx = Height(c, x + e, z) - Height(c, x - e, z);
+	const float hdz = Height(c, x, z + e) - Height(c, x, z - e);
+	return NormalFromDiff(hdx, hdz);
+}
+
+void WaterSampleBatch(const WaterWaveParams& p, const float* xs, const float* zs, size_t count, float* heights, XMFLOAT3* normals) {
+	const WaveConsts c = MakeConsts(p);
+	const XMVECTOR e = XMVectorReplicate(kWaterNormalEps);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const XMVECTOR x = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(xs + i));
+		const XMVECTOR z = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(zs + i));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(heights + i), Height4(c, x, z));
+
+		if (normals) {
+			XMFLOAT4 hdx, hdz;
+			XMStoreFloat4(&hdx, XMVectorSubtract(Height4(c, XMVectorAdd(x, e), z), Height4(c, XMVectorSubtract(x, e), z)));
+			XMStoreFloat4(&hdz, XMVectorSubtract(Height4(c, x, XMVectorAdd(z, e)), Height4(c, x, XMVectorSubtract(z, e))));
+			normals[i + 0] = NormalFromDiff(hdx.x, hdz.x);
+			normals[i + 1] = NormalFromDiff(hdx.y, hdz.y);
+			normals[i + 2] = NormalFromDiff(hdx.z, hdz.z);
+			normals[i + 3] = NormalFromDiff(hdx.w, hdz.w);
+		}
+	}
+
+	// 端数
+	for (; i < count; ++i) {
+		heights[i] = Height(c, xs[i], zs[i]);
+		if (normals) {
+			const float ex = kWaterNormalEps;
+			normals[i] = NormalFromDiff(Height(c, xs[i] + ex, zs[i]) - Height(c, xs[i] - ex, zs[i]), Height(c, xs[i], zs[i] + ex) - Height(c, xs[i], zs[i] - ex));
+		}
+	}
+}
+
+} // namespace Engine
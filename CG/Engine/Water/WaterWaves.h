@@ -0,0 +1,39 @@
+// Engine/Water/WaterWaves.h
+#pragma once
+// =======================================
+//  WaterWaves : 水面の VS（gVSWater の heightAt）と同じ波を CPU で計算する
+//  - 式と演算の順番は HLSL に合わせてある（HLSL を直したらこちらも直す）
+//  - 法線も VS と同じ中心差分（kWaterNormalEps）なので、描画された面とそろう
+//  - バッチ版は 4 点ずつ DirectXMath（SSE）で計算する（浮遊物/パーティクル用）
+//    XMVectorSin/Cos は多項式近似なので、1 点版とは一致しない（|x|,|z| <= 500 で高さ 2e-5 m 程度。Tests/WaterWavesTest）
+// =======================================
+#include <DirectXMath.h>
+#include <cstddef>
+
+namespace Engine {
+
+// 波パラメータ + 時間（= 水面の b1 定数バッファ）
+//
+// wave1 : dirX, dirZ, amplitude, frequency
+// wave2 : dirX, dirZ, amplitude, frequency
+// misc  : time, waterHeight, reserved, reserved
+struct WaterWaveParams {
+	DirectX::XMFLOAT4 wave1;
+	DirectX::XMFLOAT4 wave2;
+	DirectX::XMFLOAT4 misc;
+};
+
+// VS の法線の中心差分の幅
+constexpr float kWaterNormalEps = 0.4f;
+
+// waterHeight からいちばん離れうる量（振幅の合計。カリングの箱用）
+float WaterWaveAmplitude(const WaterWaveParams& p);
+
+// 1 点ぶん
+float WaterHeightAt(const WaterWaveParams& p, float x, float z);
+DirectX::XMFLOAT3 WaterNormalAt(const WaterWaveParams& p, float x, float z);
+
+// count 点ぶん。normals は null なら高さだけ。アラインは不要
+void WaterSampleBatch(const WaterWaveParams& p, const float* xs, const float* zs, size_t count, float* heights, DirectX::XMFLOAT3* normals = nullptr);
+
+} // namespace Engine
@@ -0,0 +1,52 @@
+#pragma once
+#include "AABB.h"
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace Engine {
+
+// AABB の集まりを成分ごとの配列（SoA）で持つ。Collision::NearestHit などで 8 個ずつまとめて判定する
+// - 配列の長さは 8 の倍数。余りは「空の箱」（min = +inf, max = -inf）で埋めてあり、どのレイにも当たらない
+// - 番号は Build に渡した並びのまま
+struct AABBSet {
+	static constexpr size_t kBatch = 8;
+
+	std::vector<float> minX, minY, minZ;
+	std::vector<float> maxX, maxY, maxZ;
+	size_t count = 0;
+
+	void Build(const std::vector<AABB>& boxes) {
+		count = boxes.size();
+		const size_t padded = (count + kBatch - 1) / kBatch * kBatch;
+		const float inf = std::numeric_limits<float>::infinity();
+		minX.assign(padded, inf);
+		minY.assign(padded, inf);
+		minZ.assign(padded, inf);
+		maxX.assign(padded, -inf);
+		maxY.assign(padded, -inf);
+		maxZ.assign(padded, -inf);
+		for (size_t i = 0; i < count; ++i) {
+			Set(i, boxes[i]);
+		}
+	}
+
+	// 動く箱（リフトなど）の更新用
+	void Set(size_t i, const AABB& b) {
+		minX[i] = b.min.x;
+		minY[i] = b.min.y;
+		minZ[i] = b.min.z;
+		maxX[i] = b.max.x;
+		maxY[i] = b.max.y;
+		maxZ[i] = b.max.z;
+	}
+
+	AABB Get(size_t i) const { return AABB{{minX[i], minY[i], minZ[i]}, {maxX[i], maxY[i], maxZ[i]}}; }
+
+	size_t Size() const { return count; }
+	size_t PaddedSize() const { return minX.size(); }
+	bool Empty() const { return count == 0; }
+	void Clear() { Build({}); }
+};
+
+} // namespace Engine
@@ -0,0 +1,382 @@
+#include "AABBTree.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Engine {
+
+namespace {
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+
+inline float Axis(const Vector3& v, int a) { return a == 0 ? v.x : (a == 1 ? v.y : v.z); }
+
+inline void Grow(Vector3& lo, Vector3& hi, const Vector3& pmin, const Vector3& pmax) {
+	lo = {(std::min)(lo.x, pmin.x), (std::min)(lo.y, pmin.y), (std::min)(lo.z, pmin.z)};
+	hi = {(std::max)(hi.x, pmax.x), (std::max)(hi.y, pmax.y), (std::max)(hi.z, pmax.z)};
+}
+
+inline float HalfArea(const Vector3& lo, const Vector3& hi) {
+	const float dx = hi.x - lo.x, dy = hi.y - lo.y, dz = hi.z - lo.z;
+	return (dx < 0.0f || dy < 0.0f || dz < 0.0f) ? 0.0f : dx * dy + dy * dz + dz * dx;
+}
+
+// ノードの外枠に対するレイ（線分）の区間。Collision と同じく |d| < 1e-6 の軸は平行として扱う
+struct NodeRay {
+	float o[3];
+	float invD[3];
+	bool parallel[3];
+};
+
+NodeRay MakeNodeRay(const Vector3& origin, const Vector3& dir) {
+	NodeRay r{};
+	const float d[3] = {dir.x, dir.y, dir.z};
+	r.o[0] = origin.x;
+	r.o[1] = origin.y;
+	r.o[2] = origin.z;
+	for (int a = 0; a < 3; ++a) {
+		r.parallel[a] = std::fabs(d[a]) < 1e-6f;
+		r.invD[a] = r.parallel[a] ? 0.0f : 1.0f / d[a];
+	}
+	return r;
+}
+
+// [tNear, tFar] を返す。平行な軸で外なら false
+inline bool NodeSlab(const NodeRay& r, const float* lo, const float* hi, float expand, float& tNear, float& tFar) {
+	tNear = -kInf;
+	tFar = kInf;
+	for (int a = 0; a < 3; ++a) {
+		const float l = lo[a] - expand, h = hi[a] + expand;
+		if (r.parallel[a]) {
+			if (r.o[a] < l || r.o[a] > h)
+				return false;
+			continue;
+		}
+		float t1 = (l - r.o[a]) * r.invD[a];
+		float t2 = (h - r.o[a]) * r.invD[a];
+		if (t1 > t2)
+			std::swap(t1, t2);
+		tNear = (std::max)(tNear, t1);
+		tFar = (std::min)(tFar, t2);
+	}
+	return tNear <= tFar;
+}
+
+// 逆数の掛け算と割り算の差で葉の判定より狭くならないように、区間を少しだけ広げる
+inline float Slack(float t) { return 1e-5f * (std::max)(1.0f, std::fabs(t)); }
+
+} // namespace
+
+// ---------------------------------------------
+// 構築
+// ---------------------------------------------
+void AABBTree::Build(const std::vector<AABB>& boxes) {
+	boxes_ = boxes;
+	enabled_.assign(boxes_.size(), 1);
+	prims_.resize(boxes_.size());
+	nodes_.clear();
+	if (boxes_.empty())
+		return;
+
+	std::vector<Vector3> centers(boxes_.size());
+	for (size_t i = 0; i < boxes_.size(); ++i) {
+		prims_[i] = uint32_t(i);
+		const AABB& b = boxes_[i];
+		centers[i] = {(b.min.x + b.max.x) * 0.5f, (b.min.y + b.max.y) * 0.5f, (b.min.z + b.max.z) * 0.5f};
+	}
+	nodes_.reserve(boxes_.size() * 2 / kMaxLeaf + 1);
+	buildNode_(0, uint32_t(boxes_.size()), 0, centers);
+}
+
+void AABBTree::setBounds_(Node& n, uint32_t first, uint32_t count) const {
+	Vector3 lo{kInf, kInf, kInf}, hi{-kInf, -kInf, -kInf};
+	for (uint32_t k = first; k < first + count; ++k) {
+		const AABB& b = boxes_[prims_[k]];
+		Grow(lo, hi, b.min, b.max);
+	}
+	n.minX = lo.x;
+	n.minY = lo.y;
+	n.minZ = lo.z;
+	n.maxX = hi.x;
+	n.maxY = hi.y;
+	n.maxZ = hi.z;
+}
+
+uint32_t AABBTree::buildNode_(uint32_t first, uint32_t count, uint32_t depth, std::vector<Vector3>& centers) {
+	const uint32_t index = uint32_t(nodes_.size());
+	nodes_.push_back(Node{});
+	setBounds_(nodes_[index], first, count);
+
+	auto makeLeaf = [&] {
+		nodes_[index].leftFirst = first;
+		nodes_[index].count = count;
+		return index;
+	};
+	if (count <= 1 || depth >= kMaxDepth)
+		return makeLeaf();
+
+	// 中心の範囲をビンに分けて、いちばん安い分け方（SAH）を探す
+	Vector3 clo{kInf, kInf, kInf}, chi{-kInf, -kInf, -kInf};
+	for (uint32_t k = first; k < first + count; ++k) {
+		Grow(clo, chi, centers[prims_[k]], centers[prims_[k]]);
+	}
+
+	float bestCost = kInf;
+	int bestAxis = -1, bestSplit = 0;
+	for (int a = 0; a < 3; ++a) {
+		const float cmin = Axis(clo, a), extent = Axis(chi, a) - cmin;
+		if (extent <= 0.0f)
+			continue;
+		const float scale = float(kBins) / extent;
+
+		struct Bin {
+			Vector3 lo{kInf, kInf, kInf}, hi{-kInf, -kInf, -kInf};
+			uint32_t n = 0;
+		} bins[kBins];
+		for (uint32_t k = first; k < first + count; ++k) {
+			const uint32_t p = prims_[k];
+			const int b = (std::min)(int((Axis(centers[p], a) - cmin) * scale), kBins - 1);
+			Grow(bins[b].lo, bins[b].hi, boxes_[p].min, boxes_[p].max);
+			++bins[b].n;
+		}
+
+		// 左から / 右からの累積
+		float leftArea[kBins - 1], rightArea[kBins - 1];
+		uint32_t leftN[kBins - 1], rightN[kBins - 1];
+		Vector3 llo{kInf, kInf, kInf}, lhi{-kInf, -kInf, -kInf}, rlo = llo, rhi = lhi;
+		uint32_t ln = 0, rn = 0;
+		for (int i = 0; i < kBins - 1; ++i) {
+			ln += bins[i].n;
+			Grow(llo, lhi, bins[i].lo, bins[i].hi);
+			leftN[i] = ln;
+			leftArea[i] = HalfArea(llo, lhi);
+
+			rn += bins[kBins - 1 - i].n;
+			Grow(rlo, rhi, bins[kBins - 1 - i].lo, bins[kBins - 1 - i].hi);
+			rightN[kBins - 2 - i] = rn;
+			rightArea[kBins - 2 - i] = HalfArea(rlo, rhi);
+		}
+		for (int i = 0; i < kBins - 1; ++i) {
+			if (leftN[i] == 0 || rightN[i] == 0)
+				continue;
+			const float cost = leftArea[i] * float(leftN[i]) + rightArea[i] * float(rightN[i]);
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestAxis = a;
+				bestSplit = i;
+			}
+		}
+	}
+
+	// 分けても得をしない小さな集まりは葉に（走査 1 回 ≒ 箱 1 個の判定として比べる）
+	const Node& self = nodes_[index];
+	const float parentArea = HalfArea({self.minX, self.minY, self.minZ}, {self.maxX, self.maxY, self.maxZ});
+	if (bestAxis < 0 || (count <= kMaxLeaf && parentArea > 0.0f && 1.0f + bestCost / parentArea >= float(count)))
+		return makeLeaf();
+
+	// 分け目で並べ替え
+	const float cmin = Axis(clo, bestAxis);
+	const float scale = float(kBins) / (Axis(chi, bestAxis) - cmin);
+	uint32_t* mid = std::partition(prims_.data() + first, prims_.data() + first + count, [&](uint32_t p) { return (std::min)(int((Axis(centers[p], bestAxis) - cmin) * scale), kBins - 1) <= bestSplit; });
+	const uint32_t leftCount = uint32_t(mid - (prims_.data() + first));
+	if (leftCount == 0 || leftCount == count)
+		return makeLeaf();
+
+	buildNode_(first, leftCount, depth + 1, centers); // = index + 1
+	const uint32_t right = buildNode_(first + leftCount, count - leftCount, depth + 1, centers);
+	nodes_[index].leftFirst = right;
+	nodes_[index].count = 0;
+	return index;
+}
+
+void AABBTree::Refit() {
+	// 子は親より後ろにあるので、後ろから作れば子が先に済んでいる
+	for (size_t i = nodes_.size(); i-- > 0;) {
+		Node& n = nodes_[i];
+		if (n.count > 0) {
+			setBounds_(n, n.leftFirst, n.count);
+			continue;
+		}
+		const Node& l = nodes_[i + 1];
+		const Node& r = nodes_[n.leftFirst];
+		n.minX = (std::min)(l.minX, r.minX);
+		n.minY = (std::min)(l.minY, r.minY);
+		n.minZ = (std::min)(l.minZ, r.minZ);
+		n.maxX = (std::max)(l.maxX, r.maxX);
+		n.maxY = (std::max)(l.maxY, r.maxY);
+		n.maxZ = (std::max)(l.maxZ, r.maxZ);
+	}
+}
+
+// ---------------------------------------------
+// 問い合わせ
+// ---------------------------------------------
+bool AABBTree::Raycast(const Vector3& origin, const Vector3& dir, Collision::RayHit& out, float expand, float tMin, float tMax, int skipIndex) const {
+	if (nodes_.empty())
+		return false;
+
+	const NodeRay r = MakeNodeRay(origin, dir);
+	float best = tMax;
+	int bestIndex = -1;
+	Vector3 bestNormal{};
+
+	// 葉の t は「入る t（箱の外から）」か「出る t（中から）」で、どちらも外枠の [tNear, tFar] に入る
+	auto visit = [&](const Node& n, float& tNear) {
+		float tFar;
+		if (!NodeSlab(r, &n.minX, &n.maxX, expand, tNear, tFar))
+			return false;
+		const float s = Slack((std::max)(std::fabs(tNear), std::fabs(tFar)));
+		return tFar + s > tMin && tNear - s <= best;
+	};
+
+	uint32_t stack[64];
+	int sp = 0;
+	float t0;
+	if (visit(nodes_[0], t0))
+		stack[sp++] = 0;
+	while (sp > 0) {
+		const Node& n = nodes_[stack[--sp]];
+		if (n.count > 0) {
+			for (uint32_t k = n.leftFirst; k < n.leftFirst + n.count; ++k) {
+				const uint32_t p = prims_[k];
+				if (!enabled_[p] || int(p) == skipIndex)
+					continue;
+				float t;
+				Vector3 nn;
+				if (Collision::IntersectRayAABBExpanded(origin, dir, boxes_[p], expand, t, nn) && t > tMin && (t < best || (t == best && int(p) < bestIndex))) {
+					best = t;
+					bestIndex = int(p);
+					bestNormal = nn;
+				}
+			}
+			continue;
+		}
+		// 近い方の子を後に積む（先に見る）
+		const uint32_t li = uint32_t(&n - nodes_.data()) + 1, ri = n.leftFirst;
+		float tl, tr;
+		const bool hl = visit(nodes_[li], tl);
+		const bool hr = visit(nodes_[ri], tr);
+		if (hl && hr) {
+			if (tl <= tr) {
+				stack[sp++] = ri;
+				stack[sp++] = li;
+			} else {
+				stack[sp++] = li;
+				stack[sp++] = ri;
+			}
+		} else if (hl) {
+			stack[sp++] = li;
+		} else if (hr) {
+			stack[sp++] = ri;
+		}
+	}
+
+	if (bestIndex < 0)
+		return false;
+	out.t = best;
+	out.index = bestIndex;
+	out.normal = bestNormal;
+	return true;
+}
+
+bool AABBTree::SegmentAnyHit(const Vector3& p0, const Vector3& p1, int* outIndex) const {
+	if (nodes_.empty())
+		return false;
+
+	const Vector3 d{p1.x - p0.x, p1.y - p0.y, p1.z - p0.z};
+	const NodeRay r = MakeNodeRay(p0, d);
+
+	uint32_t stack[64];
+	int sp = 0;
+	stack[sp++] = 0;
+	while (sp > 0) {
+		const Node& n = nodes_[stack[--sp]];
+		float tNear, tFar;
+		if (!NodeSlab(r, &n.minX, &n.maxX, 0.0f, tNear, tFar))
+			continue;
+		const float s = Slack((std::max)(std::fabs(tNear), std::fabs(tFar)));
+		if (tFar + s < 0.0f || tNear - s > 1.0f)
+			continue;
+		if (n.count > 0) {
+			for (uint32_t k = n.leftFirst; k < n.leftFirst + n.count; ++k) {
+				const uint32_t p = prims_[k];
+				float t;
+				Vector3 nn;
+				if (enabled_[p] && Collision::IntersectSegmentAABB(p0, p1, boxes_[p], t, nn)) {
+					if (outIndex)
+						*outIndex = int(p);
+					return true;
+				}
+			}
+			continue;
+		}
+		stack[sp++] = n.leftFirst;
+		stack[sp++] = uint32_t(&n - nodes_.data()) + 1;
+	}
+	return false;
+}
+
+void AABBTree::QuerySphere(const Vector3& c, float radius, std::vector<int>& out) const {
+	if (nodes_.empty())
+		return;
+
+	// 箱の中で球の中心にいちばん近い点までの距離 <= 半径
+	const float r2 = radius * radius;
+	auto overlaps = [&](float x0, float y0, float z0, float x1, float y1, float z1) {
+		const float dx = (std::max)((std::max)(x0 - c.x, 0.0f), c.x - x1);
+		const float dy = (std::max)((std::max)(y0 - c.y, 0.0f), c.y - y1);
+		const float dz = (std::max)((std::max)(z0 - c.z, 0.0f), c.z - z1);
+		return dx * dx + dy * dy + dz * dz <= r2;
+	};
+
+	uint32_t stack[64];
+	int sp = 0;
+	stack[sp++] = 0;
+	while (sp > 0) {
+		const Node& n = nodes_[stack[--sp]];
+		if (!overlaps(n.minX, n.minY, n.minZ, n.maxX, n.maxY, n.maxZ))
+			continue;
+		if (n.count > 0) {
+			for (uint32_t k = n.leftFirst; k < n.leftFirst + n.count; ++k) {
+				const uint32_t p = prims_[k];
+				const AABB& b = boxes_[p];
+				if (enabled_[p] && overlaps(b.min.x, b.min.y, b.min.z, b.max.x, b.max.y, b.max.z))
+					out.push_back(int(p));
+			}
+			continue;
+		}
+		stack[sp++] = n.leftFirst;
+		stack[sp++] = uint32_t(&n - nodes_.data()) + 1;
+	}
+}
+
+void AABBTree::QueryAABB(const AABB& q, std::vector<int>& out) const {
+	if (nodes_.empty())
+		return;
+
+	auto overlaps = [&](float x0, float y0, float z0, float x1, float y1, float z1) {
+		return x0 <= q.max.x && x1 >= q.min.x && y0 <= q.max.y && y1 >= q.min.y && z0 <= q.max.z && z1 >= q.min.z;
+	};
+
+	uint32_t stack[64];
+	int sp = 0;
+	stack[sp++] = 0;
+	while (sp > 0) {
+		const Node& n = nodes_[stack[--sp]];
+		if (!overlaps(n.minX, n.minY, n.minZ, n.maxX, n.maxY, n.maxZ))
+			continue;
+		if (n.count > 0) {
+			for (uint32_t k = n.leftFirst; k < n.leftFirst + n.count; ++k) {
+				const uint32_t p = prims_[k];
+				const AABB& b = boxes_[p];
+				if (enabled_[p] && overlaps(b.min.x, b.min.y, b.min.z, b.max.x, b.max.y, b.max.z))
+					out.push_back(int(p));
+			}
+			continue;
+		}
+		stack[sp++] = n.leftFirst;
+		stack[sp++] = uint32_t(&n - nodes_.data()) + 1;
+	}
+}
+
+} // namespace Engine
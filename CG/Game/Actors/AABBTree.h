@@ -0,0 +1,59 @@
+#pragma once
+#include "AABB.h"
+#include "Collision.h"
+#include "Matrix4x4.h"
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+// 動かない箱（ステージの壁など）の BVH
+// - SAH（16 分割のビン）で作り、深さ優先の 1 本の配列に並べる（左の子は親の次、右の子は番号を持つ）
+// - 葉の判定は Collision の 1 個ずつの関数と同じ（線形に全部見たときと同じ結果になる）
+// - 箱が少し動くだけ（リフト）なら SetBox → Refit で木の形はそのまま外枠だけ直す
+// - SetEnabled(false) の箱はどの問い合わせにも出てこない（下がっているリフトなど）
+class AABBTree {
+public:
+	void Build(const std::vector<AABB>& boxes);
+
+	// 箱を差し替える（まとめて変えてから Refit を 1 回）
+	void SetBox(size_t i, const AABB& box) { boxes_[i] = box; }
+	void SetEnabled(size_t i, bool enabled) { enabled_[i] = enabled ? 1 : 0; }
+	// 葉から根へ外枠を作り直す（O(ノード数)）
+	void Refit();
+
+	// レイ：tMin < t < tMax でいちばん近い箱（IntersectRayAABBExpanded と同じ判定。同じ t なら番号の小さい方）
+	bool Raycast(const Vector3& origin, const Vector3& dir, Collision::RayHit& out, float expand = 0.0f, float tMin = 1e-4f, float tMax = 1e9f, int skipIndex = -1) const;
+	// 線分：どれか 1 つに当たるか（IntersectSegmentAABB と同じ判定。見つけた時点で終わる）
+	bool SegmentAnyHit(const Vector3& p0, const Vector3& p1, int* outIndex = nullptr) const;
+	// 球 / 箱と重なる箱の番号を out に足す（境界で接しているものも含む）
+	void QuerySphere(const Vector3& center, float radius, std::vector<int>& out) const;
+	void QueryAABB(const AABB& box, std::vector<int>& out) const;
+
+	size_t Size() const { return boxes_.size(); }
+	size_t NodeCount() const { return nodes_.size(); }
+	const AABB& Box(size_t i) const { return boxes_[i]; }
+
+private:
+	// 32B。count == 0 なら内部ノード（左の子 = 自分 + 1、右の子 = leftFirst）、それ以外は葉（prims_[leftFirst..+count)）
+	struct alignas(32) Node {
+		float minX, minY, minZ;
+		uint32_t leftFirst;
+		float maxX, maxY, maxZ;
+		uint32_t count;
+	};
+
+	static constexpr uint32_t kMaxLeaf = 4;
+	static constexpr uint32_t kMaxDepth = 48; // 走査のスタック（64）に収まる深さ
+	static constexpr int kBins = 16;
+
+	uint32_t buildNode_(uint32_t first, uint32_t count, uint32_t depth, std::vector<Vector3>& centers);
+	void setBounds_(Node& n, uint32_t first, uint32_t count) const;
+
+	std::vector<AABB> boxes_;
+	std::vector<uint8_t> enabled_;
+	std::vector<uint32_t> prims_; // 葉から箱の番号へ
+	std::vector<Node> nodes_;
+};
+
+} // namespace Engine
@@ -216,6 +216,8 @@ void Boss::BeginSlam_() {
 	state_ = State::Slam;
 	stateTimer_ = 0.0f;
 	terrainHitNotified_ = false;
+	prevTip_ = GetTipPosition_();
+	hasImpactPos_ = false;
 }
 
 //-------------------------------------------
@@ -234,8 +236,20 @@ void Boss::UpdateSlam_(float /*dt*/) {
 
 	// 棒の先端と地形の衝突判定
 	bool hitGround = false;
-	if (terrainHeightCallback_) {
-		Vector3 tip = GetTipPosition_();
+	const Vector3 tip = GetTipPosition_();
+
+	// 前フレームからの先端の通り道（速く振ると 1 フレームで地面を抜けるため）
+	if (terrainSegmentCallback_) {
+		Vector3 hitPos;
+		if (terrainSegmentCallback_(prevTip_, tip, hitPos)) {
+			hitGround = true;
+			impactPos_ = hitPos;
+			hasImpactPos_ = true;
+		}
+	}
+	prevTip_ = tip;
+
+	if (!hitGround && terrainHeightCallback_) {
 		float groundY = terrainHeightCallback_(tip);
 		const float eps = 0.02f; // 少しだけめり込みを許す
 		if (tip.y <= groundY + eps) {
@@ -404,6 +418,21 @@ Vector3 Boss::GetTipPosition_() const {
 	return tip;
 }
 
+//-------------------------------------------
+// 棒の当たりカプセル
+//-------------------------------------------
+void Boss::GetStickCapsule(Vector3& p0, Vector3& p1, float& radius) const {
+	p1 = GetTipPosition_();
+
+	// 先端から棒の向きに全長ぶん戻ったところがスライド後の根元
+	float s = std::sin(currentAngle_);
+	float c = std::cos(currentAngle_);
+	p0.x = p1.x - fallAxis_.x * s * stickLength_;
+	p0.y = p1.y - c * stickLength_;
+	p0.z = p1.z - fallAxis_.z * s * stickLength_;
+	radius = stickRadius_;
+}
+
 //-------------------------------------------
 // 地形への「ここを凹ませて」通知
 //-------------------------------------------
@@ -412,7 +441,7 @@ void Boss::NotifyTerrainHit_() {
 		return;
 
 	TerrainHitInfo info{};
-	info.position = GetTipPosition_(); // 実際に当たった先端位置
+	info.position = hasImpactPos_ ? impactPos_ : GetTipPosition_(); // 実際に当たった先端位置
 	info.radius = 4.0f;                // 凹みの広さ（お好みで調整）
 	info.depth = 1.5f;                 // 凹みの深さ
 
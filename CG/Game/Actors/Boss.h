@@ -53,12 +53,18 @@ public:
 		UpdateTransformFromPose_();
 	}
 
+	// 棒の当たりカプセル（スライド後の根元 → 先端、半径は棒の太さ）
+	void GetStickCapsule(Engine::Vector3& p0, Engine::Vector3& p1, float& radius) const;
+
 	// 地形を凹ませる処理を登録
 	void SetTerrainHitCallback(std::function<void(const TerrainHitInfo&)> cb) { terrainHitCallback_ = std::move(cb); }
 
 	// XZ の位置から、その地点でのボクセル地形の高さ(Y)を返すコールバック
 	void SetTerrainHeightCallback(std::function<float(const Engine::Vector3&)> cb) { terrainHeightCallback_ = std::move(cb); }
 
+	// 2 点の間で地形をまたいだら true と当たった位置を返すコールバック（先端の通り道の判定用）
+	void SetTerrainSegmentCallback(std::function<bool(const Engine::Vector3&, const Engine::Vector3&, Engine::Vector3&)> cb) { terrainSegmentCallback_ = std::move(cb); }
+
 private:
 	// 状態更新
 	void UpdateWaiting_(float dt, const Engine::Vector3& playerPos);
@@ -90,6 +96,7 @@ private:
 
 	// 棒の全長
 	float stickLength_ = 25.0f;
+	float stickRadius_ = 0.46f; // 棒の太さ（bou.obj の断面の半径）
 
 	// 根元（回転の支点）のワールド座標
 	Engine::Vector3 rootPos_{0.0f, 0.0f, 0.0f};
@@ -124,9 +131,15 @@ private:
 	// 地形ヒット通知フラグ
 	bool terrainHitNotified_ = false;
 
+	// Slam 中の前フレームの先端位置 / 通り道で当たった位置
+	Engine::Vector3 prevTip_{0.0f, 0.0f, 0.0f};
+	Engine::Vector3 impactPos_{0.0f, 0.0f, 0.0f};
+	bool hasImpactPos_ = false;
+
 	// コールバック
 	std::function<void(const TerrainHitInfo&)> terrainHitCallback_;
 	std::function<float(const Engine::Vector3&)> terrainHeightCallback_;
+	std::function<bool(const Engine::Vector3&, const Engine::Vector3&, Engine::Vector3&)> terrainSegmentCallback_;
 };
 
 } // namespace Game
@@ -0,0 +1,277 @@
+#include "Broadphase.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+namespace {
+
+inline Broadphase::Pair ToPair(uint64_t key) { return Broadphase::Pair{uint32_t(key >> 32), uint32_t(key)}; }
+
+inline uint32_t HashCell(int32_t x, int32_t y, int32_t z) { return (uint32_t(x) * 73856093u) ^ (uint32_t(y) * 19349663u) ^ (uint32_t(z) * 83492791u); }
+
+// セルの番号。単調でさえあれば組の数え方は崩れないので、floor の代わりに下駄を履かせて切り捨てる
+constexpr float kCellRange = 1048576.0f; // ±2^20 セルまで
+inline int32_t CellOf(float v, float inv) { return int32_t((std::min)((std::max)(v * inv, -kCellRange), kCellRange) + kCellRange) - int32_t(kCellRange); }
+
+// 64bit キーの LSD 基数ソート（8bit ずつ。番号の上位の 0 のバイトは飛ばす）
+void RadixSort(std::vector<uint64_t>& keys, std::vector<uint64_t>& tmp, uint32_t maxId) {
+	int bytes = 0;
+	while (bytes < 4 && (maxId >> (bytes * 8)) != 0) {
+		++bytes;
+	}
+
+	tmp.resize(keys.size());
+	for (int half = 0; half < 2; ++half) {
+		for (int b = 0; b < bytes; ++b) {
+			const int shift = half * 32 + b * 8;
+			size_t count[256] = {};
+			for (uint64_t k : keys) {
+				++count[(k >> shift) & 0xFF];
+			}
+			size_t sum = 0;
+			for (size_t& c : count) {
+				const size_t n = c;
+				c = sum;
+				sum += n;
+			}
+			for (uint64_t k : keys) {
+				tmp[count[(k >> shift) & 0xFF]++] = k;
+			}
+			keys.swap(tmp);
+		}
+	}
+}
+
+} // namespace
+
+Broadphase::ProxyId Broadphase::Create(const AABB& box, uint32_t userData, uint32_t category, uint32_t mask) {
+	ProxyId id;
+	if (!free_.empty()) {
+		id = free_.back();
+		free_.pop_back();
+	} else {
+		id = ProxyId(proxies_.size());
+		proxies_.emplace_back();
+	}
+
+	Proxy& p = proxies_[id];
+	p.box = box;
+	p.userData = userData;
+	p.category = category;
+	p.mask = mask;
+	p.alive = true;
+	p.enabled = true;
+	return id;
+}
+
+void Broadphase::Destroy(ProxyId id) {
+	if (id >= proxies_.size() || !proxies_[id].alive)
+		return;
+	proxies_[id].alive = false;
+	pendingFree_.push_back(id);
+}
+
+void Broadphase::Move(ProxyId id, const AABB& box) { proxies_[id].box = box; }
+
+void Broadphase::Clear() {
+	proxies_.clear();
+	free_.clear();
+	pendingFree_.clear();
+	pairs_.clear();
+	found_.clear();
+	begins_.clear();
+	stays_.clear();
+	ends_.clear();
+}
+
+void Broadphase::Update() {
+	gather_();
+	fillCells_();
+	findPairs_();
+	diffPairs_();
+
+	// 終わった組を出し終えたので番号を返す
+	free_.insert(free_.end(), pendingFree_.begin(), pendingFree_.end());
+	pendingFree_.clear();
+}
+
+void Broadphase::gather_() {
+	minX_.clear();
+	maxX_.clear();
+	minY_.clear();
+	maxY_.clear();
+	minZ_.clear();
+	maxZ_.clear();
+	category_.clear();
+	mask_.clear();
+	ids_.clear();
+
+	double extent = 0.0;
+	for (ProxyId id = 0; id < proxies_.size(); ++id) {
+		const Proxy& p = proxies_[id];
+		if (!p.alive || !p.enabled)
+			continue;
+		minX_.push_back(p.box.min.x);
+		maxX_.push_back(p.box.max.x);
+		minY_.push_back(p.box.min.y);
+		maxY_.push_back(p.box.max.y);
+		minZ_.push_back(p.box.min.z);
+		maxZ_.push_back(p.box.max.z);
+		category_.push_back(p.category);
+		mask_.push_back(p.mask);
+		ids_.push_back(id);
+		extent += (std::max)({p.box.max.x - p.box.min.x, p.box.max.y - p.box.min.y, p.box.max.z - p.box.min.z});
+	}
+
+	// 平均的な箱がだいたい 1 セル（多くて 8 セル）に収まる大きさ
+	cellSize_ = fixedCellSize_ > 0.0f ? fixedCellSize_ : (ids_.empty() ? 1.0f : (std::max)(float(2.0 * extent / double(ids_.size())), 1e-3f));
+}
+
+void Broadphase::fillCells_() {
+	const float inv = 1.0f / cellSize_;
+	const size_t n = ids_.size();
+	large_.clear();
+	isLarge_.assign(n, 0);
+	cellX0_.resize(n);
+	cellY0_.resize(n);
+	cellZ0_.resize(n);
+	if (entries_.size() < n * 8) {
+		entries_.resize(n * 8);
+	}
+
+	// ふつうの箱は各軸 1〜2 セル。8 通りを全部書いて、範囲内のものだけ書き込み位置を進める（分岐を読み違えない）
+	size_t w = 0;
+	for (size_t i = 0; i < n; ++i) {
+		const int32_t x0 = CellOf(minX_[i], inv), x1 = CellOf(maxX_[i], inv);
+		const int32_t y0 = CellOf(minY_[i], inv), y1 = CellOf(maxY_[i], inv);
+		const int32_t z0 = CellOf(minZ_[i], inv), z1 = CellOf(maxZ_[i], inv);
+		cellX0_[i] = x0;
+		cellY0_[i] = y0;
+		cellZ0_[i] = z0;
+		const int32_t nx = x1 - x0, ny = y1 - y0, nz = z1 - z0;
+		if ((nx | ny | nz) <= 1) {
+			Entry* out = entries_.data() + w;
+			size_t m = 0;
+			for (int32_t k = 0; k < 8; ++k) {
+				const int32_t dx = k & 1, dy = (k >> 1) & 1, dz = k >> 2;
+				out[m] = Entry{uint32_t(i), x0 + dx, y0 + dy, z0 + dz};
+				m += size_t((dx <= nx) & (dy <= ny) & (dz <= nz));
+			}
+			w += m;
+			continue;
+		}
+
+		const int64_t cells = int64_t(nx + 1) * int64_t(ny + 1) * int64_t(nz + 1);
+		if (cells > kMaxCellsPerProxy) {
+			large_.push_back(uint32_t(i));
+			isLarge_[i] = 1;
+			continue;
+		}
+		// 残りの代理のぶん（1 個 8）も空けておく
+		const size_t need = w + size_t(cells) + (n - i - 1) * 8;
+		if (entries_.size() < need) {
+			entries_.resize(need);
+		}
+		for (int32_t z = z0; z <= z1; ++z) {
+			for (int32_t y = y0; y <= y1; ++y) {
+				for (int32_t x = x0; x <= x1; ++x) {
+					entries_[w++] = Entry{uint32_t(i), x, y, z};
+				}
+			}
+		}
+	}
+	entryCount_ = w;
+
+	// バケツ数は登録数以上の 2 のべき乗。バケツ順に計数ソート
+	size_t buckets = 64;
+	while (buckets < w) {
+		buckets *= 2;
+	}
+	if (entryCell_.size() < w) {
+		entryCell_.resize(w);
+		sorted_.resize(w);
+	}
+	bucketStart_.assign(buckets + 1, 0);
+	for (size_t k = 0; k < w; ++k) {
+		const Entry& e = entries_[k];
+		entryCell_[k] = HashCell(e.x, e.y, e.z) & uint32_t(buckets - 1);
+		++bucketStart_[entryCell_[k]];
+	}
+	// 各バケツの末尾まで数えてから、後ろから詰めると先頭が残る
+	for (size_t b = 0; b < buckets; ++b) {
+		bucketStart_[b + 1] += bucketStart_[b];
+	}
+	for (size_t k = w; k-- > 0;) {
+		sorted_[--bucketStart_[entryCell_[k]]] = entries_[k];
+	}
+}
+
+void Broadphase::addPair_(size_t i, size_t j) {
+	++lastTests_;
+	// 読み違えやすいので比較はまとめて 1 回の分岐に
+	const bool hit = (minX_[j] <= maxX_[i]) & (maxX_[j] >= minX_[i]) & (minY_[j] <= maxY_[i]) & (maxY_[j] >= minY_[i]) & (minZ_[j] <= maxZ_[i]) & (maxZ_[j] >= minZ_[i]) &
+	                 ((category_[i] & mask_[j]) != 0) & ((category_[j] & mask_[i]) != 0);
+	if (!hit)
+		return;
+	const uint64_t a = ids_[i], b = ids_[j];
+	found_.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+}
+
+void Broadphase::findPairs_() {
+	found_.clear();
+	lastTests_ = 0;
+
+	// 同じセルにいるものどうし。重なりの最小の角がこのセルにある組だけ数える
+	// （セル番号は単調なので、角のセル = 2 つの箱の最小のセルの大きい方）
+	const size_t buckets = bucketStart_.size() - 1;
+	for (size_t b = 0; b < buckets; ++b) {
+		const uint32_t first = bucketStart_[b], last = bucketStart_[b + 1];
+		if (last - first < 2)
+			continue;
+		for (uint32_t p = first; p + 1 < last; ++p) {
+			const Entry& ea = sorted_[p];
+			for (uint32_t q = p + 1; q < last; ++q) {
+				const Entry& eb = sorted_[q];
+				const uint32_t i = ea.index, j = eb.index;
+				const bool owner = (ea.x == eb.x) & (ea.y == eb.y) & (ea.z == eb.z) & ((std::max)(cellX0_[i], cellX0_[j]) == ea.x) & ((std::max)(cellY0_[i], cellY0_[j]) == ea.y) &
+				                   ((std::max)(cellZ0_[i], cellZ0_[j]) == ea.z);
+				if (owner)
+					addPair_(i, j);
+			}
+		}
+	}
+
+	// 大きい箱は全部と比べる（大きいものどうしは番号の若い方から 1 回）
+	const size_t n = ids_.size();
+	for (uint32_t l : large_) {
+		for (size_t j = 0; j < n; ++j) {
+			if (j == l || (isLarge_[j] && j < l))
+				continue;
+			addPair_(l, j);
+		}
+	}
+}
+
+void Broadphase::diffPairs_() {
+	RadixSort(found_, scratch_, uint32_t(proxies_.size()));
+
+	// 前のフレームの組と突き合わせる（どちらも昇順）
+	begins_.clear();
+	stays_.clear();
+	ends_.clear();
+	size_t i = 0, j = 0;
+	while (i < found_.size() || j < pairs_.size()) {
+		if (j == pairs_.size() || (i < found_.size() && found_[i] < pairs_[j])) {
+			begins_.push_back(ToPair(found_[i++]));
+		} else if (i == found_.size() || pairs_[j] < found_[i]) {
+			ends_.push_back(ToPair(pairs_[j++]));
+		} else {
+			stays_.push_back(ToPair(found_[i++]));
+			++j;
+		}
+	}
+	pairs_.swap(found_);
+}
+
+} // namespace Engine
@@ -0,0 +1,109 @@
+#pragma once
+#include "AABB.h"
+#include "Matrix4x4.h"
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+// 動くもの（敵・弾・近接攻撃のカプセルなど）の大まかな当たり判定（ゆるい空間ハッシュ）
+// - 代理（proxy）ごとに箱を持ち、毎フレーム Move で書き換えてから Update を 1 回呼ぶ
+// - Update で箱が掛かるセルをハッシュ表に数え上げて（計数ソート）、同じセルにいるものどうしだけ比べる
+//   組は 2 つの箱の重なりの最小の角があるセルでだけ数える（何セルにまたがっても 1 回）
+// - セルの一辺は既定で箱の大きさの平均の 2 倍（SetCellSize で固定もできる）。セルを多くまたぐ大きい箱は別に全部と比べる
+// - 集めた組を前のフレームと比べ、始まった / 続いている / 終わった組に分ける
+// - category / mask で組み合わせを絞る（(a.category & b.mask) && (b.category & a.mask) のときだけ組にする）
+// - Destroy した代理の組は次の Update で「終わった組」に出る。番号はその Update が済むまで使い回さない
+// - 組は箱が重なっている（接しているだけも含む）ことしか見ない。細かい判定は Collision で行う
+class Broadphase {
+public:
+	using ProxyId = uint32_t;
+	static constexpr ProxyId kInvalid = ~0u;
+
+	// a < b
+	struct Pair {
+		ProxyId a, b;
+	};
+
+	ProxyId Create(const AABB& box, uint32_t userData = 0, uint32_t category = 1, uint32_t mask = ~0u);
+	void Destroy(ProxyId id);
+
+	// 箱を書き換える（並び直しは次の Update でまとめて）
+	void Move(ProxyId id, const AABB& box);
+	void MoveSphere(ProxyId id, const Vector3& center, float radius) { Move(id, AABB{{center.x - radius, center.y - radius, center.z - radius}, {center.x + radius, center.y + radius, center.z + radius}}); }
+	// 無効の代理はどの組にも入らない（出ている組は終わった組になる）
+	void SetEnabled(ProxyId id, bool enabled) { proxies_[id].enabled = enabled; }
+
+	// セルの一辺（0 なら Update ごとに箱の大きさから決める）
+	void SetCellSize(float size) { fixedCellSize_ = size; }
+	float CellSize() const { return cellSize_; }
+
+	void Update();
+
+	const std::vector<Pair>& Begins() const { return begins_; }
+	const std::vector<Pair>& Stays() const { return stays_; }
+	const std::vector<Pair>& Ends() const { return ends_; }
+
+	const AABB& Box(ProxyId id) const { return proxies_[id].box; }
+	uint32_t UserData(ProxyId id) const { return proxies_[id].userData; }
+
+	size_t ProxyCount() const { return proxies_.size() - free_.size() - pendingFree_.size(); }
+	size_t PairCount() const { return pairs_.size(); }
+	// 直近の Update の内訳（セルへの登録数 / 箱どうしを比べた回数）
+	size_t LastEntries() const { return entryCount_; }
+	size_t LastTests() const { return lastTests_; }
+
+	void Clear();
+
+private:
+	struct Proxy {
+		AABB box;
+		uint32_t userData = 0;
+		uint32_t category = 1;
+		uint32_t mask = ~0u;
+		bool alive = false;
+		bool enabled = true;
+	};
+
+	// 1 つの箱を登録するセルの数の上限（これより多くまたぐ箱は大きい箱として別に扱う）
+	static constexpr int kMaxCellsPerProxy = 32;
+
+	void gather_();
+	void fillCells_();
+	void findPairs_();
+	void diffPairs_();
+	void addPair_(size_t i, size_t j);
+
+	std::vector<Proxy> proxies_;
+	std::vector<ProxyId> free_;
+	std::vector<ProxyId> pendingFree_; // Destroy 済み。終わった組を出してから free_ へ
+
+	float fixedCellSize_ = 0.0f;
+	float cellSize_ = 1.0f;
+
+	// 有効な代理の成分（Update のたびに詰め直す）
+	std::vector<float> minX_, maxX_, minY_, maxY_, minZ_, maxZ_;
+	std::vector<uint32_t> category_, mask_;
+	std::vector<ProxyId> ids_;
+	std::vector<uint32_t> large_; // セルを多くまたぐ箱
+	std::vector<uint8_t> isLarge_;
+	std::vector<int32_t> cellX0_, cellY0_, cellZ0_; // 箱の最小の角のセル
+
+	// セルへの登録。バケツ順に並べ直したものと、その各バケツの先頭
+	struct Entry {
+		uint32_t index; // 詰めた番号
+		int32_t x, y, z; // セルの位置（同じバケツに別のセルが混ざるので見分ける）
+	};
+	std::vector<Entry> entries_, sorted_; // 先頭 entryCount_ 個が今回の分（配列は縮めない）
+	std::vector<uint32_t> entryCell_;     // entries_ ごとのバケツ
+	size_t entryCount_ = 0;
+	std::vector<uint32_t> bucketStart_;
+
+	// 組は (a << 32) | b のキーで昇順。pairs_ が今の組、found_ は今回見つけた分
+	std::vector<uint64_t> pairs_, found_, scratch_;
+	std::vector<Pair> begins_, stays_, ends_;
+
+	size_t lastTests_ = 0;
+};
+
+} // namespace Engine
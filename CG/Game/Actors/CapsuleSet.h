@@ -0,0 +1,55 @@
+#pragma once
+#include "Matrix4x4.h"
+#include <cstddef>
+#include <vector>
+
+namespace Engine {
+
+// カプセル（線分 p0-p1 と半径）の集まりを成分ごとの配列（SoA）で持つ。Collision::CapsuleCapsules で 4 個ずつまとめて判定する
+// - 配列の長さは 4 の倍数。余りは原点の点（半径 0）で埋めてあり、判定では番号 >= Size() を見ない
+// - 番号は Add に渡した並びのまま
+struct CapsuleSet {
+	static constexpr size_t kBatch = 4;
+
+	std::vector<float> ax, ay, az; // p0
+	std::vector<float> bx, by, bz; // p1
+	std::vector<float> r;
+	size_t count = 0;
+
+	void Add(const Vector3& p0, const Vector3& p1, float radius) {
+		if (count == PaddedSize()) {
+			const size_t padded = count + kBatch;
+			for (std::vector<float>* v : {&ax, &ay, &az, &bx, &by, &bz, &r}) {
+				v->resize(padded, 0.0f);
+			}
+		}
+		Set(count++, p0, p1, radius);
+	}
+
+	// 動く相手（ボスの棒など）の更新用
+	void Set(size_t i, const Vector3& p0, const Vector3& p1, float radius) {
+		ax[i] = p0.x;
+		ay[i] = p0.y;
+		az[i] = p0.z;
+		bx[i] = p1.x;
+		by[i] = p1.y;
+		bz[i] = p1.z;
+		r[i] = radius;
+	}
+
+	Vector3 P0(size_t i) const { return {ax[i], ay[i], az[i]}; }
+	Vector3 P1(size_t i) const { return {bx[i], by[i], bz[i]}; }
+	float Radius(size_t i) const { return r[i]; }
+
+	size_t Size() const { return count; }
+	size_t PaddedSize() const { return ax.size(); }
+	bool Empty() const { return count == 0; }
+	void Clear() {
+		for (std::vector<float>* v : {&ax, &ay, &az, &bx, &by, &bz, &r}) {
+			v->clear();
+		}
+		count = 0;
+	}
+};
+
+} // namespace Engine
@@ -1,6 +1,8 @@
 #include "Collision.h"
+#include <DirectXMath.h>
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace Engine {
 namespace Collision {
@@ -48,7 +50,7 @@ bool IntersectSegmentAABB(const Vector3& p0, const Vector3& p1, const AABB& box,
 }
 
 // Collision.cpp
-bool Collision::IntersectRayAABB(const Vector3& origin, const Vector3& dir, const AABB& box, float& outT, Vector3& outNormal) {
+bool IntersectRayAABB(const Vector3& origin, const Vector3& dir, const AABB& box, float& outT, Vector3& outNormal) {
 	float tmin = -1e9f;
 	float tmax = 1e9f;
 	int hitAxis = -1;
@@ -108,7 +110,7 @@ bool Collision::IntersectRayAABB(const Vector3& origin, const Vector3& dir, cons
 	return true;
 }
 
-bool Collision::IntersectRayAABBExpanded(
+bool IntersectRayAABBExpanded(
     const Vector3& origin, const Vector3& dir, const AABB& box, float expand, // ← 拡張幅
     float& outT, Vector3& outNormal) {
 	// ボックスを expand 分だけ拡大
@@ -124,10 +126,183 @@ bool Collision::IntersectRayAABBExpanded(
 	return IntersectRayAABB(origin, dir, expanded, outT, outNormal);
 }
 
+// ---------------------------------------------
+// まとめて判定
+// ---------------------------------------------
+namespace {
+
+using namespace DirectX;
+
+// レイと集合ごとに決まるもの（軸ごとに平行か / 近い面と遠い面の配列 / 1/d）
+struct SlabRay {
+	XMVECTOR o[3];
+	XMVECTOR invD[3];
+	XMVECTOR sign[3];     // 入る側の面の法線の向き（d > 0 なら min 面 = -1）
+	XMVECTOR nearE[3];    // 近い面を広げる向き（min 面なら -expand）
+	XMVECTOR farE[3];
+	const float* nearP[3]; // 近い面の配列（向きだけで決まるので箱ごとの入れ替えは要らない）
+	const float* farP[3];
+	const float* minP[3]; // 平行な軸の判定用
+	const float* maxP[3];
+	bool parallel[3];
+};
+
+SlabRay MakeSlabRay(const Vector3& origin, const Vector3& dir, const AABBSet& set, float expand) {
+	SlabRay r{};
+	const float o[3] = {origin.x, origin.y, origin.z};
+	const float d[3] = {dir.x, dir.y, dir.z};
+	const float* mins[3] = {set.minX.data(), set.minY.data(), set.minZ.data()};
+	const float* maxs[3] = {set.maxX.data(), set.maxY.data(), set.maxZ.data()};
+	for (int a = 0; a < 3; ++a) {
+		const bool positive = d[a] > 0.0f;
+		r.o[a] = XMVectorReplicate(o[a]);
+		r.parallel[a] = std::fabs(d[a]) < 1e-6f; // IntersectRayAABB と同じしきい値
+		r.invD[a] = XMVectorReplicate(r.parallel[a] ? 0.0f : 1.0f / d[a]);
+		r.sign[a] = XMVectorReplicate(positive ? -1.0f : 1.0f);
+		r.nearE[a] = XMVectorReplicate(positive ? -expand : expand);
+		r.farE[a] = XMVectorReplicate(positive ? expand : -expand);
+		r.nearP[a] = positive ? mins[a] : maxs[a];
+		r.farP[a] = positive ? maxs[a] : mins[a];
+		r.minP[a] = mins[a];
+		r.maxP[a] = maxs[a];
+	}
+	return r;
+}
 
+// 箱 i..i+3 のスラブ判定。戻り値は当たりのマスク。outAxis は入る側の軸（0/1/2、無ければ -1）
+// outNear は入る側の t そのもの（箱の中からでも出る側に差し替えない。線分の判定用）
+inline XMVECTOR Slab4(const SlabRay& r, size_t i, XMVECTOR expand, XMVECTOR& outT, XMVECTOR& outAxis, XMVECTOR& outSign, XMVECTOR* outNear = nullptr) {
+	XMVECTOR tmin = XMVectorReplicate(-1e9f);
+	XMVECTOR tmax = XMVectorReplicate(1e9f);
+	XMVECTOR axis = XMVectorReplicate(-1.0f);
+	XMVECTOR sign = XMVectorZero();
+	XMVECTOR ok = XMVectorTrueInt();
+
+	for (int a = 0; a < 3; ++a) {
+		if (r.parallel[a]) {
+			// 平行：スラブの中にいなければ外れ
+			const XMVECTOR lo = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(r.minP[a] + i)), expand);
+			const XMVECTOR hi = XMVectorAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(r.maxP[a] + i)), expand);
+			ok = XMVectorAndInt(ok, XMVectorAndInt(XMVectorGreaterOrEqual(r.o[a], lo), XMVectorLessOrEqual(r.o[a], hi)));
+			continue;
+		}
+		const XMVECTOR nearB = XMVectorAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(r.nearP[a] + i)), r.nearE[a]);
+		const XMVECTOR farB = XMVectorAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(r.farP[a] + i)), r.farE[a]);
+		const XMVECTOR t1 = XMVectorMultiply(XMVectorSubtract(nearB, r.o[a]), r.invD[a]);
+		const XMVECTOR t2 = XMVectorMultiply(XMVectorSubtract(farB, r.o[a]), r.invD[a]);
+		const XMVECTOR upd = XMVectorGreater(t1, tmin);
+		tmin = XMVectorSelect(tmin, t1, upd);
+		axis = XMVectorSelect(axis, XMVectorReplicate(float(a)), upd);
+		sign = XMVectorSelect(sign, r.sign[a], upd);
+		tmax = XMVectorMin(tmax, t2);
+	}
+	ok = XMVectorAndInt(ok, XMVectorLessOrEqual(tmin, tmax));
+
+	// 箱の中から：出る側の t（両方後ろなら外れ）
+	const XMVECTOR inside = XMVectorLess(tmin, XMVectorZero());
+	ok = XMVectorAndCInt(ok, XMVectorAndInt(inside, XMVectorLess(tmax, XMVectorZero())));
+	outT = XMVectorSelect(tmin, tmax, inside);
+	outAxis = axis;
+	outSign = sign;
+	if (outNear)
+		*outNear = tmin;
+	return ok;
+}
 
+Vector3 AxisNormal(float axis, float sign) {
+	Vector3 n{0, 0, 0};
+	if (axis == 0.0f)
+		n.x = sign;
+	if (axis == 1.0f)
+		n.y = sign;
+	if (axis == 2.0f)
+		n.z = sign;
+	return n;
+}
+
+} // namespace
+
+uint32_t IntersectRayAABBx8(const Vector3& origin, const Vector3& dir, const AABBSet& set, size_t first, float expand, float outT[8], Vector3 outNormal[8]) {
+	if (first + AABBSet::kBatch > set.PaddedSize())
+		return 0;
+
+	const SlabRay r = MakeSlabRay(origin, dir, set, expand);
+	const XMVECTOR e = XMVectorReplicate(expand);
+	uint32_t mask = 0;
+	for (size_t half = 0; half < 2; ++half) {
+		XMVECTOR t, axis, sign;
+		const uint32_t m = uint32_t(_mm_movemask_ps(Slab4(r, first + half * 4, e, t, axis, sign)));
+		if (m == 0)
+			continue;
+		float pt[4], pa[4], ps[4];
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(pt), t);
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(pa), axis);
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(ps), sign);
+		for (int l = 0; l < 4; ++l) {
+			if (m & (1u << l)) {
+				outT[half * 4 + l] = pt[l];
+				outNormal[half * 4 + l] = AxisNormal(pa[l], ps[l]);
+			}
+		}
+		mask |= m << (half * 4);
+	}
+	return mask;
+}
+
+bool NearestHit(const Vector3& origin, const Vector3& dir, const AABBSet& set, RayHit& out, float expand, float tMin, float tMax, int skipIndex) {
+	if (set.Empty())
+		return false;
+
+	const SlabRay r = MakeSlabRay(origin, dir, set, expand);
+	const XMVECTOR e = XMVectorReplicate(expand);
+	const XMVECTOR vtMin = XMVectorReplicate(tMin);
+	const XMVECTOR vtMax = XMVectorReplicate(tMax);
+	const XMVECTOR skip = XMVectorReplicate(float(skipIndex));
+	const XMVECTOR lane = XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+
+	// レーンごとの最良（同じレーンは番号の若い順に来るので、厳密に近いときだけ入れ替える）
+	XMVECTOR bestT = vtMax;
+	XMVECTOR bestIdx = XMVectorReplicate(-1.0f);
+	XMVECTOR bestAxis = XMVectorZero();
+	XMVECTOR bestSign = XMVectorZero();
+
+	const size_t n = set.PaddedSize();
+	for (size_t i = 0; i < n; i += 4) {
+		XMVECTOR t, axis, sign;
+		XMVECTOR ok = Slab4(r, i, e, t, axis, sign);
+		const XMVECTOR idx = XMVectorAdd(lane, XMVectorReplicate(float(i)));
+		ok = XMVectorAndInt(ok, XMVectorGreater(t, vtMin));
+		ok = XMVectorAndCInt(ok, XMVectorEqual(idx, skip));
+		const XMVECTOR better = XMVectorAndInt(ok, XMVectorLess(t, bestT));
+		bestT = XMVectorSelect(bestT, t, better);
+		bestIdx = XMVectorSelect(bestIdx, idx, better);
+		bestAxis = XMVectorSelect(bestAxis, axis, better);
+		bestSign = XMVectorSelect(bestSign, sign, better);
+	}
+
+	// 4 レーンから 1 つ
+	float pt[4], pi[4], pa[4], ps[4];
+	XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(pt), bestT);
+	XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(pi), bestIdx);
+	XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(pa), bestAxis);
+	XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(ps), bestSign);
+	int best = -1;
+	for (int l = 0; l < 4; ++l) {
+		if (pi[l] < 0.0f)
+			continue;
+		if (best < 0 || pt[l] < pt[best] || (pt[l] == pt[best] && pi[l] < pi[best]))
+			best = l;
+	}
+	if (best < 0)
+		return false;
+
+	out.t = pt[best];
+	out.index = int(pi[best]);
+	out.normal = AxisNormal(pa[best], ps[best]);
+	return true;
+}
 
-bool Collision::IntersectSegmentSphere(const Vector3& p0, const Vector3& p1, const Vector3& center, float radius, float& outT, Vector3& outNormal) {
+bool IntersectSegmentSphere(const Vector3& p0, const Vector3& p1, const Vector3& center, float radius, float& outT, Vector3& outNormal) {
 
   Vector3 d = {p1.x - p0.x, p1.y - p0.y, p1.z - p0.z}; // 線分方向
 	Vector3 m = {p0.x - center.x, p0.y - center.y, p0.z - center.z};
@@ -140,7 +315,7 @@ bool Collision::IntersectSegmentSphere(const Vector3& p0, const Vector3& p1, con
 	if (discriminant < 0.0f)
 		return false; // 衝突なし
 
-	float sqrtD = std::sqrtf(discriminant);
+	float sqrtD = std::sqrt(discriminant);
 	float t1 = (-b - sqrtD) / (2.0f * a);
 	float t2 = (-b + sqrtD) / (2.0f * a);
 
@@ -158,7 +333,7 @@ bool Collision::IntersectSegmentSphere(const Vector3& p0, const Vector3& p1, con
 	outNormal = {hit.x - center.x, hit.y - center.y, hit.z - center.z};
 
 	// 正規化
-	float len = std::sqrtf(outNormal.x * outNormal.x + outNormal.y * outNormal.y + outNormal.z * outNormal.z);
+	float len = std::sqrt(outNormal.x * outNormal.x + outNormal.y * outNormal.y + outNormal.z * outNormal.z);
 	if (len > 1e-6f) {
 		outNormal.x /= len;
 		outNormal.y /= len;
@@ -172,5 +347,363 @@ bool Collision::IntersectSegmentSphere(const Vector3& p0, const Vector3& p1, con
 
 }
 
+// ---------------------------------------------
+// カプセル
+// ---------------------------------------------
+namespace {
+
+using namespace DirectX;
+
+// v に垂直な単位ベクトル（v が 0 なら上向き）
+Vector3 AnyPerpendicular(const Vector3& v) {
+	const float ax = std::fabs(v.x), ay = std::fabs(v.y), az = std::fabs(v.z);
+	const Vector3 axis = (ax <= ay && ax <= az) ? Vector3{1, 0, 0} : (ay <= az ? Vector3{0, 1, 0} : Vector3{0, 0, 1});
+	const Vector3 c = Cross(v, axis);
+	const float len = std::sqrt(Dot(c, c));
+	return len > 1e-12f ? c / len : Vector3{0, 1, 0};
+}
+
+// 芯どうしの最近点 a（カプセル側）と b（相手側）から Contact を作る。2 点が重なっていれば fallback() の向き
+template <class Fallback>
+bool MakeContact(const Vector3& a, const Vector3& b, float radiusA, float radiusB, Fallback fallback, Contact& out) {
+	const Vector3 d = a - b;
+	const float distSq = Dot(d, d);
+	const float sum = radiusA + radiusB;
+	if (distSq >= sum * sum)
+		return false;
+	const float dist = std::sqrt(distSq);
+	out.normal = dist > 1e-6f ? d / dist : fallback();
+	out.depth = sum - dist;
+	out.point = b + out.normal * radiusB;
+	return true;
+}
+
+// まとめて判定の大まかな弾きで使う半径（計算順の違いで取りこぼさないよう少しだけ広げる）
+inline float Loosen(float r) { return r * 1.001f + 1e-4f; }
+
+} // namespace
+
+Vector3 ClosestPointOnSegment(const Vector3& p0, const Vector3& p1, const Vector3& q, float& outT) {
+	const Vector3 d = p1 - p0;
+	const float dd = Dot(d, d);
+	outT = dd > 0.0f ? std::clamp(Dot(q - p0, d) / dd, 0.0f, 1.0f) : 0.0f;
+	return p0 + d * outT;
+}
+
+// Real-Time Collision Detection 5.1.9 と同じ手順
+float ClosestPointsSegmentSegment(const Vector3& a0, const Vector3& a1, const Vector3& b0, const Vector3& b1, float& outS, float& outT, Vector3& outA, Vector3& outB) {
+	const float eps = 1e-12f;
+	const Vector3 d1 = a1 - a0;
+	const Vector3 d2 = b1 - b0;
+	const Vector3 r = a0 - b0;
+	const float a = Dot(d1, d1);
+	const float e = Dot(d2, d2);
+	const float f = Dot(d2, r);
+
+	float s = 0.0f, t = 0.0f;
+	if (a <= eps) {
+		// A が点
+		t = e > eps ? std::clamp(f / e, 0.0f, 1.0f) : 0.0f;
+	} else {
+		const float c = Dot(d1, r);
+		if (e <= eps) {
+			// B が点
+			s = std::clamp(-c / a, 0.0f, 1.0f);
+		} else {
+			const float b = Dot(d1, d2);
+			const float denom = a * e - b * b;
+			// 平行に近いときは s = 0 から始める（距離は変わらない）
+			s = denom > 1e-7f * a * e ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+			t = (b * s + f) / e;
+			if (t < 0.0f) {
+				t = 0.0f;
+				s = std::clamp(-c / a, 0.0f, 1.0f);
+			} else if (t > 1.0f) {
+				t = 1.0f;
+				s = std::clamp((b - c) / a, 0.0f, 1.0f);
+			}
+		}
+	}
+
+	outS = s;
+	outT = t;
+	outA = a0 + d1 * s;
+	outB = b0 + d2 * t;
+	const Vector3 diff = outA - outB;
+	return Dot(diff, diff);
+}
+
+// 箱までの距離の 2 乗は t について下に凸な区分 2 次式（各軸が面をまたぐ t で式が変わる）
+// 区間ごとに 2 次式の最小を取って、いちばん小さいものを返す
+float ClosestPointSegmentAABB(const Vector3& p0, const Vector3& p1, const AABB& box, float& outT, Vector3& outQ) {
+	const Vector3 d = p1 - p0;
+	const float p[3] = {p0.x, p0.y, p0.z};
+	const float dv[3] = {d.x, d.y, d.z};
+	const float lo[3] = {box.min.x, box.min.y, box.min.z};
+	const float hi[3] = {box.max.x, box.max.y, box.max.z};
+
+	// 区間の境目（両端 + 各軸の 2 面）
+	float ts[8] = {0.0f, 1.0f};
+	int n = 2;
+	for (int a = 0; a < 3; ++a) {
+		if (dv[a] == 0.0f)
+			continue;
+		for (float bound : {lo[a], hi[a]}) {
+			const float t = (bound - p[a]) / dv[a];
+			if (t > 0.0f && t < 1.0f)
+				ts[n++] = t;
+		}
+	}
+	// 高々 8 個なので挿入ソート
+	for (int i = 1; i < n; ++i) {
+		const float v = ts[i];
+		int j = i;
+		for (; j > 0 && ts[j - 1] > v; --j) {
+			ts[j] = ts[j - 1];
+		}
+		ts[j] = v;
+	}
+
+	float best = std::numeric_limits<float>::infinity();
+	for (int k = 0; k + 1 < n; ++k) {
+		const float t0 = ts[k], t1 = ts[k + 1];
+		// 区間の中ほどで、どの軸がどちらの面の外にいるかを決める
+		const float tm = 0.5f * (t0 + t1);
+		float qa = 0.0f, qb = 0.0f;
+		for (int a = 0; a < 3; ++a) {
+			const float x = p[a] + dv[a] * tm;
+			const float bound = x < lo[a] ? lo[a] : (x > hi[a] ? hi[a] : x);
+			if (bound == x)
+				continue;
+			const float e = p[a] - bound;
+			qa += dv[a] * dv[a];
+			qb += e * dv[a];
+		}
+		// どの軸も面の内側なら区間の中は箱の中（距離 0）。端は丸めで外に出ることがあるので中ほどを採る
+		const float t = qa > 0.0f ? std::clamp(-qb / qa, t0, t1) : tm;
+
+		// 距離はその t で測り直す（式の係数の丸めを持ち込まない）
+		float distSq = 0.0f;
+		float qv[3];
+		for (int a = 0; a < 3; ++a) {
+			const float x = p[a] + dv[a] * t;
+			qv[a] = std::clamp(x, lo[a], hi[a]);
+			distSq += (x - qv[a]) * (x - qv[a]);
+		}
+		if (distSq < best) {
+			best = distSq;
+			outT = t;
+			outQ = Vector3{qv[0], qv[1], qv[2]};
+		}
+	}
+	return best;
+}
+
+bool CapsuleSphere(const Vector3& p0, const Vector3& p1, float radius, const Vector3& center, float sphereRadius, Contact& out) {
+	float t;
+	const Vector3 c = ClosestPointOnSegment(p0, p1, center, t);
+	// 中心が芯の上にあるときは芯に垂直な向きへ押し出す
+	return MakeContact(c, center, radius, sphereRadius, [&] { return AnyPerpendicular(p1 - p0); }, out);
+}
+
+bool CapsuleAABB(const Vector3& p0, const Vector3& p1, float radius, const AABB& box, Contact& out) {
+	float t;
+	Vector3 q;
+	const float distSq = ClosestPointSegmentAABB(p0, p1, box, t, q);
+	// 厚みのない箱を横切ると丸めで 0 にならないので、ごく近ければ刺さっている扱い
+	if (distSq > 1e-10f) {
+		if (distSq >= radius * radius)
+			return false;
+		const float dist = std::sqrt(distSq);
+		const Vector3 c = p0 + (p1 - p0) * t;
+		out.normal = (c - q) / dist;
+		out.depth = radius - dist;
+		out.point = q;
+		return true;
+	}
+
+	// 芯が箱に刺さっている：箱の 6 面のうち、カプセル全体を押し出す量のいちばん少ない面
+	const float lo[3] = {(std::min)(p0.x, p1.x) - radius, (std::min)(p0.y, p1.y) - radius, (std::min)(p0.z, p1.z) - radius};
+	const float hi[3] = {(std::max)(p0.x, p1.x) + radius, (std::max)(p0.y, p1.y) + radius, (std::max)(p0.z, p1.z) + radius};
+	const float bmin[3] = {box.min.x, box.min.y, box.min.z};
+	const float bmax[3] = {box.max.x, box.max.y, box.max.z};
+	int axis = 0;
+	float sign = 1.0f;
+	float depth = std::numeric_limits<float>::infinity();
+	for (int a = 0; a < 3; ++a) {
+		if (bmax[a] - lo[a] < depth) {
+			depth = bmax[a] - lo[a];
+			axis = a;
+			sign = 1.0f;
+		}
+		if (hi[a] - bmin[a] < depth) {
+			depth = hi[a] - bmin[a];
+			axis = a;
+			sign = -1.0f;
+		}
+	}
+
+	// 接触点：押し出す向きにいちばん深い端点を箱に収めて、その面に載せる
+	const float e0 = (&p0.x)[axis], e1 = (&p1.x)[axis];
+	const Vector3& deep = (sign > 0.0f) == (e0 <= e1) ? p0 : p1;
+	Vector3 point{std::clamp(deep.x, box.min.x, box.max.x), std::clamp(deep.y, box.min.y, box.max.y), std::clamp(deep.z, box.min.z, box.max.z)};
+	(&point.x)[axis] = sign > 0.0f ? bmax[axis] : bmin[axis];
+
+	out.normal = {0, 0, 0};
+	(&out.normal.x)[axis] = sign;
+	out.depth = depth;
+	out.point = point;
+	return true;
+}
+
+bool CapsuleCapsule(const Vector3& a0, const Vector3& a1, float radiusA, const Vector3& b0, const Vector3& b1, float radiusB, Contact& out) {
+	float s, t;
+	Vector3 ca, cb;
+	ClosestPointsSegmentSegment(a0, a1, b0, b1, s, t, ca, cb);
+
+	// 芯が交わっているときは 2 本に垂直な向き（平行なら A に垂直な向き）。中点どうしで A 側を向ける
+	auto fallback = [&] {
+		Vector3 n = Cross(a1 - a0, b1 - b0);
+		const float len = std::sqrt(Dot(n, n));
+		n = len > 1e-6f ? n / len : AnyPerpendicular(a1 - a0);
+		return Dot(n, (a0 + a1) - (b0 + b1)) < 0.0f ? n * -1.0f : n;
+	};
+	return MakeContact(ca, cb, radiusA, radiusB, fallback, out);
+}
+
+size_t CapsuleSpheres(const Vector3& p0, const Vector3& p1, float radius, const SphereSet& set, std::vector<Contact>& out) {
+	const size_t before = out.size();
+	const Vector3 d = p1 - p0;
+	const float dd = Dot(d, d);
+	const XMVECTOR ox = XMVectorReplicate(p0.x), oy = XMVectorReplicate(p0.y), oz = XMVectorReplicate(p0.z);
+	const XMVECTOR dx = XMVectorReplicate(d.x), dy = XMVectorReplicate(d.y), dz = XMVectorReplicate(d.z);
+	const XMVECTOR invDD = XMVectorReplicate(dd > 0.0f ? 1.0f / dd : 0.0f);
+	const XMVECTOR r = XMVectorReplicate(Loosen(radius));
+	const XMVECTOR loose = XMVectorReplicate(1.001f);
+
+	const size_t n = set.PaddedSize();
+	for (size_t i = 0; i < n; i += SphereSet::kBatch) {
+		// 球の中心から芯への最近点
+		const XMVECTOR wx = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(set.cx.data() + i)), ox);
+		const XMVECTOR wy = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(set.cy.data() + i)), oy);
+		const XMVECTOR wz = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(set.cz.data() + i)), oz);
+		const XMVECTOR t = XMVectorSaturate(XMVectorMultiply(XMVectorMultiplyAdd(wx, dx, XMVectorMultiplyAdd(wy, dy, XMVectorMultiply(wz, dz))), invDD));
+		const XMVECTOR ex = XMVectorNegativeMultiplySubtract(dx, t, wx);
+		const XMVECTOR ey = XMVectorNegativeMultiplySubtract(dy, t, wy);
+		const XMVECTOR ez = XMVectorNegativeMultiplySubtract(dz, t, wz);
+		const XMVECTOR distSq = XMVectorMultiplyAdd(ex, ex, XMVectorMultiplyAdd(ey, ey, XMVectorMultiply(ez, ez)));
+		const XMVECTOR sum = XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(set.r.data() + i)), loose, r);
+		const uint32_t m = uint32_t(_mm_movemask_ps(XMVectorLessOrEqual(distSq, XMVectorMultiply(sum, sum))));
+		if (m == 0)
+			continue;
+		for (size_t l = 0; l < 4 && i + l < set.Size(); ++l) {
+			Contact c;
+			if ((m & (1u << l)) && CapsuleSphere(p0, p1, radius, set.Center(i + l), set.Radius(i + l), c)) {
+				c.index = int(i + l);
+				out.push_back(c);
+			}
+		}
+	}
+	return out.size() - before;
+}
+
+size_t CapsuleAABBs(const Vector3& p0, const Vector3& p1, float radius, const AABBSet& set, std::vector<Contact>& out) {
+	const size_t before = out.size();
+	if (set.Empty())
+		return 0;
+
+	// 芯の線分 vs 半径だけ広げた箱（角の丸みの分だけ広いので取りこぼさない）
+	const SlabRay r = MakeSlabRay(p0, p1 - p0, set, Loosen(radius));
+	const XMVECTOR e = XMVectorReplicate(Loosen(radius));
+	const XMVECTOR one = XMVectorReplicate(1.0f);
+	const size_t n = set.PaddedSize();
+	for (size_t i = 0; i < n; i += 4) {
+		XMVECTOR t, axis, sign, tNear;
+		XMVECTOR ok = Slab4(r, i, e, t, axis, sign, &tNear);
+		ok = XMVectorAndInt(ok, XMVectorLessOrEqual(tNear, one));
+		const uint32_t m = uint32_t(_mm_movemask_ps(ok));
+		if (m == 0)
+			continue;
+		for (size_t l = 0; l < 4 && i + l < set.Size(); ++l) {
+			Contact c;
+			if ((m & (1u << l)) && CapsuleAABB(p0, p1, radius, set.Get(i + l), c)) {
+				c.index = int(i + l);
+				out.push_back(c);
+			}
+		}
+	}
+	return out.size() - before;
+}
+
+size_t CapsuleCapsules(const Vector3& p0, const Vector3& p1, float radius, const CapsuleSet& set, std::vector<Contact>& out) {
+	const size_t before = out.size();
+	const float eps = 1e-12f;
+	const Vector3 d1 = p1 - p0;
+	const float a = Dot(d1, d1);
+	const XMVECTOR ox = XMVectorReplicate(p0.x), oy = XMVectorReplicate(p0.y), oz = XMVectorReplicate(p0.z);
+	const XMVECTOR d1x = XMVectorReplicate(d1.x), d1y = XMVectorReplicate(d1.y), d1z = XMVectorReplicate(d1.z);
+	const XMVECTOR va = XMVectorReplicate(a);
+	const XMVECTOR invA = XMVectorReplicate(a > eps ? 1.0f / a : 0.0f);
+	const XMVECTOR veps = XMVectorReplicate(eps);
+	const XMVECTOR parallelEps = XMVectorReplicate(1e-7f * a);
+	const XMVECTOR zero = XMVectorZero();
+	const XMVECTOR r = XMVectorReplicate(Loosen(radius));
+	const XMVECTOR loose = XMVectorReplicate(1.001f);
+
+	const size_t n = set.PaddedSize();
+	for (size_t i = 0; i < n; i += CapsuleSet::kBatch) {
+		// ClosestPointsSegmentSegment の分岐を選択に置き換えたもの
+		const XMVECTOR b0x = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(set.ax.data() + i));
+		const XMVECTOR b0y = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(set.ay.data() + i));
+		const XMVECTOR b0z = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(set.az.data() + i));
+		const XMVECTOR d2x = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(set.bx.data() + i)), b0x);
+		const XMVECTOR d2y = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(set.by.data() + i)), b0y);
+		const XMVECTOR d2z = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(set.bz.data() + i)), b0z);
+		const XMVECTOR rx = XMVectorSubtract(ox, b0x);
+		const XMVECTOR ry = XMVectorSubtract(oy, b0y);
+		const XMVECTOR rz = XMVectorSubtract(oz, b0z);
+		const XMVECTOR e = XMVectorMultiplyAdd(d2x, d2x, XMVectorMultiplyAdd(d2y, d2y, XMVectorMultiply(d2z, d2z)));
+		const XMVECTOR f = XMVectorMultiplyAdd(d2x, rx, XMVectorMultiplyAdd(d2y, ry, XMVectorMultiply(d2z, rz)));
+		const XMVECTOR bPoint = XMVectorLessOrEqual(e, veps);
+
+		XMVECTOR s, t;
+		if (a <= eps) {
+			s = zero;
+			t = XMVectorSelect(XMVectorSaturate(XMVectorDivide(f, e)), zero, bPoint);
+		} else {
+			const XMVECTOR c = XMVectorMultiplyAdd(d1x, rx, XMVectorMultiplyAdd(d1y, ry, XMVectorMultiply(d1z, rz)));
+			const XMVECTOR b = XMVectorMultiplyAdd(d1x, d2x, XMVectorMultiplyAdd(d1y, d2y, XMVectorMultiply(d1z, d2z)));
+			const XMVECTOR denom = XMVectorNegativeMultiplySubtract(b, b, XMVectorMultiply(va, e));
+			const XMVECTOR sFree = XMVectorSaturate(XMVectorDivide(XMVectorSubtract(XMVectorMultiply(b, f), XMVectorMultiply(c, e)), denom));
+			s = XMVectorSelect(zero, sFree, XMVectorGreater(denom, XMVectorMultiply(parallelEps, e)));
+			t = XMVectorDivide(XMVectorMultiplyAdd(b, s, f), e);
+			const XMVECTOR sLow = XMVectorSaturate(XMVectorMultiply(XMVectorNegate(c), invA));
+			const XMVECTOR sHigh = XMVectorSaturate(XMVectorMultiply(XMVectorSubtract(b, c), invA));
+			const XMVECTOR below = XMVectorOrInt(XMVectorLess(t, zero), bPoint);
+			const XMVECTOR above = XMVectorAndCInt(XMVectorGreater(t, XMVectorReplicate(1.0f)), below);
+			s = XMVectorSelect(XMVectorSelect(s, sHigh, above), sLow, below);
+			t = XMVectorSelect(XMVectorSelect(t, XMVectorReplicate(1.0f), above), zero, below);
+		}
+
+		// 最近点どうしの距離
+		const XMVECTOR ex = XMVectorSubtract(XMVectorMultiplyAdd(d1x, s, rx), XMVectorMultiply(d2x, t));
+		const XMVECTOR ey = XMVectorSubtract(XMVectorMultiplyAdd(d1y, s, ry), XMVectorMultiply(d2y, t));
+		const XMVECTOR ez = XMVectorSubtract(XMVectorMultiplyAdd(d1z, s, rz), XMVectorMultiply(d2z, t));
+		const XMVECTOR distSq = XMVectorMultiplyAdd(ex, ex, XMVectorMultiplyAdd(ey, ey, XMVectorMultiply(ez, ez)));
+		const XMVECTOR sum = XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(set.r.data() + i)), loose, r);
+		const uint32_t m = uint32_t(_mm_movemask_ps(XMVectorLessOrEqual(distSq, XMVectorMultiply(sum, sum))));
+		if (m == 0)
+			continue;
+		for (size_t l = 0; l < 4 && i + l < set.Size(); ++l) {
+			Contact ct;
+			if ((m & (1u << l)) && CapsuleCapsule(p0, p1, radius, set.P0(i + l), set.P1(i + l), set.Radius(i + l), ct)) {
+				ct.index = int(i + l);
+				out.push_back(ct);
+			}
+		}
+	}
+	return out.size() - before;
+}
+
 } // namespace Collision
 } // namespace Engine
@@ -1,6 +1,11 @@
 #pragma once
 #include "AABB.h"
+#include "AABBSet.h"
+#include "CapsuleSet.h"
 #include "Matrix4x4.h"
+#include "SphereSet.h"
+#include <cstdint>
+#include <vector>
 
 namespace Engine {
 namespace Collision {
@@ -18,9 +23,58 @@ bool IntersectRayAABBExpanded(
     const Vector3& origin, const Vector3& dir, const AABB& box, float expand, // ← 拡張幅
     float& outT, Vector3& outNormal);
 
+// ---- まとめて判定（AABBSet。SSE で 4 個ずつ、1 回のループで 8 個） ----
+// 判定は IntersectRayAABBExpanded と同じ（箱を expand だけ広げる。箱の中から出るときは出る側の t、法線は入る側の面）
+
+// set の first から 8 個（first は 8 の倍数）。戻り値のビット i が first + i の当たり
+// outT[i] / outNormal[i] は当たった箱だけ書く
+uint32_t IntersectRayAABBx8(const Vector3& origin, const Vector3& dir, const AABBSet& set, size_t first, float expand, float outT[8], Vector3 outNormal[8]);
+
+struct RayHit {
+	float t = 0.0f;
+	Vector3 normal{0, 0, 0};
+	int index = -1; // set の中の番号
+};
+
+// tMin < t < tMax でいちばん近い箱（同じ t なら番号の小さい方）。skipIndex の箱は見ない
+// 線分なら dir = p1 - p0, tMax = 1
+bool NearestHit(const Vector3& origin, const Vector3& dir, const AABBSet& set, RayHit& out, float expand = 0.0f, float tMin = 1e-4f, float tMax = 1e9f, int skipIndex = -1);
+
 //線分 vs 球（レーザー用）
 bool IntersectSegmentSphere(const Vector3& p0, const Vector3& p1, const Vector3& center, float radius, float& outT, Vector3& outNormal);
 
+// ---- カプセル（線分 p0-p1 を半径 radius で太らせたもの。近接攻撃の剣やボスの棒） ----
+// 重なっていれば true（ちょうど接するだけなら false）。相手がカプセルを押し返す向きで返す
+
+struct Contact {
+	Vector3 point{0, 0, 0};  // 相手の表面上の接触点
+	Vector3 normal{0, 0, 0}; // 相手 → カプセルの単位ベクトル（カプセルをこの向きに depth 動かせば離れる）
+	float depth = 0.0f;      // めり込み量
+	int index = -1;          // まとめて判定したときの相手の番号
+};
+
+// 線分上で q にいちばん近い点（outT は 0〜1 の比率）
+Vector3 ClosestPointOnSegment(const Vector3& p0, const Vector3& p1, const Vector3& q, float& outT);
+
+// 2 本の線分のいちばん近い点の組（outS / outT は 0〜1 の比率）。戻り値は距離の 2 乗
+float ClosestPointsSegmentSegment(const Vector3& a0, const Vector3& a1, const Vector3& b0, const Vector3& b1, float& outS, float& outT, Vector3& outA, Vector3& outB);
+
+// 線分と箱のいちばん近い点（outT は線分上の比率、outQ は箱の上の点）。戻り値は距離の 2 乗（線分が箱を通れば 0）
+float ClosestPointSegmentAABB(const Vector3& p0, const Vector3& p1, const AABB& box, float& outT, Vector3& outQ);
+
+bool CapsuleSphere(const Vector3& p0, const Vector3& p1, float radius, const Vector3& center, float sphereRadius, Contact& out);
+
+// 芯の線分が箱に刺さっているときは箱の 3 軸のうち押し戻しのいちばん短い向きを返す
+bool CapsuleAABB(const Vector3& p0, const Vector3& p1, float radius, const AABB& box, Contact& out);
+
+bool CapsuleCapsule(const Vector3& a0, const Vector3& a1, float radiusA, const Vector3& b0, const Vector3& b1, float radiusB, Contact& out);
+
+// ---- 1 本のカプセル vs 集まり（SSE で 4 個ずつ大まかに弾き、残ったものだけ上の判定で詰める） ----
+// 結果は上の関数を番号順に呼んだときと同じ。当たったものを out の末尾に足して、足した数を返す
+size_t CapsuleSpheres(const Vector3& p0, const Vector3& p1, float radius, const SphereSet& set, std::vector<Contact>& out);
+size_t CapsuleAABBs(const Vector3& p0, const Vector3& p1, float radius, const AABBSet& set, std::vector<Contact>& out);
+size_t CapsuleCapsules(const Vector3& p0, const Vector3& p1, float radius, const CapsuleSet& set, std::vector<Contact>& out);
+
 
 } // namespace Collision
 } // namespace Engine
@@ -18,26 +18,41 @@ void ParticleEmitter::Burst(int count) {
 
 	count = (std::min)(count, params_.maxOnce * 4); // 安全上限
 
-	for (int i = 0; i < count; ++i) {
-		Engine::Vector3 v = RandV3(params_.initVelMin, params_.initVelMax);
-		Engine::Vector3 scl = RandV3(params_.initScaleMin, params_.initScaleMax);
-		float life = RandF(params_.lifeMin, params_.lifeMax);
+	// 先にまとめて確保（満杯のときは params_.overflow に従う）
+	sys_.SetOverflow(params_.overflow);
+	size_t granted = 0;
+	const size_t first = sys_.EmitN(size_t(count), granted);
 
-		Engine::Vector3 p = position_;
-		if (params_.spawnPosJitter.x != 0.0f || params_.spawnPosJitter.y != 0.0f || params_.spawnPosJitter.z != 0.0f) {
-			p.x += RandF(-params_.spawnPosJitter.x, +params_.spawnPosJitter.x);
-			p.y += RandF(-params_.spawnPosJitter.y, +params_.spawnPosJitter.y);
-			p.z += RandF(-params_.spawnPosJitter.z, +params_.spawnPosJitter.z);
-		}
+	if (granted == 0)
+		return;
 
-		// ★風が有効なら、速度に風の成分を加算して吹き飛ばす
-		if (windEnabled_) {
-			v.x += windDir_.x * windStrength_;
-			v.y += windDir_.y * windStrength_;
-			v.z += windDir_.z * windStrength_;
-		}
+	// 初期値は成分ごとにまとめて乱数で埋める（4 個ずつ SIMD）
+	burstVel_.resize(granted);
+	burstScale_.resize(granted);
+	burstLife_.resize(granted);
+	rng_.FillRangeV3(burstVel_.data(), granted, params_.initVelMin, params_.initVelMax);
+	rng_.FillRangeV3(burstScale_.data(), granted, params_.initScaleMin, params_.initScaleMax);
+	rng_.FillRange(burstLife_.data(), granted, params_.lifeMin, params_.lifeMax);
+
+	const Engine::Vector3& j = params_.spawnPosJitter;
+	const bool jitter = j.x != 0.0f || j.y != 0.0f || j.z != 0.0f;
+	if (jitter) {
+		burstJitter_.resize(granted);
+		rng_.FillRangeV3(burstJitter_.data(), granted, Engine::Vector3{-j.x, -j.y, -j.z}, j);
+	}
+
+	// ★風が有効なら、速度に風の成分を加算して吹き飛ばす
+	const Engine::Vector3 wind = windEnabled_ ? Engine::Vector3{windDir_.x * windStrength_, windDir_.y * windStrength_, windDir_.z * windStrength_} : Engine::Vector3{0.0f, 0.0f, 0.0f};
 
-		sys_.Emit(p, v, scl, params_.initColor, life);
+	for (size_t i = 0; i < granted; ++i) {
+		Engine::Vector3 p = position_;
+		if (jitter) {
+			p.x += burstJitter_[i].x;
+			p.y += burstJitter_[i].y;
+			p.z += burstJitter_[i].z;
+		}
+		const Engine::Vector3& v = burstVel_[i];
+		sys_.SetParticle(first + i, p, Engine::Vector3{v.x + wind.x, v.y + wind.y, v.z + wind.z}, burstScale_[i], params_.initColor, burstLife_[i]);
 	}
 }
 
@@ -1,7 +1,9 @@
 #pragma once
 #include "Matrix4x4.h"
+#include "Random.h"
 #include "Renderer.h"
 #include <random>
+#include <vector>
 
 // Engine 側のパーティクルを利用
 #include "Particle.h" // ← Engine::ParticleSystem が宣言されている想定
@@ -13,6 +15,7 @@ struct EmitterParams {
 	// 放出
 	float emitRate = 0.0f; // 1秒あたり放出数（0で自動放出なし）
 	int maxOnce = 16;      // 1フレームあたりの上限（保険）
+	Engine::ParticleOverflow overflow = Engine::ParticleOverflow::Drop; // 満杯のとき（捨てる/古いのを消す/増やす）
 
 	// 初期値レンジ
 	Engine::Vector3 initVelMin{-1.0f, +2.0f, -1.0f};
@@ -64,6 +67,10 @@ public:
 	// 外部から任意のタイミングでまとめて発生
 	void Burst(int count);
 
+	// 乱数のシード（同じシード + 同じ呼び出し順なら同じ粒が出る。リプレイ用）
+	void SetSeed(uint64_t seed) { rng_.Seed(seed); }
+	uint64_t Seed() const { return rng_.GetSeed(); }
+
 	// 風の設定（方向と強さ）
 	void SetWind(const Engine::Vector3& dir, float strength);
 	// ON/OFFだけ切り替えたい時用
@@ -73,6 +80,9 @@ public:
 	void Update(float dt);
 	void Draw(ID3D12GraphicsCommandList* cmd, const Engine::Camera& cam);
 
+	// 中身（粒の数や描画の統計）
+	const Engine::ParticleSystem& System() const { return sys_; }
+
 private:
 	Engine::Renderer* renderer_ = nullptr;
 	Engine::ParticleSystem sys_; // Engine 既存のパーティクルシステム
@@ -82,13 +92,12 @@ private:
 	// 自動放出用
 	float emitCarry_ = 0.0f;
 
-	// 乱数
-	std::mt19937 rng_{std::random_device{}()};
-	float RandF(float a, float b) {
-		std::uniform_real_distribution<float> dist(a, b);
-		return dist(rng_);
-	}
-	Engine::Vector3 RandV3(const Engine::Vector3& mn, const Engine::Vector3& mx) { return {RandF(mn.x, mx.x), RandF(mn.y, mx.y), RandF(mn.z, mx.z)}; }
+	// 乱数（既定のシードは毎回変わる。揃えたいときは SetSeed）
+	Engine::Random rng_{std::random_device{}()};
+
+	// Burst の作業用（初期値をまとめて乱数で埋める）
+	std::vector<Engine::Vector3> burstVel_, burstScale_, burstJitter_;
+	std::vector<float> burstLife_;
 
 	EmitterParams params_{};
 
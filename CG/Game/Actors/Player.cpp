@@ -80,6 +80,7 @@ void Player::Initialize(Engine::Renderer& renderer, ID3D12Device* device, ID3D12
 	{
 		auto& ep = hitEmitter_.Params();
 		ep.emitRate = 0.0f;
+		ep.overflow = Engine::ParticleOverflow::RecycleOldest; // 命中の火花は必ず出す
 		ep.useAdditive = true;
 		ep.initColor = {1.0f, 0.6f, 0.2f, 1.0f};
 		ep.initScaleMin = {0.05f, 0.05f, 0.05f};
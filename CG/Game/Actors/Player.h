@@ -27,6 +27,8 @@ public:
 
 	// プレイヤー位置取得
 	Vector3 GetPos() const { return transform_.translate; }
+	// 緊急回避中か
+	bool IsDodging() const { return dodgeActive_; }
 	// 進行方向取得（現状は固定）
 	Vector3 GetForwardDir() const;
 
@@ -0,0 +1,59 @@
+#pragma once
+#include "Matrix4x4.h"
+#include <cstddef>
+#include <vector>
+
+namespace Engine {
+
+// 球の集まりを成分ごとの配列（SoA）で持つ。Collision::CapsuleSpheres で 4 個ずつまとめて判定する
+// - 配列の長さは 4 の倍数。余りは半径 0 の球で埋めてあり、判定では番号 >= Size() を見ない
+// - 番号は Add / Build に渡した並びのまま
+struct SphereSet {
+	static constexpr size_t kBatch = 4;
+
+	std::vector<float> cx, cy, cz;
+	std::vector<float> r;
+	size_t count = 0;
+
+	void Build(const std::vector<Vector3>& centers, const std::vector<float>& radii) {
+		Clear();
+		for (size_t i = 0; i < centers.size() && i < radii.size(); ++i) {
+			Add(centers[i], radii[i]);
+		}
+	}
+
+	void Add(const Vector3& c, float radius) {
+		if (count == PaddedSize()) {
+			const size_t padded = count + kBatch;
+			cx.resize(padded, 0.0f);
+			cy.resize(padded, 0.0f);
+			cz.resize(padded, 0.0f);
+			r.resize(padded, 0.0f);
+		}
+		Set(count++, c, radius);
+	}
+
+	// 動く相手（敵など）の更新用
+	void Set(size_t i, const Vector3& c, float radius) {
+		cx[i] = c.x;
+		cy[i] = c.y;
+		cz[i] = c.z;
+		r[i] = radius;
+	}
+
+	Vector3 Center(size_t i) const { return {cx[i], cy[i], cz[i]}; }
+	float Radius(size_t i) const { return r[i]; }
+
+	size_t Size() const { return count; }
+	size_t PaddedSize() const { return cx.size(); }
+	bool Empty() const { return count == 0; }
+	void Clear() {
+		cx.clear();
+		cy.clear();
+		cz.clear();
+		r.clear();
+		count = 0;
+	}
+};
+
+} // namespace Engine
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cmath>
 #include <fstream>
 #include <sstream>
 
@@ -107,6 +108,11 @@ void Stage::Initialize(
 	for (auto& r : mapData)
 		maxCols_ = std::max<int>(maxCols_, (int)r.size());
 
+	// 格子の当たり判定（セル (0, 0) の左下の角を gridToWorld と合わせる）
+	const float gridOriginX = (anchor_ == GridAnchor::Center) ? -maxCols_ * 0.5f * pitchX_ : 0.0f;
+	const float gridOriginZ = (anchor_ == GridAnchor::Center) ? -rows_ * 0.5f * pitchZ_ : 0.0f;
+	grid_.Build(maxCols_, rows_, gridOriginX, gridOriginZ, pitchX_, pitchZ_);
+
 	//---------------------------------------------
 	// ブロック（壁/プリズム/リフト）配置
 	//---------------------------------------------
@@ -114,8 +120,10 @@ void Stage::Initialize(
 		for (int x = 0; x < (int)mapData[z].size(); ++x) {
 			const std::string& cell = mapData[z][x];
 			const std::string angStr = (z < (int)angleData.size() && x < (int)angleData[z].size()) ? angleData[z][x] : "0";
-			if (cell != "1" && cell != "2" && cell != "3")
+			if (cell != "1" && cell != "2" && cell != "3") {
+				grid_.SetCell(x, z, StageGrid::CellType::Floor);
 				continue;
+			}
 
 			// ---- ★ 壁ブロックだけ複数段積む設定 ----
 			const int wallStackCount = 5; // 壁の段数
@@ -126,11 +134,15 @@ void Stage::Initialize(
 			// 壁のみ 5 段、それ以外は 1 段
 			const int stackCount = isWall ? wallStackCount : 1;
 
+			AABB column{}; // 積んだ段をまとめた柱（格子の当たり判定用）
+			int cellIndex = -1;
 			for (int h = 0; h < stackCount; ++h) {
 				Tile t{};
 				t.isWall = isWall;
 				t.isPrism = isPrism;
 				t.isLift = isLift;
+				t.gridX = x;
+				t.gridZ = z;
 				t.prismAngle = std::stof(angStr);
 				t.modelHandle = t.isWall ? wallModelHandle_ : (t.isPrism ? prismModelHandle_ : sensorModelHandle_);
 
@@ -159,6 +171,7 @@ void Stage::Initialize(
 				t.aabb.max = {c.x + half.x + e, c.y + half.y + e, c.z + half.z + e};
 
 				if (t.isWall || t.isLift) {
+					t.wallIndex = static_cast<int>(wallAABBs_.size());
 					wallAABBs_.push_back(t.aabb); // ← リフトは1段なので1回だけ入る
 				}
 				if (t.isPrism) {
@@ -166,12 +179,27 @@ void Stage::Initialize(
 					prismAngles_.push_back(t.prismAngle);
 				}
 
+				if (h == 0) {
+					column = t.aabb;
+					cellIndex = t.isPrism ? static_cast<int>(prismAABBs_.size()) - 1 : t.wallIndex;
+				} else {
+					column.max.y = t.aabb.max.y;
+				}
+
 				t.baseY = t.transform.translate.y;
 				tiles_.push_back(std::move(t));
 			}
+
+			const StageGrid::CellType type = isWall ? StageGrid::CellType::Wall : (isPrism ? StageGrid::CellType::Prism : StageGrid::CellType::Lift);
+			grid_.SetCell(x, z, type, column, cellIndex, std::stof(angStr));
 		}
 	}
 
+	wallSet_.Build(wallAABBs_);
+	prismSet_.Build(prismAABBs_);
+	wallTree_.Build(wallAABBs_);
+	prismTree_.Build(prismAABBs_);
+
 	//-------------------------------------
 	// ★ 床タイル：CSV上の "1" 以外のマスに敷く
 	//-------------------------------------
@@ -206,13 +234,34 @@ void Stage::Initialize(
 
 //---------------------------------------------
 void Stage::Update() {
+	bool liftMoved = false;
 	for (auto& t : tiles_) {
 		if (!t.isLift)
 			continue;
 		float targetY = t.isUp ? (t.baseY - 2.0f) : t.baseY;
 		float diff = targetY - t.transform.translate.y;
-		t.transform.translate.y += diff * 0.1f;
+		const float dy = diff * 0.1f;
+		t.transform.translate.y += dy;
 		t.activeCollision = !t.isUp;
+
+		// 当たり判定の箱も一緒に動かす（止まっているリフトは触らない）
+		if (t.wallIndex >= 0) {
+			if (std::fabs(dy) > 1e-5f) {
+				t.aabb.min.y += dy;
+				t.aabb.max.y += dy;
+				wallAABBs_[t.wallIndex] = t.aabb;
+				wallSet_.Set(t.wallIndex, t.aabb);
+				wallTree_.SetBox(t.wallIndex, t.aabb);
+				grid_.SetBox(t.gridX, t.gridZ, t.aabb);
+				liftMoved = true;
+			}
+			wallTree_.SetEnabled(t.wallIndex, t.activeCollision);
+			grid_.SetEnabled(t.gridX, t.gridZ, t.activeCollision);
+		}
+	}
+	// 木の形はそのまま、外枠だけ直す
+	if (liftMoved) {
+		wallTree_.Refit();
 	}
 
 	// ★ 追加：床タイルの発光ターゲットを距離で決め、なめらかに追従
@@ -1,5 +1,8 @@
 #pragma once
 #include "AABB.h"
+#include "AABBSet.h"
+#include "AABBTree.h"
+#include "StageGrid.h"
 #include "Camera.h"
 #include "Matrix4x4.h"
 #include "Renderer.h"
@@ -33,9 +36,21 @@ public:
 	void SetCamera(const Camera* cam) { camera_ = cam; }
 
 	// 衝突などで利用
+	// ※ 下の Set / Tree / Grid は当たり判定の下回りとして用意してあるだけで、まだどこからも呼ばれていない
+	//    （Stage は今のシーンで使われておらず、Laser のステージ判定もコメントアウトのまま。移すときはこちらを使う）
+	// リフトの箱は Update で動かした位置に揃える（GetWalls / GetWallSet / GetWallTree / GetGrid で同じ箱、同じ番号）
+	// 下がって当たらないリフトを外すのは GetWallsDynamic / GetWallTree / GetGrid だけ（GetWalls / GetWallSet には残る）
 	const std::vector<AABB>& GetWalls() const { return wallAABBs_; }
 	const std::vector<AABB>& GetPrismWalls() const { return prismAABBs_; }
 	const std::vector<float>& GetPrismAngles() const { return prismAngles_; }
+	// 同じ箱の SoA 版（Collision::NearestHit でまとめて判定する用。番号は GetWalls / GetPrismWalls と同じ）
+	const AABBSet& GetWallSet() const { return wallSet_; }
+	const AABBSet& GetPrismSet() const { return prismSet_; }
+	// 同じ箱の BVH（番号は同じ。壁の木はリフトの上下に合わせて Update で Refit する）
+	const AABBTree& GetWallTree() const { return wallTree_; }
+	const AABBTree& GetPrismTree() const { return prismTree_; }
+	// CSV の格子のままの当たり判定（DDA のレイ / レーザーの反射・プリズム経路。まだ呼び出し元はない）
+	const StageGrid& GetGrid() const { return grid_; }
 	std::vector<AABB> GetWallsDynamic() const;
 
 	// 昇降ブロックのトグル
@@ -73,6 +88,8 @@ private:
 		float baseY = 0.0f;
 		bool isUp = false;
 		bool activeCollision = true;
+		int wallIndex = -1; // wallAABBs_ / wallTree_ での番号（壁とリフト）
+		int gridX = -1, gridZ = -1; // CSV のセル
 
 		// ★ 追加：床タイルの発光強度（0..1）
 		float glow = 0.0f;
@@ -86,6 +103,11 @@ private:
 	std::vector<AABB> wallAABBs_;
 	std::vector<AABB> prismAABBs_;
 	std::vector<float> prismAngles_;
+	AABBSet wallSet_;
+	AABBSet prismSet_;
+	AABBTree wallTree_;
+	AABBTree prismTree_;
+	StageGrid grid_;
 	const Camera* camera_ = nullptr;
 
 	float tileWidth_ = 1.0f;
@@ -0,0 +1,239 @@
+#include "StageGrid.h"
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Engine {
+
+namespace {
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+
+// 反射ベクトル（Laser::Reflect と同じ）
+Vector3 Reflect(const Vector3& d, const Vector3& n) {
+	const float dot = d.x * n.x + d.y * n.y + d.z * n.z;
+	return Normalize(Vector3{d.x - 2.0f * dot * n.x, d.y - 2.0f * dot * n.y, d.z - 2.0f * dot * n.z});
+}
+
+} // namespace
+
+void StageGrid::Build(int cols, int rows, float originX, float originZ, float pitchX, float pitchZ) {
+	cols_ = (std::max)(cols, 0);
+	rows_ = (std::max)(rows, 0);
+	originX_ = originX;
+	originZ_ = originZ;
+	pitchX_ = pitchX;
+	pitchZ_ = pitchZ;
+	overhang_ = 0.0f;
+
+	types_.assign(size_t(cols_) * size_t(rows_), uint8_t(CellType::Empty));
+	slot_.assign(types_.size(), -1);
+	boxes_.clear();
+	indices_.clear();
+	angles_.clear();
+	enabled_.clear();
+	stamp_.clear();
+	query_ = 0;
+}
+
+void StageGrid::SetCell(int x, int z, CellType type, const AABB& box, int index, float prismAngleDeg) {
+	if (!InBounds(x, z))
+		return;
+	const size_t c = Index(x, z);
+	types_[c] = uint8_t(type);
+	if (!IsSolid(uint8_t(type))) {
+		slot_[c] = -1;
+		return;
+	}
+
+	if (slot_[c] < 0) {
+		slot_[c] = int32_t(boxes_.size());
+		boxes_.push_back(box);
+		indices_.push_back(index);
+		angles_.push_back(prismAngleDeg);
+		enabled_.push_back(1);
+		stamp_.push_back(0);
+	} else {
+		boxes_[slot_[c]] = box;
+		indices_[slot_[c]] = index;
+		angles_[slot_[c]] = prismAngleDeg;
+	}
+	SetBox(x, z, box);
+}
+
+void StageGrid::SetBox(int x, int z, const AABB& box) {
+	if (!InBounds(x, z) || slot_[Index(x, z)] < 0)
+		return;
+	boxes_[slot_[Index(x, z)]] = box;
+
+	// セルの外へはみ出す量（XZ だけ。Y は格子に関係ない）
+	const float x0 = originX_ + float(x) * pitchX_, z0 = originZ_ + float(z) * pitchZ_;
+	overhang_ = (std::max)({overhang_, x0 - box.min.x, box.max.x - (x0 + pitchX_), z0 - box.min.z, box.max.z - (z0 + pitchZ_)});
+}
+
+void StageGrid::SetEnabled(int x, int z, bool enabled) {
+	if (InBounds(x, z) && slot_[Index(x, z)] >= 0)
+		enabled_[slot_[Index(x, z)]] = enabled ? 1 : 0;
+}
+
+bool StageGrid::Raycast(const Vector3& origin, const Vector3& dir, Hit& out, float expand, float tMin, float tMax, int skipPrism) const {
+	lastCells_ = 0;
+	if (boxes_.empty())
+		return false;
+
+	// 箱（expand で広げたもの）はセルから margin まではみ出しうる → 通ったセルの周り r セルまで見る
+	const float margin = expand + overhang_;
+	const int r = (std::max)(1, int(std::ceil(margin / (std::min)(pitchX_, pitchZ_))));
+
+	// 格子を r セルぶん広げた矩形にレイを切り詰める（XZ）
+	const float rx0 = originX_ - float(r) * pitchX_, rx1 = originX_ + float(cols_ + r) * pitchX_;
+	const float rz0 = originZ_ - float(r) * pitchZ_, rz1 = originZ_ + float(rows_ + r) * pitchZ_;
+	float tEnter = (std::max)(0.0f, tMin), tExit = tMax;
+	const float o[2] = {origin.x, origin.z};
+	const float d[2] = {dir.x, dir.z};
+	const float lo[2] = {rx0, rz0}, hi[2] = {rx1, rz1};
+	for (int a = 0; a < 2; ++a) {
+		if (std::fabs(d[a]) < 1e-12f) {
+			if (o[a] < lo[a] || o[a] > hi[a])
+				return false;
+			continue;
+		}
+		float t1 = (lo[a] - o[a]) / d[a], t2 = (hi[a] - o[a]) / d[a];
+		if (t1 > t2)
+			std::swap(t1, t2);
+		tEnter = (std::max)(tEnter, t1);
+		tExit = (std::min)(tExit, t2);
+	}
+	if (tEnter > tExit)
+		return false;
+
+	// 開始セル（広げた格子での番号）
+	const float px = origin.x + dir.x * tEnter, pz = origin.z + dir.z * tEnter;
+	int cx = std::clamp(int(std::floor((px - originX_) / pitchX_)), -r, cols_ + r - 1);
+	int cz = std::clamp(int(std::floor((pz - originZ_) / pitchZ_)), -r, rows_ + r - 1);
+
+	// DDA：次の x / z 境界までの t と、1 セル進む t
+	const int stepX = dir.x > 0.0f ? 1 : -1, stepZ = dir.z > 0.0f ? 1 : -1;
+	const float tDeltaX = dir.x != 0.0f ? pitchX_ / std::fabs(dir.x) : kInf;
+	const float tDeltaZ = dir.z != 0.0f ? pitchZ_ / std::fabs(dir.z) : kInf;
+	float tNextX = dir.x != 0.0f ? (originX_ + float(cx + (stepX > 0 ? 1 : 0)) * pitchX_ - origin.x) / dir.x : kInf;
+	float tNextZ = dir.z != 0.0f ? (originZ_ + float(cz + (stepZ > 0 ? 1 : 0)) * pitchZ_ - origin.z) / dir.z : kInf;
+
+	// 同じ箱を近所として何度も見ないように、問い合わせごとの印を付ける
+	if (++query_ == 0) {
+		std::fill(stamp_.begin(), stamp_.end(), 0u);
+		query_ = 1;
+	}
+
+	float best = tMax;
+	int bestSlot = -1;
+	bool bestPrism = false;
+	Vector3 bestNormal{};
+	while (true) {
+		++lastCells_;
+		const float tCellExit = (std::min)({tNextX, tNextZ, tExit});
+
+		for (int z = (std::max)(cz - r, 0); z <= (std::min)(cz + r, rows_ - 1); ++z) {
+			for (int x = (std::max)(cx - r, 0); x <= (std::min)(cx + r, cols_ - 1); ++x) {
+				const int s = slot_[Index(x, z)];
+				if (s < 0 || stamp_[s] == query_)
+					continue;
+				stamp_[s] = query_;
+				const bool prism = types_[Index(x, z)] == uint8_t(CellType::Prism);
+				if (!enabled_[s] || (prism && indices_[s] == skipPrism))
+					continue;
+				float t;
+				Vector3 n;
+				// 同じ距離なら壁を優先（旧レーザー予測は壁を先に調べ、プリズムはより近いときだけ採っていた）
+				if (Collision::IntersectRayAABBExpanded(origin, dir, boxes_[s], expand, t, n) && t > tMin && (t < best || (t == best && bestPrism && !prism))) {
+					best = t;
+					bestSlot = s;
+					bestPrism = prism;
+					bestNormal = n;
+					out.cellX = x;
+					out.cellZ = z;
+				}
+			}
+		}
+
+		// 当たった点はこのセルの中か、もう通ったセルの中 → 先のセルにこれより近いものはない
+		if (bestSlot >= 0 && best <= tCellExit)
+			break;
+		if (tCellExit >= tExit)
+			break;
+
+		if (tNextX < tNextZ) {
+			cx += stepX;
+			tNextX += tDeltaX;
+		} else {
+			cz += stepZ;
+			tNextZ += tDeltaZ;
+		}
+		if (cx < -r || cz < -r || cx >= cols_ + r || cz >= rows_ + r)
+			break;
+	}
+
+	if (bestSlot < 0)
+		return false;
+	out.t = best;
+	out.normal = bestNormal;
+	out.type = CellType(types_[Index(out.cellX, out.cellZ)]);
+	out.index = indices_[bestSlot];
+	return true;
+}
+
+int StageGrid::Trace(const Vector3& origin, const Vector3& dir, const TraceDesc& desc, std::vector<PathSegment>& out) const {
+	out.clear();
+	Vector3 pos = origin;
+	Vector3 d = Normalize(dir);
+	float traveled = 0.0f;
+	int bounce = 0;
+	int lastPrism = -1; // 直前に通ったプリズム（出た直後に当たり直さない）
+	uint32_t cells = 0;
+
+	while (bounce <= desc.maxBounces) {
+		// 残りの長さ（XZ）をレイの t に直して、その先は見ない（d は 3D で単位長なので XZ 成分の長さで割る）
+		const float xz = std::sqrt(d.x * d.x + d.z * d.z);
+		const float tLimit = xz > 1e-6f ? (desc.maxLength - traveled) / xz : 1e9f;
+
+		Hit hit;
+		const bool found = Raycast(pos, d, hit, desc.expand, 1e-4f, tLimit, lastPrism);
+		cells += lastCells_;
+
+		const Vector3 endPos = found ? pos + d * hit.t : pos + d * (std::min)(desc.missLength, tLimit);
+		const Vector3 seg = endPos - pos;
+		const float len = std::sqrt(seg.x * seg.x + seg.z * seg.z);
+		if (len > 1e-4f) {
+			out.push_back(PathSegment{pos, endPos, false});
+		}
+		traveled += len;
+		if (!found || traveled >= desc.maxLength)
+			break;
+
+		// プリズム：中心へ吸い込んで、角度の向きへ出し直す（反射の回数には数えない）
+		if (hit.type == CellType::Prism) {
+			const int s = slot_[Index(hit.cellX, hit.cellZ)];
+			const AABB& box = boxes_[s];
+			const Vector3 center{(box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f};
+			const float rad = DirectX::XMConvertToRadians(angles_[s]);
+			d = Normalize(Vector3{std::sin(rad), 0.0f, std::cos(rad)});
+
+			out.push_back(PathSegment{endPos, center, true});
+			pos = center + d * desc.prismExit;
+			lastPrism = hit.index;
+			continue;
+		}
+
+		// 壁：反射
+		d = Reflect(d, hit.normal);
+		++bounce;
+		pos = endPos + d * 0.001f;
+		lastPrism = -1;
+	}
+
+	lastCells_ = cells;
+	return bounce;
+}
+
+} // namespace Engine
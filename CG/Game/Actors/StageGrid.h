@@ -0,0 +1,92 @@
+#pragma once
+#include "AABB.h"
+#include "Collision.h"
+#include "Matrix4x4.h"
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+// ステージの CSV の格子そのままの当たり判定（XZ の 2D 格子 + セルごとに 1 箱）
+// - セルの種類は 1 バイトの配列。当たりのあるセル（壁/プリズム/リフト）だけ箱を持つ
+// - 壁は積んだ段をまとめた 1 本の柱として扱う（段の箱は少し重なっているので和集合 = 柱）
+// - レイは Amanatides-Woo の DDA でセルを順にたどり、通ったセルとその近所（expand の分）の箱だけ判定する
+//   → 手間は壁の数ではなく通ったセルの数に比例する
+// - 箱の判定は Collision::IntersectRayAABBExpanded と同じ
+class StageGrid {
+public:
+	enum class CellType : uint8_t {
+		Empty, // CSV の外
+		Floor, // 床だけ（当たりなし）
+		Wall,
+		Prism,
+		Lift,
+	};
+
+	struct Hit {
+		float t = 0.0f;
+		Vector3 normal{0, 0, 0};
+		int cellX = -1, cellZ = -1;
+		CellType type = CellType::Empty;
+		int index = -1; // Prism ならプリズムの番号（GetPrismAngles と同じ）、Wall / Lift なら壁の番号
+	};
+
+	// 反射/プリズムで折れた 1 区間
+	struct PathSegment {
+		Vector3 from, to;
+		bool intoPrism = false; // プリズムの表面 → 中心（吸い込み）の区間
+	};
+
+	struct TraceDesc {
+		int maxBounces = 2;        // 壁での反射の回数
+		float maxLength = 1000.0f; // XZ の長さの合計（これを超える区間は途中で切る。プリズムへ吸い込む区間は数えない）
+		float expand = 0.5f;       // 箱を広げる幅（レーザーの太さ）
+		float missLength = 100.0f; // 何にも当たらなかったときの最後の区間の長さ
+		float prismExit = 0.2f;    // プリズムの中心から再出射するときに離す距離
+	};
+
+	// 格子の形（セル (x, z) の範囲は origin + (x, z) * pitch から pitch 分）
+	void Build(int cols, int rows, float originX, float originZ, float pitchX, float pitchZ);
+	// 当たりのあるセルは box と番号を渡す（壁の柱、プリズムなら角度 [deg] も）
+	void SetCell(int x, int z, CellType type, const AABB& box = {}, int index = -1, float prismAngleDeg = 0.0f);
+	// リフトなど動くセルの箱の更新 / 一時的に当たりを消す
+	void SetBox(int x, int z, const AABB& box);
+	void SetEnabled(int x, int z, bool enabled);
+
+	// tMin < t < tMax でいちばん近い箱。skipPrism の番号のプリズムは見ない
+	bool Raycast(const Vector3& origin, const Vector3& dir, Hit& out, float expand = 0.0f, float tMin = 1e-4f, float tMax = 1e9f, int skipPrism = -1) const;
+
+	// レーザーの経路：壁で反射、プリズムで角度の向きへ曲げる（Laser の予測線と同じ規則）
+	// 戻り値は反射した回数
+	int Trace(const Vector3& origin, const Vector3& dir, const TraceDesc& desc, std::vector<PathSegment>& out) const;
+
+	int Cols() const { return cols_; }
+	int Rows() const { return rows_; }
+	CellType TypeAt(int x, int z) const { return InBounds(x, z) ? CellType(types_[Index(x, z)]) : CellType::Empty; }
+	bool InBounds(int x, int z) const { return x >= 0 && z >= 0 && x < cols_ && z < rows_; }
+	// 直近の Raycast / Trace でたどったセルの数（近所の判定は数えない）
+	uint32_t LastCellsVisited() const { return lastCells_; }
+
+private:
+	size_t Index(int x, int z) const { return size_t(z) * size_t(cols_) + size_t(x); }
+	bool IsSolid(uint8_t t) const { return t == uint8_t(CellType::Wall) || t == uint8_t(CellType::Prism) || t == uint8_t(CellType::Lift); }
+
+	int cols_ = 0, rows_ = 0;
+	float originX_ = 0.0f, originZ_ = 0.0f;
+	float pitchX_ = 1.0f, pitchZ_ = 1.0f;
+	float overhang_ = 0.0f; // 箱がセルからはみ出す最大量（近所を見る範囲に足す）
+
+	std::vector<uint8_t> types_;   // CellType
+	std::vector<int32_t> slot_;    // 当たりのあるセル → boxes_ の番号（無ければ -1）
+	std::vector<AABB> boxes_;      // 当たりのあるセルの箱
+	std::vector<int32_t> indices_; // boxes_ と同じ並び：プリズム/壁の番号
+	std::vector<float> angles_;    // boxes_ と同じ並び：プリズムの角度 [deg]
+	std::vector<uint8_t> enabled_; // boxes_ と同じ並び
+
+	// Raycast 用：近所として見た箱の印（問い合わせごとに query_ を進める）
+	mutable std::vector<uint32_t> stamp_;
+	mutable uint32_t query_ = 0;
+	mutable uint32_t lastCells_ = 0;
+};
+
+} // namespace Engine
@@ -1,10 +1,12 @@
 #include "GameScene.h"
 #include "Collision.h"
+#include "ParticleRenderer.h"
 #include "imgui.h"
 #include <Windows.h>
 #include <Xinput.h>
 #include <cmath>
 #include <random>
+#include <vector>
 #pragma comment(lib, "xinput9_1_0.lib")
 
 using namespace DirectX;
@@ -27,6 +29,13 @@ void ForceCursorVisible(bool visible) {
 	}
 }
 
+// シーンをまたいで残す地形の変形（GameScene を抜けるときに取り、次に入ったときに戻す）
+// シーンごとに Renderer を作り直すので、凹みの状態はここに圧縮したバイト列で預けておく
+std::vector<uint8_t>& TerrainCarryOver() {
+	static std::vector<uint8_t> bytes;
+	return bytes;
+}
+
 } // namespace
 
 namespace Engine {
@@ -51,6 +60,11 @@ static Vector3 GetCameraForward(const Camera& cam) {
 	return Vector3{f.x, f.y, f.z};
 }
 
+GameScene::~GameScene() {
+	// 抜けるときの地形（ベース地形との差分）を預ける
+	renderer_.CaptureTerrainDeformation(TerrainCarryOver());
+}
+
 void GameScene::Initialize(WindowDX* dx) {
 	dx_ = dx;
 
@@ -66,6 +80,10 @@ void GameScene::Initialize(WindowDX* dx) {
 	// 1. Renderer / Input
 	// ===============================
 	renderer_.Initialize(*dx_);
+	// 前にこのシーンを抜けたときの地形へ戻す（凹みを入れ直さずに展開 1 回で）
+	if (!TerrainCarryOver().empty()) {
+		renderer_.RestoreTerrainDeformation(TerrainCarryOver().data(), TerrainCarryOver().size());
+	}
 	input_.Initialize(dx_->GetHInstance(), dx_->GetHwnd());
 
 	// ===============================
@@ -96,6 +114,7 @@ void GameScene::Initialize(WindowDX* dx) {
 	sparks_.SetPosition({0, 1.0f, 0});
 	auto& p = sparks_.Params();
 	p.maxOnce = 256;
+	p.overflow = Engine::ParticleOverflow::RecycleOldest; // 連打で満杯でも新しい火花を優先
 	p.useAdditive = true;
 	p.initColor = {0.3f, 0.2f, 0.1f, 0.5f};
 	p.initScaleMin = {0.05f, 0.05f, 0.05f};
@@ -148,6 +167,17 @@ void GameScene::Initialize(WindowDX* dx) {
 	// ★XZ 位置からボクセル地形の高さを返すコールバック
 	boss_->SetTerrainHeightCallback([this](const Engine::Vector3& pos) { return renderer_.TerrainHeightAt(pos.x, pos.z); });
 
+	// ★先端の通り道が地形をまたいだかをレイで見るコールバック
+	boss_->SetTerrainSegmentCallback([this](const Engine::Vector3& from, const Engine::Vector3& to, Engine::Vector3& hitPos) {
+		const Engine::Vector3 d = to - from;
+		const float len = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+		Engine::TerrainRayHit hit;
+		if (len <= 0.0f || !renderer_.TerrainRaycast(from, d, len, hit))
+			return false;
+		hitPos = hit.position;
+		return true;
+	});
+
 	// 巨大地面をロード
 	outerGroundHandle_ = renderer_.LoadModel(dx_->Dev(), dx_->List(), "Resources/Plane/Plane.obj");
 
@@ -160,12 +190,17 @@ void GameScene::Initialize(WindowDX* dx) {
 	Engine::WaterSurfaceDesc wd;
 	wd.sizeX = 1000.0f; // 島を囲むくらいに調整
 	wd.sizeZ = 1000.0f;
-	wd.tessX = 200;
-	wd.tessZ = 200;
+	wd.finestCell = 1.0f; // カメラの近くの頂点間隔（遠くほど粗く）
 	wd.height = -2.0f; // 海面の高さ（好みで調整）
+	wd.useOceanFFT = false; // FFT 海面（true で 256 格子、250m タイル。CPU で毎フレーム回すので既定は式の波）
+	wd.ocean.resolution = 256;
+	wd.ocean.patchSize = 250.0f;
+	wd.ocean.waveHeight = 1.2f;
 
 	water_ = std::make_unique<Engine::WaterSurface>();
 	water_->Initialize(*dx_, wd);
+	// 地形の下に沈んだ水面のパッチは描かない
+	water_->SetTerrainQuery([this](float x0, float z0, float x1, float z1, float& lo) { return renderer_.TerrainMinHeightIn(x0, z0, x1, z1, lo); });
 
 	// ===============================
 	// 5. Grid 初期化（Stage 依存なし版）
@@ -320,9 +355,30 @@ void GameScene::Update() {
 
 		if (boss_) {
 			boss_->Update(gameDt, playerPos);
+
+			// 近接攻撃の剣カプセル vs ボスの棒（1 振りにつき 1 回だけ当てる）
+			Vector3 sword0, sword1;
+			float swordR;
+			if (player_.GetMeleeHitCapsule(sword0, sword1, swordR)) {
+				Vector3 stick0, stick1;
+				float stickR;
+				boss_->GetStickCapsule(stick0, stick1, stickR);
+				Engine::Collision::Contact contact;
+				if (!meleeHitBoss_ && Engine::Collision::CapsuleCapsule(sword0, sword1, swordR, stick0, stick1, stickR, contact)) {
+					player_.TriggerHitEffect(contact.point, contact.normal);
+					meleeHitBoss_ = true;
+				}
+			} else {
+				meleeHitBoss_ = false;
+			}
 		}
 
 		if (water_) {
+			// 波紋の格子はプレイヤーについていく。水面近くで回避したら航跡を残す
+			water_->SetRippleCenter(playerPos.x, playerPos.z);
+			if (player_.IsDodging() && std::fabs(playerPos.y - water_->SampleHeight(playerPos.x, playerPos.z)) < 1.0f) {
+				water_->AddRipple(playerPos.x, playerPos.z, 0.8f, -0.04f);
+			}
 			water_->Update(gameDt);
 		}
 
@@ -449,6 +505,16 @@ void GameScene::Update() {
 			// とりあえず壁コリジョンなしで、そのまま希望位置へ
 			Engine::Vector3 allowed = desired;
 
+			// ===== ボクセル地形との衝突（プレイヤーとの間に地形があれば手前で止める） =====
+			{
+				const Engine::Vector3 toCam = desired - eye;
+				const float camDist = std::sqrt(toCam.x * toCam.x + toCam.y * toCam.y + toCam.z * toCam.z);
+				Engine::TerrainRayHit hit;
+				if (renderer_.TerrainSphereCast(eye, toCam, camRadius, camDist, hit)) {
+					allowed = hit.position;
+				}
+			}
+
 			// ===== ボクセル地形との衝突（地面にめり込まないように） =====
 			{
 				// この XZ での地形の高さを取得
@@ -502,6 +568,28 @@ void GameScene::DrawImGui_() {
 	ImGui::Text("FPS : %5.1f", fps_);
 	ImGui::SetWindowFontScale(1.0f);
 
+	// 地形の再生成コスト（直近 1 回ぶん）
+	const auto& vs = renderer_.VoxelStats();
+	ImGui::Text("Terrain rebuild : %u chunks / %u cells (%.3f ms)", vs.chunks, vs.cells, vs.recordMs);
+	ImGui::Text("Terrain LOD     : %u patches, %u / %u tris", vs.lodPatches, vs.lodTriangles, vs.fullTriangles);
+	ImGui::Text("Terrain dents   : %u (merged %u)", renderer_.TerrainDents().Count(), renderer_.TerrainDents().MergedCount());
+	if (water_) {
+		// 水面（CPU 側の波）とプレイヤーの高さの差。負なら水の中
+		const Vector3 pp = player_.GetPos();
+		ImGui::Text("Water at player : %.2f m (player %+.2f)", water_->SampleHeight(pp.x, pp.z), pp.y - water_->SampleHeight(pp.x, pp.z));
+		ImGui::Text("Water mesh      : %u patches, %u verts", water_->DrawnPatches(), water_->DrawnVertices());
+		const Engine::WaterCullStats& wc = water_->CullStats();
+		ImGui::Text("Water culling   : %u drawn / %u frustum / %u under terrain", wc.drawn, wc.frustumCulled, wc.terrainCulled);
+		ImGui::Text("Water indices   : %u / %u submitted", water_->SubmittedIndices(), water_->CandidateIndices());
+	}
+	// 火花（インスタンス描画なので 1 エミッタ 1 ドローコール）
+	const Engine::ParticleSystem& sp = sparks_.System();
+	ImGui::Text("Sparks          : %zu / %zu alive, %zu drawn in %u draw call", sp.AliveCount(), sp.Capacity(), sp.DrawnInstances(), sp.DrawCalls());
+	// 全エミッタ共用のプール（直前のフレーム）
+	if (auto pr = renderer_.SharedParticleRenderer()) {
+		ImGui::Text("Particle pool   : %.1f / %.1f KB, %u draw calls", pr->PoolUsed() / 1024.0, pr->PoolSize() / 1024.0, pr->FrameDrawCalls());
+	}
+
 	ImGui::End();
 
 	ImGui::PopStyleColor(2);
@@ -547,6 +635,11 @@ void GameScene::ApplyBossHitToTerrain_(const Game::TerrainHitInfo& info) {
 	// ★ボスの着弾位置を GPU ボクセル地形に凹みとして登録
 	DirectX::XMFLOAT3 pos{info.position.x, info.position.y, info.position.z};
 	renderer_.AddTerrainDent(pos, info.radius, info.depth);
+
+	// 水面の近くなら波紋も立てる
+	if (water_ && std::fabs(info.position.y - water_->SampleHeight(info.position.x, info.position.z)) < info.radius) {
+		water_->AddRipple(info.position.x, info.position.z, info.radius * 1.5f, 0.4f);
+	}
 }
 
 void GameScene::Draw() {
@@ -21,6 +21,8 @@ namespace Engine {
 
 class GameScene : public IScene {
 public:
+	~GameScene() override;
+
 	void Initialize(WindowDX* dx) override;
 	void Update() override;
 	void Draw() override;
@@ -67,6 +69,7 @@ private:
 	float hitStopScale_ = 0.1f; // ヒットストップ中のスケール（0で完全停止）
 	float debugBaseDt_ = 0.0f;  // 生のdt（1/60）
 	float debugGameDt_ = 0.0f;  // ヒットストップ適用後のdt
+	bool meleeHitBoss_ = false; // 今の振りでもうボスに当てたか
 
 	// ==== 敵スポーン制御 ====
 	float enemySpawnTimer_ = 0.0f;    // 経過時間
@@ -0,0 +1,135 @@
+// CG/Tests/AABBTreeBench.cpp
+// AABBTree：25x25 〜 512x512 の Stage の壁で、全部を見る線形のレイ判定（1 個ずつ / AABBSet で 8 個ずつ）との比較
+// 作る時間、リフトの Refit、レーザーと同じ水平なレイ、半径 1 の球の問い合わせ
+#include "TestCommon.h"
+#include "AABBTree.h"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+// AABBTreeTest と同じ並べ方（外周が壁、中は 12% が 5 段の壁、1% がリフト）
+std::vector<std::string> RandomMap(int n, std::mt19937& rng) {
+	std::uniform_real_distribution<float> u(0.0f, 1.0f);
+	std::vector<std::string> rows(n, std::string(n, '0'));
+	for (int z = 0; z < n; ++z) {
+		for (int x = 0; x < n; ++x) {
+			if (z == 0 || x == 0 || z == n - 1 || x == n - 1) {
+				rows[z][x] = '1';
+				continue;
+			}
+			const float r = u(rng);
+			rows[z][x] = r < 0.12f ? '1' : (r < 0.13f ? '3' : '0');
+		}
+	}
+	return rows;
+}
+
+std::vector<AABB> MakeWalls(const std::vector<std::string>& rows, std::vector<int>& lifts) {
+	constexpr float kTile = 2.0f, kGap = 0.02f, kPitch = kTile + kGap, kE = 0.02f;
+	const int r = int(rows.size()), c = int(rows[0].size());
+	std::vector<AABB> out;
+	for (int z = 0; z < r; ++z) {
+		for (int x = 0; x < c; ++x) {
+			const char cell = rows[z][x];
+			if (cell != '1' && cell != '3')
+				continue;
+			const float cx = (x + 0.5f - c * 0.5f) * kPitch, cz = (z + 0.5f - r * 0.5f) * kPitch;
+			const float hx = (kTile - kGap) * 0.5f, hy = kTile * 0.5f, hz = hx;
+			for (int h = 0; h < (cell == '1' ? 5 : 1); ++h) {
+				const float cy = hy + h * kTile;
+				if (cell == '3') {
+					lifts.push_back(int(out.size()));
+				}
+				out.push_back(AABB{{cx - hx - kE, cy - hy - kE, cz - hz - kE}, {cx + hx + kE, cy + hy + kE, cz + hz + kE}});
+			}
+		}
+	}
+	return out;
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(11);
+	std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+	constexpr int kRays = 2000;
+
+	std::printf("%-9s %7s %9s %9s | %12s %12s %9s %7s | %9s\n", "map", "boxes", "build ms", "refit ms", "scan us/ray", "SoA us/ray", "BVH us", "vs SoA", "sphere us");
+	for (int n : {25, 64, 128, 256, 512}) {
+		std::vector<int> lifts;
+		std::vector<AABB> boxes = MakeWalls(RandomMap(n, rng), lifts);
+		AABBTree tree;
+		const double buildUs = Test::TimeUs([&] { tree.Build(boxes); });
+		AABBSet set;
+		set.Build(boxes);
+
+		// リフトを少し下げて Refit（Stage::Update で 1 フレームに起きること）
+		const double refitUs = Test::TimeUs([&] {
+			for (int i : lifts) {
+				boxes[i].min.y -= 0.01f;
+				boxes[i].max.y -= 0.01f;
+				tree.SetBox(i, boxes[i]);
+			}
+			tree.Refit();
+		});
+		set.Build(boxes);
+
+		const float half = n * 1.01f;
+		std::vector<Vector3> origins(kRays), dirs(kRays);
+		for (int q = 0; q < kRays; ++q) {
+			origins[q] = {u(rng) * half, 1.0f, u(rng) * half};
+			dirs[q] = Normalize(Vector3{u(rng), 0.0f, u(rng)});
+		}
+
+		// 線形は大きいマップだと遅いので本数を減らす
+		const int linearRays = boxes.size() > 100000 ? 100 : kRays;
+		volatile float sink = 0.0f;
+		const double scanUs = Test::TimeUs([&] {
+			for (int q = 0; q < linearRays; ++q) {
+				float best = 1e9f;
+				for (const AABB& b : boxes) {
+					float t;
+					Vector3 nrm;
+					if (Collision::IntersectRayAABBExpanded(origins[q], dirs[q], b, 0.5f, t, nrm) && t > 1e-4f && t < best) {
+						best = t;
+					}
+				}
+				sink = sink + best;
+			}
+		}) / linearRays;
+		const double soaUs = Test::TimeUs([&] {
+			for (int q = 0; q < linearRays; ++q) {
+				Collision::RayHit hit;
+				if (Collision::NearestHit(origins[q], dirs[q], set, hit, 0.5f)) {
+					sink = sink + hit.t;
+				}
+			}
+		}) / linearRays;
+		const double bvhUs = Test::TimeUs([&] {
+			for (int q = 0; q < kRays; ++q) {
+				Collision::RayHit hit;
+				if (tree.Raycast(origins[q], dirs[q], hit, 0.5f)) {
+					sink = sink + hit.t;
+				}
+			}
+		}) / kRays;
+		std::vector<int> found;
+		const double sphereUs = Test::TimeUs([&] {
+			for (int q = 0; q < kRays; ++q) {
+				found.clear();
+				tree.QuerySphere(origins[q], 1.0f, found);
+				sink = sink + float(found.size());
+			}
+		}) / kRays;
+
+		char name[16];
+		std::snprintf(name, sizeof(name), "%dx%d", n, n);
+		std::printf("%-9s %7zu %9.2f %9.3f | %12.1f %12.1f %9.2f %6.0fx | %9.2f\n", name, boxes.size(), buildUs / 1000.0, refitUs / 1000.0, scanUs, soaUs, bvhUs, soaUs / bvhUs, sphereUs);
+	}
+	return 0;
+}
@@ -0,0 +1,200 @@
+// CG/Tests/AABBTreeTest.cpp
+// AABBTree：Stage と同じ並べ方の壁で、レイ / 線分 / 球 / 箱の問い合わせが全部を線形に見たときと一致するか（リフトを動かして Refit したあとも）
+#include "TestCommon.h"
+#include "AABBTree.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+// 外周が壁、中は 12% が壁（5 段積み）、1% がリフト（1 段）の N x N の CSV
+std::vector<std::string> RandomMap(int n, std::mt19937& rng) {
+	std::uniform_real_distribution<float> u(0.0f, 1.0f);
+	std::vector<std::string> rows(n, std::string(n, '0'));
+	for (int z = 0; z < n; ++z) {
+		for (int x = 0; x < n; ++x) {
+			if (z == 0 || x == 0 || z == n - 1 || x == n - 1) {
+				rows[z][x] = '1';
+				continue;
+			}
+			const float r = u(rng);
+			rows[z][x] = r < 0.12f ? '1' : (r < 0.13f ? '3' : '0');
+		}
+	}
+	return rows;
+}
+
+// Stage::Initialize と同じ箱（タイル 2m、隙間 0.02、中心合わせ、0.02 太らせる）
+std::vector<AABB> MakeWalls(const std::vector<std::string>& rows, std::vector<int>& lifts) {
+	constexpr float kTile = 2.0f, kGap = 0.02f, kPitch = kTile + kGap, kE = 0.02f;
+	const int r = int(rows.size()), c = int(rows[0].size());
+	std::vector<AABB> out;
+	for (int z = 0; z < r; ++z) {
+		for (int x = 0; x < c; ++x) {
+			const char cell = rows[z][x];
+			if (cell != '1' && cell != '3')
+				continue;
+			const float cx = (x + 0.5f - c * 0.5f) * kPitch, cz = (z + 0.5f - r * 0.5f) * kPitch;
+			const float hx = (kTile - kGap) * 0.5f, hy = kTile * 0.5f, hz = hx;
+			for (int h = 0; h < (cell == '1' ? 5 : 1); ++h) {
+				const float cy = hy + h * kTile;
+				if (cell == '3') {
+					lifts.push_back(int(out.size()));
+				}
+				out.push_back(AABB{{cx - hx - kE, cy - hy - kE, cz - hz - kE}, {cx + hx + kE, cy + hy + kE, cz + hz + kE}});
+			}
+		}
+	}
+	return out;
+}
+
+bool Overlap(const AABB& a, const AABB& b) {
+	return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y && a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+// 全部の問い合わせを線形に見た結果と比べて、違った数を返す
+int CompareWithLinear(const AABBTree& tree, const std::vector<AABB>& boxes, const std::vector<bool>& enabled, float halfX, float halfZ, std::mt19937& rng, int queries) {
+	std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+	int mismatch = 0;
+	std::vector<int> got, ref;
+	for (int q = 0; q < queries; ++q) {
+		const Vector3 o{u(rng) * halfX, 1.0f + u(rng) * 0.5f, u(rng) * halfZ};
+		Vector3 d{u(rng), (q % 3 == 0) ? u(rng) * 0.2f : 0.0f, u(rng)};
+		if (std::fabs(d.x) + std::fabs(d.z) < 1e-3f) {
+			d.x = 1.0f;
+		}
+		d = Normalize(d);
+		const float expand = (q & 1) ? 0.5f : 0.0f;
+		const int skip = (q % 7 == 0) ? int(rng() % boxes.size()) : -1;
+
+		// レイ：いちばん近い箱（t はビット単位で同じ）
+		float bestT = 1e9f;
+		int bestI = -1;
+		for (size_t i = 0; i < boxes.size(); ++i) {
+			float t;
+			Vector3 n;
+			if (enabled[i] && int(i) != skip && Collision::IntersectRayAABBExpanded(o, d, boxes[i], expand, t, n) && t > 1e-4f && t < bestT) {
+				bestT = t;
+				bestI = int(i);
+			}
+		}
+		Collision::RayHit hit;
+		const bool hitTree = tree.Raycast(o, d, hit, expand, 1e-4f, 1e9f, skip);
+		if (hitTree != (bestI >= 0) || (hitTree && (hit.index != bestI || hit.t != bestT))) {
+			++mismatch;
+		}
+
+		// 線分：どれかに当たるか
+		const Vector3 p1{o.x + d.x * 30.0f * u(rng), o.y + d.y * 5.0f, o.z + d.z * 30.0f * u(rng)};
+		bool anyRef = false;
+		for (size_t i = 0; i < boxes.size() && !anyRef; ++i) {
+			float t;
+			Vector3 n;
+			anyRef = enabled[i] && Collision::IntersectSegmentAABB(o, p1, boxes[i], t, n);
+		}
+		int anyIndex = -1;
+		const bool anyTree = tree.SegmentAnyHit(o, p1, &anyIndex);
+		if (anyTree != anyRef || (anyTree && !enabled[anyIndex])) {
+			++mismatch;
+		}
+
+		// 球：接しているものも含む
+		const float radius = std::fabs(u(rng)) * 4.0f;
+		got.clear();
+		ref.clear();
+		tree.QuerySphere(o, radius, got);
+		for (size_t i = 0; i < boxes.size(); ++i) {
+			const AABB& b = boxes[i];
+			const float dx = (std::max)({b.min.x - o.x, 0.0f, o.x - b.max.x});
+			const float dy = (std::max)({b.min.y - o.y, 0.0f, o.y - b.max.y});
+			const float dz = (std::max)({b.min.z - o.z, 0.0f, o.z - b.max.z});
+			if (enabled[i] && dx * dx + dy * dy + dz * dz <= radius * radius) {
+				ref.push_back(int(i));
+			}
+		}
+		std::sort(got.begin(), got.end());
+		if (got != ref) {
+			++mismatch;
+		}
+
+		// 箱
+		const AABB qb{{o.x - radius, o.y - radius, o.z - radius}, {o.x + radius * 2.0f, o.y + radius, o.z + radius}};
+		got.clear();
+		ref.clear();
+		tree.QueryAABB(qb, got);
+		for (size_t i = 0; i < boxes.size(); ++i) {
+			if (enabled[i] && Overlap(boxes[i], qb)) {
+				ref.push_back(int(i));
+			}
+		}
+		std::sort(got.begin(), got.end());
+		if (got != ref) {
+			++mismatch;
+		}
+	}
+	return mismatch;
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(11);
+
+	// 1) 25x25 〜 128x128 の壁：作った直後、リフトを下げて半分を無効にして Refit したあと
+	for (int n : {25, 64, 128}) {
+		std::vector<int> lifts;
+		std::vector<AABB> boxes = MakeWalls(RandomMap(n, rng), lifts);
+		AABBTree tree;
+		tree.Build(boxes);
+		TEST_CHECK(tree.Size() == boxes.size());
+		TEST_CHECK(tree.NodeCount() < 2 * boxes.size());
+
+		const float half = n * 1.01f;
+		std::vector<bool> enabled(boxes.size(), true);
+		TEST_CHECK(CompareWithLinear(tree, boxes, enabled, half, half, rng, 300) == 0);
+
+		for (size_t k = 0; k < lifts.size(); ++k) {
+			const int i = lifts[k];
+			boxes[i].min.y -= 1.3f;
+			boxes[i].max.y -= 1.3f;
+			tree.SetBox(i, boxes[i]);
+			if (k & 1) {
+				enabled[i] = false;
+				tree.SetEnabled(i, false);
+			}
+		}
+		tree.Refit();
+		TEST_CHECK(!lifts.empty());
+		TEST_CHECK(CompareWithLinear(tree, boxes, enabled, half, half, rng, 300) == 0);
+		for (int i : lifts) {
+			const AABB& b = tree.Box(i);
+			TEST_CHECK(b.min.y == boxes[i].min.y && b.max.y == boxes[i].max.y);
+		}
+	}
+
+	// 2) 箱が 1 個 / 0 個
+	{
+		AABBTree tree;
+		tree.Build({AABB{{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}}});
+		Collision::RayHit hit;
+		TEST_CHECK(tree.Raycast({-5.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, hit));
+		TEST_CHECK_NEAR(hit.t, 4.0, 1e-6);
+		TEST_CHECK(hit.index == 0 && hit.normal.x == -1.0f);
+		TEST_CHECK(!tree.Raycast({-5.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, hit, 0.0f, 1e-4f, 1e9f, 0));
+
+		AABBTree empty;
+		empty.Build({});
+		std::vector<int> out;
+		empty.QuerySphere({0.0f, 0.0f, 0.0f}, 10.0f, out);
+		TEST_CHECK(!empty.Raycast({0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, hit));
+		TEST_CHECK(!empty.SegmentAnyHit({0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}));
+		TEST_CHECK(out.empty());
+	}
+
+	return Test::Result("AABBTreeTest");
+}
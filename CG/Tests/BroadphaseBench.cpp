@@ -0,0 +1,77 @@
+// CG/Tests/BroadphaseBench.cpp
+// Broadphase：半径 0.5 の球が 10000 個、一辺 100 の箱の中を動く（1000〜20000 個は同じ密度で箱を広げる）
+// 1 フレームの Update の時間（最小と平均）、組の数、セルへの登録数、箱の比較数、全部の組を見たときの時間
+#include "TestCommon.h"
+#include "Broadphase.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+bool Overlap(const AABB& a, const AABB& b) {
+	return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y && a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(25);
+	std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+	constexpr float kRadius = 0.5f;
+	constexpr int kFrames = 200;
+
+	std::printf("%6s %6s | %9s %9s %9s | %7s %8s %7s | %11s\n", "N", "side", "min us", "avg us", "move us", "pairs", "entries", "tests", "brute us");
+	for (int n : {1000, 5000, 10000, 20000}) {
+		const float half = 50.0f * std::cbrt(float(n) / 10000.0f);
+		Broadphase bp;
+		std::vector<Vector3> p(n), v(n);
+		std::vector<Broadphase::ProxyId> ids(n);
+		for (int i = 0; i < n; ++i) {
+			p[i] = {u(rng) * half, u(rng) * half, u(rng) * half};
+			v[i] = Vector3{u(rng), u(rng), u(rng)} * 0.05f;
+			ids[i] = bp.Create(AABB{p[i] - Vector3{kRadius, kRadius, kRadius}, p[i] + Vector3{kRadius, kRadius, kRadius}});
+		}
+		bp.Update();
+
+		double minUs = 1e30, sumUs = 0.0, moveUs = 0.0;
+		size_t pairs = 0, entries = 0, tests = 0;
+		for (int f = 0; f < kFrames; ++f) {
+			moveUs += Test::TimeUs([&] {
+				for (int i = 0; i < n; ++i) {
+					p[i] += v[i];
+					if (std::fabs(p[i].x) > half)
+						v[i].x = -v[i].x;
+					if (std::fabs(p[i].y) > half)
+						v[i].y = -v[i].y;
+					if (std::fabs(p[i].z) > half)
+						v[i].z = -v[i].z;
+					bp.MoveSphere(ids[i], p[i], kRadius);
+				}
+			});
+			const double us = Test::TimeUs([&] { bp.Update(); });
+			minUs = (std::min)(minUs, us);
+			sumUs += us;
+			pairs += bp.PairCount();
+			entries += bp.LastEntries();
+			tests += bp.LastTests();
+		}
+
+		// 全部の組を見る（1 フレーム分）。組の数も合わせる
+		size_t brutePairs = 0;
+		const double bruteUs = Test::TimeUs([&] {
+			brutePairs = 0;
+			for (int i = 0; i < n; ++i) {
+				for (int j = i + 1; j < n; ++j) {
+					brutePairs += Overlap(bp.Box(ids[i]), bp.Box(ids[j])) ? 1 : 0;
+				}
+			}
+		});
+		std::printf("%6d %6.0f | %9.1f %9.1f %9.1f | %7zu %8zu %7zu | %11.0f%s\n", n, half * 2.0f, minUs, sumUs / kFrames, moveUs / kFrames, pairs / kFrames, entries / kFrames,
+		            tests / kFrames, bruteUs, brutePairs == bp.PairCount() ? "" : "  (pair count mismatch)");
+	}
+	return 0;
+}
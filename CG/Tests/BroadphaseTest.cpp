@@ -0,0 +1,174 @@
+// CG/Tests/BroadphaseTest.cpp
+// Broadphase：出入りの多い 1500 個の球で、毎フレームの始まった / 続いている / 終わった組が全部の組を見たときと一致するか
+// （category / mask、有効の切り替え、Destroy と Create の番号の使い回し、大きい箱も混ぜる）
+#include "TestCommon.h"
+#include "Broadphase.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+struct Ball {
+	Vector3 p, v;
+	float r = 0.0f;
+	Broadphase::ProxyId id = Broadphase::kInvalid;
+	uint32_t category = 1, mask = ~0u;
+	bool enabled = true;
+};
+
+bool Overlap(const AABB& a, const AABB& b) {
+	return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y && a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+uint64_t Key(uint32_t a, uint32_t b) { return a < b ? (uint64_t(a) << 32 | b) : (uint64_t(b) << 32 | a); }
+
+// 組の並びを集合に（a < b でないものが混ざっていたら失敗）
+std::set<uint64_t> ToSet(const std::vector<Broadphase::Pair>& pairs) {
+	std::set<uint64_t> out;
+	for (const Broadphase::Pair& p : pairs) {
+		TEST_CHECK(p.a < p.b);
+		out.insert(Key(p.a, p.b));
+	}
+	return out;
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(25);
+	std::uniform_real_distribution<float> u(-1.0f, 1.0f), u01(0.0f, 1.0f);
+	constexpr float kW = 40.0f;
+
+	// 1) 毎フレーム全部の組と比べる
+	{
+		Broadphase bp;
+		std::vector<Ball> balls;
+		auto spawn = [&] {
+			Ball b;
+			b.p = {u(rng) * kW, u(rng) * kW * 0.3f, u(rng) * kW};
+			b.v = Vector3{u(rng), u(rng) * 0.3f, u(rng)} * 0.4f;
+			// たまにセルを多くまたぐ大きい箱
+			b.r = rng() % 100 == 0 ? 8.0f : 0.3f + u01(rng) * 1.2f;
+			b.category = 1u << (rng() % 3);
+			b.mask = rng() % 4 == 0 ? ~b.category : ~0u;
+			b.id = bp.Create(AABB{b.p - Vector3{b.r, b.r, b.r}, b.p + Vector3{b.r, b.r, b.r}}, 0, b.category, b.mask);
+			balls.push_back(b);
+		};
+		for (int i = 0; i < 1500; ++i) {
+			spawn();
+		}
+
+		std::set<uint64_t> prev;
+		int mismatches = 0;
+		for (int frame = 0; frame < 300; ++frame) {
+			for (Ball& b : balls) {
+				b.p += b.v;
+				if (std::fabs(b.p.x) >= kW) {
+					b.p.x = std::clamp(b.p.x, -kW, kW);
+					b.v.x = -b.v.x;
+				}
+				if (std::fabs(b.p.z) >= kW) {
+					b.p.z = std::clamp(b.p.z, -kW, kW);
+					b.v.z = -b.v.z;
+				}
+				if (rng() % 500 == 0) {
+					b.p = {u(rng) * kW, u(rng) * kW * 0.3f, u(rng) * kW};
+				}
+				bp.MoveSphere(b.id, b.p, b.r);
+				if (rng() % 200 == 0) {
+					b.enabled = !b.enabled;
+					bp.SetEnabled(b.id, b.enabled);
+				}
+			}
+
+			// 50 フレームごとに 300 個まとめて入れ替え、ふだんは数個
+			const int churn = frame % 50 == 0 ? 300 : int(rng() % 10);
+			std::set<uint32_t> destroyed;
+			for (int k = 0; k < churn && !balls.empty(); ++k) {
+				const size_t i = rng() % balls.size();
+				bp.Destroy(balls[i].id);
+				destroyed.insert(balls[i].id);
+				balls[i] = balls.back();
+				balls.pop_back();
+			}
+			for (int k = 0; k < churn; ++k) {
+				spawn();
+			}
+			// Update の前に番号を使い回さない
+			for (const Ball& b : balls) {
+				TEST_CHECK(destroyed.count(b.id) == 0);
+			}
+
+			bp.Update();
+
+			std::set<uint64_t> cur;
+			for (size_t i = 0; i < balls.size(); ++i) {
+				for (size_t j = i + 1; j < balls.size(); ++j) {
+					const Ball& a = balls[i];
+					const Ball& b = balls[j];
+					if (!a.enabled || !b.enabled || !(a.category & b.mask) || !(b.category & a.mask))
+						continue;
+					if (Overlap(bp.Box(a.id), bp.Box(b.id))) {
+						cur.insert(Key(a.id, b.id));
+					}
+				}
+			}
+			std::set<uint64_t> begins, stays, ends;
+			for (uint64_t k : cur) {
+				(prev.count(k) ? stays : begins).insert(k);
+			}
+			for (uint64_t k : prev) {
+				if (!cur.count(k)) {
+					ends.insert(k);
+				}
+			}
+
+			// 同じ組が 2 回出ていないか（集合と個数の両方で見る）
+			const bool same = ToSet(bp.Begins()) == begins && ToSet(bp.Stays()) == stays && ToSet(bp.Ends()) == ends && bp.Begins().size() == begins.size() &&
+			                  bp.Stays().size() == stays.size() && bp.Ends().size() == ends.size() && bp.PairCount() == cur.size() && bp.ProxyCount() == balls.size();
+			if (!same) {
+				if (++mismatches <= 4) {
+					std::printf("  frame %d: begins %zu/%zu stays %zu/%zu ends %zu/%zu proxies %zu/%zu\n", frame, bp.Begins().size(), begins.size(), bp.Stays().size(),
+					            stays.size(), bp.Ends().size(), ends.size(), bp.ProxyCount(), balls.size());
+				}
+			}
+			prev.swap(cur);
+		}
+		TEST_CHECK(mismatches == 0);
+	}
+
+	// 2) 接しているだけの箱も組になる。セルの一辺を固定しても同じ
+	for (float cell : {0.0f, 0.25f, 4.0f}) {
+		Broadphase bp;
+		bp.SetCellSize(cell);
+		const Broadphase::ProxyId a = bp.Create(AABB{{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}});
+		const Broadphase::ProxyId b = bp.Create(AABB{{1.0f, 0.0f, 0.0f}, {2.0f, 1.0f, 1.0f}});
+		const Broadphase::ProxyId c = bp.Create(AABB{{2.5f, 0.0f, 0.0f}, {3.0f, 1.0f, 1.0f}});
+		bp.Update();
+		TEST_CHECK(bp.PairCount() == 1);
+		TEST_CHECK(bp.Begins().size() == 1 && bp.Begins()[0].a == a && bp.Begins()[0].b == b);
+
+		// 離すと終わった組に出る。もう一度 Update すると何も出ない
+		bp.Move(b, AABB{{1.2f, 0.0f, 0.0f}, {2.2f, 1.0f, 1.0f}});
+		bp.Update();
+		TEST_CHECK(bp.PairCount() == 0 && bp.Ends().size() == 1 && bp.Begins().empty());
+		bp.Update();
+		TEST_CHECK(bp.Begins().empty() && bp.Stays().empty() && bp.Ends().empty());
+
+		// Destroy した代理の組は次の Update で終わる
+		bp.Move(c, AABB{{2.0f, 0.0f, 0.0f}, {3.0f, 1.0f, 1.0f}});
+		bp.Update();
+		TEST_CHECK(bp.Begins().size() == 1);
+		bp.Destroy(c);
+		bp.Update();
+		TEST_CHECK(bp.Ends().size() == 1 && bp.PairCount() == 0 && bp.ProxyCount() == 2);
+	}
+
+	return Test::Result("BroadphaseTest");
+}
@@ -0,0 +1,97 @@
+// CG/Tests/CapsuleCollisionBench.cpp
+// カプセル 1 本 vs 集まり：まとめて判定（CapsuleSpheres / CapsuleCapsules / CapsuleAABBs）と 1 個ずつのループの比較（相手 1 個あたりの ns）
+#include "TestCommon.h"
+#include "Collision.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+int main() {
+	std::mt19937 rng(24);
+	std::uniform_real_distribution<float> uni(-1.0f, 1.0f), uni01(0.0f, 1.0f);
+	auto randomVec = [&](float s) { return Vector3{uni(rng) * s, uni(rng) * s, uni(rng) * s}; };
+	constexpr float kRadius = 0.55f; // 剣のカプセル
+
+	std::printf("%6s | %24s | %24s | %24s\n", "N", "sphere ns/target", "capsule ns/target", "aabb ns/target");
+	for (int n : {64, 1024, 16384}) {
+		// 1 辺 3 * cbrt(N) の立方体にばらまく（密度を N によらず揃える）
+		const float w = std::cbrt(float(n)) * 3.0f;
+		SphereSet spheres;
+		CapsuleSet capsules;
+		std::vector<Vector3> centers, c0, c1;
+		std::vector<float> radii;
+		std::vector<AABB> boxes;
+		for (int i = 0; i < n; ++i) {
+			const Vector3 c{uni(rng) * w, uni(rng) * w, uni(rng) * w};
+			const float R = 0.5f + uni01(rng);
+			spheres.Add(c, R);
+			centers.push_back(c);
+			radii.push_back(R);
+			const Vector3 q1 = c + randomVec(1.5f);
+			capsules.Add(c, q1, 0.4f);
+			c0.push_back(c);
+			c1.push_back(q1);
+			const Vector3 h{0.5f + uni01(rng), 0.5f + uni01(rng), 0.5f + uni01(rng)};
+			boxes.push_back({c - h, c + h});
+		}
+		AABBSet boxSet;
+		boxSet.Build(boxes);
+
+		const int queries = (std::max)(20, 2000000 / n);
+		std::vector<Vector3> q0(queries), q1(queries);
+		for (int q = 0; q < queries; ++q) {
+			q0[q] = {uni(rng) * w, uni(rng) * w, uni(rng) * w};
+			q1[q] = q0[q] + randomVec(1.5f);
+		}
+
+		std::vector<Collision::Contact> out;
+		out.reserve(4096);
+		auto nsPerTarget = [&](auto&& query) {
+			const double us = Test::TimeUs([&] {
+				for (int q = 0; q < queries; ++q) {
+					out.clear();
+					query(q);
+				}
+			});
+			return us * 1000.0 / (double(queries) * n);
+		};
+
+		const double sphereLoop = nsPerTarget([&](int q) {
+			for (int i = 0; i < n; ++i) {
+				Collision::Contact c;
+				if (Collision::CapsuleSphere(q0[q], q1[q], kRadius, centers[i], radii[i], c)) {
+					c.index = i;
+					out.push_back(c);
+				}
+			}
+		});
+		const double sphereBatch = nsPerTarget([&](int q) { Collision::CapsuleSpheres(q0[q], q1[q], kRadius, spheres, out); });
+		const double capsuleLoop = nsPerTarget([&](int q) {
+			for (int i = 0; i < n; ++i) {
+				Collision::Contact c;
+				if (Collision::CapsuleCapsule(q0[q], q1[q], kRadius, c0[i], c1[i], 0.4f, c)) {
+					c.index = i;
+					out.push_back(c);
+				}
+			}
+		});
+		const double capsuleBatch = nsPerTarget([&](int q) { Collision::CapsuleCapsules(q0[q], q1[q], kRadius, capsules, out); });
+		const double boxLoop = nsPerTarget([&](int q) {
+			for (int i = 0; i < n; ++i) {
+				Collision::Contact c;
+				if (Collision::CapsuleAABB(q0[q], q1[q], kRadius, boxes[i], c)) {
+					c.index = i;
+					out.push_back(c);
+				}
+			}
+		});
+		const double boxBatch = nsPerTarget([&](int q) { Collision::CapsuleAABBs(q0[q], q1[q], kRadius, boxSet, out); });
+
+		std::printf("%6d | %6.2f -> %5.2f (%5.1fx) | %6.2f -> %5.2f (%5.1fx) | %6.2f -> %5.2f (%5.1fx)\n", n, sphereLoop, sphereBatch, sphereLoop / sphereBatch, capsuleLoop, capsuleBatch,
+		            capsuleLoop / capsuleBatch, boxLoop, boxBatch, boxLoop / boxBatch);
+	}
+	return 0;
+}
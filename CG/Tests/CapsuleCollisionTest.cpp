@@ -0,0 +1,364 @@
+// CG/Tests/CapsuleCollisionTest.cpp
+// カプセルの判定：線分上の距離を黄金分割探索で倍精度に詰めた参照と、当たり / めり込み量 / 接触点 / 押し戻しが合うか
+// まとめて判定（CapsuleSpheres / CapsuleCapsules / CapsuleAABBs）が 1 個ずつの関数を番号順に呼んだ結果とビット単位で同じか
+#include "TestCommon.h"
+#include "Collision.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+struct D3 {
+	double x, y, z;
+};
+
+D3 ToD(const Vector3& v) { return {v.x, v.y, v.z}; }
+D3 Sub(const D3& a, const D3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+double DotD(const D3& a, const D3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+D3 LerpD(const D3& a, const D3& b, double t) { return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t}; }
+
+double DistPointSegment(const D3& p, const D3& a, const D3& b) {
+	const D3 d = Sub(b, a);
+	const double len2 = DotD(d, d);
+	const double t = len2 > 0.0 ? std::clamp(DotD(Sub(p, a), d) / len2, 0.0, 1.0) : 0.0;
+	const D3 e = Sub(p, LerpD(a, b, t));
+	return std::sqrt(DotD(e, e));
+}
+
+double DistPointBox(const D3& p, const AABB& b) {
+	const double dx = (std::max)({b.min.x - p.x, 0.0, p.x - b.max.x});
+	const double dy = (std::max)({b.min.y - p.y, 0.0, p.y - b.max.y});
+	const double dz = (std::max)({b.min.z - p.z, 0.0, p.z - b.max.z});
+	return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// 線分上の点 → 相手までの距離は t について凸なので、黄金分割探索（+ 両端）で最小値を詰める
+template <class F> double MinOverSegment(F f) {
+	const double g = 0.6180339887498949;
+	double lo = 0.0, hi = 1.0;
+	double x1 = hi - g * (hi - lo), x2 = lo + g * (hi - lo);
+	double f1 = f(x1), f2 = f(x2);
+	for (int i = 0; i < 120; ++i) {
+		if (f1 < f2) {
+			hi = x2;
+			x2 = x1;
+			f2 = f1;
+			x1 = hi - g * (hi - lo);
+			f1 = f(x1);
+		} else {
+			lo = x1;
+			x1 = x2;
+			f1 = f2;
+			x2 = lo + g * (hi - lo);
+			f2 = f(x2);
+		}
+	}
+	return (std::min)({f1, f2, f(0.0), f(1.0)});
+}
+
+double RefSegSeg(const D3& a0, const D3& a1, const D3& b0, const D3& b1) {
+	return MinOverSegment([&](double t) { return DistPointSegment(LerpD(a0, a1, t), b0, b1); });
+}
+
+double RefSegBox(const D3& a0, const D3& a1, const AABB& b) {
+	return MinOverSegment([&](double t) { return DistPointBox(LerpD(a0, a1, t), b); });
+}
+
+std::mt19937 rng(24);
+std::uniform_real_distribution<float> uni(-1.0f, 1.0f), uni01(0.0f, 1.0f);
+
+Vector3 RandomVec(float s) { return {uni(rng) * s, uni(rng) * s, uni(rng) * s}; }
+
+// ときどき座標を丸めて、軸に揃った / 同じ高さの組を作る
+Vector3 Snap(Vector3 v) {
+	switch (rng() % 8) {
+	case 0:
+		v.x = std::round(v.x);
+		break;
+	case 1:
+		v.y = std::round(v.y * 2.0f) * 0.5f;
+		break;
+	default:
+		break;
+	}
+	return v;
+}
+
+// 長さ 0 / 軸に平行 / 一般の向き、半径 0 も混ぜる
+void RandomCapsule(Vector3& p0, Vector3& p1, float& r) {
+	p0 = Snap(RandomVec(3.0f));
+	switch (rng() % 10) {
+	case 0:
+		p1 = p0;
+		break;
+	case 1:
+		p1 = p0;
+		p1.y += uni(rng) * 3.0f;
+		break;
+	case 2:
+		p1 = p0;
+		p1.x += uni(rng) * 3.0f;
+		break;
+	default:
+		p1 = Snap(p0 + RandomVec(2.0f));
+		break;
+	}
+	r = (rng() % 10 == 0) ? 0.0f : uni01(rng) * 1.2f;
+}
+
+bool IsUnit(const Vector3& n) { return std::fabs(Dot(n, n) - 1.0f) < 1e-4f; }
+
+bool SameContact(const Collision::Contact& a, const Collision::Contact& b) {
+	return a.index == b.index && std::memcmp(&a.point, &b.point, sizeof(Vector3)) == 0 && std::memcmp(&a.normal, &b.normal, sizeof(Vector3)) == 0 && a.depth == b.depth;
+}
+
+bool SameContacts(const std::vector<Collision::Contact>& a, const std::vector<Collision::Contact>& b) {
+	if (a.size() != b.size())
+		return false;
+	for (size_t i = 0; i < a.size(); ++i) {
+		if (!SameContact(a[i], b[i]))
+			return false;
+	}
+	return true;
+}
+
+} // namespace
+
+int main() {
+	// ちょうど接する境目の前後 kBand は丸めでどちらにも転ぶので見ない
+	constexpr double kBand = 2e-4;
+	constexpr int kTrials = 300000;
+
+	// 1) カプセル vs 球
+	{
+		int checked = 0, hits = 0, bad = 0;
+		for (int it = 0; it < kTrials; ++it) {
+			Vector3 p0, p1;
+			float r;
+			RandomCapsule(p0, p1, r);
+			Vector3 c = Snap(RandomVec(4.0f));
+			const float R = (rng() % 10 == 0) ? 0.0f : uni01(rng) * 1.5f;
+			if (rng() % 20 == 0) {
+				c = Lerp(p0, p1, uni01(rng)); // 中心が芯の上
+			}
+			const double dist = DistPointSegment(ToD(c), ToD(p0), ToD(p1));
+			const double sum = r + R;
+			if (std::fabs(dist - sum) < kBand)
+				continue;
+			++checked;
+			Collision::Contact ct;
+			const bool hit = Collision::CapsuleSphere(p0, p1, r, c, R, ct);
+			if (hit != (dist < sum)) {
+				++bad;
+				continue;
+			}
+			if (!hit)
+				continue;
+			++hits;
+			const D3 toPoint = Sub(ToD(ct.point), ToD(c));
+			const Vector3 push = ct.normal * (ct.depth + 1e-3f);
+			if (!IsUnit(ct.normal) || std::fabs(ct.depth - (sum - dist)) > 2e-4 || std::fabs(std::sqrt(DotD(toPoint, toPoint)) - R) > 2e-4 ||
+			    DistPointSegment(ToD(c), ToD(p0 + push), ToD(p1 + push)) < sum - 1e-4) {
+				++bad;
+			}
+		}
+		std::printf("  sphere: %d cases, %d hits\n", checked, hits);
+		TEST_CHECK(bad == 0);
+		TEST_CHECK(hits > checked / 20);
+	}
+
+	// 2) カプセル vs カプセル（平行 / 完全に重なる組も混ぜる）
+	{
+		int checked = 0, hits = 0, bad = 0;
+		for (int it = 0; it < kTrials; ++it) {
+			Vector3 a0, a1, b0, b1;
+			float ra, rb;
+			RandomCapsule(a0, a1, ra);
+			RandomCapsule(b0, b1, rb);
+			if (rng() % 15 == 0) {
+				const Vector3 off = RandomVec(0.5f);
+				b0 = a0 + off;
+				b1 = a1 + off;
+			}
+			if (rng() % 30 == 0) {
+				b0 = a0;
+				b1 = a1;
+			}
+			const double dist = RefSegSeg(ToD(a0), ToD(a1), ToD(b0), ToD(b1));
+			const double sum = ra + rb;
+			if (std::fabs(dist - sum) < kBand)
+				continue;
+			++checked;
+			Collision::Contact ct;
+			const bool hit = Collision::CapsuleCapsule(a0, a1, ra, b0, b1, rb, ct);
+			if (hit != (dist < sum)) {
+				++bad;
+				continue;
+			}
+			if (!hit)
+				continue;
+			++hits;
+			const Vector3 push = ct.normal * (ct.depth + 1e-3f);
+			if (!IsUnit(ct.normal) || std::fabs(ct.depth - (sum - dist)) > 3e-4 || std::fabs(DistPointSegment(ToD(ct.point), ToD(b0), ToD(b1)) - rb) > 3e-4 ||
+			    RefSegSeg(ToD(a0 + push), ToD(a1 + push), ToD(b0), ToD(b1)) < sum - 1e-4) {
+				++bad;
+			}
+		}
+		std::printf("  capsule: %d cases, %d hits\n", checked, hits);
+		TEST_CHECK(bad == 0);
+		TEST_CHECK(hits > checked / 20);
+	}
+
+	// 3) カプセル vs 箱（厚み 0 の箱、芯が箱の中を通るものも混ぜる。芯が刺さっているときはめり込み量の代わりに押し戻しで見る）
+	{
+		int checked = 0, hits = 0, deep = 0, bad = 0;
+		for (int it = 0; it < kTrials; ++it) {
+			Vector3 p0, p1;
+			float r;
+			RandomCapsule(p0, p1, r);
+			const Vector3 c = Snap(RandomVec(3.0f));
+			Vector3 h{uni01(rng) * 1.5f, uni01(rng) * 1.5f, uni01(rng) * 1.5f};
+			if (rng() % 10 == 0) {
+				h.y = 0.0f;
+			}
+			const AABB box{c - h, c + h};
+			if (rng() % 20 == 0) {
+				p0 = c + Vector3{h.x * uni(rng), h.y * uni(rng), h.z * uni(rng)} * 0.9f;
+				p1 = c + Vector3{h.x * uni(rng), h.y * uni(rng), h.z * uni(rng)} * 0.9f;
+			}
+			const double dist = RefSegBox(ToD(p0), ToD(p1), box);
+			if (std::fabs(dist - r) < kBand || (dist > 0.0 && dist < kBand))
+				continue;
+			++checked;
+			Collision::Contact ct;
+			const bool hit = Collision::CapsuleAABB(p0, p1, r, box, ct);
+			if (hit != (dist < r || dist == 0.0)) {
+				++bad;
+				continue;
+			}
+			if (!hit)
+				continue;
+			++hits;
+			if (dist == 0.0) {
+				++deep;
+			} else if (std::fabs(ct.depth - (r - dist)) > 3e-4) {
+				++bad;
+			}
+			const Vector3 push = ct.normal * (ct.depth + 1e-3f);
+			const double after = RefSegBox(ToD(p0 + push), ToD(p1 + push), box);
+			if (!IsUnit(ct.normal) || DistPointBox(ToD(ct.point), box) > 1e-4 || after < r - 1e-4 || after <= 0.0) {
+				++bad;
+			}
+		}
+		std::printf("  box: %d cases, %d hits (%d with the core inside)\n", checked, hits, deep);
+		TEST_CHECK(bad == 0);
+		TEST_CHECK(deep > 0);
+	}
+
+	// 4) まとめて判定 == 1 個ずつを番号順（0〜69 個、余りの枠を含む）
+	int batchMismatch = 0;
+	for (int it = 0; it < 3000; ++it) {
+		const int n = int(rng() % 70);
+		SphereSet spheres;
+		CapsuleSet capsules;
+		std::vector<AABB> boxes;
+		for (int i = 0; i < n; ++i) {
+			spheres.Add(RandomVec(4.0f), uni01(rng) * 1.2f);
+			Vector3 q0, q1;
+			float qr;
+			RandomCapsule(q0, q1, qr);
+			capsules.Add(q0, q1, qr);
+			const Vector3 c = RandomVec(4.0f), h{uni01(rng), uni01(rng), uni01(rng)};
+			boxes.push_back({c - h, c + h});
+		}
+		AABBSet boxSet;
+		boxSet.Build(boxes);
+		Vector3 p0, p1;
+		float r;
+		RandomCapsule(p0, p1, r);
+
+		std::vector<Collision::Contact> got, ref;
+		Collision::CapsuleSpheres(p0, p1, r, spheres, got);
+		for (int i = 0; i < n; ++i) {
+			Collision::Contact c;
+			if (Collision::CapsuleSphere(p0, p1, r, spheres.Center(i), spheres.Radius(i), c)) {
+				c.index = i;
+				ref.push_back(c);
+			}
+		}
+		batchMismatch += SameContacts(got, ref) ? 0 : 1;
+
+		got.clear();
+		ref.clear();
+		Collision::CapsuleCapsules(p0, p1, r, capsules, got);
+		for (int i = 0; i < n; ++i) {
+			Collision::Contact c;
+			if (Collision::CapsuleCapsule(p0, p1, r, capsules.P0(i), capsules.P1(i), capsules.Radius(i), c)) {
+				c.index = i;
+				ref.push_back(c);
+			}
+		}
+		batchMismatch += SameContacts(got, ref) ? 0 : 1;
+
+		got.clear();
+		ref.clear();
+		Collision::CapsuleAABBs(p0, p1, r, boxSet, got);
+		for (int i = 0; i < n; ++i) {
+			Collision::Contact c;
+			if (Collision::CapsuleAABB(p0, p1, r, boxes[i], c)) {
+				c.index = i;
+				ref.push_back(c);
+			}
+		}
+		batchMismatch += SameContacts(got, ref) ? 0 : 1;
+	}
+
+	// 5) 大まかな弾きの余裕：ちょうど接する距離の ±1e-5 に相手を並べても、まとめて判定が取りこぼさない
+	for (int it = 0; it < 20000; ++it) {
+		Vector3 p0, p1;
+		float r;
+		RandomCapsule(p0, p1, r);
+		SphereSet spheres;
+		CapsuleSet capsules;
+		for (int i = 0; i < 8; ++i) {
+			const Vector3 on = Lerp(p0, p1, uni01(rng));
+			const Vector3 dir = Normalize(RandomVec(1.0f));
+			const float R = uni01(rng);
+			const float eps = (uni01(rng) - 0.5f) * 1e-5f * (r + R + 1.0f);
+			const Vector3 q = on + dir * (r + R + eps);
+			spheres.Add(q, R);
+			const Vector3 perp = Cross(dir, Normalize(RandomVec(1.0f)));
+			capsules.Add(q - perp, q + perp, R);
+		}
+		std::vector<Collision::Contact> got, ref;
+		Collision::CapsuleSpheres(p0, p1, r, spheres, got);
+		for (int i = 0; i < 8; ++i) {
+			Collision::Contact c;
+			if (Collision::CapsuleSphere(p0, p1, r, spheres.Center(i), spheres.Radius(i), c)) {
+				c.index = i;
+				ref.push_back(c);
+			}
+		}
+		batchMismatch += SameContacts(got, ref) ? 0 : 1;
+
+		got.clear();
+		ref.clear();
+		Collision::CapsuleCapsules(p0, p1, r, capsules, got);
+		for (int i = 0; i < 8; ++i) {
+			Collision::Contact c;
+			if (Collision::CapsuleCapsule(p0, p1, r, capsules.P0(i), capsules.P1(i), capsules.Radius(i), c)) {
+				c.index = i;
+				ref.push_back(c);
+			}
+		}
+		batchMismatch += SameContacts(got, ref) ? 0 : 1;
+	}
+	TEST_CHECK(batchMismatch == 0);
+
+	return Test::Result("CapsuleCollisionTest");
+}
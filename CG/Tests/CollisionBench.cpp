@@ -0,0 +1,59 @@
+// CG/Tests/CollisionBench.cpp
+// Collision::NearestHit（AABBSet を SSE で 8 個ずつ）と、箱を 1 個ずつ IntersectRayAABBExpanded で見る従来のループの比較
+#include "TestCommon.h"
+#include "Collision.h"
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+int main() {
+	std::mt19937 rng(5);
+	std::uniform_real_distribution<float> pos(-20.0f, 20.0f), dirDist(-1.0f, 1.0f);
+	constexpr int kRays = 20000;
+	constexpr float kExpand = 0.5f;
+
+	std::printf("%6s %14s %14s %8s\n", "boxes", "scalar ns/ray", "SoA ns/ray", "speedup");
+	for (size_t n : {64, 256, 1024, 4096}) {
+		// 地面に並んだ 1m の箱（Stage の壁と同じ大きさ）と、水平なレイ
+		std::vector<AABB> boxes(n);
+		for (AABB& b : boxes) {
+			const Vector3 c{pos(rng), 0.0f, pos(rng)};
+			b.min = {c.x - 0.5f, c.y - 0.5f, c.z - 0.5f};
+			b.max = {c.x + 0.5f, c.y + 0.5f, c.z + 0.5f};
+		}
+		AABBSet set;
+		set.Build(boxes);
+		std::vector<Vector3> origins(kRays), dirs(kRays);
+		for (int q = 0; q < kRays; ++q) {
+			origins[q] = {pos(rng), 0.0f, pos(rng)};
+			dirs[q] = Normalize(Vector3{dirDist(rng), 0.0f, dirDist(rng)});
+		}
+
+		volatile float sink = 0.0f;
+		const double usScalar = Test::TimeUs([&] {
+			for (int q = 0; q < kRays; ++q) {
+				float best = 1e9f;
+				for (const AABB& b : boxes) {
+					float t;
+					Vector3 nrm;
+					if (Collision::IntersectRayAABBExpanded(origins[q], dirs[q], b, kExpand, t, nrm) && t > 1e-4f && t < best) {
+						best = t;
+					}
+				}
+				sink = sink + best;
+			}
+		});
+		const double usSoA = Test::TimeUs([&] {
+			for (int q = 0; q < kRays; ++q) {
+				Collision::RayHit hit;
+				if (Collision::NearestHit(origins[q], dirs[q], set, hit, kExpand)) {
+					sink = sink + hit.t;
+				}
+			}
+		});
+		const double a = usScalar * 1000.0 / kRays, b = usSoA * 1000.0 / kRays;
+		std::printf("%6zu %14.0f %14.0f %7.1fx\n", n, a, b, a / b);
+	}
+	return 0;
+}
@@ -0,0 +1,152 @@
+// CG/Tests/CollisionTest.cpp
+// Collision：AABBSet のまとめて判定（IntersectRayAABBx8 / NearestHit）が 1 個ずつの IntersectRayAABBExpanded と一致するか
+#include "TestCommon.h"
+#include "Collision.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+bool SameNormal(const Vector3& a, const Vector3& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(5);
+	std::uniform_real_distribution<float> pos(-20.0f, 20.0f), half(0.2f, 3.0f), dirDist(-1.0f, 1.0f);
+
+	// ランダムな箱の集まり × ランダムなレイ
+	//  - 箱は重なりあり、1/8 は別の箱の角に中心を置く（面や辺がちょうど重なる）
+	//  - レイは軸に平行（成分 0）も混ぜる。expand 0 / 0.5、skipIndex あり / なし
+	int x8Mismatch = 0, nearestMismatch = 0, ties = 0;
+	long queries = 0, hits = 0;
+	double maxRelDt = 0.0;
+	for (int trial = 0; trial < 400; ++trial) {
+		const size_t n = 1 + rng() % 300;
+		std::vector<AABB> boxes(n);
+		for (AABB& b : boxes) {
+			Vector3 c{pos(rng), pos(rng) * 0.2f, pos(rng)};
+			if (rng() % 8 == 0) {
+				c = boxes[rng() % n].min;
+			}
+			const Vector3 h{half(rng), half(rng), half(rng)};
+			b.min = {c.x - h.x, c.y - h.y, c.z - h.z};
+			b.max = {c.x + h.x, c.y + h.y, c.z + h.z};
+		}
+		AABBSet set;
+		set.Build(boxes);
+		TEST_CHECK(set.PaddedSize() % 8 == 0 && set.PaddedSize() >= n);
+
+		for (int q = 0; q < 200; ++q) {
+			const Vector3 o{pos(rng), pos(rng) * 0.2f, pos(rng)};
+			Vector3 d{dirDist(rng), dirDist(rng) * 0.3f, dirDist(rng)};
+			switch (rng() % 6) {
+			case 0:
+				d.y = 0.0f;
+				break;
+			case 1:
+				d.x = 0.0f;
+				break;
+			case 2:
+				d.y = d.z = 0.0f;
+				break;
+			default:
+				break;
+			}
+			if (std::fabs(d.x) + std::fabs(d.y) + std::fabs(d.z) < 1e-3f) {
+				d.x = 1.0f;
+			}
+			const float expand = (q & 1) ? 0.5f : 0.0f;
+			const int skip = (q % 5 == 0) ? int(rng() % n) : -1;
+
+			// 8 個ずつ：当たりのビットと t / 法線が 1 個ずつと一致（余りの枠は当たらない）
+			for (size_t first = 0; first < set.PaddedSize(); first += 8) {
+				float t8[8];
+				Vector3 n8[8];
+				const uint32_t mask = Collision::IntersectRayAABBx8(o, d, set, first, expand, t8, n8);
+				for (int lane = 0; lane < 8; ++lane) {
+					const size_t i = first + lane;
+					float t = 0.0f;
+					Vector3 nrm{};
+					const bool ref = i < n && Collision::IntersectRayAABBExpanded(o, d, boxes[i], expand, t, nrm);
+					const bool got = (mask >> lane) & 1;
+					if (got != ref) {
+						++x8Mismatch;
+					} else if (got && (std::fabs(t8[lane] - t) > 1e-4f * (std::max)(1.0f, std::fabs(t)) || !SameNormal(n8[lane], nrm))) {
+						++x8Mismatch;
+					}
+				}
+			}
+
+			// いちばん近い箱：1 個ずつ全部見たものと一致（同じ t の箱が並ぶときは番号 / 法線の違いを許す）
+			constexpr float kTMin = 1e-4f, kTMax = 1e9f;
+			float bestT = kTMax;
+			int bestI = -1;
+			Vector3 bestN{};
+			for (size_t i = 0; i < n; ++i) {
+				float t;
+				Vector3 nrm;
+				if (int(i) != skip && Collision::IntersectRayAABBExpanded(o, d, boxes[i], expand, t, nrm) && t > kTMin && t < bestT) {
+					bestT = t;
+					bestI = int(i);
+					bestN = nrm;
+				}
+			}
+			Collision::RayHit hit;
+			const bool got = Collision::NearestHit(o, d, set, hit, expand, kTMin, kTMax, skip);
+			++queries;
+			if (got != (bestI >= 0)) {
+				// tMin ちょうどの境目だけは丸めでどちらにも転ぶ
+				const float edgeT = got ? hit.t : bestT;
+				if (std::fabs(edgeT - kTMin) >= kTMin) {
+					++nearestMismatch;
+				}
+				continue;
+			}
+			if (!got)
+				continue;
+			++hits;
+			const double relDt = std::fabs(hit.t - bestT) / (std::max)(1.0f, std::fabs(bestT));
+			maxRelDt = (std::max)(maxRelDt, relDt);
+			if (hit.index != bestI || !SameNormal(hit.normal, bestN)) {
+				if (relDt < 1e-5) {
+					++ties;
+				} else {
+					++nearestMismatch;
+				}
+			}
+			if (hit.index == skip) {
+				++nearestMismatch;
+			}
+		}
+	}
+	std::printf("  queries %ld hits %ld ties %d max rel dt %.2e\n", queries, hits, ties, maxRelDt);
+	TEST_CHECK(x8Mismatch == 0);
+	TEST_CHECK(nearestMismatch == 0);
+	TEST_CHECK(maxRelDt < 1e-4);
+	TEST_CHECK(hits > queries / 4);
+
+	// 線分として使う（tMax = 1）：箱の手前で止まる線分は当たらない
+	{
+		AABBSet set;
+		set.Build({AABB{{4.0f, -1.0f, -1.0f}, {6.0f, 1.0f, 1.0f}}});
+		Collision::RayHit hit;
+		TEST_CHECK(!Collision::NearestHit({0, 0, 0}, {3.0f, 0, 0}, set, hit, 0.0f, 1e-4f, 1.0f));
+		TEST_CHECK(Collision::NearestHit({0, 0, 0}, {5.0f, 0, 0}, set, hit, 0.0f, 1e-4f, 1.0f));
+		TEST_CHECK_NEAR(hit.t, 0.8, 1e-6);
+		TEST_CHECK(hit.index == 0 && hit.normal.x == -1.0f);
+		// expand 0.5 で手前の面が 3.5 に来る
+		TEST_CHECK(Collision::NearestHit({0, 0, 0}, {4.0f, 0, 0}, set, hit, 0.5f, 1e-4f, 1.0f));
+		TEST_CHECK_NEAR(hit.t, 0.875, 1e-6);
+		// 空の集まり
+		AABBSet empty;
+		empty.Build({});
+		TEST_CHECK(!Collision::NearestHit({0, 0, 0}, {1, 0, 0}, empty, hit));
+	}
+
+	return Test::Result("CollisionTest");
+}
@@ -0,0 +1,28 @@
+// CG/Tests/OceanFFTBench.cpp
+// OceanFFT::Update の 1 フレームの時間（解像度とスレッド数ごと）
+#include "TestCommon.h"
+#include "Water/OceanFFT.h"
+#include <algorithm>
+#include <thread>
+
+using namespace Engine;
+
+int main() {
+	const uint32_t hw = (std::max)(std::thread::hardware_concurrency(), 1u);
+	for (uint32_t n : {128u, 256u, 512u}) {
+		for (uint32_t threads : {1u, hw}) {
+			OceanFFT o;
+			OceanFFT::Desc d;
+			d.resolution = n;
+			d.threads = threads;
+			o.Initialize(d);
+			o.Update(0.0f);
+			float t = 0.0f;
+			const double us = Test::TimeUs([&] { o.Update(t += 0.016f); }, n >= 512 ? 10 : 40);
+			std::printf("n=%4u threads %2u: Update %.2f ms/frame\n", n, threads, us / 1000.0);
+			if (hw == 1)
+				break;
+		}
+	}
+	return 0;
+}
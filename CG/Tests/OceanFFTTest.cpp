@@ -0,0 +1,187 @@
+// CG/Tests/OceanFFTTest.cpp
+// OceanFFT：パーセバル（スペクトルと高さの分散）、タイルの繰り返し、横ずれで波頭が尖る向きか、スレッド数で結果が変わらないか
+#include "TestCommon.h"
+#include "Water/OceanFFT.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+namespace {
+
+double HeightVariance(const OceanFFT& o) {
+	double s = 0.0;
+	for (const XMFLOAT4& d : o.Displacement()) {
+		s += double(d.y) * d.y;
+	}
+	return s / double(o.Displacement().size());
+}
+
+} // namespace
+
+int main() {
+	// 1) パーセバル：毎フレーム Σ|h(k,t)|² = 高さの二乗平均。時間平均は ExpectedVariance、有義波高 4σ は指定どおり
+	for (OceanFFT::Spectrum spectrum : {OceanFFT::Spectrum::Phillips, OceanFFT::Spectrum::Jonswap}) {
+		OceanFFT o;
+		OceanFFT::Desc d;
+		d.resolution = 256;
+		d.spectrum = spectrum;
+		d.waveHeight = 1.2f;
+		TEST_CHECK(o.Initialize(d));
+		double worst = 0.0, mean = 0.0;
+		constexpr int kFrames = 200;
+		for (int f = 0; f < kFrames; ++f) {
+			o.Update(float(f) * 0.37f);
+			const double v = HeightVariance(o);
+			worst = (std::max)(worst, std::fabs(v - o.SpectrumEnergy()) / o.SpectrumEnergy());
+			mean += v / kFrames;
+		}
+		TEST_CHECK(worst < 1e-3);
+		TEST_CHECK_NEAR(mean / o.ExpectedVariance(), 1.0, 0.1);
+		TEST_CHECK_NEAR(4.0 * std::sqrt(mean), d.waveHeight, 0.1 * d.waveHeight);
+		std::printf("%s: Parseval max rel err %.2e, time-avg variance / expected %.3f, Hs %.3f m\n", spectrum == OceanFFT::Spectrum::Phillips ? "Phillips" : "JONSWAP ", worst,
+		            mean / o.ExpectedVariance(), 4.0 * std::sqrt(mean));
+	}
+
+	// 2) タイル：patchSize ずらしても同じ値、継ぎ目の段差は内側の隣どうしの差と同程度
+	{
+		OceanFFT o;
+		OceanFFT::Desc d;
+		d.resolution = 128;
+		TEST_CHECK(o.Initialize(d));
+		o.Update(12.0f);
+		const uint32_t n = o.Resolution();
+		const float L = o.PatchSize();
+		std::mt19937 rng(5);
+		std::uniform_real_distribution<float> pos(-300.0f, 300.0f);
+		double period = 0.0;
+		for (int i = 0; i < 10000; ++i) {
+			const float x = pos(rng), z = pos(rng);
+			const XMFLOAT3 a = o.DisplacementAt(x, z), b = o.DisplacementAt(x + L, z - 2.0f * L);
+			period = (std::max)({period, double(std::fabs(a.x - b.x)), double(std::fabs(a.y - b.y)), double(std::fabs(a.z - b.z))});
+		}
+		TEST_CHECK(period < 1e-3);
+
+		const auto& disp = o.Displacement();
+		double seam = 0.0, inner = 0.0;
+		for (uint32_t z = 0; z < n; ++z) {
+			seam = (std::max)(seam, double(std::fabs(disp[size_t(z) * n + n - 1].y - disp[size_t(z) * n].y)));
+			seam = (std::max)(seam, double(std::fabs(disp[size_t(n - 1) * n + z].y - disp[z].y)));
+			for (uint32_t x = 0; x + 1 < n; ++x) {
+				inner = (std::max)(inner, double(std::fabs(disp[size_t(z) * n + x + 1].y - disp[size_t(z) * n + x].y)));
+			}
+		}
+		TEST_CHECK(seam <= inner * 1.5);
+
+		// 横ずれ後の面の高さ：ずらした点で聞くと元の高さ
+		double inversion = 0.0;
+		for (int i = 0; i < 2000; ++i) {
+			const float x = pos(rng), z = pos(rng);
+			const XMFLOAT3 dd = o.DisplacementAt(x, z);
+			inversion = (std::max)(inversion, double(std::fabs(o.HeightAt(x + dd.x, z + dd.z) - dd.y)));
+		}
+		TEST_CHECK(inversion < 0.05);
+		std::printf("tiling: period mismatch %.2e, seam step %.3f vs inside %.3f, HeightAt inversion %.3f m\n", period, seam, inner, inversion);
+	}
+
+	// 3) 波頭が尖る向き：横ずれは山へ寄る（Σ h div D < 0）、ヤコビアンは山で 1 未満・谷で 1 超え
+	{
+		OceanFFT o;
+		OceanFFT::Desc d;
+		d.resolution = 128;
+		d.patchSize = 100.0f;
+		d.waveHeight = 2.0f;
+		d.choppiness = 1.0f;
+		TEST_CHECK(o.Initialize(d));
+		o.Update(5.0f);
+		const uint32_t n = o.Resolution();
+		const float cell = o.PatchSize() / float(n);
+		const auto& disp = o.Displacement();
+		const auto& nrm = o.Normals();
+		const double sigma = std::sqrt(HeightVariance(o));
+		const auto at = [&](uint32_t x, uint32_t z) -> const XMFLOAT4& { return disp[size_t(z & (n - 1)) * n + (x & (n - 1))]; };
+
+		double hDiv = 0.0, crestJ = 0.0, troughJ = 0.0, divErr = 0.0;
+		int crests = 0, troughs = 0;
+		for (uint32_t z = 0; z < n; ++z) {
+			for (uint32_t x = 0; x < n; ++x) {
+				const float h = at(x, z).y;
+				const double div = (at(x + 1, z).x - at(x - 1, z).x + at(x, z + 1).z - at(x, z - 1).z) / (2.0 * cell);
+				hDiv += h * div;
+				const float J = nrm[size_t(z) * n + x].w;
+				if (h > 1.5 * sigma) {
+					crestJ += J;
+					++crests;
+				} else if (h < -1.5 * sigma) {
+					troughJ += J;
+					++troughs;
+				}
+				// 1 次の項：J ≈ 1 + div D（差分と解析の向きがそろっている）
+				divErr += std::fabs((J - 1.0) - div);
+			}
+		}
+		crestJ /= (std::max)(crests, 1);
+		troughJ /= (std::max)(troughs, 1);
+		divErr /= double(n) * n;
+		TEST_CHECK(hDiv < 0.0);
+		TEST_CHECK(crests > 0 && crestJ < 1.0);
+		TEST_CHECK(troughs > 0 && troughJ > 1.0);
+		std::printf("crests: sum h div D %.1f, mean J at crests %.3f (%d), at troughs %.3f (%d), mean |J - 1 - div D| %.3f\n", hDiv, crestJ, crests, troughJ, troughs, divErr);
+
+		// 横ずれなしならヤコビアンはどこでも 1
+		OceanFFT flat;
+		d.choppiness = 0.0f;
+		TEST_CHECK(flat.Initialize(d));
+		flat.Update(5.0f);
+		bool allOne = true;
+		for (const XMFLOAT4& v : flat.Normals()) {
+			allOne = allOne && v.w == 1.0f;
+		}
+		TEST_CHECK(allOne);
+	}
+
+	// 4) スレッド数で結果が変わらない（ワーカーは使い回し、何フレーム回しても同じ）
+	{
+		OceanFFT one, many;
+		OceanFFT::Desc d;
+		d.resolution = 256;
+		d.threads = 1;
+		TEST_CHECK(one.Initialize(d));
+		d.threads = 4;
+		TEST_CHECK(many.Initialize(d));
+		bool same = true;
+		for (int f = 0; f < 20; ++f) {
+			one.Update(float(f) * 0.016f);
+			many.Update(float(f) * 0.016f);
+			for (size_t i = 0; i < one.Displacement().size(); ++i) {
+				const XMFLOAT4 &a = one.Displacement()[i], &b = many.Displacement()[i];
+				const XMFLOAT4 &na = one.Normals()[i], &nb = many.Normals()[i];
+				same = same && a.x == b.x && a.y == b.y && a.z == b.z && na.x == nb.x && na.y == nb.y && na.z == nb.z && na.w == nb.w;
+			}
+		}
+		TEST_CHECK(same);
+
+		// 作り直し・ムーブしても動く
+		many = OceanFFT{};
+		TEST_CHECK(!many.IsValid());
+		TEST_CHECK(many.Initialize(d));
+		many.Update(1.0f);
+		TEST_CHECK(many.MaxHeight() > 0.0f);
+	}
+
+	// 5) 解像度の範囲外は false
+	{
+		OceanFFT o;
+		OceanFFT::Desc d;
+		d.resolution = 100;
+		TEST_CHECK(!o.Initialize(d));
+		d.resolution = 8;
+		TEST_CHECK(!o.Initialize(d));
+		TEST_CHECK(!o.IsValid());
+	}
+
+	return Test::Result("OceanFFTTest");
+}
@@ -0,0 +1,157 @@
+// CG/Tests/ParticleBufferBench.cpp
+// ParticleBuffer の Update：旧実装（AoS + active 分岐で全スロットを見る）との比較
+// EmitN：Burst 1 回ぶんの確保（旧実装の空きの線形探索との比較、満杯時の扱いごと）
+// PackInstances：インスタンスバッファへ詰める時間と大きさ（旧 1 粒 1 ドローの 256B 定数バッファ枠との比較）
+#include "TestCommon.h"
+#include "ParticleBuffer.h"
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+// 旧実装（空きスロットも毎フレーム見る）
+struct OldParticle {
+	Vector3 pos, vel, scale;
+	Vector4 color;
+	float life = 1.0f, age = 0.0f;
+	bool active = false;
+};
+
+struct OldSystem {
+	std::vector<OldParticle> ps;
+	size_t hint = 0; // 空き探索を O(n) にしない（Update だけ比べたいので）
+
+	void Emit(const Vector3& pos, const Vector3& vel, const Vector3& scale, const Vector4& color, float life) {
+		for (size_t k = 0; k < ps.size(); ++k) {
+			const size_t i = (hint + k) % ps.size();
+			OldParticle& p = ps[i];
+			if (!p.active) {
+				p = OldParticle{pos, vel, scale, color, life, 0.0f, true};
+				hint = i + 1;
+				return;
+			}
+		}
+	}
+	void Update(float dt) {
+		for (OldParticle& p : ps) {
+			if (!p.active)
+				continue;
+			p.age += dt;
+			if (p.age >= p.life) {
+				p.active = false;
+				continue;
+			}
+			p.pos.x += p.vel.x * dt;
+			p.pos.y += p.vel.y * dt;
+			p.pos.z += p.vel.z * dt;
+			p.color.w = 1.0f - p.age / p.life;
+		}
+	}
+	size_t Alive() const {
+		size_t n = 0;
+		for (const OldParticle& p : ps) {
+			n += p.active;
+		}
+		return n;
+	}
+};
+
+} // namespace
+
+int main() {
+	// 容量 N、生存率 alive を保つように毎フレーム死んだ分を補充（寿命 0.5..2 s）
+	std::printf("%9s %6s | %10s %10s | %7s\n", "capacity", "alive", "old ms", "SoA ms", "speedup");
+	for (size_t n : {size_t(10000), size_t(100000), size_t(1000000)}) {
+		for (float alive : {1.0f, 0.25f}) {
+			std::mt19937 rng(7);
+			std::uniform_real_distribution<float> u(-1.0f, 1.0f), lifeDist(0.5f, 2.0f);
+			OldSystem old;
+			old.ps.resize(n);
+			ParticleBuffer buf;
+			buf.Initialize(n);
+			const size_t target = size_t(double(n) * alive);
+			auto refill = [&](auto&& emit, size_t have) {
+				for (size_t k = have; k < target; ++k) {
+					emit(Vector3{u(rng), u(rng), u(rng)}, Vector3{u(rng), u(rng), u(rng)}, Vector3{0.1f, 0.1f, 0.1f}, Vector4{1.0f, 0.5f, 0.2f, 1.0f}, lifeDist(rng));
+				}
+			};
+			auto emitOld = [&](const Vector3& p, const Vector3& v, const Vector3& s, const Vector4& c, float l) { old.Emit(p, v, s, c, l); };
+			auto emitNew = [&](const Vector3& p, const Vector3& v, const Vector3& s, const Vector4& c, float l) { buf.Emit(p, v, s, c, l); };
+			refill(emitOld, 0);
+			refill(emitNew, 0);
+
+			const int frames = n >= 1000000 ? 30 : 200;
+			double oldUs = 0.0, newUs = 0.0;
+			for (int f = 0; f < frames; ++f) {
+				oldUs += Test::TimeUs([&] { old.Update(1.0f / 60.0f); });
+				newUs += Test::TimeUs([&] { buf.Update(1.0f / 60.0f); });
+				refill(emitOld, old.Alive());
+				refill(emitNew, buf.Count());
+			}
+			std::printf("%9zu %5.0f%% | %10.3f %10.3f | %6.1fx\n", n, alive * 100.0f, oldUs / frames / 1000.0, newUs / frames / 1000.0, oldUs / newUs);
+		}
+	}
+	// 散らばった空きの線形探索（旧）と EmitN（Burst 512 粒）
+	std::printf("\n%6s %5s | %12s %12s %12s %12s\n", "pool", "fill", "old linear", "EmitN drop", "EmitN recyc", "EmitN grow");
+	for (size_t n : {size_t(6000), size_t(100000)}) {
+		for (float fill : {0.5f, 0.9f, 0.99f, 1.0f}) {
+			std::mt19937 rng(3);
+			constexpr size_t kBurst = 512;
+			const int reps = n > 50000 ? 20 : 200;
+			double oldUs = 0.0, policyUs[3] = {};
+			for (int r = 0; r < reps; ++r) {
+				std::vector<OldParticle> ps(n);
+				for (OldParticle& p : ps) {
+					p.active = double(rng() % 10000) < fill * 10000.0;
+				}
+				if (fill >= 1.0f) {
+					ps.back().active = false; // 旧実装は満杯だと何もできないので最後の 1 つだけ空ける
+				}
+				oldUs += Test::TimeUs([&] {
+					for (size_t k = 0; k < kBurst; ++k) {
+						for (OldParticle& p : ps) {
+							if (!p.active) {
+								p.active = true;
+								break;
+							}
+						}
+					}
+				});
+
+				for (int policy = 0; policy < 3; ++policy) {
+					ParticleBuffer buf;
+					buf.Initialize(n);
+					buf.SetOverflow(ParticleOverflow(policy));
+					size_t granted = 0;
+					size_t first = buf.EmitN(size_t(double(n) * fill), granted);
+					for (size_t i = 0; i < granted; ++i) {
+						buf.Set(first + i, {}, {}, {}, {}, 0.5f + float(rng() % 1000) * 1e-3f);
+					}
+					buf.Update(0.01f * float(rng() % 10));
+					policyUs[policy] += Test::TimeUs([&] {
+						first = buf.EmitN(kBurst, granted);
+						for (size_t i = 0; i < granted; ++i) {
+							buf.Set(first + i, {1.0f, 2.0f, 3.0f}, {0.0f, 1.0f, 0.0f}, {0.1f, 0.1f, 0.1f}, {1.0f, 1.0f, 1.0f, 1.0f}, 1.0f);
+						}
+					});
+				}
+			}
+			std::printf("%6zu %4.0f%% | %9.1f us %9.1f us %9.1f us %9.1f us\n", n, fill * 100.0f, oldUs / reps, policyUs[0] / reps, policyUs[1] / reps, policyUs[2] / reps);
+		}
+	}
+	// インスタンスに詰める
+	std::printf("\n");
+	for (size_t n : {size_t(6000), size_t(100000), size_t(1000000)}) {
+		ParticleBuffer buf;
+		buf.Initialize(n);
+		for (size_t i = 0; i < n; ++i) {
+			buf.Emit({1.0f, 2.0f, 3.0f}, {}, {0.1f, 0.1f, 0.1f}, {1.0f, 0.5f, 0.2f, 1.0f}, 5.0f);
+		}
+		std::vector<ParticleInstance> out(n);
+		const double us = Test::TimeUs([&] { buf.PackInstances(out.data(), n); }, 20);
+		std::printf("pack %7zu: %.3f ms, %zu KB (vs %zu KB of 256B CB slots)\n", n, us / 1000.0, n * sizeof(ParticleInstance) / 1024, n * 256 / 1024);
+	}
+	return 0;
+}
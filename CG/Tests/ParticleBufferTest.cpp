@@ -0,0 +1,183 @@
+// CG/Tests/ParticleBufferTest.cpp
+// ParticleBuffer：1 粒ずつ素直に進める参照実装（旧 AoS + active フラグ）と生き残りと中身が一致するか
+#include "TestCommon.h"
+#include "ParticleBuffer.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+// 参照：旧実装と同じ 1 粒ずつの更新
+struct RefParticle {
+	Vector3 pos, vel;
+	float life, age;
+};
+
+void RefUpdate(std::map<int, RefParticle>& ps, float dt) {
+	for (auto it = ps.begin(); it != ps.end();) {
+		RefParticle& p = it->second;
+		p.age += dt;
+		if (p.age >= p.life) {
+			it = ps.erase(it);
+			continue;
+		}
+		p.pos.x += p.vel.x * dt;
+		p.pos.y += p.vel.y * dt;
+		p.pos.z += p.vel.z * dt;
+		++it;
+	}
+}
+
+} // namespace
+
+int main() {
+	// 1) 同じ入力を 300 フレーム：生きている粒の集合（scale.x を ID に使う）と位置 / アルファが一致
+	//    容量は 4 の倍数でない（端数の 4 粒組も通す）
+	{
+		constexpr size_t kCapacity = 3001;
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> u(-1.0f, 1.0f), lifeDist(0.1f, 1.0f);
+		ParticleBuffer buf;
+		buf.Initialize(kCapacity);
+		std::map<int, RefParticle> ref;
+		int nextId = 0, setMismatch = 0;
+		double maxErr = 0.0;
+		for (int f = 0; f < 300; ++f) {
+			const int n = int(rng() % 60);
+			for (int k = 0; k < n; ++k) {
+				const Vector3 p{u(rng), u(rng), u(rng)}, v{u(rng) * 5.0f, u(rng) * 5.0f, u(rng) * 5.0f};
+				const float life = lifeDist(rng);
+				const bool added = buf.Emit(p, v, Vector3{float(nextId), 0.0f, 0.0f}, Vector4{1.0f, 1.0f, 1.0f, 1.0f}, life);
+				if (added) {
+					ref[nextId] = RefParticle{p, v, life, 0.0f};
+				}
+				TEST_CHECK(added == (ref.size() <= kCapacity));
+				++nextId;
+			}
+			buf.Update(1.0f / 60.0f);
+			RefUpdate(ref, 1.0f / 60.0f);
+
+			setMismatch += buf.Count() != ref.size();
+			for (size_t i = 0; i < buf.Count(); ++i) {
+				const auto it = ref.find(int(buf.Scale(i).x));
+				if (it == ref.end()) {
+					++setMismatch;
+					continue;
+				}
+				const Vector3 p = buf.Position(i);
+				const RefParticle& r = it->second;
+				maxErr = (std::max)({maxErr, double(std::fabs(p.x - r.pos.x)), double(std::fabs(p.y - r.pos.y)), double(std::fabs(p.z - r.pos.z)),
+				                     double(std::fabs(buf.Color(i).w - (1.0f - r.age / r.life)))});
+			}
+		}
+		TEST_CHECK(setMismatch == 0);
+		TEST_CHECK(maxErr < 1e-5);
+		std::printf("300 frames vs reference: set mismatches %d, max |pos/alpha diff| %.2e\n", setMismatch, maxErr);
+	}
+
+	// 2) 一度に全部死ぬ・空で回す・Clear
+	{
+		ParticleBuffer buf;
+		buf.Initialize(10);
+		TEST_CHECK(buf.Capacity() == 10);
+		for (int i = 0; i < 10; ++i) {
+			TEST_CHECK(buf.Emit({}, {}, {}, {1.0f, 1.0f, 1.0f, 1.0f}, 0.5f));
+		}
+		TEST_CHECK(buf.Full());
+		TEST_CHECK(!buf.Emit({}, {}, {}, {}, 1.0f)); // 既定は Drop
+		buf.Update(0.25f);
+		TEST_CHECK(buf.Count() == 10);
+		buf.Update(0.25f);
+		TEST_CHECK(buf.Count() == 0);
+		buf.Update(0.25f);
+		TEST_CHECK(buf.Count() == 0);
+		buf.Emit({}, {}, {}, {}, 1.0f);
+		buf.Clear();
+		TEST_CHECK(buf.Count() == 0);
+	}
+
+	// 3) 満杯のときの EmitN：Drop は入る分だけ、RecycleOldest は age/life の大きい粒から消す、Grow は増やして既存はそのまま
+	{
+		size_t granted = 0;
+		ParticleBuffer recycle;
+		recycle.Initialize(10);
+		recycle.SetOverflow(ParticleOverflow::RecycleOldest);
+		for (int i = 0; i < 10; ++i) {
+			recycle.Emit({}, {}, {float(i), 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, 1.0f + float(i)); // 寿命の短い 0, 1, 2 ほど進んでいる
+		}
+		recycle.Update(0.5f);
+		const size_t first = recycle.EmitN(3, granted);
+		for (size_t i = 0; i < granted; ++i) {
+			recycle.Set(first + i, {}, {}, {100.0f + float(i), 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, 1.0f);
+		}
+		TEST_CHECK(granted == 3 && recycle.Count() == 10);
+		for (size_t i = 0; i < recycle.Count(); ++i) {
+			const float id = recycle.Scale(i).x;
+			TEST_CHECK(id != 0.0f && id != 1.0f && id != 2.0f);
+		}
+		// 容量より多く頼んでも容量まで
+		recycle.EmitN(25, granted);
+		TEST_CHECK(granted == 10 && recycle.Count() == 10);
+
+		ParticleBuffer drop;
+		drop.Initialize(10);
+		for (int i = 0; i < 8; ++i) {
+			drop.Emit({}, {}, {}, {}, 1.0f);
+		}
+		drop.EmitN(5, granted);
+		TEST_CHECK(granted == 2 && drop.Count() == 10);
+		drop.EmitN(5, granted);
+		TEST_CHECK(granted == 0);
+
+		ParticleBuffer grow;
+		grow.Initialize(10);
+		grow.SetOverflow(ParticleOverflow::Grow);
+		for (int i = 0; i < 10; ++i) {
+			grow.Emit({float(i), 0.0f, 0.0f}, {}, {float(i), 0.0f, 0.0f}, {}, 1.0f);
+		}
+		grow.EmitN(100, granted);
+		TEST_CHECK(granted == 100 && grow.Count() == 110 && grow.Capacity() >= 110);
+		bool kept = true;
+		for (int i = 0; i < 10; ++i) {
+			kept = kept && grow.Scale(i).x == float(i) && grow.Position(i).x == float(i);
+		}
+		TEST_CHECK(kept);
+	}
+
+	// 4) PackInstances：位置・大きさはそのまま、色は 0..1 に丸めて 8bit（R が最下位バイト）、maxCount で打ち切り
+	{
+		std::mt19937 rng(2);
+		std::uniform_real_distribution<float> u(-2.0f, 2.0f);
+		ParticleBuffer buf;
+		buf.Initialize(1000);
+		for (int i = 0; i < 1000; ++i) {
+			buf.Emit({u(rng), u(rng), u(rng)}, {u(rng), u(rng), u(rng)}, {0.1f + float(i) * 1e-3f, 0.2f, 0.3f}, {u(rng) * 0.5f + 0.5f, u(rng), 1.2f, 0.5f}, 1.0f + float(i) * 1e-3f);
+		}
+		buf.Update(0.3f);
+		std::vector<ParticleInstance> out(2000);
+		TEST_CHECK(buf.PackInstances(out.data(), out.size()) == buf.Count());
+		int bad = 0;
+		for (size_t i = 0; i < buf.Count(); ++i) {
+			const Vector3 p = buf.Position(i), sc = buf.Scale(i);
+			const Vector4 c = buf.Color(i);
+			const ParticleInstance& o = out[i];
+			bad += o.x != p.x || o.y != p.y || o.z != p.z || o.sizeX != sc.x || o.sizeY != sc.y;
+			const float ch[4] = {c.x, c.y, c.z, c.w};
+			for (int k = 0; k < 4; ++k) {
+				const uint32_t want = uint32_t(std::lround(std::clamp(ch[k], 0.0f, 1.0f) * 255.0f));
+				bad += ((o.color >> (8 * k)) & 0xFF) != want;
+			}
+		}
+		TEST_CHECK(bad == 0);
+		TEST_CHECK(buf.PackInstances(out.data(), 10) == 10);
+		buf.Clear();
+		TEST_CHECK(buf.PackInstances(out.data(), out.size()) == 0);
+	}
+
+	return Test::Result("ParticleBufferTest");
+}
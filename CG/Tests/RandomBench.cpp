@@ -0,0 +1,101 @@
+// CG/Tests/RandomBench.cpp
+// Random：std::mt19937 + uniform_real_distribution との比較（Burst 1 回ぶんの初期値、カメラシェイクの 6 個、1 個ずつ）
+#include "TestCommon.h"
+#include "Random.h"
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+int main() {
+	// Burst(512)：速度 / 大きさ / ジッタを Vector3、寿命を float で（ParticleEmitter と同じ取り方）
+	{
+		constexpr size_t kCount = 512;
+		const Vector3 vMin{-1.0f, 2.0f, -1.0f}, vMax{1.0f, 4.0f, 1.0f};
+		const Vector3 sMin{0.08f, 0.08f, 0.08f}, sMax{0.16f, 0.16f, 0.16f};
+		const Vector3 jMin{-0.2f, -0.2f, -0.2f}, jMax{0.2f, 0.2f, 0.2f};
+		std::vector<Vector3> vel(kCount), scale(kCount), jitter(kCount);
+		std::vector<float> life(kCount);
+
+		std::mt19937 mt(1);
+		auto rangeMt = [&](float lo, float hi) { return std::uniform_real_distribution<float>(lo, hi)(mt); };
+		auto rangeV3Mt = [&](const Vector3& lo, const Vector3& hi) { return Vector3{rangeMt(lo.x, hi.x), rangeMt(lo.y, hi.y), rangeMt(lo.z, hi.z)}; };
+		const double usMt = Test::TimeUs(
+		    [&] {
+			    for (size_t i = 0; i < kCount; ++i) {
+				    vel[i] = rangeV3Mt(vMin, vMax);
+				    scale[i] = rangeV3Mt(sMin, sMax);
+				    life[i] = rangeMt(0.8f, 1.6f);
+				    jitter[i] = rangeV3Mt(jMin, jMax);
+			    }
+		    },
+		    2000);
+
+		Random rng(1);
+		const double usSingle = Test::TimeUs(
+		    [&] {
+			    for (size_t i = 0; i < kCount; ++i) {
+				    vel[i] = rng.RangeV3(vMin, vMax);
+				    scale[i] = rng.RangeV3(sMin, sMax);
+				    life[i] = rng.Range(0.8f, 1.6f);
+				    jitter[i] = rng.RangeV3(jMin, jMax);
+			    }
+		    },
+		    2000);
+		const double usBulk = Test::TimeUs(
+		    [&] {
+			    rng.FillRangeV3(vel.data(), kCount, vMin, vMax);
+			    rng.FillRangeV3(scale.data(), kCount, sMin, sMax);
+			    rng.FillRange(life.data(), kCount, 0.8f, 1.6f);
+			    rng.FillRangeV3(jitter.data(), kCount, jMin, jMax);
+		    },
+		    2000);
+		std::printf("Burst(512) 初期値 (float 5120 個)\n");
+		std::printf("  mt19937          %8.2f us\n", usMt);
+		std::printf("  Random 1 個ずつ   %8.2f us (x%.1f)\n", usSingle, usMt / usSingle);
+		std::printf("  Random まとめて   %8.2f us (x%.1f)\n", usBulk, usMt / usBulk);
+	}
+
+	// カメラシェイク：1 フレーム 6 個
+	{
+		float n[6];
+		volatile float sink = 0.0f;
+		Random rng(3);
+		const double nsBulk = Test::TimeUs(
+		                          [&] {
+			                          rng.FillRange(n, 6, -1.0f, 1.0f);
+			                          sink = sink + n[5];
+		                          },
+		                          1000000) *
+		                      1000.0;
+		std::mt19937 mt(3);
+		std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+		const double nsMt = Test::TimeUs(
+		                        [&] {
+			                        for (float& x : n) {
+				                        x = u(mt);
+			                        }
+			                        sink = sink + n[5];
+		                        },
+		                        1000000) *
+		                    1000.0;
+		std::printf("カメラシェイク 6 個：Random %.1f ns, mt19937 %.1f ns\n", nsBulk, nsMt);
+	}
+
+	// 大きな配列（1M 個）の 1 個あたり
+	{
+		const size_t kN = size_t(1) << 20;
+		std::vector<float> v(kN);
+		Random rng(4);
+		const double usBulk = Test::TimeUs([&] { rng.FillRange(v.data(), kN, 0.0f, 1.0f); }, 20);
+		const double usSingle = Test::TimeUs(
+		    [&] {
+			    for (float& x : v) {
+				    x = rng.Float01();
+			    }
+		    },
+		    20);
+		std::printf("1M 個：まとめて %.2f ns/個、1 個ずつ %.2f ns/個\n", usBulk * 1000.0 / double(kN), usSingle * 1000.0 / double(kN));
+	}
+	return 0;
+}
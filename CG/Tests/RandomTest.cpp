@@ -0,0 +1,221 @@
+// CG/Tests/RandomTest.cpp
+// Random：xoshiro128+ 1 本ずつの参照実装との一致、まとめて取る API と 1 個ずつの並びの一致、分布の統計
+#include "TestCommon.h"
+#include "Random.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+uint64_t SplitMix64(uint64_t& x) {
+	uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+// 参照：xoshiro128+ 1 本（論文どおりの素直な形）
+struct RefXoshiro {
+	uint32_t s[4];
+	uint32_t Next() {
+		const uint32_t r = s[0] + s[3], t = s[1] << 9;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = (s[3] << 11) | (s[3] >> 21);
+		return r;
+	}
+};
+
+// 参照の並び：4 本を lane 0,1,2,3 の順に 1 個ずつ
+struct RefRandom {
+	RefXoshiro lane[4];
+	int k = 0;
+	explicit RefRandom(uint64_t seed) {
+		uint64_t x = seed;
+		for (RefXoshiro& l : lane) {
+			const uint64_t a = SplitMix64(x), b = SplitMix64(x);
+			l.s[0] = uint32_t(a);
+			l.s[1] = uint32_t(a >> 32);
+			l.s[2] = uint32_t(b);
+			l.s[3] = uint32_t(b >> 32);
+		}
+	}
+	uint32_t Next() { return lane[k++ & 3].Next(); }
+};
+
+// 256 区間の χ²（自由度 255。平均 255、標準偏差 22.6 なので 350 は 4σ 超）
+double ChiSquare(const std::vector<double>& hist, double expected) {
+	double chi = 0.0;
+	for (double c : hist) {
+		chi += (c - expected) * (c - expected) / expected;
+	}
+	return chi;
+}
+
+} // namespace
+
+int main() {
+	// 1) 参照実装と 1 個ずつの並びが一致、同じシードなら同じ並び
+	{
+		Random r(42), again(7);
+		again.Seed(42);
+		RefRandom ref(42);
+		int mismatch = 0;
+		for (int i = 0; i < 100000; ++i) {
+			const uint32_t v = r.NextU32();
+			if (v != ref.Next() || v != again.NextU32()) {
+				++mismatch;
+			}
+		}
+		TEST_CHECK(mismatch == 0);
+		TEST_CHECK(again.GetSeed() == 42);
+	}
+
+	// 2) まとめて取る API は 1 個ずつ取ったのと同じ並び（呼び出しの前後に 1 個ずつの呼び出しを挟んでも続きになる）
+	//    [0, 2^24) に広げると値が整数でちょうどになるので丸めの差なしで比べられる
+	{
+		const size_t sizes[] = {0, 1, 2, 3, 4, 5, 7, 8, 13, 1003};
+		const float kLo = 0.0f, kHi = 16777216.0f;
+		Random bulk(5), single(5);
+		int mismatch = 0;
+		for (int round = 0; round < 40; ++round) {
+			// 先に 0〜3 個 1 個ずつ取って残りの位置をずらす
+			for (int k = 0; k < round % 4; ++k) {
+				if (bulk.NextU32() != single.NextU32()) {
+					++mismatch;
+				}
+			}
+			const size_t n = sizes[round % 10];
+			std::vector<float> v(n + 1, -1.0f);
+			bulk.FillRange(v.data(), n, kLo, kHi);
+			for (size_t i = 0; i < n; ++i) {
+				if (v[i] != single.Range(kLo, kHi)) {
+					++mismatch;
+				}
+			}
+			TEST_CHECK(v[n] == -1.0f);
+
+			std::vector<Vector3> v3(n + 1, Vector3{-1.0f, -1.0f, -1.0f});
+			bulk.FillRangeV3(v3.data(), n, Vector3{kLo, kLo, kLo}, Vector3{kHi, kHi, kHi});
+			for (size_t i = 0; i < n; ++i) {
+				const Vector3 s = single.RangeV3(Vector3{kLo, kLo, kLo}, Vector3{kHi, kHi, kHi});
+				if (v3[i].x != s.x || v3[i].y != s.y || v3[i].z != s.z) {
+					++mismatch;
+				}
+			}
+			TEST_CHECK(v3[n].x == -1.0f);
+		}
+		TEST_CHECK(mismatch == 0);
+		TEST_CHECK(bulk.NextU32() == single.NextU32());
+	}
+
+	// 3) 一般の範囲でも 1 個ずつと一致（FMA を使わないビルドでは丸めも同じ）
+	{
+		Random a(7), b(7);
+		b.NextU32();
+		a.NextU32();
+		std::vector<float> v(1003);
+		a.FillRange(v.data(), v.size(), -2.0f, 3.0f);
+		double maxDiff = 0.0;
+		for (float x : v) {
+			maxDiff = (std::max)(maxDiff, double(std::fabs(x - b.Range(-2.0f, 3.0f))));
+		}
+		TEST_CHECK_NEAR(maxDiff, 0.0, 1e-6);
+	}
+
+	// 4) 範囲：[lo, hi)、hi < lo なら (hi, lo]。Vector3 は成分ごとの範囲
+	{
+		Random r(9);
+		std::vector<float> v(4099);
+		r.FillRange(v.data(), v.size(), 3.0f, -1.0f);
+		TEST_CHECK(*std::min_element(v.begin(), v.end()) > -1.0f);
+		TEST_CHECK(*std::max_element(v.begin(), v.end()) <= 3.0f);
+
+		const Vector3 lo{-1.0f, 2.0f, -3.0f}, hi{1.0f, 4.0f, -2.0f};
+		std::vector<Vector3> v3(4097);
+		r.FillRangeV3(v3.data(), v3.size(), lo, hi);
+		double sx = 0.0, sy = 0.0, sz = 0.0;
+		int outside = 0;
+		for (const Vector3& p : v3) {
+			if (p.x < lo.x || p.x >= hi.x || p.y < lo.y || p.y >= hi.y || p.z < lo.z || p.z >= hi.z) {
+				++outside;
+			}
+			sx += p.x;
+			sy += p.y;
+			sz += p.z;
+		}
+		TEST_CHECK(outside == 0);
+		const double n = double(v3.size());
+		TEST_CHECK_NEAR(sx / n, 0.0, 0.05);
+		TEST_CHECK_NEAR(sy / n, 3.0, 0.05);
+		TEST_CHECK_NEAR(sz / n, -2.5, 0.025);
+	}
+
+	// 5) [0, 1) の統計：平均 / 分散 / 隣どうしの相関 / 256 区間の χ² / 隣り合う 2 個の 16x16 の χ²
+	//    隣どうしは別の lane から来るので、lane の間の相関もここで見える
+	{
+		Random r(123);
+		const size_t kN = size_t(1) << 22;
+		std::vector<float> v(kN);
+		r.FillRange(v.data(), kN, 0.0f, 1.0f);
+
+		double mean = 0.0, sq = 0.0, lag = 0.0;
+		float mn = 1.0f, mx = 0.0f;
+		std::vector<double> hist(256, 0.0), pair(256, 0.0);
+		for (size_t i = 0; i < kN; ++i) {
+			const double u = v[i];
+			mean += u;
+			sq += u * u;
+			if (i > 0) {
+				lag += (u - 0.5) * (v[i - 1] - 0.5);
+			}
+			hist[int(u * 256.0)] += 1.0;
+			if (i % 2 == 1) {
+				pair[int(v[i - 1] * 16.0f) * 16 + int(v[i] * 16.0f)] += 1.0;
+			}
+			mn = (std::min)(mn, v[i]);
+			mx = (std::max)(mx, v[i]);
+		}
+		mean /= double(kN);
+		const double var = sq / double(kN) - mean * mean;
+		const double corr = lag / double(kN - 1) * 12.0;
+		const double chi = ChiSquare(hist, double(kN) / 256.0);
+		const double chiPair = ChiSquare(pair, double(kN / 2) / 256.0);
+		std::printf("  U01 N=%zu: mean %.6f var %.6f (1/12=%.6f) lag1 corr %.2e chi2 %.1f pair chi2 %.1f\n", kN, mean, var, 1.0 / 12.0, corr, chi, chiPair);
+
+		TEST_CHECK(mn >= 0.0f && mx < 1.0f);
+		TEST_CHECK_NEAR(mean, 0.5, 1e-3);
+		TEST_CHECK_NEAR(var, 1.0 / 12.0, 1e-3);
+		TEST_CHECK_NEAR(corr, 0.0, 3e-3);
+		TEST_CHECK(chi < 350.0);
+		TEST_CHECK(chiPair < 350.0);
+	}
+
+	// 6) lane ごとの並び（4 個おき）どうしの相関
+	{
+		Random r(77);
+		const size_t kN = size_t(1) << 20;
+		std::vector<float> v(kN * 4);
+		r.FillRange(v.data(), v.size(), -0.5f, 0.5f);
+		double maxCorr = 0.0;
+		for (int a = 0; a < 4; ++a) {
+			for (int b = a + 1; b < 4; ++b) {
+				double s = 0.0;
+				for (size_t i = 0; i < kN; ++i) {
+					s += double(v[i * 4 + a]) * v[i * 4 + b];
+				}
+				maxCorr = (std::max)(maxCorr, std::fabs(s / double(kN) * 12.0));
+			}
+		}
+		std::printf("  max |corr| between lanes %.2e\n", maxCorr);
+		TEST_CHECK(maxCorr < 5e-3);
+	}
+
+	return Test::Result("RandomTest");
+}
@@ -0,0 +1,300 @@
+// CG/Tests/StageGridTest.cpp
+// StageGrid：DDA のレイ / レーザー経路が、全部の箱を線形に見る判定（旧 Laser の予測線と同じ規則）と一致するか
+// Trace の経路の長さが TraceDesc::maxLength を超えないか
+#include "TestCommon.h"
+#include "StageGrid.h"
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+// Stage::Initialize と同じ並べ方（タイル 2m、隙間 0.02、中心合わせ。壁は 5 段、プリズム / リフトは 1 段）
+struct TestStage {
+	StageGrid grid;
+	std::vector<AABB> walls, prisms;
+	std::vector<float> angles;
+	std::vector<bool> wallEnabled;
+	std::vector<int> liftX, liftZ, liftWall;
+};
+
+// 外周が壁、中は dens が壁、1% ずつリフト（'3'）とプリズム（'2'）
+std::vector<std::string> RandomMap(int n, float dens, std::mt19937& rng) {
+	std::uniform_real_distribution<float> u(0.0f, 1.0f);
+	std::vector<std::string> rows(n, std::string(n, '0'));
+	for (int z = 0; z < n; ++z) {
+		for (int x = 0; x < n; ++x) {
+			if (z == 0 || x == 0 || z == n - 1 || x == n - 1) {
+				rows[z][x] = '1';
+				continue;
+			}
+			const float r = u(rng);
+			rows[z][x] = r < dens ? '1' : (r < dens + 0.01f ? '3' : (r < dens + 0.02f ? '2' : '0'));
+		}
+	}
+	return rows;
+}
+
+void BuildStage(const std::vector<std::string>& rows, TestStage& s, std::mt19937& rng) {
+	constexpr float kTile = 2.0f, kGap = 0.02f, kPitch = kTile + kGap, kE = 0.02f;
+	const int r = int(rows.size()), c = int(rows[0].size());
+	s.grid.Build(c, r, -c * 0.5f * kPitch, -r * 0.5f * kPitch, kPitch, kPitch);
+	for (int z = 0; z < r; ++z) {
+		for (int x = 0; x < c; ++x) {
+			const char cell = rows[z][x];
+			if (cell != '1' && cell != '2' && cell != '3') {
+				s.grid.SetCell(x, z, StageGrid::CellType::Floor);
+				continue;
+			}
+			const float cx = (x + 0.5f - c * 0.5f) * kPitch, cz = (z + 0.5f - r * 0.5f) * kPitch;
+			const float hx = (kTile - kGap) * 0.5f, hy = kTile * 0.5f, hz = hx;
+			const float angle = float(rng() % 8) * 45.0f;
+			AABB column{};
+			int index = -1;
+			for (int h = 0; h < (cell == '1' ? 5 : 1); ++h) {
+				const float cy = hy + h * kTile;
+				const AABB b{{cx - hx - kE, cy - hy - kE, cz - hz - kE}, {cx + hx + kE, cy + hy + kE, cz + hz + kE}};
+				int i;
+				if (cell == '2') {
+					i = int(s.prisms.size());
+					s.prisms.push_back(b);
+					s.angles.push_back(angle);
+				} else {
+					i = int(s.walls.size());
+					s.walls.push_back(b);
+				}
+				if (h == 0) {
+					column = b;
+					index = i;
+				} else {
+					column.max.y = b.max.y;
+				}
+			}
+			if (cell == '3') {
+				s.liftX.push_back(x);
+				s.liftZ.push_back(z);
+				s.liftWall.push_back(index);
+			}
+			const StageGrid::CellType type = cell == '1' ? StageGrid::CellType::Wall : (cell == '2' ? StageGrid::CellType::Prism : StageGrid::CellType::Lift);
+			s.grid.SetCell(x, z, type, column, index, angle);
+		}
+	}
+	s.wallEnabled.assign(s.walls.size(), true);
+}
+
+Vector3 Reflect(const Vector3& d, const Vector3& n) {
+	const float dot = d.x * n.x + d.y * n.y + d.z * n.z;
+	return Normalize(Vector3{d.x - 2.0f * dot * n.x, d.y - 2.0f * dot * n.y, d.z - 2.0f * dot * n.z});
+}
+
+// 参照：壁とプリズムを全部見るレーザーの予測線（旧 Laser の規則 + 長さの上限）
+void RefTrace(const TestStage& s, Vector3 pos, Vector3 dir, const StageGrid::TraceDesc& desc, std::vector<StageGrid::PathSegment>& out) {
+	out.clear();
+	dir = Normalize(dir);
+	float traveled = 0.0f;
+	int bounce = 0, lastPrism = -1;
+	while (bounce <= desc.maxBounces) {
+		const float xz = std::sqrt(dir.x * dir.x + dir.z * dir.z);
+		const float tLimit = xz > 1e-6f ? (desc.maxLength - traveled) / xz : 1e9f;
+		float best = tLimit;
+		Vector3 bestN{};
+		int prism = -1;
+		bool hit = false;
+		for (size_t i = 0; i < s.walls.size(); ++i) {
+			float t;
+			Vector3 n;
+			if (s.wallEnabled[i] && Collision::IntersectRayAABBExpanded(pos, dir, s.walls[i], desc.expand, t, n) && t > 1e-4f && t < best) {
+				best = t;
+				bestN = n;
+				hit = true;
+			}
+		}
+		for (size_t i = 0; i < s.prisms.size(); ++i) {
+			float t;
+			Vector3 n;
+			if (int(i) != lastPrism && Collision::IntersectRayAABBExpanded(pos, dir, s.prisms[i], desc.expand, t, n) && t > 1e-4f && t < best) {
+				best = t;
+				bestN = n;
+				hit = true;
+				prism = int(i);
+			}
+		}
+		const Vector3 end = hit ? pos + dir * best : pos + dir * (std::min)(desc.missLength, tLimit);
+		const Vector3 seg = end - pos;
+		const float len = std::sqrt(seg.x * seg.x + seg.z * seg.z);
+		if (len > 1e-4f) {
+			out.push_back({pos, end, false});
+		}
+		traveled += len;
+		if (!hit || traveled >= desc.maxLength)
+			break;
+		if (prism >= 0) {
+			const float rad = DirectX::XMConvertToRadians(s.angles[prism]);
+			dir = Normalize(Vector3{std::sin(rad), 0.0f, std::cos(rad)});
+			const AABB& p = s.prisms[prism];
+			const Vector3 center{(p.min.x + p.max.x) * 0.5f, (p.min.y + p.max.y) * 0.5f, (p.min.z + p.max.z) * 0.5f};
+			out.push_back({end, center, true});
+			pos = center + dir * desc.prismExit;
+			lastPrism = prism;
+			continue;
+		}
+		dir = Reflect(dir, bestN);
+		++bounce;
+		pos = end + dir * 0.001f;
+		lastPrism = -1;
+	}
+}
+
+float Diff(const Vector3& a, const Vector3& b) { return std::fabs(a.x - b.x) + std::fabs(a.y - b.y) + std::fabs(a.z - b.z); }
+
+// プリズムへ吸い込む区間を除いた XZ の長さの合計
+float PathLength(const std::vector<StageGrid::PathSegment>& path) {
+	float sum = 0.0f;
+	for (const StageGrid::PathSegment& p : path) {
+		if (!p.intoPrism) {
+			sum += std::sqrt((p.to.x - p.from.x) * (p.to.x - p.from.x) + (p.to.z - p.from.z) * (p.to.z - p.from.z));
+		}
+	}
+	return sum;
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(21);
+	std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+
+	for (int n : {25, 64, 128}) {
+		TestStage s;
+		BuildStage(RandomMap(n, 0.12f, rng), s, rng);
+		// リフト：1/3 は下げる、1/3 は当たりを消す
+		for (size_t k = 0; k < s.liftWall.size(); ++k) {
+			AABB& b = s.walls[s.liftWall[k]];
+			if (k % 3 == 0) {
+				b.min.y -= 1.5f;
+				b.max.y -= 1.5f;
+				s.grid.SetBox(s.liftX[k], s.liftZ[k], b);
+			} else if (k % 3 == 1) {
+				s.wallEnabled[s.liftWall[k]] = false;
+				s.grid.SetEnabled(s.liftX[k], s.liftZ[k], false);
+			}
+		}
+		const float half = n * 1.01f;
+
+		// 1) Raycast：いちばん近い箱の t / 法線 / 種類（プリズムなら番号も）
+		int rayMismatch = 0;
+		for (int q = 0; q < 1000; ++q) {
+			const Vector3 o{u(rng) * half, 1.0f, u(rng) * half};
+			const Vector3 d = Normalize(Vector3{u(rng), 0.0f, u(rng)});
+			const float expand = (q & 1) ? 0.5f : 0.0f;
+			const int skip = (q % 5 == 0 && !s.prisms.empty()) ? int(rng() % s.prisms.size()) : -1;
+			float best = 1e9f;
+			int bestI = -1;
+			bool bestPrism = false;
+			Vector3 bestN{};
+			for (size_t i = 0; i < s.walls.size(); ++i) {
+				float t;
+				Vector3 nrm;
+				if (s.wallEnabled[i] && Collision::IntersectRayAABBExpanded(o, d, s.walls[i], expand, t, nrm) && t > 1e-4f && t < best) {
+					best = t;
+					bestI = int(i);
+					bestPrism = false;
+					bestN = nrm;
+				}
+			}
+			for (size_t i = 0; i < s.prisms.size(); ++i) {
+				float t;
+				Vector3 nrm;
+				if (int(i) != skip && Collision::IntersectRayAABBExpanded(o, d, s.prisms[i], expand, t, nrm) && t > 1e-4f && t < best) {
+					best = t;
+					bestI = int(i);
+					bestPrism = true;
+					bestN = nrm;
+				}
+			}
+			StageGrid::Hit hit;
+			const bool got = s.grid.Raycast(o, d, hit, expand, 1e-4f, 1e9f, skip);
+			if (got != (bestI >= 0)) {
+				++rayMismatch;
+				continue;
+			}
+			if (!got)
+				continue;
+			const bool prism = hit.type == StageGrid::CellType::Prism;
+			if (std::fabs(hit.t - best) > 1e-4f || prism != bestPrism || (prism && hit.index != bestI) || hit.normal.x != bestN.x || hit.normal.z != bestN.z) {
+				++rayMismatch;
+			}
+		}
+		TEST_CHECK(rayMismatch == 0);
+
+		// 2) Trace：既定の長さ / 短い上限（区間の途中で切れる）の両方で参照と同じ経路、長さは上限以下
+		int traceMismatch = 0, tooLong = 0, clipped = 0;
+		for (int q = 0; q < 400; ++q) {
+			const Vector3 o{u(rng) * half * 0.9f, 1.0f, u(rng) * half * 0.9f};
+			const Vector3 d{u(rng), 0.0f, u(rng)};
+			StageGrid::TraceDesc desc;
+			if (q & 1) {
+				desc.maxLength = 2.0f + std::fabs(u(rng)) * 30.0f;
+				desc.maxBounces = 4;
+			}
+			std::vector<StageGrid::PathSegment> got, ref;
+			s.grid.Trace(o, d, desc, got);
+			RefTrace(s, o, d, desc, ref);
+			bool same = got.size() == ref.size();
+			for (size_t i = 0; same && i < got.size(); ++i) {
+				same = Diff(got[i].from, ref[i].from) < 1e-3f && Diff(got[i].to, ref[i].to) < 1e-3f && got[i].intoPrism == ref[i].intoPrism;
+			}
+			if (!same) {
+				++traceMismatch;
+			}
+			const float len = PathLength(got);
+			if (len > desc.maxLength * (1.0f + 1e-5f)) {
+				++tooLong;
+			}
+			if (len > desc.maxLength * 0.999f) {
+				++clipped;
+			}
+		}
+		TEST_CHECK(traceMismatch == 0);
+		TEST_CHECK(tooLong == 0);
+		TEST_CHECK(clipped > 0);
+	}
+
+	// 3) 長さの上限：壁まで 20m の通路で上限 5m → 1 区間 5m で終わる（前は壁まで伸びていた）
+	//    何にも当たらない向きでも missLength より上限が短ければ上限で切る
+	{
+		TestStage s;
+		BuildStage({"1111111111111", "1000000000001", "1111111111111"}, s, rng);
+		const Vector3 o{-10.0f, 1.0f, 0.0f};
+		StageGrid::TraceDesc desc;
+		desc.expand = 0.0f;
+		std::vector<StageGrid::PathSegment> path;
+		TEST_CHECK(s.grid.Trace(o, {1.0f, 0.0f, 0.0f}, desc, path) == 3); // 上限が長ければ反射の回数で終わる（3 本目の先の壁まで）
+		TEST_CHECK(path.size() == 3);
+		TEST_CHECK(PathLength(path) < desc.maxLength);
+
+		desc.maxLength = 5.0f;
+		TEST_CHECK(s.grid.Trace(o, {1.0f, 0.0f, 0.0f}, desc, path) == 0);
+		TEST_CHECK(path.size() == 1);
+		TEST_CHECK_NEAR(path[0].to.x, -5.0, 1e-4);
+
+		// 斜め下向き（XZ の長さで数える）
+		desc.maxLength = 3.0f;
+		s.grid.Trace(o, {1.0f, -1.0f, 0.0f}, desc, path);
+		TEST_CHECK(path.size() == 1);
+		TEST_CHECK_NEAR(PathLength(path), 3.0, 1e-4);
+
+		// 格子の外へ向かう（当たりなし）
+		desc.maxLength = 7.0f;
+		s.grid.Trace({-30.0f, 1.0f, 20.0f}, {-1.0f, 0.0f, 0.0f}, desc, path);
+		TEST_CHECK(path.size() == 1);
+		TEST_CHECK_NEAR(PathLength(path), 7.0, 1e-4);
+	}
+
+	return Test::Result("StageGridTest");
+}
@@ -0,0 +1,81 @@
+// CG/Tests/TerrainChunkStreamerTest.cpp
+// TerrainChunkStreamer：決まった道を歩かせて、メモリが予算内に収まるか / 足元のチャンクから正しく答えるか
+#include "TestCommon.h"
+#include "Terrain/TerrainChunkStreamer.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace Engine;
+
+namespace {
+
+// ベース地形は格子の外で平らなので、起伏のある関数で格子から引けているかを見る
+float Hills(float x, float z) { return 3.0f * std::sin(0.05f * x) * std::cos(0.04f * z); }
+
+} // namespace
+
+int main() {
+	TerrainChunkStreamer streamer;
+	TerrainChunkStreamer::Desc desc;
+	desc.memoryBudgetBytes = 2u * 1024 * 1024;
+	desc.ringRadius = 2;
+	desc.workerCount = 2;
+	streamer.Initialize(desc, Hills);
+
+	const int ring = 2 * desc.ringRadius + 1;
+	const size_t ringBytes = size_t(ring) * ring * streamer.ChunkBytes();
+	const size_t limit = (std::max)(desc.memoryBudgetBytes, ringBytes);
+
+	// 渦巻きに外へ（最後は原点から 1.8km ほど）
+	int overBudget = 0, missing = 0, ringMissing = 0;
+	double maxErr = 0.0, maxGradErr = 0.0;
+	for (int f = 0; f < 12000; ++f) {
+		const float a = f * 0.002f, r = f * 0.15f;
+		const float x = r * std::cos(a), z = r * std::sin(a);
+		streamer.Update(x, z);
+		overBudget += streamer.GetStats().bytes > limit;
+
+		// 50 フレームごとに生成を待ち、周囲が全部そろっているか・値が合っているかを見る
+		if (f % 50 != 0)
+			continue;
+		streamer.Flush();
+		const int cx = int(std::floor(x / streamer.ChunkSize())), cz = int(std::floor(z / streamer.ChunkSize()));
+		for (int dz = -desc.ringRadius; dz <= desc.ringRadius; ++dz) {
+			for (int dx = -desc.ringRadius; dx <= desc.ringRadius; ++dx) {
+				ringMissing += !streamer.IsResident(cx + dx, cz + dz);
+			}
+		}
+		float h;
+		if (!streamer.HeightAt(x, z, h)) {
+			++missing;
+			continue;
+		}
+		maxErr = (std::max)(maxErr, double(std::fabs(h - Hills(x, z))));
+
+		// 勾配は格子の差分（解析的な傾きとの差はセル 1 個ぶんの曲がり程度）
+		TerrainSample s;
+		TEST_CHECK(streamer.SampleAt(x, z, s));
+		const float gx = 0.15f * std::cos(0.05f * x) * std::cos(0.04f * z), gz = -0.12f * std::sin(0.05f * x) * std::sin(0.04f * z);
+		maxGradErr = (std::max)(maxGradErr, double((std::max)(std::fabs(s.dHdx - gx), std::fabs(s.dHdz - gz))));
+	}
+	streamer.Flush();
+
+	const TerrainChunkStreamer::Stats& st = streamer.GetStats();
+	TEST_CHECK(overBudget == 0);
+	TEST_CHECK(st.peakBytes <= limit);
+	TEST_CHECK(st.evicted > 0); // 予算を超える道のりなので捨てているはず
+	TEST_CHECK(missing == 0);
+	TEST_CHECK(ringMissing == 0);
+	TEST_CHECK(maxErr < 0.01); // 0.8m 格子の双線形補間の誤差
+	TEST_CHECK(maxGradErr < 0.01);
+	std::printf("resident %u, generated %u, evicted %u, peak %zu / %zu bytes, height err %.4f, gradient err %.4f\n", st.resident, st.generated, st.evicted, st.peakBytes, limit, maxErr, maxGradErr);
+
+	// 生成中に止めても固まらない
+	streamer.Update(1.0e4f, 1.0e4f);
+	streamer.Shutdown();
+	float h;
+	TEST_CHECK(!streamer.HeightAt(1.0e4f, 1.0e4f, h));
+	TEST_CHECK(streamer.GetStats().bytes == 0);
+
+	return Test::Result("TerrainChunkStreamerTest");
+}
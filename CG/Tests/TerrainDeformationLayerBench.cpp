@@ -0,0 +1,55 @@
+// CG/Tests/TerrainDeformationLayerBench.cpp
+// 長い戦闘の地形を保存 / 読み込みする時間：凹みの数によらず格子 1 枚ぶん
+#include "TestCommon.h"
+#include "Terrain/TerrainDeformationLayer.h"
+#include "Terrain/TerrainDentGrid.h"
+#include "Terrain/TerrainHeightField.h"
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+int main() {
+	constexpr uint32_t kGrid = 400;
+	constexpr float kCell = 0.8f;
+
+	for (int slams : {300, 3000, 30000}) {
+		std::mt19937 rng(6);
+		std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+		TerrainHeightField field;
+		field.Initialize(kGrid, kGrid, kCell);
+		TerrainDentGrid dents;
+		dents.Initialize(-160.0f, -160.0f, 4.0f, 80, 80);
+		const double replayUs = Test::TimeUs([&] {
+			for (int i = 0; i < slams; ++i) {
+				const auto r = dents.Add(TerrainDent{{pos(rng), pos(rng)}, 4.0f, 0.6f});
+				if (r.merged) {
+					field.UnstampDent(r.previous);
+				}
+				field.StampDent(dents.Dent(r.index));
+			}
+		});
+
+		TerrainDeformationLayer layer;
+		layer.Initialize(kGrid, kGrid, kCell);
+		std::vector<uint8_t> bytes;
+		const double saveUs = Test::TimeUs([&] {
+			layer.CaptureFrom(field);
+			layer.Encode(bytes);
+		}, 10);
+
+		// 読み込み = 展開 + ベースだけ焼いた高さキャッシュへ足す（Renderer::RebakeTerrainFromLayer の CPU 部分）
+		TerrainDeformationLayer loaded;
+		loaded.Initialize(kGrid, kGrid, kCell);
+		TerrainHeightField restored;
+		const double decodeUs = Test::TimeUs([&] { loaded.Decode(bytes.data(), bytes.size()); }, 10);
+		const double applyUs = Test::TimeUs([&] {
+			restored.Initialize(kGrid, kGrid, kCell);
+			loaded.ApplyTo(restored);
+		}, 10);
+
+		std::printf("%5d slams: replay %8.2f ms | capture+encode %.2f ms, %4zu KB | decode %.2f ms | rebake field %.2f ms\n", slams, replayUs / 1000.0, saveUs / 1000.0, bytes.size() / 1024,
+		            decodeUs / 1000.0, applyUs / 1000.0);
+	}
+	return 0;
+}
@@ -0,0 +1,148 @@
+// CG/Tests/TerrainDeformationLayerTest.cpp
+// TerrainDeformationLayer：保存 → 読み込みで地形が戻るか、壊れたデータを弾くか
+#include "TestCommon.h"
+#include "Terrain/TerrainDeformationLayer.h"
+#include "Terrain/TerrainDentGrid.h"
+#include "Terrain/TerrainHeightField.h"
+#include "Terrain/TerrainSampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+constexpr uint32_t kGrid = 400;
+constexpr float kCell = 0.8f;
+
+// Renderer::AddTerrainDent と同じ手順で凹みを入れる
+void Slam(TerrainDentGrid& dents, TerrainHeightField& field, const TerrainDent& d) {
+	const auto r = dents.Add(d);
+	if (r.merged) {
+		field.UnstampDent(r.previous);
+	}
+	field.StampDent(dents.Dent(r.index));
+}
+
+double MaxFieldDiff(const TerrainHeightField& a, const TerrainHeightField& b) {
+	double e = 0.0;
+	for (uint32_t iz = 0; iz < a.SamplesZ(); ++iz) {
+		for (uint32_t ix = 0; ix < a.SamplesX(); ++ix) {
+			e = (std::max)(e, double(std::fabs(a.Sample(ix, iz) - b.Sample(ix, iz))));
+		}
+	}
+	return e;
+}
+
+} // namespace
+
+int main() {
+	const float halfStep = 0.5f * TerrainDeformationLayer::kQuantStep;
+	std::mt19937 rng(5);
+	std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+
+	TerrainHeightField field;
+	field.Initialize(kGrid, kGrid, kCell);
+	TerrainDentGrid dents;
+	dents.Initialize(-160.0f, -160.0f, 4.0f, 80, 80);
+	for (int i = 0; i < 3000; ++i) {
+		Slam(dents, field, TerrainDent{{pos(rng), pos(rng)}, 4.0f, 0.6f});
+	}
+
+	// 1) 取り込み → バイト列 → 戻す：量子化した値がそのまま戻る
+	TerrainDeformationLayer layer;
+	layer.Initialize(kGrid, kGrid, kCell);
+	TEST_CHECK(layer.CaptureFrom(field));
+	TEST_CHECK(!layer.IsEmpty());
+	std::vector<uint8_t> bytes;
+	layer.Encode(bytes);
+	TEST_CHECK(bytes.size() < layer.Raw().size() * sizeof(int16_t));
+
+	TerrainDeformationLayer loaded;
+	loaded.Initialize(kGrid, kGrid, kCell);
+	TEST_CHECK(loaded.Decode(bytes.data(), bytes.size()));
+	TEST_CHECK(loaded.Raw() == layer.Raw());
+
+	// 2) ベースだけの高さキャッシュに足すと、元の地形と量子化の半刻み以内で一致
+	TerrainHeightField restored;
+	restored.Initialize(kGrid, kGrid, kCell);
+	loaded.ApplyTo(restored);
+	const double fieldErr = MaxFieldDiff(field, restored);
+	TEST_CHECK(fieldErr <= halfStep * 1.01);
+
+	// 格子点ではレイヤーだけのサンプル = 凹みからのサンプル
+	double sampleErr = 0.0;
+	for (int i = 0; i < 10000; ++i) {
+		const uint32_t ix = rng() % (kGrid + 1), iz = rng() % (kGrid + 1);
+		const float x = field.SampleX(ix), z = field.SampleZ(iz);
+		sampleErr = (std::max)(sampleErr, double(std::fabs(TerrainSampleAt(nullptr, x, z, &loaded).height - TerrainSampleAt(&dents, x, z).height)));
+	}
+	TEST_CHECK(sampleErr <= halfStep * 1.01);
+
+	// 3) シーンを出入りする流れ：戻した地形にさらに凹みを入れて取り直しても、全部の凹みを入れた地形と一致
+	for (int i = 0; i < 500; ++i) {
+		const TerrainDent d{{pos(rng), pos(rng)}, 3.0f, 0.4f};
+		Slam(dents, field, d);
+		restored.StampDent(d);
+	}
+	TerrainDeformationLayer second;
+	second.Initialize(kGrid, kGrid, kCell);
+	TEST_CHECK(second.CaptureFrom(restored));
+	std::vector<uint8_t> secondBytes;
+	second.Encode(secondBytes);
+	TerrainDeformationLayer reentered;
+	reentered.Initialize(kGrid, kGrid, kCell);
+	TEST_CHECK(reentered.Decode(secondBytes.data(), secondBytes.size()));
+	TerrainHeightField again;
+	again.Initialize(kGrid, kGrid, kCell);
+	reentered.ApplyTo(again);
+	// 量子化は 2 回（2 回目は 1 回目の量子化済みの値を含むので、誤差は半刻みの 2 倍まで）
+	TEST_CHECK(MaxFieldDiff(field, again) <= 2.0 * halfStep * 1.01);
+
+	// 4) ファイル経由
+	const std::string path = (std::filesystem::temp_directory_path() / "TerrainDeformationLayerTest.tdef").string();
+	TEST_CHECK(layer.SaveToFile(path));
+	TerrainDeformationLayer fromFile;
+	fromFile.Initialize(kGrid, kGrid, kCell);
+	TEST_CHECK(fromFile.LoadFromFile(path));
+	TEST_CHECK(fromFile.Raw() == layer.Raw());
+	std::filesystem::remove(path);
+	TEST_CHECK(!fromFile.LoadFromFile(path));
+
+	// 5) 壊れたデータは弾き、中身は変えない
+	const std::vector<int16_t> before = loaded.Raw();
+	std::vector<uint8_t> broken = bytes;
+	TEST_CHECK(!loaded.Decode(broken.data(), broken.size() - 1)); // 短い
+	TEST_CHECK(!loaded.Decode(broken.data(), 8));                  // ヘッダも足りない
+	broken[0] = 'X';
+	TEST_CHECK(!loaded.Decode(broken.data(), broken.size())); // magic
+	broken = bytes;
+	broken.back() ^= 0x80;
+	broken.push_back(0);
+	TerrainDeformationLayer::FileHeader h;
+	std::memcpy(&h, broken.data(), sizeof(h));
+	h.payloadBytes += 1;
+	std::memcpy(broken.data(), &h, sizeof(h));
+	TEST_CHECK(!loaded.Decode(broken.data(), broken.size())); // 余計なバイト
+	TEST_CHECK(loaded.Raw() == before);
+
+	TerrainDeformationLayer other;
+	other.Initialize(200, 200, kCell);
+	TEST_CHECK(!other.Decode(bytes.data(), bytes.size())); // 格子の大きさ違い
+	TEST_CHECK(!other.CaptureFrom(field));
+
+	// 6) 変形なしは数百バイト
+	TerrainDeformationLayer empty;
+	empty.Initialize(kGrid, kGrid, kCell);
+	std::vector<uint8_t> emptyBytes;
+	empty.Encode(emptyBytes);
+	TEST_CHECK(emptyBytes.size() < 4096);
+
+	std::printf("raw %zu KB -> %zu KB, field err %.2e, sample err %.2e (step/2 %.2e), empty %zu bytes\n", layer.Raw().size() * 2 / 1024, bytes.size() / 1024, fieldErr, sampleErr, halfStep,
+	            emptyBytes.size());
+	return Test::Result("TerrainDeformationLayerTest");
+}
@@ -0,0 +1,63 @@
+// CG/Tests/TerrainDentGridBench.cpp
+// 凹み 10k 個：追加・セル経由の問い合わせ・GPU 用の表の作り直しと、全凹みを見る問い合わせ
+#include "TestCommon.h"
+#include "Terrain/TerrainDentGrid.h"
+#include "Terrain/TerrainHeightField.h"
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+int main() {
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+	std::uniform_real_distribution<float> radius(2.0f, 5.0f);
+	std::vector<TerrainDent> input(10000);
+	for (TerrainDent& d : input) {
+		d = TerrainDent{{pos(rng), pos(rng)}, radius(rng), 0.3f};
+	}
+
+	// Renderer::AddTerrainDent と同じく、高さキャッシュへの焼き込みも込みで
+	TerrainDentGrid grid;
+	grid.Initialize(-160.0f, -160.0f, 4.0f, 80, 80);
+	TerrainHeightField field;
+	field.Initialize(400, 400, 0.8f);
+	const double addUs = Test::TimeUs([&] {
+		for (const TerrainDent& d : input) {
+			const auto r = grid.Add(d);
+			if (r.merged) {
+				field.UnstampDent(r.previous);
+			}
+			field.StampDent(grid.Dent(r.index));
+		}
+	});
+	const double flatUs = Test::TimeUs([&] { grid.BuildFlatTables(); });
+
+	std::vector<float> xs(200000), zs(200000);
+	for (size_t i = 0; i < xs.size(); ++i) {
+		xs[i] = pos(rng);
+		zs[i] = pos(rng);
+	}
+	volatile float sink = 0.0f;
+	const double gridUs = Test::TimeUs([&] {
+		float s = 0.0f;
+		for (size_t i = 0; i < xs.size(); ++i) {
+			s += grid.OffsetAt(xs[i], zs[i]);
+		}
+		sink = s;
+	});
+	const size_t flatQueries = 2000;
+	const double linearUs = Test::TimeUs([&] {
+		float s = 0.0f;
+		for (size_t i = 0; i < flatQueries; ++i) {
+			s += TerrainHeightAnalytic(xs[i], zs[i], grid.Dents().data(), grid.Count()) - TerrainBaseHeight(xs[i], zs[i]);
+		}
+		sink = s;
+	});
+	(void)sink;
+
+	std::printf("10k dents (%u kept, %u merged): add+stamp %.2f ms total (%.2f us/dent) | flat tables %.2f ms (%zu indices)\n", grid.Count(), grid.MergedCount(), addUs / 1000.0, addUs / double(input.size()),
+	            flatUs / 1000.0, grid.FlatIndices().size());
+	std::printf("OffsetAt via cells %.3f us/query | all dents %.2f us/query\n", gridUs / double(xs.size()), linearUs / double(flatQueries));
+	return 0;
+}
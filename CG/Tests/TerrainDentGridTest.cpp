@@ -0,0 +1,199 @@
+// CG/Tests/TerrainDentGridTest.cpp
+// TerrainDentGrid：セルに振り分けた凹みの和が全凹みの和と一致するか、まとめてよい凹みだけまとめるか
+// 変形レイヤーに焼き込むとき、凹みの数が頭打ちになって格子点の高さが変わらないか
+#include "TestCommon.h"
+#include "Terrain/TerrainDeformationLayer.h"
+#include "Terrain/TerrainDentGrid.h"
+#include "Terrain/TerrainHeightField.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+// Renderer と同じ（320m 四方 / 4m セル）
+void InitGrid(TerrainDentGrid& g) { g.Initialize(-160.0f, -160.0f, 4.0f, 80, 80); }
+
+float SumOffsets(const std::vector<TerrainDent>& dents, float x, float z) {
+	float y = 0.0f;
+	for (const TerrainDent& d : dents) {
+		y += TerrainDentOffset(x, z, d);
+	}
+	return y;
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+	std::uniform_real_distribution<float> query(-158.0f, 158.0f);
+
+	// 1) 10k 個：セルに載っている凹みだけ見た和 = 全凹みの和（まとめた分も含めて、まとめた後の凹みで）
+	{
+		TerrainDentGrid grid;
+		InitGrid(grid);
+		std::uniform_real_distribution<float> radius(2.0f, 5.0f);
+		for (int i = 0; i < 10000; ++i) {
+			grid.Add(TerrainDent{{pos(rng), pos(rng)}, radius(rng), 0.3f});
+		}
+		double maxErr = 0.0;
+		for (int i = 0; i < 20000; ++i) {
+			const float x = query(rng), z = query(rng);
+			maxErr = (std::max)(maxErr, double(std::fabs(grid.OffsetAt(x, z) - SumOffsets(grid.Dents(), x, z))));
+		}
+		TEST_CHECK(maxErr < 1e-4);
+		TEST_CHECK(grid.Count() + grid.MergedCount() == 10000);
+
+		// GPU 用の平らな表はセルごとのリストと同じ中身
+		grid.BuildFlatTables();
+		const auto& ranges = grid.FlatRanges();
+		TEST_CHECK(ranges.size() == size_t(grid.CellsX()) * grid.CellsZ());
+		size_t total = 0;
+		for (const auto& r : ranges) {
+			TEST_CHECK(r.first == total);
+			total += r.count;
+		}
+		TEST_CHECK(total == grid.FlatIndices().size());
+		TEST_CHECK(!grid.BuildFlatTables()); // 変更なしなら作り直さない
+		std::printf("10k random dents: %u kept, %u merged, max err %.2e\n", grid.Count(), grid.MergedCount(), maxErr);
+	}
+
+	// 2) 同じ所を何度も叩く：1 個にまとまり、形は和に近い
+	{
+		TerrainDentGrid grid;
+		InitGrid(grid);
+		std::vector<TerrainDent> all;
+		for (int i = 0; i < 1000; ++i) {
+			all.push_back(TerrainDent{{10.0f, 5.0f}, 4.0f, 0.5f});
+			grid.Add(all.back());
+		}
+		TEST_CHECK(grid.Count() == 1);
+		double maxErr = 0.0;
+		for (int i = 0; i < 2000; ++i) {
+			const float x = 10.0f + (query(rng) / 158.0f) * 6.0f, z = 5.0f + (query(rng) / 158.0f) * 6.0f;
+			maxErr = (std::max)(maxErr, double(std::fabs(grid.OffsetAt(x, z) - SumOffsets(all, x, z))));
+		}
+		TEST_CHECK(maxErr < 1e-2); // 深さの合計 500 に対して
+	}
+
+	// 3) 浅く広い凹みの中心に小さな一撃：形が変わるのでまとめない
+	{
+		TerrainDentGrid grid;
+		InitGrid(grid);
+		const std::vector<TerrainDent> all = {TerrainDent{{0.0f, 0.0f}, 10.0f, 0.2f}, TerrainDent{{0.1f, 0.0f}, 0.5f, 1.0f}};
+		grid.Add(all[0]);
+		const auto r = grid.Add(all[1]);
+		TEST_CHECK(!r.merged);
+		TEST_CHECK(grid.Count() == 2);
+		TEST_CHECK_NEAR(grid.OffsetAt(5.0f, 0.0f), SumOffsets(all, 5.0f, 0.0f), 1e-6);
+		TEST_CHECK_NEAR(grid.OffsetAt(0.1f, 0.0f), SumOffsets(all, 0.1f, 0.0f), 1e-6);
+	}
+
+	// 4) まとめられる範囲ぎりぎりの 2 個：まとめた凹みと 2 個の和の差は深さの合計の 1 割以内
+	{
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		double worst = 0.0;
+		int merged = 0;
+		for (int i = 0; i < 2000; ++i) {
+			TerrainDentGrid grid;
+			InitGrid(grid);
+			const float r0 = 1.0f + 5.0f * unit(rng);
+			const float r1 = r0 * (TerrainDentGrid::kMergeRadiusRatio + (1.0f - TerrainDentGrid::kMergeRadiusRatio) * unit(rng));
+			const float angle = 6.2831853f * unit(rng);
+			const float dist = (std::min)(r0, r1) * TerrainDentGrid::kMergeDistanceRatio * 0.999f * unit(rng);
+			const std::vector<TerrainDent> pair = {TerrainDent{{20.0f, -30.0f}, r0, 0.1f + unit(rng)},
+			                                       TerrainDent{{20.0f + dist * std::cos(angle), -30.0f + dist * std::sin(angle)}, r1, 0.1f + unit(rng)}};
+			grid.Add(pair[0]);
+			merged += grid.Add(pair[1]).merged;
+			const float depth = pair[0].depth + pair[1].depth;
+			for (int k = 0; k < 200; ++k) {
+				const float x = 20.0f + (2.0f * unit(rng) - 1.0f) * r0 * 1.2f, z = -30.0f + (2.0f * unit(rng) - 1.0f) * r0 * 1.2f;
+				worst = (std::max)(worst, double(std::fabs(grid.OffsetAt(x, z) - SumOffsets(pair, x, z))) / depth);
+			}
+		}
+		TEST_CHECK(merged == 2000);
+		TEST_CHECK(worst < 0.1);
+		std::printf("merge error at the limits: %.3f of the summed depth\n", worst);
+	}
+
+	// 5) レイヤーに焼き込む：10k 回叩いてもセルの凹みは上限まで。格子点の高さは全凹みを焼いた高さキャッシュと
+	//    （その格子点に焼き込んだ回数 x 量子化の刻みの半分以内で）一致
+	{
+		TerrainDentGrid grid;
+		InitGrid(grid);
+		TerrainDeformationLayer layer;
+		layer.Initialize(400, 400, 0.8f);
+		TerrainHeightField field;
+		field.Initialize(400, 400, 0.8f);
+		std::vector<uint16_t> folds(size_t(field.SamplesX()) * field.SamplesZ(), 0); // 格子点ごとの焼き込み回数
+		std::uniform_real_distribution<float> radius(2.0f, 5.0f);
+		bool merged = false;
+		uint32_t maxCount = 0;
+		for (int i = 0; i < 10000; ++i) {
+			const TerrainDent d{{pos(rng), pos(rng)}, radius(rng), 0.6f};
+			const auto r = grid.Add(d, &layer);
+			merged |= r.merged;
+			field.StampDent(d);
+			for (const TerrainDent& f : r.folded) {
+				for (uint32_t iz = 0; iz < field.SamplesZ(); ++iz) {
+					const float z = field.SampleZ(iz);
+					if (std::fabs(z - f.centerXZ.y) > f.radius)
+						continue;
+					for (uint32_t ix = 0; ix < field.SamplesX(); ++ix) {
+						if (TerrainDentOffset(field.SampleX(ix), z, f) != 0.0f) {
+							++folds[size_t(iz) * field.SamplesX() + ix];
+						}
+					}
+				}
+			}
+			maxCount = (std::max)(maxCount, grid.Count());
+		}
+		TEST_CHECK(!merged);
+		TEST_CHECK(grid.Count() + grid.FoldedCount() == 10000);
+
+		grid.BuildFlatTables();
+		uint32_t maxPerCell = 0;
+		for (const auto& r : grid.FlatRanges()) {
+			maxPerCell = (std::max)(maxPerCell, r.count);
+		}
+		TEST_CHECK(maxPerCell <= TerrainDentGrid::kMaxDentsPerCell);
+		TEST_CHECK(maxCount <= grid.CellsX() * grid.CellsZ() * TerrainDentGrid::kMaxDentsPerCell);
+
+		double maxErr = 0.0, maxExcess = 0.0;
+		for (uint32_t iz = 0; iz < field.SamplesZ(); ++iz) {
+			for (uint32_t ix = 0; ix < field.SamplesX(); ++ix) {
+				const float x = field.SampleX(ix), z = field.SampleZ(iz);
+				const double expected = field.Sample(ix, iz) - TerrainBaseHeight(x, z);
+				const double err = std::fabs(layer.DeltaAt(ix, iz) + grid.OffsetAt(x, z) - expected);
+				const double tol = folds[size_t(iz) * field.SamplesX() + ix] * TerrainDeformationLayer::kQuantStep * 0.5 + 1e-4;
+				maxErr = (std::max)(maxErr, err);
+				maxExcess = (std::max)(maxExcess, err - tol);
+			}
+		}
+		TEST_CHECK(maxExcess <= 0.0);
+		std::printf("10k dents folded into the layer: %u kept (max %u, %u per cell), %u folded, max height err %.2e m\n", grid.Count(), maxCount, maxPerCell,
+		            grid.FoldedCount(), maxErr);
+	}
+
+	// 6) 同じ所を何度も叩く（レイヤーあり）：前の凹みは覆われて焼き込まれ、1 個しか残らない
+	{
+		TerrainDentGrid grid;
+		InitGrid(grid);
+		TerrainDeformationLayer layer;
+		layer.Initialize(400, 400, 0.8f);
+		for (int i = 0; i < 1000; ++i) {
+			grid.Add(TerrainDent{{10.0f, 5.0f}, 4.0f, 0.01f}, &layer);
+		}
+		TEST_CHECK(grid.Count() == 1 && grid.FoldedCount() == 999);
+		// 格子点 (213, 206) = (10.4, 4.8) で深さの合計と比べる
+		const float x = 10.4f, z = 4.8f;
+		const double expected = -10.0 * (1.0 - (0.4 * 0.4 + 0.2 * 0.2) / 16.0);
+		TEST_CHECK_NEAR(layer.DeltaAt(213, 206) + grid.OffsetAt(x, z), expected, 999 * TerrainDeformationLayer::kQuantStep * 0.5);
+	}
+
+	return Test::Result("TerrainDentGridTest");
+}
@@ -0,0 +1,52 @@
+// CG/Tests/TerrainHeightFieldBench.cpp
+// 高さの問い合わせ：ベイクした格子は凹みの数によらず一定、解析解は凹みの数に比例
+#include "TestCommon.h"
+#include "Terrain/TerrainHeightField.h"
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+int main() {
+	std::mt19937 rng(2);
+	std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+	std::vector<float> xs(100000), zs(100000);
+	for (size_t i = 0; i < xs.size(); ++i) {
+		xs[i] = pos(rng);
+		zs[i] = pos(rng);
+	}
+
+	for (int dentCount : {0, 100, 1000}) {
+		TerrainHeightField field;
+		field.Initialize(400, 400, 0.8f);
+		std::vector<TerrainDent> dents;
+		for (int i = 0; i < dentCount; ++i) {
+			dents.push_back(TerrainDent{{pos(rng), pos(rng)}, 3.0f, 1.0f});
+		}
+		const double stampUs = Test::TimeUs([&] {
+			for (const TerrainDent& d : dents) {
+				field.StampDent(d);
+			}
+		});
+
+		volatile float sink = 0.0f;
+		const double fieldUs = Test::TimeUs([&] {
+			float s = 0.0f;
+			for (size_t i = 0; i < xs.size(); ++i) {
+				s += field.HeightAt(xs[i], zs[i]);
+			}
+			sink = s;
+		});
+		const double analyticUs = Test::TimeUs([&] {
+			float s = 0.0f;
+			for (size_t i = 0; i < xs.size(); ++i) {
+				s += TerrainHeightAnalytic(xs[i], zs[i], dents.data(), unsigned(dents.size()));
+			}
+			sink = s;
+		});
+		(void)sink;
+		std::printf("dents %4d: stamp %8.1f us | HeightAt %6.2f ns/query | analytic %8.2f ns/query\n", dentCount, stampUs, fieldUs * 1000.0 / double(xs.size()),
+		            analyticUs * 1000.0 / double(xs.size()));
+	}
+	return 0;
+}
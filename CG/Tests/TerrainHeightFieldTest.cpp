@@ -0,0 +1,71 @@
+// CG/Tests/TerrainHeightFieldTest.cpp
+// TerrainHeightField（ベイクした高さ）が解析解（TerrainHeightAnalytic）と一致するか
+#include "TestCommon.h"
+#include "Terrain/TerrainHeightField.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+int main() {
+	// Renderer と同じ 400x400 / 0.8m
+	TerrainHeightField field;
+	field.Initialize(400, 400, 0.8f);
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+	std::uniform_real_distribution<float> radius(1.0f, 8.0f);
+	std::uniform_real_distribution<float> depth(0.2f, 2.0f);
+	std::vector<TerrainDent> dents;
+	for (int i = 0; i < 1000; ++i) {
+		dents.push_back(TerrainDent{{pos(rng), pos(rng)}, radius(rng), depth(rng)});
+		field.StampDent(dents.back());
+	}
+	const unsigned count = unsigned(dents.size());
+
+	// 格子点では解析解そのもの（足し込む順番ぶんの誤差だけ）
+	double maxVertexErr = 0.0;
+	for (uint32_t iz = 0; iz < field.SamplesZ(); ++iz) {
+		for (uint32_t ix = 0; ix < field.SamplesX(); ++ix) {
+			const float a = TerrainHeightAnalytic(field.SampleX(ix), field.SampleZ(iz), dents.data(), count);
+			maxVertexErr = (std::max)(maxVertexErr, double(std::fabs(a - field.Sample(ix, iz))));
+		}
+	}
+	TEST_CHECK(maxVertexErr < 1e-4);
+
+	// 格子の間は 4 隅の解析解の双線形補間（メッシュと同じ面）
+	double maxInteriorErr = 0.0;
+	const float half = 0.5f * 400 * 0.8f;
+	for (int i = 0; i < 200000; ++i) {
+		const float x = pos(rng), z = pos(rng);
+		const float fx = (x + half) / 0.8f, fz = (z + half) / 0.8f;
+		const uint32_t ix = uint32_t(fx), iz = uint32_t(fz);
+		const float tx = fx - float(ix), tz = fz - float(iz);
+		auto corner = [&](uint32_t cx, uint32_t cz) { return TerrainHeightAnalytic(field.SampleX(cx), field.SampleZ(cz), dents.data(), count); };
+		const float h0 = corner(ix, iz) + (corner(ix + 1, iz) - corner(ix, iz)) * tx;
+		const float h1 = corner(ix, iz + 1) + (corner(ix + 1, iz + 1) - corner(ix, iz + 1)) * tx;
+		maxInteriorErr = (std::max)(maxInteriorErr, double(std::fabs(h0 + (h1 - h0) * tz - field.HeightAt(x, z))));
+	}
+	TEST_CHECK(maxInteriorErr < 1e-4);
+
+	// 格子の外はベース地形
+	TEST_CHECK(!field.Contains(500.0f, 0.0f));
+	TEST_CHECK_NEAR(field.HeightAt(500.0f, 0.0f), TerrainBaseHeight(500.0f, 0.0f), 0.0);
+
+	// 凹みを全部取り消すとベース地形に戻る
+	for (const TerrainDent& d : dents) {
+		field.UnstampDent(d);
+	}
+	double maxBaseErr = 0.0;
+	for (uint32_t iz = 0; iz < field.SamplesZ(); iz += 3) {
+		for (uint32_t ix = 0; ix < field.SamplesX(); ix += 3) {
+			maxBaseErr = (std::max)(maxBaseErr, double(std::fabs(TerrainBaseHeight(field.SampleX(ix), field.SampleZ(iz)) - field.Sample(ix, iz))));
+		}
+	}
+	TEST_CHECK(maxBaseErr < 1e-4);
+
+	std::printf("vertex err %.2e, interior err %.2e, unstamp err %.2e\n", maxVertexErr, maxInteriorErr, maxBaseErr);
+	return Test::Result("TerrainHeightFieldTest");
+}
@@ -0,0 +1,148 @@
+// CG/Tests/TerrainHeightPyramidBench.cpp
+// TerrainHeightPyramid：Renderer と同じ 400x400 / 0.8m に凹み 3000 個、カメラ風のキャスト 4000 本
+// ピラミッドのレイ / 球キャストと、半セル刻みで高さを見ていくレイ、全セルの三角形の総当たり（一部だけ）の比較
+#include "TestCommon.h"
+#include "Terrain/TerrainHeightField.h"
+#include "Terrain/TerrainHeightPyramid.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+// 半セルずつ進めて地面の下に入ったら二分探索（ピラミッドなしでよくやる方法）
+bool MarchRay(const TerrainHeightField& f, const Vector3& o, const Vector3& d, float maxDist, float& t) {
+	const float step = 0.5f * f.Cell();
+	float prev = 0.0f;
+	for (float s = step; s <= maxDist; s += step) {
+		const Vector3 p = o + d * s;
+		if (p.y > f.HeightAt(p.x, p.z)) {
+			prev = s;
+			continue;
+		}
+		float lo = prev, hi = s;
+		for (int i = 0; i < 16; ++i) {
+			const float m = 0.5f * (lo + hi);
+			const Vector3 q = o + d * m;
+			(q.y > f.HeightAt(q.x, q.z) ? lo : hi) = m;
+		}
+		t = hi;
+		return true;
+	}
+	return false;
+}
+
+// 全セルの三角形 2 枚ずつを総当たり（Moller-Trumbore、表から当たるものだけ）
+bool BruteRay(const TerrainHeightField& f, const Vector3& o, const Vector3& d, float maxDist, float& t) {
+	t = maxDist;
+	bool hit = false;
+	auto tri = [&](const Vector3& a, const Vector3& b, const Vector3& c) {
+		const Vector3 e1 = b - a, e2 = c - a;
+		Vector3 n = Cross(e1, e2);
+		if ((n.y < 0.0f ? -Dot(n, d) : Dot(n, d)) >= 0.0f)
+			return;
+		const Vector3 p = Cross(d, e2);
+		const float det = Dot(e1, p);
+		const Vector3 s = o - a;
+		const float u = Dot(s, p) / det;
+		const Vector3 q = Cross(s, e1);
+		const float v = Dot(d, q) / det;
+		const float dist = Dot(e2, q) / det;
+		if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && dist >= 0.0f && dist < t) {
+			t = dist;
+			hit = true;
+		}
+	};
+	for (uint32_t iz = 0; iz < f.GridZ(); ++iz) {
+		for (uint32_t ix = 0; ix < f.GridX(); ++ix) {
+			const Vector3 p00{f.SampleX(ix), f.Sample(ix, iz), f.SampleZ(iz)};
+			const Vector3 p10{f.SampleX(ix + 1), f.Sample(ix + 1, iz), f.SampleZ(iz)};
+			const Vector3 p01{f.SampleX(ix), f.Sample(ix, iz + 1), f.SampleZ(iz + 1)};
+			const Vector3 p11{f.SampleX(ix + 1), f.Sample(ix + 1, iz + 1), f.SampleZ(iz + 1)};
+			tri(p00, p10, p01);
+			tri(p10, p11, p01);
+		}
+	}
+	return hit;
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> pos(-150.0f, 150.0f), unit(0.0f, 1.0f);
+
+	TerrainHeightField field;
+	field.Initialize(400, 400, 0.8f);
+	std::vector<TerrainDent> dents;
+	for (int i = 0; i < 3000; ++i) {
+		dents.push_back(TerrainDent{{pos(rng), pos(rng)}, 2.0f + 4.0f * unit(rng), 0.3f + 1.5f * unit(rng)});
+		field.StampDent(dents.back());
+	}
+	TerrainHeightPyramid pyramid;
+	const double buildUs = Test::TimeUs([&] { pyramid.Build(&field); });
+	const double refitUs = Test::TimeUs([&] {
+		for (int i = 0; i < 100; ++i) {
+			pyramid.RefitDent(dents[i]);
+		}
+	}) / 100.0;
+
+	// カメラ風：地面の上 3〜25m から、真下〜水平の方向へ 60m まで
+	constexpr int kCasts = 4000;
+	constexpr float kMaxDist = 60.0f;
+	std::vector<Vector3> origins(kCasts), dirs(kCasts);
+	for (int i = 0; i < kCasts; ++i) {
+		const float x = pos(rng), z = pos(rng);
+		origins[i] = {x, field.HeightAt(x, z) + 3.0f + 22.0f * unit(rng), z};
+		const float yaw = 6.2831853f * unit(rng), pitch = -1.5f * unit(rng);
+		dirs[i] = {std::cos(pitch) * std::cos(yaw), std::sin(pitch), std::cos(pitch) * std::sin(yaw)};
+	}
+
+	int rayHits = 0, sphereHits = 0, marchHits = 0, marchDiff = 0;
+	std::vector<float> rayT(kCasts, -1.0f);
+	const double rayUs = Test::TimeUs([&] {
+		for (int i = 0; i < kCasts; ++i) {
+			TerrainRayHit hit;
+			if (pyramid.Raycast(origins[i], dirs[i], kMaxDist, hit)) {
+				++rayHits;
+				rayT[i] = hit.distance;
+			}
+		}
+	}) / kCasts;
+	const double sphereUs = Test::TimeUs([&] {
+		for (int i = 0; i < kCasts; ++i) {
+			TerrainRayHit hit;
+			sphereHits += pyramid.SphereCast(origins[i], dirs[i], 0.5f, kMaxDist, hit);
+		}
+	}) / kCasts;
+	const double marchUs = Test::TimeUs([&] {
+		for (int i = 0; i < kCasts; ++i) {
+			float t;
+			const bool hit = MarchRay(field, origins[i], dirs[i], kMaxDist, t);
+			marchHits += hit;
+			// 半セル刻みだと薄い出っ張りを飛び越えることがあり、面も双線形なのでメッシュの三角形とは少しずれる
+			marchDiff += hit != (rayT[i] >= 0.0f) || (hit && std::fabs(t - rayT[i]) > 1e-2f);
+		}
+	}) / kCasts;
+
+	// 総当たりは重いので先頭の 50 本だけ（答えも合わせる）
+	constexpr int kBrute = 50;
+	int bruteDiff = 0;
+	const double bruteUs = Test::TimeUs([&] {
+		for (int i = 0; i < kBrute; ++i) {
+			float t;
+			const bool hit = BruteRay(field, origins[i], dirs[i], kMaxDist, t);
+			bruteDiff += hit != (rayT[i] >= 0.0f) || (hit && std::fabs(t - rayT[i]) > 1e-3f);
+		}
+	}) / kBrute;
+
+	std::printf("400x400 cells, %zu dents, %u levels: build %.0f us, refit %.1f us/dent\n", dents.size(), pyramid.LevelCount(), buildUs, refitUs);
+	std::printf("%-22s %10s %8s %10s\n", "", "us/cast", "hits", "vs ray");
+	std::printf("%-22s %10.2f %8d %10s\n", "pyramid ray", rayUs, rayHits, "1.0x");
+	std::printf("%-22s %10.2f %8d %9.1fx\n", "pyramid sphere r=0.5", sphereUs, sphereHits, sphereUs / rayUs);
+	std::printf("%-22s %10.2f %8d %9.1fx  (%d differ from the ray)\n", "half-cell march", marchUs, marchHits, marchUs / rayUs, marchDiff);
+	std::printf("%-22s %10.1f %8s %9.0fx  (%d of %d differ)\n", "brute force (50 rays)", bruteUs, "-", bruteUs / rayUs, bruteDiff, kBrute);
+	return 0;
+}
@@ -0,0 +1,326 @@
+// CG/Tests/TerrainHeightPyramidTest.cpp
+// TerrainHeightPyramid：レイ / 球キャストが全セルの三角形を総当たりした結果と一致するか（当たり / 外れ、距離、法線）
+// 地形の中から始めたキャスト、StampDent のあとの Refit も
+#include "TestCommon.h"
+#include "Terrain/TerrainHeightField.h"
+#include "Terrain/TerrainHeightPyramid.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+struct Triangle {
+	Vector3 a, b, c;
+	Vector3 n; // 上向きの法線
+};
+
+// メッシュと同じ分け方で全セルの三角形を並べる
+std::vector<Triangle> AllTriangles(const TerrainHeightField& f) {
+	std::vector<Triangle> out;
+	for (uint32_t iz = 0; iz < f.GridZ(); ++iz) {
+		for (uint32_t ix = 0; ix < f.GridX(); ++ix) {
+			auto p = [&](uint32_t x, uint32_t z) { return Vector3{f.SampleX(x), f.Sample(x, z), f.SampleZ(z)}; };
+			const Vector3 p00 = p(ix, iz), p10 = p(ix + 1, iz), p01 = p(ix, iz + 1), p11 = p(ix + 1, iz + 1);
+			for (const Triangle& t : {Triangle{p00, p10, p01, {}}, Triangle{p10, p11, p01, {}}}) {
+				Triangle u = t;
+				u.n = Normalize(Cross(t.b - t.a, t.c - t.a));
+				if (u.n.y < 0.0f) {
+					u.n = u.n * -1.0f;
+				}
+				out.push_back(u);
+			}
+		}
+	}
+	return out;
+}
+
+// レイ：表から入る三角形のうち最も近いもの（Moller-Trumbore）。法線も返す
+bool BruteRay(const std::vector<Triangle>& tris, const Vector3& o, const Vector3& d, float maxDist, float& best, Vector3& normal) {
+	best = maxDist;
+	bool hit = false;
+	for (const Triangle& t : tris) {
+		if (Dot(t.n, d) >= 0.0f)
+			continue;
+		const Vector3 e1 = t.b - t.a, e2 = t.c - t.a;
+		const Vector3 p = Cross(d, e2);
+		const float det = Dot(e1, p);
+		if (std::fabs(det) < 1e-12f)
+			continue;
+		const Vector3 s = o - t.a;
+		const float u = Dot(s, p) / det;
+		const Vector3 q = Cross(s, e1);
+		const float v = Dot(d, q) / det;
+		const float dist = Dot(e2, q) / det;
+		if (u < 0.0f || v < 0.0f || u + v > 1.0f || dist < 0.0f || dist >= best)
+			continue;
+		best = dist;
+		normal = t.n;
+		hit = true;
+	}
+	return hit;
+}
+
+// 点 p に最も近い三角形上の点（Ericson, Real-Time Collision Detection 5.1.5）
+Vector3 ClosestOnTriangle(const Vector3& p, const Triangle& t) {
+	const Vector3 ab = t.b - t.a, ac = t.c - t.a, ap = p - t.a;
+	const float d1 = Dot(ab, ap), d2 = Dot(ac, ap);
+	if (d1 <= 0.0f && d2 <= 0.0f)
+		return t.a;
+	const Vector3 bp = p - t.b;
+	const float d3 = Dot(ab, bp), d4 = Dot(ac, bp);
+	if (d3 >= 0.0f && d4 <= d3)
+		return t.b;
+	const float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+		return t.a + ab * (d1 / (d1 - d3));
+	const Vector3 cp = p - t.c;
+	const float d5 = Dot(ab, cp), d6 = Dot(ac, cp);
+	if (d6 >= 0.0f && d5 <= d6)
+		return t.c;
+	const float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+		return t.a + ac * (d2 / (d2 - d6));
+	const float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+		return t.b + (t.c - t.b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+	const float denom = 1.0f / (va + vb + vc);
+	return t.a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+float Distance(const Vector3& a, const Vector3& b) { return std::sqrt(Dot(a - b, a - b)); }
+
+// メッシュ全体で p に最も近い点
+Vector3 ClosestOnMesh(const std::vector<Triangle>& tris, const Vector3& p) {
+	Vector3 best = tris[0].a;
+	float bestDist = FLT_MAX;
+	for (const Triangle& t : tris) {
+		const Vector3 q = ClosestOnTriangle(p, t);
+		const float dist = Distance(p, q);
+		if (dist < bestDist) {
+			bestDist = dist;
+			best = q;
+		}
+	}
+	return best;
+}
+
+// 球：中心が o + d t のとき三角形までの距離は t の凸関数なので、三角形ごとに最小を三分探索してから
+// 最初に r 以下になる t を二分探索する。minGap には経路全体でのメッシュとの最小の隙間（距離 - r）を返す
+bool BruteSphere(const std::vector<Triangle>& tris, const Vector3& o, const Vector3& d, float r, float maxDist, float& best, float& minGap) {
+	best = maxDist;
+	minGap = FLT_MAX;
+	bool hit = false;
+	const Vector3 e = o + d * maxDist;
+	const Vector3 lo{(std::min)(o.x, e.x) - r, (std::min)(o.y, e.y) - r, (std::min)(o.z, e.z) - r};
+	const Vector3 hi{(std::max)(o.x, e.x) + r, (std::max)(o.y, e.y) + r, (std::max)(o.z, e.z) + r};
+	for (const Triangle& t : tris) {
+		// 掃いた範囲の箱に掛からない三角形は触れない
+		if ((std::max)({t.a.x, t.b.x, t.c.x}) < lo.x || (std::min)({t.a.x, t.b.x, t.c.x}) > hi.x || (std::max)({t.a.y, t.b.y, t.c.y}) < lo.y ||
+		    (std::min)({t.a.y, t.b.y, t.c.y}) > hi.y || (std::max)({t.a.z, t.b.z, t.c.z}) < lo.z || (std::min)({t.a.z, t.b.z, t.c.z}) > hi.z)
+			continue;
+		auto gap = [&](float s) {
+			const Vector3 c = o + d * s;
+			return Distance(c, ClosestOnTriangle(c, t)) - r;
+		};
+		float a = 0.0f, b = maxDist;
+		for (int i = 0; i < 100; ++i) {
+			const float m1 = a + (b - a) / 3.0f, m2 = b - (b - a) / 3.0f;
+			if (gap(m1) < gap(m2)) {
+				b = m2;
+			} else {
+				a = m1;
+			}
+		}
+		const float tMin = 0.5f * (a + b);
+		minGap = (std::min)(minGap, gap(tMin));
+		if (gap(tMin) > 0.0f)
+			continue;
+		float l = 0.0f, h = tMin;
+		for (int i = 0; i < 60; ++i) {
+			const float m = 0.5f * (l + h);
+			if (gap(m) > 0.0f) {
+				l = m;
+			} else {
+				h = m;
+			}
+		}
+		if (h < best) {
+			best = h;
+			hit = true;
+		}
+	}
+	return hit;
+}
+
+// 穴の縁をまたぐ 96x96 / 0.8m の格子に凹みをいくつか
+void MakeField(TerrainHeightField& field, std::mt19937& rng) {
+	field.Initialize(96, 96, 0.8f);
+	std::uniform_real_distribution<float> pos(-36.0f, 36.0f), radius(1.0f, 6.0f), depth(0.3f, 3.0f);
+	for (int i = 0; i < 60; ++i) {
+		field.StampDent(TerrainDent{{pos(rng), pos(rng)}, radius(rng), depth(rng)});
+	}
+}
+
+// カメラ風のキャスト：地形の上 3〜25m から、下向き〜水平の方向へ
+void CameraCast(std::mt19937& rng, Vector3& o, Vector3& d) {
+	std::uniform_real_distribution<float> pos(-36.0f, 36.0f), unit(0.0f, 1.0f);
+	o = {pos(rng), 0.0f, pos(rng)};
+	o.y = 5.0f + 22.0f * unit(rng);
+	const float yaw = 6.2831853f * unit(rng), pitch = -1.5f * unit(rng);
+	d = {std::cos(pitch) * std::cos(yaw), std::sin(pitch), std::cos(pitch) * std::sin(yaw)};
+}
+
+struct Stats {
+	int casts = 0, hits = 0, mismatches = 0;
+	double maxDistErr = 0.0, minNormalDot = 1.0;
+};
+
+// レイを総当たりと比べる
+void CheckRays(const TerrainHeightPyramid& pyramid, const std::vector<Triangle>& tris, std::mt19937& rng, int count, Stats& st) {
+	for (int i = 0; i < count; ++i) {
+		Vector3 o, d;
+		CameraCast(rng, o, d);
+		const float maxDist = 80.0f;
+		float refT;
+		Vector3 refN{};
+		const bool ref = BruteRay(tris, o, d, maxDist, refT, refN);
+		TerrainRayHit hit;
+		const bool got = pyramid.Raycast(o, d * 3.0f, maxDist, hit); // 方向は正規化しなくてよい
+		++st.casts;
+		if (ref != got) {
+			++st.mismatches;
+			continue;
+		}
+		if (!ref)
+			continue;
+		++st.hits;
+		st.maxDistErr = (std::max)(st.maxDistErr, double(std::fabs(hit.distance - refT)));
+		// 2 枚の境目ちょうどに当たると、どちらの法線でもよい
+		const Vector3 p = o + d * refT;
+		st.minNormalDot = (std::min)(st.minNormalDot, double(Dot(hit.normal, refN)));
+		if (Dot(hit.normal, refN) < 0.999f && Distance(ClosestOnMesh(tris, p), p) > 1e-3f) {
+			++st.mismatches;
+		}
+		if (Distance(hit.position, p) > 1e-2f) {
+			++st.mismatches;
+		}
+	}
+}
+
+// 球を総当たりと比べる（ぎりぎりかすめるものは当たり / 外れのどちらでもよい）
+void CheckSpheres(const TerrainHeightPyramid& pyramid, const std::vector<Triangle>& tris, std::mt19937& rng, int count, Stats& st) {
+	std::uniform_real_distribution<float> radius(0.2f, 2.0f);
+	for (int i = 0; i < count; ++i) {
+		Vector3 o, d;
+		CameraCast(rng, o, d);
+		const float r = radius(rng), maxDist = 60.0f;
+		float refT, minGap;
+		const bool ref = BruteSphere(tris, o, d, r, maxDist, refT, minGap);
+		TerrainRayHit hit;
+		const bool got = pyramid.SphereCast(o, d, r, maxDist, hit);
+		++st.casts;
+		if (ref != got) {
+			if (std::fabs(minGap) > 1e-3f) {
+				++st.mismatches;
+			}
+			continue;
+		}
+		if (!ref)
+			continue;
+		++st.hits;
+		st.maxDistErr = (std::max)(st.maxDistErr, double(std::fabs(hit.distance - refT)));
+		// 法線は接触点から中心へ（メッシュで最も近い点から）
+		const Vector3 c = o + d * hit.distance;
+		const Vector3 refN = Normalize(c - ClosestOnMesh(tris, c));
+		st.minNormalDot = (std::min)(st.minNormalDot, double(Dot(hit.normal, refN)));
+		if (Dot(hit.normal, refN) < 0.99f) {
+			++st.mismatches;
+		}
+	}
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(7);
+	TerrainHeightField field;
+	MakeField(field, rng);
+	TerrainHeightPyramid pyramid;
+	pyramid.Build(&field);
+	TEST_CHECK(pyramid.IsValid());
+	std::vector<Triangle> tris = AllTriangles(field);
+
+	// 1) カメラ風のレイ 2000 本
+	{
+		Stats st;
+		CheckRays(pyramid, tris, rng, 2000, st);
+		TEST_CHECK(st.mismatches == 0);
+		TEST_CHECK(st.hits > 1000 && st.hits < st.casts); // 当たりも外れもある
+		TEST_CHECK(st.maxDistErr < 1e-3);
+		std::printf("rays: %d casts, %d hits, %d mismatches, max |t - ref| %.2e, min normal dot %.6f\n", st.casts, st.hits, st.mismatches, st.maxDistErr,
+		            st.minNormalDot);
+	}
+
+	// 2) 半径 0.2〜2 の球 300 個
+	{
+		Stats st;
+		CheckSpheres(pyramid, tris, rng, 300, st);
+		TEST_CHECK(st.mismatches == 0);
+		TEST_CHECK(st.hits > 150 && st.hits < st.casts);
+		TEST_CHECK(st.maxDistErr < 2e-3);
+		std::printf("spheres: %d casts, %d hits, %d mismatches, max |t - ref| %.2e, min normal dot %.6f\n", st.casts, st.hits, st.mismatches, st.maxDistErr,
+		            st.minNormalDot);
+	}
+
+	// 3) 地形の中から始める：裏から抜ける面は無視する
+	{
+		const float x = 3.3f, z = -7.1f;
+		const float y = field.HeightAt(x, z);
+		TerrainRayHit hit;
+		TEST_CHECK(!pyramid.Raycast({x, y - 1.0f, z}, {0.0f, 1.0f, 0.0f}, 50.0f, hit));
+		TEST_CHECK(!pyramid.Raycast({x, y - 1.0f, z}, {0.0f, -1.0f, 0.0f}, 50.0f, hit));
+		// 球の中心が面の少し上でも、半径で食い込んでいれば上へは抜けられる
+		TEST_CHECK(!pyramid.SphereCast({x, y + 0.2f, z}, {0.0f, 1.0f, 0.0f}, 0.5f, 50.0f, hit));
+		// 格子の外から始めて外へ向かうものは何も当たらない
+		TEST_CHECK(!pyramid.Raycast({100.0f, 10.0f, 0.0f}, {1.0f, -0.1f, 0.0f}, 50.0f, hit));
+		// 真上から真下：距離はその点の高さまで
+		TEST_CHECK(pyramid.Raycast({x, y + 10.0f, z}, {0.0f, -1.0f, 0.0f}, 50.0f, hit));
+		TEST_CHECK_NEAR(hit.distance, 10.0f, 1e-4);
+		// maxDist の手前で止まる
+		TEST_CHECK(!pyramid.Raycast({x, y + 10.0f, z}, {0.0f, -1.0f, 0.0f}, 9.9f, hit));
+	}
+
+	// 4) StampDent のあと Refit すると、新しい凹みの底まで届く（作り直した総当たりと一致）
+	{
+		const TerrainDent dent{{-4.0f, 6.0f}, 5.0f, 4.0f};
+		const float before = field.HeightAt(-4.0f, 6.0f);
+		field.StampDent(dent);
+		pyramid.RefitDent(dent);
+		tris = AllTriangles(field);
+
+		TerrainRayHit hit;
+		TEST_CHECK(pyramid.Raycast({-4.0f, before + 10.0f, 6.0f}, {0.0f, -1.0f, 0.0f}, 50.0f, hit));
+		TEST_CHECK_NEAR(hit.distance, 10.0f + (before - field.HeightAt(-4.0f, 6.0f)), 1e-3);
+
+		// Refit した範囲の上のノードも新しい高さを覆っている
+		for (uint32_t level = 0; level < pyramid.LevelCount(); ++level) {
+			const uint32_t nx = 45u >> level, nz = 55u >> level; // (-4, 6) のあたりのセル
+			float lo, hi;
+			pyramid.NodeMinMax(level, nx, nz, lo, hi);
+			TEST_CHECK(lo <= field.Sample(45, 55) + 1e-6f);
+		}
+
+		Stats rays, spheres;
+		CheckRays(pyramid, tris, rng, 500, rays);
+		CheckSpheres(pyramid, tris, rng, 100, spheres);
+		TEST_CHECK(rays.mismatches == 0 && spheres.mismatches == 0);
+		TEST_CHECK(rays.maxDistErr < 1e-3 && spheres.maxDistErr < 2e-3);
+	}
+
+	return Test::Result("TerrainHeightPyramidTest");
+}
@@ -0,0 +1,55 @@
+// CG/Tests/TerrainLodSelectorBench.cpp
+// よくあるカメラでの三角形数と選択 + インデックス作成の時間（固定格子 2 * 400 * 400 枚との比較）
+#include "TestCommon.h"
+#include "Terrain/TerrainHeightField.h"
+#include "Terrain/TerrainHeightPyramid.h"
+#include "Terrain/TerrainLodSelector.h"
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+int main() {
+	constexpr uint32_t kGrid = 400;
+	constexpr float kCell = 0.8f;
+	constexpr size_t kFixedTris = size_t(2) * kGrid * kGrid;
+
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+	TerrainHeightField field;
+	field.Initialize(kGrid, kGrid, kCell);
+	for (int i = 0; i < 300; ++i) {
+		field.StampDent(TerrainDent{{pos(rng), pos(rng)}, 4.0f, 0.8f});
+	}
+	TerrainHeightPyramid pyramid;
+	pyramid.Build(&field);
+	TerrainLodSelector selector;
+	selector.Initialize(&field, &pyramid, {});
+
+	struct Camera {
+		const char* name;
+		XMFLOAT3 eye, at;
+	};
+	const Camera cameras[] = {
+	    {"center, looking across", {0.0f, 6.0f, -10.0f}, {0.0f, 0.0f, 20.0f}},
+	    {"ring, looking in", {0.0f, 8.0f, -60.0f}, {0.0f, 0.0f, 0.0f}},
+	    {"edge, looking along", {-150.0f, 6.0f, -150.0f}, {150.0f, 0.0f, -140.0f}},
+	    {"high overview", {0.0f, 80.0f, -120.0f}, {0.0f, 0.0f, 0.0f}},
+	};
+	const XMMATRIX proj = XMMatrixPerspectiveFovLH(0.8f, 16.0f / 9.0f, 0.1f, 1000.0f);
+	std::vector<TerrainLodPatch> patches;
+	std::vector<uint32_t> indices;
+	for (const Camera& c : cameras) {
+		XMFLOAT4 planes[6];
+		const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(c.eye.x, c.eye.y, c.eye.z, 1.0f), XMVectorSet(c.at.x, c.at.y, c.at.z, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		TerrainLodSelector::ExtractFrustumPlanes(view * proj, planes);
+		const double us = Test::TimeUs([&] {
+			selector.Select(c.eye, planes, patches);
+			TerrainLodSelector::BuildIndices(patches, kGrid, indices);
+		}, 100);
+		std::printf("%-24s patches %4zu tris %6zu (%5.1f%% of fixed %zu) | select + indices %.3f ms\n", c.name, patches.size(), indices.size() / 3, 100.0 * double(indices.size() / 3) / kFixedTris,
+		            kFixedTris, us / 1000.0);
+	}
+	return 0;
+}
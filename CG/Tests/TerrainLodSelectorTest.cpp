@@ -0,0 +1,127 @@
+// CG/Tests/TerrainLodSelectorTest.cpp
+// TerrainLodSelector：選んだパッチが格子をちょうど 1 回ずつ覆い、継ぎ目に穴や T 字がないか
+#include "TestCommon.h"
+#include "Terrain/TerrainHeightField.h"
+#include "Terrain/TerrainHeightPyramid.h"
+#include "Terrain/TerrainLodSelector.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+namespace {
+
+constexpr uint32_t kGrid = 400;
+constexpr float kCell = 0.8f;
+
+// セルごとに何枚のパッチが覆っているか
+std::vector<int> Coverage(const std::vector<TerrainLodPatch>& patches) {
+	std::vector<int> cov(size_t(kGrid) * kGrid, 0);
+	for (const TerrainLodPatch& p : patches) {
+		for (uint32_t z = p.cellZ0; z < uint32_t(p.cellZ0 + p.cellsZ); ++z) {
+			for (uint32_t x = p.cellX0; x < uint32_t(p.cellX0 + p.cellsX); ++x) {
+				++cov[size_t(z) * kGrid + x];
+			}
+		}
+	}
+	return cov;
+}
+
+// 閉じたメッシュなら内側の辺はちょうど 2 枚、外周の辺は 1 枚の三角形に使われる
+int EdgeViolations(const std::vector<uint32_t>& indices) {
+	std::map<std::pair<uint32_t, uint32_t>, int> edges;
+	for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+		for (int e = 0; e < 3; ++e) {
+			const uint32_t a = indices[t + e], b = indices[t + (e + 1) % 3];
+			++edges[{(std::min)(a, b), (std::max)(a, b)}];
+		}
+	}
+	int bad = 0;
+	for (const auto& [e, count] : edges) {
+		const uint32_t ax = e.first % (kGrid + 1), az = e.first / (kGrid + 1);
+		const uint32_t bx = e.second % (kGrid + 1), bz = e.second / (kGrid + 1);
+		const bool border = (ax == bx && (ax == 0 || ax == kGrid)) || (az == bz && (az == 0 || az == kGrid));
+		bad += count != (border ? 1 : 2);
+	}
+	return bad;
+}
+
+// 三角形の面積の合計（セル単位。向きもそろっていれば格子の面積になる）
+double SignedArea(const std::vector<uint32_t>& indices) {
+	double area = 0.0;
+	for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+		const double x0 = indices[t] % (kGrid + 1), z0 = indices[t] / (kGrid + 1);
+		const double x1 = indices[t + 1] % (kGrid + 1), z1 = indices[t + 1] / (kGrid + 1);
+		const double x2 = indices[t + 2] % (kGrid + 1), z2 = indices[t + 2] / (kGrid + 1);
+		area += 0.5 * ((x1 - x0) * (z2 - z0) - (x2 - x0) * (z1 - z0));
+	}
+	return area;
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+	TerrainHeightField field;
+	field.Initialize(kGrid, kGrid, kCell);
+	for (int i = 0; i < 300; ++i) {
+		field.StampDent(TerrainDent{{pos(rng), pos(rng)}, 4.0f, 0.8f});
+	}
+	TerrainHeightPyramid pyramid;
+	pyramid.Build(&field);
+	TerrainLodSelector selector;
+	selector.Initialize(&field, &pyramid, {});
+	TEST_CHECK(selector.LodCount() > 1);
+
+	// 1) 視錐台なし：どこから見ても覆い方は 1 回ずつ、継ぎ目は閉じている
+	std::vector<TerrainLodPatch> patches;
+	std::vector<uint32_t> indices;
+	int coverBad = 0, edgeBad = 0, areaBad = 0;
+	for (int k = 0; k < 50; ++k) {
+		const XMFLOAT3 eye{pos(rng) * 1.2f, 2.0f + float(rng() % 40), pos(rng) * 1.2f};
+		selector.Select(eye, nullptr, patches);
+		for (int c : Coverage(patches)) {
+			coverBad += c != 1;
+		}
+		TerrainLodSelector::BuildIndices(patches, kGrid, indices);
+		edgeBad += EdgeViolations(indices);
+		areaBad += std::fabs(std::fabs(SignedArea(indices)) - double(kGrid) * kGrid) > 1e-6;
+
+		// 足元は一番細かい LOD、細かさは距離とともに粗くなる
+		const int ex = int((eye.x + 0.5f * kGrid * kCell) / kCell), ez = int((eye.z + 0.5f * kGrid * kCell) / kCell);
+		for (const TerrainLodPatch& p : patches) {
+			if (ex >= p.cellX0 && ex < p.cellX0 + p.cellsX && ez >= p.cellZ0 && ez < p.cellZ0 + p.cellsZ && eye.y < 10.0f) {
+				TEST_CHECK(p.lod == 0);
+			}
+			TEST_CHECK(p.morph >= 0.0f && p.morph <= 1.0f);
+		}
+	}
+	TEST_CHECK(coverBad == 0);
+	TEST_CHECK(edgeBad == 0);
+	TEST_CHECK(areaBad == 0);
+
+	// 2) 視錐台あり：後ろのパッチは落ち、見えているところは残る。残った分の継ぎ目の辺はどれも 2 枚以下
+	const XMMATRIX proj = XMMatrixPerspectiveFovLH(0.8f, 16.0f / 9.0f, 0.1f, 1000.0f);
+	const XMFLOAT3 eye{0.0f, 6.0f, -10.0f};
+	XMFLOAT4 planes[6];
+	TerrainLodSelector::ExtractFrustumPlanes(XMMatrixLookAtLH(XMVectorSet(eye.x, eye.y, eye.z, 1.0f), XMVectorSet(0.0f, 0.0f, 20.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) * proj,
+	                                         planes);
+	selector.Select(eye, nullptr, patches);
+	const size_t allPatches = patches.size();
+	selector.Select(eye, planes, patches);
+	TEST_CHECK(!patches.empty() && patches.size() < allPatches);
+	const std::vector<int> cov = Coverage(patches);
+	TEST_CHECK(*std::max_element(cov.begin(), cov.end()) == 1);
+	const auto cellIndex = [](float x, float z) { return size_t(int((z + 0.5f * kGrid * kCell) / kCell)) * kGrid + size_t(int((x + 0.5f * kGrid * kCell) / kCell)); };
+	TEST_CHECK(cov[cellIndex(0.0f, 20.0f)] == 1);  // 正面
+	TEST_CHECK(cov[cellIndex(0.0f, -60.0f)] == 0); // 真後ろ
+
+	std::printf("50 eyes: coverage %d, edge %d, area %d violations | frustum %zu / %zu patches\n", coverBad, edgeBad, areaBad, patches.size(), allPatches);
+	return Test::Result("TerrainLodSelectorTest");
+}
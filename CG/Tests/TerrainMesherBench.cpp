@@ -0,0 +1,52 @@
+// CG/Tests/TerrainMesherBench.cpp
+// 凹み 1 回あたりの作り直し：全体（100 チャンク）と dirty なチャンクだけ
+#include "TestCommon.h"
+#include "Terrain/TerrainMesher.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+int main() {
+	constexpr uint32_t kGrid = 400;
+	constexpr float kCell = 0.8f;
+	const float extent = kGrid * kCell;
+
+	TerrainChunkGrid chunks;
+	chunks.Initialize(kGrid, kGrid, 40, kCell);
+	TerrainDentGrid dents;
+	dents.Initialize(-0.5f * extent, -0.5f * extent, 4.0f, uint32_t(std::ceil(extent / 4.0f)), uint32_t(std::ceil(extent / 4.0f)));
+	TerrainMeshDesc desc{kGrid, kGrid, kCell, &dents, nullptr};
+	std::vector<TerrainVertex> vertices(chunks.TotalVertices());
+
+	std::mt19937 rng(4);
+	std::uniform_real_distribution<float> pos(-170.0f, 170.0f);
+	std::vector<uint32_t> dirty;
+	constexpr int kSlams = 30;
+	double fullUs = 0.0, incrementalUs = 0.0;
+	size_t dirtyTotal = 0;
+	for (int s = 0; s < kSlams; ++s) {
+		const TerrainDentGrid::AddResult r = dents.Add(TerrainDent{{pos(rng), pos(rng)}, 4.0f, 1.0f});
+		if (r.merged) {
+			chunks.MarkDent(r.previous, 0.0f);
+		}
+		chunks.MarkDent(dents.Dent(r.index), 0.0f);
+
+		fullUs += Test::TimeUs([&] {
+			for (uint32_t i = 0; i < chunks.ChunkCount(); ++i) {
+				TerrainMeshChunk(desc, chunks.Chunk(i), vertices.data());
+			}
+		});
+		incrementalUs += Test::TimeUs([&] {
+			chunks.TakeDirty(dirty);
+			for (uint32_t i : dirty) {
+				TerrainMeshChunk(desc, chunks.Chunk(i), vertices.data());
+			}
+		});
+		dirtyTotal += dirty.size();
+	}
+	std::printf("400x400, 40-cell chunks: full rebuild %.2f ms/slam | dirty chunks only %.3f ms/slam (%.1f of %u chunks)\n", fullUs / kSlams / 1000.0, incrementalUs / kSlams / 1000.0,
+	            double(dirtyTotal) / kSlams, chunks.ChunkCount());
+	return 0;
+}
@@ -0,0 +1,110 @@
+// CG/Tests/TerrainMesherTest.cpp
+// チャンク単位の作り直し（TerrainChunkGrid + TerrainMeshChunk）が全体の作り直しとバイト単位で一致するか
+#include "TestCommon.h"
+#include "Terrain/TerrainMesher.h"
+#include "Terrain/TerrainSampler.h"
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+// Renderer と同じ大きさ
+constexpr uint32_t kGrid = 400;
+constexpr uint32_t kChunkCells = 40;
+constexpr float kCell = 0.8f;
+constexpr float kDentCellSize = 4.0f;
+
+void MeshAll(const TerrainMeshDesc& desc, const TerrainChunkGrid& chunks, std::vector<TerrainVertex>& out) {
+	for (uint32_t i = 0; i < chunks.ChunkCount(); ++i) {
+		TerrainMeshChunk(desc, chunks.Chunk(i), out.data());
+	}
+}
+
+} // namespace
+
+int main() {
+	TerrainChunkGrid chunks;
+	chunks.Initialize(kGrid, kGrid, kChunkCells, kCell);
+	const float extent = kGrid * kCell;
+	TerrainDentGrid dents;
+	dents.Initialize(-0.5f * extent, -0.5f * extent, kDentCellSize, uint32_t(std::ceil(extent / kDentCellSize)), uint32_t(std::ceil(extent / kDentCellSize)));
+	TerrainMeshDesc desc{kGrid, kGrid, kCell, &dents, nullptr};
+
+	// 各格子点はちょうど 1 つのチャンクが担当する
+	std::vector<int> owner(chunks.TotalVertices(), 0);
+	for (uint32_t i = 0; i < chunks.ChunkCount(); ++i) {
+		const TerrainChunkRect& c = chunks.Chunk(i);
+		for (uint32_t z = 0; z < c.vertsZ; ++z) {
+			for (uint32_t x = 0; x < c.vertsX; ++x) {
+				++owner[chunks.VertexIndex(c.cellX0 + x, c.cellZ0 + z)];
+			}
+		}
+	}
+	int ownerErrors = 0;
+	for (int n : owner) {
+		ownerErrors += n != 1;
+	}
+	TEST_CHECK(ownerErrors == 0);
+
+	// インデックスは 1 セル 2 三角形で、隣の格子点だけを指す
+	std::vector<uint32_t> indices(chunks.TotalIndices());
+	TerrainBuildIndices(kGrid, kGrid, indices.data());
+	const uint32_t cellIndex = 123 * kGrid + 45;
+	const uint32_t* tri = &indices[cellIndex * TerrainChunkGrid::kIndicesPerCell];
+	TEST_CHECK(tri[0] == chunks.VertexIndex(45, 123) && tri[1] == chunks.VertexIndex(46, 123) && tri[2] == chunks.VertexIndex(45, 124));
+	TEST_CHECK(tri[3] == chunks.VertexIndex(46, 123) && tri[4] == chunks.VertexIndex(46, 124) && tri[5] == chunks.VertexIndex(45, 124));
+
+	std::vector<TerrainVertex> incremental(chunks.TotalVertices()), full(chunks.TotalVertices());
+	MeshAll(desc, chunks, incremental);
+
+	// 凹みを 1 回ずつ足し、dirty なチャンクだけ作り直したものと全体を作り直したものを比べる
+	// （ほぼ同じ場所への凹みも混ぜて、まとめられたときの取り消し範囲も確かめる）
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> pos(-170.0f, 170.0f);
+	std::uniform_real_distribution<float> jitter(-0.3f, 0.3f);
+	std::vector<uint32_t> dirty;
+	int mismatches = 0;
+	size_t dirtyTotal = 0;
+	TerrainDent last{{0.0f, 0.0f}, 3.0f, 1.0f};
+	for (int s = 0; s < 60; ++s) {
+		TerrainDent d = (s % 4 == 3) ? TerrainDent{{last.centerXZ.x + jitter(rng), last.centerXZ.y + jitter(rng)}, last.radius, 0.5f} : TerrainDent{{pos(rng), pos(rng)}, 2.0f + float(s % 5), 1.0f};
+		last = d;
+
+		const TerrainDentGrid::AddResult r = dents.Add(d);
+		if (r.merged) {
+			chunks.MarkDent(r.previous, 0.0f);
+		}
+		chunks.MarkDent(dents.Dent(r.index), 0.0f);
+
+		chunks.TakeDirty(dirty);
+		dirtyTotal += dirty.size();
+		for (uint32_t i : dirty) {
+			TerrainMeshChunk(desc, chunks.Chunk(i), incremental.data());
+		}
+		MeshAll(desc, chunks, full);
+		mismatches += std::memcmp(incremental.data(), full.data(), full.size() * sizeof(TerrainVertex)) != 0;
+	}
+	TEST_CHECK(mismatches == 0);
+	// 1 回の凹みで作り直すのは数チャンク（全体は 100）
+	TEST_CHECK(dirtyTotal <= 60 * 9);
+
+	// 頂点は解析解（高さ + 勾配）そのもの
+	double maxErr = 0.0;
+	for (uint32_t iz = 0; iz <= kGrid; iz += 7) {
+		for (uint32_t ix = 0; ix <= kGrid; ix += 3) {
+			const TerrainVertex& v = full[chunks.VertexIndex(ix, iz)];
+			const TerrainSample s = TerrainSampleAt(&dents, v.pos.x, v.pos.z);
+			const Vector3 n = s.Normal();
+			maxErr = (std::max)({maxErr, double(std::fabs(v.pos.y - s.height)), double(std::fabs(v.nrm.x - n.x)), double(std::fabs(v.nrm.y - n.y)), double(std::fabs(v.nrm.z - n.z))});
+			maxErr = (std::max)(maxErr, double(std::fabs(v.pos.x - (float(ix) * kCell - 0.5f * extent))));
+		}
+	}
+	TEST_CHECK(maxErr == 0.0);
+
+	std::printf("owner errors %d, slam mismatches %d, dirty chunks %.2f per slam, vertex err %g\n", ownerErrors, mismatches, double(dirtyTotal) / 60.0, maxErr);
+	return Test::Result("TerrainMesherTest");
+}
@@ -0,0 +1,166 @@
+// CG/Tests/TerrainSamplerTest.cpp
+// TerrainSampler：解析的な勾配が「ベース地形 + 全凹みの高さ」の中心差分と一致するか（ドーナツ全体、凹みの縁、重なった凹み）
+// バッチ版が 1 点版と同じ値を返すか（4 の倍数でない個数、アラインしていない配列、変形レイヤーあり）
+#include "TestCommon.h"
+#include "Terrain/TerrainDeformationLayer.h"
+#include "Terrain/TerrainDentGrid.h"
+#include "Terrain/TerrainSampler.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+// 中心差分の刻みと許容誤差
+// 穴と凹みは 2 次式なので中心差分は丸め誤差しか持たない（凹みを何個も float で足した高さの誤差 ~1e-5 を 2h で割って 1e-3 弱）
+// 外側の坂は r の 1 次式で、差分の打ち切り誤差は h^2 / r ~ 1e-6 程度。係数を 1 つ間違えると 1e-1 くらいずれる
+constexpr float kH = 1e-2f;
+constexpr double kGradTol = 2e-3;
+
+// Renderer と同じ（320m 四方 / 4m セル）
+void InitGrid(TerrainDentGrid& g) { g.Initialize(-160.0f, -160.0f, 4.0f, 80, 80); }
+
+// ベース + 全凹みの高さ（セルを通さず全部足す）
+float ReferenceHeight(const std::vector<TerrainDent>& dents, float x, float z) { return TerrainHeightAnalytic(x, z, dents.data(), unsigned(dents.size())); }
+
+// 勾配が折れるところ（穴の縁、外側の坂の両端、凹みの縁）から中心差分の刻みより離れているか
+bool AwayFromKinks(const std::vector<TerrainDent>& dents, float x, float z) {
+	using namespace TerrainShape;
+	const float margin = 3.0f * kH;
+	const float r = std::sqrt(x * x + z * z);
+	for (float k : {kPitRadius, kOuterRingRadius, kOuterRingRadius + kOuterBlendWidth}) {
+		if (std::fabs(r - k) < margin)
+			return false;
+	}
+	for (const TerrainDent& d : dents) {
+		const float dx = x - d.centerXZ.x, dz = z - d.centerXZ.y;
+		if (std::fabs(std::sqrt(dx * dx + dz * dz) - d.radius) < margin)
+			return false;
+	}
+	return true;
+}
+
+// 解析的な勾配と中心差分の差（大きい方の軸）
+double GradientError(const TerrainDentGrid& grid, const std::vector<TerrainDent>& dents, float x, float z) {
+	const TerrainSample s = TerrainSampleAt(&grid, x, z);
+	const double fdx = (double(ReferenceHeight(dents, x + kH, z)) - ReferenceHeight(dents, x - kH, z)) / (2.0 * kH);
+	const double fdz = (double(ReferenceHeight(dents, x, z + kH)) - ReferenceHeight(dents, x, z - kH)) / (2.0 * kH);
+	TEST_CHECK_NEAR(s.height, ReferenceHeight(dents, x, z), 1e-4);
+	return (std::max)(std::fabs(s.dHdx - fdx), std::fabs(s.dHdz - fdz));
+}
+
+bool SameSample(const TerrainSample& a, const TerrainSample& b) {
+	auto near = [](float p, float q) { return std::fabs(p - q) <= 1e-5f * (1.0f + std::fabs(q)); };
+	return near(a.height, b.height) && near(a.dHdx, b.dHdx) && near(a.dHdz, b.dHdz);
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(5);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	// 凹み：ドーナツ全体にばらけたもの + 1 か所に 20 個重ねたもの
+	TerrainDentGrid grid;
+	InitGrid(grid);
+	std::vector<TerrainDent> dents;
+	for (int i = 0; i < 300; ++i) {
+		const float a = 6.2831853f * unit(rng), r = 115.0f * std::sqrt(unit(rng));
+		dents.push_back(TerrainDent{{r * std::cos(a), r * std::sin(a)}, 2.0f + 4.0f * unit(rng), 0.2f + unit(rng)});
+	}
+	for (int i = 0; i < 20; ++i) {
+		dents.push_back(TerrainDent{{60.0f + 3.0f * unit(rng), -20.0f + 3.0f * unit(rng)}, 2.0f + 3.0f * unit(rng), 0.2f + unit(rng)});
+	}
+	for (const TerrainDent& d : dents) {
+		grid.Add(d);
+	}
+	// 近いものはまとめられるので、比べる相手はまとめた後の凹み（セルを通さず全部足す）
+	dents = grid.Dents();
+
+	// 1) ドーナツ全体（穴、枠、外側の坂、その先）
+	{
+		double worst = 0.0;
+		int checked = 0;
+		for (int i = 0; i < 20000; ++i) {
+			const float a = 6.2831853f * unit(rng), r = 120.0f * std::sqrt(unit(rng));
+			const float x = r * std::cos(a), z = r * std::sin(a);
+			if (!AwayFromKinks(dents, x, z))
+				continue;
+			worst = (std::max)(worst, GradientError(grid, dents, x, z));
+			++checked;
+		}
+		TEST_CHECK(worst <= kGradTol);
+		TEST_CHECK(checked > 19000);
+		std::printf("donut: %d points, max |grad - central diff| %.2e\n", checked, worst);
+	}
+
+	// 2) 凹みの縁のすぐ内側 / 外側（半径の ±5% まで）
+	{
+		double worst = 0.0;
+		int checked = 0;
+		for (int i = 0; i < 20000; ++i) {
+			const TerrainDent& d = dents[rng() % dents.size()];
+			const float a = 6.2831853f * unit(rng), r = d.radius * (0.95f + 0.1f * unit(rng));
+			const float x = d.centerXZ.x + r * std::cos(a), z = d.centerXZ.y + r * std::sin(a);
+			if (!AwayFromKinks(dents, x, z))
+				continue;
+			worst = (std::max)(worst, GradientError(grid, dents, x, z));
+			++checked;
+		}
+		TEST_CHECK(worst <= kGradTol);
+		TEST_CHECK(checked > 10000);
+		std::printf("dent rims: %d points, max |grad - central diff| %.2e\n", checked, worst);
+	}
+
+	// 3) 20 個重なったところ
+	{
+		double worst = 0.0;
+		int checked = 0;
+		for (int i = 0; i < 20000; ++i) {
+			const float x = 56.0f + 11.0f * unit(rng), z = -24.0f + 11.0f * unit(rng);
+			if (!AwayFromKinks(dents, x, z))
+				continue;
+			worst = (std::max)(worst, GradientError(grid, dents, x, z));
+			++checked;
+		}
+		TEST_CHECK(worst <= kGradTol);
+		TEST_CHECK(checked > 10000);
+		std::printf("overlapping dents: %d points, max |grad - central diff| %.2e\n", checked, worst);
+	}
+
+	// 4) バッチ版 = 1 点版（端数の個数、1 つずらした配列、凹み / レイヤーのあり / なし）
+	{
+		TerrainDeformationLayer layer;
+		layer.Initialize(400, 400, 0.8f);
+		for (int i = 0; i < 200; ++i) {
+			layer.StampDent(TerrainDent{{-150.0f + 300.0f * unit(rng), -150.0f + 300.0f * unit(rng)}, 4.0f, 0.6f});
+		}
+		TEST_CHECK(!layer.IsEmpty());
+
+		std::vector<float> xs(1002), zs(1002);
+		for (size_t i = 0; i < xs.size(); ++i) {
+			xs[i] = -158.0f + 316.0f * unit(rng);
+			zs[i] = -158.0f + 316.0f * unit(rng);
+		}
+		int mismatches = 0;
+		for (size_t count : {size_t(0), size_t(1), size_t(2), size_t(3), size_t(4), size_t(5), size_t(7), size_t(13), size_t(1001)}) {
+			for (int mode = 0; mode < 4; ++mode) {
+				const TerrainDentGrid* g = (mode & 1) ? &grid : nullptr;
+				const TerrainDeformationLayer* l = (mode & 2) ? &layer : nullptr;
+				std::vector<TerrainSample> out(count + 1);
+				out[count].height = 12345.0f; // count より後ろは書かない
+				TerrainSampleBatch(g, xs.data() + 1, zs.data() + 1, count, out.data(), l);
+				for (size_t i = 0; i < count; ++i) {
+					mismatches += !SameSample(out[i], TerrainSampleAt(g, xs[i + 1], zs[i + 1], l));
+				}
+				TEST_CHECK(out[count].height == 12345.0f);
+			}
+		}
+		TEST_CHECK(mismatches == 0);
+	}
+
+	return Test::Result("TerrainSamplerTest");
+}
@@ -0,0 +1,40 @@
+// CG/Tests/TerrainSplatBakerBench.cpp
+// スプラットの焼き時間：全面（1 スレッド / 全スレッド）と、凹み 1 つぶんの焼き直し
+#include "TestCommon.h"
+#include "Terrain/TerrainDentGrid.h"
+#include "Terrain/TerrainSplatBaker.h"
+#include <algorithm>
+#include <random>
+#include <thread>
+
+using namespace Engine;
+
+int main() {
+	constexpr uint32_t kGrid = 400;
+	constexpr float kCell = 0.8f;
+
+	TerrainDentGrid dents;
+	dents.Initialize(-160.0f, -160.0f, 4.0f, 80, 80);
+	TerrainSplatBaker baker;
+	baker.Initialize(kGrid, kGrid, kCell);
+	baker.BakeAll(&dents, nullptr);
+
+	std::mt19937 rng(9);
+	std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+	constexpr int kSlams = 2000;
+	const double slamUs = Test::TimeUs([&] {
+		for (int i = 0; i < kSlams; ++i) {
+			const auto r = dents.Add(TerrainDent{{pos(rng), pos(rng)}, 4.0f, 1.5f});
+			if (r.merged) {
+				baker.BakeDent(r.previous, &dents, nullptr);
+			}
+			baker.BakeDent(dents.Dent(r.index), &dents, nullptr);
+		}
+	});
+
+	const double oneUs = Test::TimeUs([&] { baker.BakeAll(&dents, nullptr, 1); }, 3);
+	const double allUs = Test::TimeUs([&] { baker.BakeAll(&dents, nullptr); }, 3);
+	std::printf("%ux%u texels, %u dents: full bake 1 thread %.2f ms | %u threads %.2f ms | per slam %.1f us\n", kGrid, kGrid, dents.Count(), oneUs / 1000.0,
+	            (std::max)(std::thread::hardware_concurrency(), 1u), allUs / 1000.0, slamUs / kSlams);
+	return 0;
+}
@@ -0,0 +1,145 @@
+// CG/Tests/TerrainSplatBakerTest.cpp
+// TerrainSplatBaker：焼いた絵が 1 点ずつ計算した参照画像と合うか、スレッド数 / 部分焼き直しで変わらないか
+#include "TestCommon.h"
+#include "Terrain/TerrainDeformationLayer.h"
+#include "Terrain/TerrainDentGrid.h"
+#include "Terrain/TerrainHeightField.h"
+#include "Terrain/TerrainSampler.h"
+#include "Terrain/TerrainSplatBaker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace {
+
+constexpr uint32_t kGrid = 400;
+constexpr float kCell = 0.8f;
+
+uint32_t Channel(uint32_t t, int c) { return (t >> (8 * c)) & 0xFF; }
+
+// 参照画像：テクセル中心で 1 点版の TerrainSampleAt を引いて重みにする（焼く側はバッチ版）
+std::vector<uint32_t> ReferenceImage(const TerrainDentGrid* dents, const TerrainDeformationLayer* layer, const TerrainSplatBaker::Rule& rule) {
+	std::vector<uint32_t> img(size_t(kGrid) * kGrid);
+	const float origin = -0.5f * kGrid * kCell;
+	for (uint32_t z = 0; z < kGrid; ++z) {
+		for (uint32_t x = 0; x < kGrid; ++x) {
+			const TerrainSample s = TerrainSampleAt(dents, origin + (float(x) + 0.5f) * kCell, origin + (float(z) + 0.5f) * kCell, layer);
+			img[size_t(z) * kGrid + x] = TerrainSplatBaker::Weights(s.height, std::sqrt(s.dHdx * s.dHdx + s.dHdz * s.dHdz), rule);
+		}
+	}
+	return img;
+}
+
+// 参照画像との差（チャンネルごとの最大差）。バッチ版と 1 点版の丸めの違いで境目の 1 段だけずれうる
+uint32_t MaxChannelDiff(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+	uint32_t e = 0;
+	for (size_t i = 0; i < a.size(); ++i) {
+		for (int c = 0; c < 3; ++c) {
+			e = (std::max)(e, uint32_t(std::abs(int(Channel(a[i], c)) - int(Channel(b[i], c)))));
+		}
+	}
+	return e;
+}
+
+size_t CountDiff(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+	size_t n = 0;
+	for (size_t i = 0; i < a.size(); ++i) {
+		n += a[i] != b[i];
+	}
+	return n;
+}
+
+} // namespace
+
+int main() {
+	const TerrainSplatBaker::Rule rule{};
+
+	// 1) 重みの決め方：帯の中央と急斜面
+	const uint32_t low = TerrainSplatBaker::Weights(rule.rockEnd - 2.0f, 0.0f, rule);
+	const uint32_t mid = TerrainSplatBaker::Weights(0.5f * (rule.rockEnd + rule.dirtEnd), 0.0f, rule);
+	const uint32_t high = TerrainSplatBaker::Weights(rule.dirtEnd + 2.0f, 0.0f, rule);
+	const uint32_t steep = TerrainSplatBaker::Weights(rule.dirtEnd + 2.0f, rule.slopeRockFull + 0.1f, rule);
+	TEST_CHECK(Channel(low, 2) == 255);
+	TEST_CHECK(Channel(mid, 0) == 255);
+	TEST_CHECK(Channel(high, 1) == 255);
+	TEST_CHECK(Channel(steep, 2) == 255);
+	// 斜面が急になるほど岩は減らない
+	uint32_t prevRock = 0;
+	for (int i = 0; i <= 40; ++i) {
+		const uint32_t rock = Channel(TerrainSplatBaker::Weights(rule.dirtEnd + 2.0f, 0.05f * float(i), rule), 2);
+		TEST_CHECK(rock >= prevRock);
+		prevRock = rock;
+	}
+
+	// 2) 凹みなしの全面：参照画像と一致
+	TerrainDentGrid dents;
+	dents.Initialize(-160.0f, -160.0f, 4.0f, 80, 80);
+	TerrainSplatBaker baker;
+	baker.Initialize(kGrid, kGrid, kCell);
+	baker.BakeAll(&dents, nullptr, 1);
+	TEST_CHECK(MaxChannelDiff(baker.Texels(), ReferenceImage(&dents, nullptr, rule)) <= 1);
+
+	// 3) 凹みを入れるたびにその下だけ焼き直す（合体したら前の形の下も）
+	std::mt19937 rng(9);
+	std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+	std::vector<TerrainSplatBaker::Rect> dirty;
+	baker.TakeDirty(dirty);
+	for (int i = 0; i < 500; ++i) {
+		const auto r = dents.Add(TerrainDent{{pos(rng), pos(rng)}, 4.0f, 1.5f});
+		if (r.merged) {
+			baker.BakeDent(r.previous, &dents, nullptr);
+		}
+		baker.BakeDent(dents.Dent(r.index), &dents, nullptr);
+	}
+	baker.TakeDirty(dirty);
+	TEST_CHECK(!dirty.empty());
+
+	TerrainSplatBaker full1, fullN;
+	full1.Initialize(kGrid, kGrid, kCell);
+	fullN.Initialize(kGrid, kGrid, kCell);
+	full1.BakeAll(&dents, nullptr, 1);
+	fullN.BakeAll(&dents, nullptr, 8);
+	TEST_CHECK(CountDiff(full1.Texels(), fullN.Texels()) == 0); // スレッド数で変わらない
+	TEST_CHECK(CountDiff(full1.Texels(), baker.Texels()) == 0); // 部分焼き直し = 全面
+	const std::vector<uint32_t> reference = ReferenceImage(&dents, nullptr, rule);
+	const uint32_t dentDiff = MaxChannelDiff(full1.Texels(), reference);
+	TEST_CHECK(dentDiff <= 1);
+
+	// 凹みで岩や土が出ている（全部草のままではない）
+	size_t nonGrass = 0;
+	for (uint32_t t : full1.Texels()) {
+		TEST_CHECK(Channel(t, 0) + Channel(t, 1) + Channel(t, 2) == 255);
+		nonGrass += Channel(t, 1) != 255;
+	}
+	TEST_CHECK(nonGrass > 0);
+
+	// 4) 変形レイヤー（読み込んだ地形）からでも同じ参照画像に合う
+	TerrainHeightField field;
+	field.Initialize(kGrid, kGrid, kCell);
+	for (uint32_t i = 0; i < dents.Count(); ++i) {
+		field.StampDent(dents.Dent(i));
+	}
+	TerrainDeformationLayer layer;
+	layer.Initialize(kGrid, kGrid, kCell);
+	TEST_CHECK(layer.CaptureFrom(field));
+	TerrainSplatBaker fromLayer;
+	fromLayer.Initialize(kGrid, kGrid, kCell);
+	fromLayer.BakeAll(nullptr, &layer);
+	TEST_CHECK(MaxChannelDiff(fromLayer.Texels(), ReferenceImage(nullptr, &layer, rule)) <= 1);
+
+	// 5) 範囲外の凹み・空の範囲では何も焼かない
+	TerrainSplatBaker outside;
+	outside.Initialize(kGrid, kGrid, kCell);
+	outside.TakeDirty(dirty);
+	outside.BakeDent(TerrainDent{{1000.0f, 1000.0f}, 4.0f, 1.0f}, &dents, nullptr);
+	outside.BakeRect({10, 10, 5, 5}, &dents, nullptr);
+	outside.TakeDirty(dirty);
+	TEST_CHECK(dirty.empty());
+
+	std::printf("%u dents, max channel diff vs reference image %u, %zu / %zu texels not pure grass\n", dents.Count(), dentDiff, nonGrass, reference.size());
+	return Test::Result("TerrainSplatBakerTest");
+}
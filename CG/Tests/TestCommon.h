@@ -0,0 +1,59 @@
+// CG/Tests/TestCommon.h
+#pragma once
+// =======================================
+//  ヘッドレステスト用の小さな道具
+//  - TEST_CHECK は失敗しても止めずに数える（最後に TestResult() で終了コードにする）
+//  - 時間計測はベンチマーク用（std::chrono::steady_clock）
+// =======================================
+#include <chrono>
+#include <cstdio>
+
+namespace Test {
+
+inline int& Failures() {
+	static int failures = 0;
+	return failures;
+}
+
+inline void Fail(const char* file, int line, const char* expr) {
+	++Failures();
+	std::printf("FAILED %s(%d): %s\n", file, line, expr);
+}
+
+// 失敗があれば 1（main から返す）
+inline int Result(const char* name) {
+	if (Failures() == 0) {
+		std::printf("%s: OK\n", name);
+		return 0;
+	}
+	std::printf("%s: %d failure(s)\n", name, Failures());
+	return 1;
+}
+
+// f() を repeat 回呼んだ 1 回あたりの時間（マイクロ秒）
+template <class F> double TimeUs(F&& f, int repeat = 1) {
+	const auto t0 = std::chrono::steady_clock::now();
+	for (int i = 0; i < repeat; ++i) {
+		f();
+	}
+	const auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::micro>(t1 - t0).count() / double(repeat);
+}
+
+} // namespace Test
+
+#define TEST_CHECK(expr) \
+	do { \
+		if (!(expr)) \
+			::Test::Fail(__FILE__, __LINE__, #expr); \
+	} while (0)
+
+// 差が tol 以下か（失敗したら値も出す）
+#define TEST_CHECK_NEAR(a, b, tol) \
+	do { \
+		const double test_a_ = double(a), test_b_ = double(b); \
+		if (!(test_a_ - test_b_ <= double(tol) && test_b_ - test_a_ <= double(tol))) { \
+			std::printf("  %s = %g, %s = %g\n", #a, test_a_, #b, test_b_); \
+			::Test::Fail(__FILE__, __LINE__, #a " ~= " #b); \
+		} \
+	} while (0)
@@ -0,0 +1,57 @@
+// CG/Tests/WaterClipmapBench.cpp
+// 島のあるステージでのカリングの内訳、描くインデックス数と Select の時間
+#include "TestCommon.h"
+#include "Terrain/TerrainHeightField.h"
+#include "Terrain/TerrainHeightPyramid.h"
+#include "Terrain/TerrainLodSelector.h"
+#include "Water/WaterClipmap.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+int main() {
+	TerrainHeightField field;
+	field.Initialize(400, 400, 1.0f);
+	for (uint32_t z = 0; z < field.SamplesZ(); ++z) {
+		for (uint32_t x = 0; x < field.SamplesX(); ++x) {
+			const float r = std::sqrt(field.SampleX(x) * field.SampleX(x) + field.SampleZ(z) * field.SampleZ(z));
+			field.AddSample(x, z, 30.0f * (std::max)(0.0f, 1.0f - r / 150.0f));
+		}
+	}
+	TerrainHeightPyramid pyramid;
+	pyramid.Build(&field);
+
+	WaterClipmap clipmap;
+	clipmap.Initialize({});
+	clipmap.SetTerrainQuery([&](float x0, float z0, float x1, float z1, float& lo) { return pyramid.MinHeightInRect(x0, z0, x1, z1, lo); });
+	std::vector<XMFLOAT2> verts;
+	std::vector<uint32_t> indices;
+	clipmap.BuildPatchMesh(verts, indices);
+
+	struct Camera {
+		const char* name;
+		XMFLOAT3 eye, dir;
+	};
+	const Camera cameras[] = {
+	    {"on island, looking across", {0.0f, 32.0f, 0.0f}, {1.0f, -0.1f, 0.3f}},
+	    {"shore, looking inland", {140.0f, 3.0f, 0.0f}, {-1.0f, -0.05f, 0.0f}},
+	    {"shore, looking out", {140.0f, 3.0f, 0.0f}, {1.0f, -0.05f, 0.0f}},
+	    {"high overview", {0.0f, 120.0f, -250.0f}, {0.0f, -0.5f, 1.0f}},
+	};
+	const XMMATRIX proj = XMMatrixPerspectiveFovLH(0.8f, 16.0f / 9.0f, 0.1f, 2000.0f);
+	std::vector<WaterPatch> patches;
+	for (const Camera& c : cameras) {
+		const XMMATRIX view = XMMatrixLookAtLH(XMLoadFloat3(&c.eye), XMVectorSet(c.eye.x + c.dir.x, c.eye.y + c.dir.y, c.eye.z + c.dir.z, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMFLOAT4 planes[6];
+		TerrainLodSelector::ExtractFrustumPlanes(view * proj, planes);
+		const double us = Test::TimeUs([&] { clipmap.Select(c.eye, planes, -2.0f, 2.5f, 1.5f, patches); }, 1000);
+		const WaterCullStats& s = clipmap.Stats();
+		const size_t total = size_t(s.drawn + s.frustumCulled + s.terrainCulled);
+		std::printf("%-26s: drawn %3u, frustum %3u, terrain %3u -> indices %6zu of %6zu | select %.3f ms\n", c.name, s.drawn, s.frustumCulled, s.terrainCulled, size_t(s.drawn) * indices.size(),
+		            total * indices.size(), us / 1000.0);
+	}
+	return 0;
+}
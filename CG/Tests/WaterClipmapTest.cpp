@@ -0,0 +1,239 @@
+// CG/Tests/WaterClipmapTest.cpp
+// WaterClipmap のカリング：見えうるパッチを捨てていないか（総当たりと比べる）、内訳の数が合うか
+// 継ぎ目：隣り合うパッチの LOD の差が 1 までで、共有する辺の寄せたあとの頂点が両側で同じか（条件を満たさない Desc も直して閉じるか）
+#include "TestCommon.h"
+#include "Terrain/TerrainHeightField.h"
+#include "Terrain/TerrainHeightPyramid.h"
+#include "Terrain/TerrainLodSelector.h"
+#include "Water/WaterClipmap.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+namespace {
+
+// ベース + 中央の島 + 凹み
+void BuildIsland(TerrainHeightField& f, std::mt19937& rng) {
+	f.Initialize(400, 400, 1.0f);
+	for (uint32_t z = 0; z < f.SamplesZ(); ++z) {
+		for (uint32_t x = 0; x < f.SamplesX(); ++x) {
+			const float r = std::sqrt(f.SampleX(x) * f.SampleX(x) + f.SampleZ(z) * f.SampleZ(z));
+			f.AddSample(x, z, 30.0f * (std::max)(0.0f, 1.0f - r / 150.0f));
+		}
+	}
+	std::uniform_real_distribution<float> pos(-180.0f, 180.0f);
+	for (int i = 0; i < 200; ++i) {
+		f.StampDent(TerrainDent{{pos(rng), pos(rng)}, 5.0f, 3.0f});
+	}
+}
+
+// VS と同じ寄せ（morph = false なら寄せない）
+XMFLOAT2 Morph(const WaterClipmap& cm, const WaterPatch& p, float gx, float gz, const XMFLOAT3& eye, float base, bool morph) {
+	const float x = p.x0 + gx * p.cell, z = p.z0 + gz * p.cell;
+	float start, end;
+	cm.MorphRange(uint32_t(p.lod), start, end);
+	const float d = std::sqrt((x - eye.x) * (x - eye.x) + (base - eye.y) * (base - eye.y) + (z - eye.z) * (z - eye.z));
+	float k = std::clamp((d - start) / (end - start), 0.0f, 1.0f);
+	if (!morph || uint32_t(p.lod) + 1 >= cm.LodCount()) {
+		k = 0.0f; // 最上段は寄せる先がない
+	}
+	gx -= (gx * 0.5f - std::floor(gx * 0.5f)) * 2.0f * k;
+	gz -= (gz * 0.5f - std::floor(gz * 0.5f)) * 2.0f * k;
+	return {p.x0 + gx * p.cell, p.z0 + gz * p.cell};
+}
+
+struct SeamStats {
+	int edges = 0;   // 共有する辺の数
+	int lodJumps = 0; // LOD が 2 段以上違う隣
+	int cracks = 0;  // 寄せたあとの頂点が両側で違う辺
+};
+
+// パッチ A の +X（+Z）辺と B の -X（-Z）辺が重なるところで、重なりに載る寄せたあとの頂点の集合を比べる
+void CheckSeams(const WaterClipmap& cm, const std::vector<WaterPatch>& patches, const XMFLOAT3& eye, float base, bool morph, SeamStats& st) {
+	const uint32_t cells = cm.GetDesc().patchCells;
+	const float n = float(cells);
+	for (const WaterPatch& a : patches) {
+		for (const WaterPatch& b : patches) {
+			const float sa = a.cell * n, sb = b.cell * n;
+			for (int axis = 0; axis < 2; ++axis) {
+				const float aEdge = axis == 0 ? a.x0 + sa : a.z0 + sa;
+				const float bEdge = axis == 0 ? b.x0 : b.z0;
+				if (std::fabs(aEdge - bEdge) > 1e-3f)
+					continue;
+				const float a0 = axis == 0 ? a.z0 : a.x0, b0 = axis == 0 ? b.z0 : b.x0;
+				const float lo = (std::max)(a0, b0), hi = (std::min)(a0 + sa, b0 + sb);
+				if (hi - lo < 1e-3f)
+					continue;
+				++st.edges;
+				st.lodJumps += std::fabs(a.lod - b.lod) > 1.0f;
+
+				// 1cm 単位にそろえて比べる（頂点はどれも格子の上）
+				std::set<long> va, vb;
+				for (uint32_t i = 0; i <= cells; ++i) {
+					const XMFLOAT2 ma = axis == 0 ? Morph(cm, a, n, float(i), eye, base, morph) : Morph(cm, a, float(i), n, eye, base, morph);
+					const XMFLOAT2 mb = axis == 0 ? Morph(cm, b, 0.0f, float(i), eye, base, morph) : Morph(cm, b, float(i), 0.0f, eye, base, morph);
+					const float ta = axis == 0 ? ma.y : ma.x, tb = axis == 0 ? mb.y : mb.x;
+					if (ta >= lo - 1e-3f && ta <= hi + 1e-3f) {
+						va.insert(std::lround(ta * 100.0f));
+					}
+					if (tb >= lo - 1e-3f && tb <= hi + 1e-3f) {
+						vb.insert(std::lround(tb * 100.0f));
+					}
+				}
+				st.cracks += va != vb;
+			}
+		}
+	}
+}
+
+// 40 通りのカメラ（半分は視錐台カリングあり）で継ぎ目を数える
+SeamStats SeamsOverCameras(WaterClipmap& cm, bool morph) {
+	const float base = -2.0f, amp = 3.0f;
+	const XMMATRIX proj = XMMatrixPerspectiveFovLH(0.8f, 16.0f / 9.0f, 0.1f, 2000.0f);
+	SeamStats st;
+	std::vector<WaterPatch> patches;
+	for (int i = 0; i < 40; ++i) {
+		const float a = float(i) * 0.61f;
+		const XMFLOAT3 eye{std::cos(a) * 7.46f * float(i), 1.0f + float(i) * 0.7f, std::sin(a) * 5.82f * float(i)};
+		const XMMATRIX view = XMMatrixLookAtLH(XMLoadFloat3(&eye), XMVectorSet(eye.x + 1.0f, eye.y - 0.3f, eye.z + 0.5f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMFLOAT4 planes[6];
+		TerrainLodSelector::ExtractFrustumPlanes(view * proj, planes);
+		cm.Select(eye, i % 2 == 0 ? planes : nullptr, base, amp, amp, patches);
+		CheckSeams(cm, patches, eye, base, morph, st);
+	}
+	return st;
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 rng(5);
+	TerrainHeightField field;
+	BuildIsland(field, rng);
+	TerrainHeightPyramid pyramid;
+	pyramid.Build(&field);
+	std::uniform_real_distribution<float> pos(-180.0f, 180.0f);
+
+	// 1) 地形の最低の高さは総当たりの最小より高くならない（高いと見えるパッチを捨てる）
+	int rects = 0, over = 0;
+	for (int k = 0; k < 5000; ++k) {
+		const float x0 = pos(rng), z0 = pos(rng);
+		const float x1 = x0 + std::exp2(float(rng() % 7)), z1 = z0 + std::exp2(float(rng() % 7));
+		float lo;
+		if (!pyramid.MinHeightInRect(x0, z0, x1, z1, lo))
+			continue;
+		++rects;
+		float brute = (std::min)({field.HeightAt(x1, z0), field.HeightAt(x0, z1), field.HeightAt(x1, z1)});
+		for (float z = z0; z <= z1; z += 0.25f) {
+			for (float x = x0; x <= x1; x += 0.25f) {
+				brute = (std::min)(brute, field.HeightAt(x, z));
+			}
+		}
+		over += lo > brute + 1e-4f;
+	}
+	TEST_CHECK(rects > 1000);
+	TEST_CHECK(over == 0);
+
+	// 2) いろいろなカメラで：カリングありの結果は、箱が視錐台に入り地形から水面が出うるパッチを全部含む
+	WaterClipmap clipmap;
+	WaterClipmap::Desc desc;
+	clipmap.Initialize(desc);
+	clipmap.SetTerrainQuery([&](float x0, float z0, float x1, float z1, float& lo) { return pyramid.MinHeightInRect(x0, z0, x1, z1, lo); });
+	WaterClipmap noTerrain = clipmap;
+	noTerrain.SetTerrainQuery(nullptr);
+
+	const float base = -2.0f, amp = 2.5f, margin = 1.5f;
+	const XMMATRIX proj = XMMatrixPerspectiveFovLH(0.8f, 16.0f / 9.0f, 0.1f, 2000.0f);
+	std::vector<WaterPatch> all, frustumOnly, got;
+	int missing = 0, badStats = 0;
+	size_t terrainCulled = 0;
+	for (int i = 0; i < 60; ++i) {
+		const float a = float(i) * 0.37f;
+		const XMFLOAT3 eye{std::cos(a) * (20.0f + i * 3.0f), 3.0f + float(i % 5) * 12.0f + (i % 3 == 0 ? 25.0f : 0.0f), std::sin(a) * (20.0f + i * 3.0f)};
+		const float ay = a * 2.1f;
+		const XMMATRIX view = XMMatrixLookAtLH(XMLoadFloat3(&eye), XMVectorSet(eye.x + std::cos(ay), eye.y - 0.35f, eye.z + std::sin(ay), 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMFLOAT4 planes[6];
+		TerrainLodSelector::ExtractFrustumPlanes(view * proj, planes);
+
+		noTerrain.Select(eye, nullptr, base, amp, margin, all);
+		noTerrain.Select(eye, planes, base, amp, margin, frustumOnly);
+		clipmap.Select(eye, planes, base, amp, margin, got);
+		const WaterCullStats& s = clipmap.Stats();
+		badStats += s.drawn + s.frustumCulled + s.terrainCulled != all.size() || s.drawn != got.size();
+		badStats += got.size() > frustumOnly.size();
+		terrainCulled += s.terrainCulled;
+
+		std::set<std::tuple<float, float, float>> drawn;
+		for (const WaterPatch& p : got) {
+			drawn.insert({p.x0, p.z0, p.cell});
+		}
+		for (const WaterPatch& p : all) {
+			const float size = p.cell * float(desc.patchCells);
+			const XMFLOAT3 lo{p.x0 - margin, base - amp, p.z0 - margin}, hi{p.x0 + size + margin, base + amp, p.z0 + size + margin};
+			bool inFrustum = true;
+			for (const XMFLOAT4& pl : planes) {
+				const float x = pl.x >= 0.0f ? hi.x : lo.x, y = pl.y >= 0.0f ? hi.y : lo.y, z = pl.z >= 0.0f ? hi.z : lo.z;
+				inFrustum = inFrustum && pl.x * x + pl.y * y + pl.z * z + pl.w >= 0.0f;
+			}
+			if (!inFrustum)
+				continue;
+			bool exposed = false;
+			const float step = (std::max)(0.25f, (hi.x - lo.x) / 64.0f);
+			for (float z = lo.z; z <= hi.z && !exposed; z += step) {
+				for (float x = lo.x; x <= hi.x && !exposed; x += step) {
+					exposed = !field.Contains(x, z) || field.HeightAt(x, z) <= hi.y;
+				}
+			}
+			missing += exposed && !drawn.count({p.x0, p.z0, p.cell});
+		}
+	}
+	TEST_CHECK(missing == 0);
+	TEST_CHECK(badStats == 0);
+	TEST_CHECK(terrainCulled > 0); // 島の下のパッチは実際に捨てている
+
+	std::printf("%d rects, min height overestimates %d | 60 cameras: visible patches missing %d, bad stats %d, terrain culled %zu\n", rects, over, missing, badStats, terrainCulled);
+
+	// 3) 継ぎ目：既定値、条件を満たさない Desc（Initialize で直る）、ほかの満たす組み合わせ
+	{
+		struct Case {
+			float rangeScale, morphStartRatio;
+			uint32_t patchCells, lodCount;
+		};
+		const Case cases[] = {{4.0f, 0.75f, 16, 7}, {3.0f, 0.7f, 16, 7}, {2.0f, 0.5f, 16, 7}, {6.0f, 0.5f, 8, 6}, {3.0f, 0.95f, 32, 5}};
+		for (const Case& c : cases) {
+			WaterClipmap cm;
+			WaterClipmap::Desc d;
+			d.rangeScale = c.rangeScale;
+			d.morphStartRatio = c.morphStartRatio;
+			d.patchCells = c.patchCells;
+			d.lodCount = c.lodCount;
+			cm.Initialize(d);
+			const WaterClipmap::Desc& fixed = cm.GetDesc();
+			TEST_CHECK(fixed.morphStartRatio * fixed.rangeScale >= WaterClipmap::kSeamProduct * 0.9999f);
+			TEST_CHECK(fixed.morphStartRatio <= WaterClipmap::kMaxMorphStartRatio);
+			// 満たしている Desc はそのまま
+			if (c.rangeScale * c.morphStartRatio >= WaterClipmap::kSeamProduct) {
+				TEST_CHECK(fixed.rangeScale == c.rangeScale && fixed.morphStartRatio == c.morphStartRatio);
+			}
+
+			const SeamStats st = SeamsOverCameras(cm, true);
+			TEST_CHECK(st.edges > 1000);
+			TEST_CHECK(st.lodJumps == 0);
+			TEST_CHECK(st.cracks == 0);
+			std::printf("seams (range %.2f, morph start %.3f, %u cells, %u LODs): %d shared edges, LOD jumps %d, cracks %d\n", fixed.rangeScale, fixed.morphStartRatio,
+			            fixed.patchCells, fixed.lodCount, st.edges, st.lodJumps, st.cracks);
+		}
+
+		// 寄せなければ LOD の境で割れる（この確かめ方で割れ目が見つかること）
+		WaterClipmap cm;
+		cm.Initialize(WaterClipmap::Desc{});
+		TEST_CHECK(SeamsOverCameras(cm, false).cracks > 0);
+	}
+	return Test::Result("WaterClipmapTest");
+}
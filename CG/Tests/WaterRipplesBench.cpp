@@ -0,0 +1,33 @@
+// CG/Tests/WaterRipplesBench.cpp
+// 波紋 1 ステップの時間（格子の大きさとスレッド数ごと）
+#include "TestCommon.h"
+#include "Water/WaterRipples.h"
+#include <algorithm>
+#include <thread>
+
+using namespace Engine;
+
+int main() {
+	const uint32_t hw = (std::max)(std::thread::hardware_concurrency(), 1u);
+	for (uint32_t n : {128u, 256u, 512u}) {
+		for (uint32_t threads : {1u, hw}) {
+			WaterRipples r;
+			WaterRipples::Desc d;
+			d.resolution = n;
+			d.threads = threads;
+			r.Initialize(d);
+			r.AddImpulse(0.0f, 0.0f, 3.0f, 0.5f);
+			uint32_t steps = 0;
+			const double us = Test::TimeUs([&] {
+				for (int i = 0; i < 600; ++i) {
+					r.Update(r.StepSeconds());
+					steps += r.LastSteps();
+				}
+			});
+			std::printf("n=%4u threads %2u: %.3f ms/step (step %.4f s)\n", n, threads, us / 1000.0 / (std::max)(steps, 1u), r.StepSeconds());
+			if (hw == 1)
+				break;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,133 @@
+// CG/Tests/WaterRipplesTest.cpp
+// WaterRipples：エネルギーの保存 / 減衰、インパルスの対称性、大きな dt での安定、スクロール、スレッド数
+#include "TestCommon.h"
+#include "Water/WaterRipples.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace Engine;
+
+int main() {
+	// 1) 減衰なし・吸収層なし：1 秒間エネルギーはほぼ一定（陽解法の離散エネルギーなので数 % 揺れる）
+	{
+		WaterRipples r;
+		WaterRipples::Desc d;
+		d.damping = 0.0f;
+		d.spongeCells = 0;
+		TEST_CHECK(r.Initialize(d));
+		r.AddImpulse(0.0f, 0.0f, 2.0f, 0.3f);
+		r.Update(r.StepSeconds());
+		const double e0 = r.Energy();
+		double lo = e0, hi = e0;
+		for (int i = 0; i < 60; ++i) {
+			r.Update(r.StepSeconds());
+			lo = (std::min)(lo, r.Energy());
+			hi = (std::max)(hi, r.Energy());
+		}
+		TEST_CHECK(e0 > 0.0);
+		TEST_CHECK(lo / e0 > 0.9 && hi / e0 < 1.1);
+		std::printf("no damping, 1 s: energy %.4f..%.4f of start\n", lo / e0, hi / e0);
+	}
+
+	// 2) 減衰あり：2 秒で e^{-2 damping t}、0.25 秒ごとに見て増えない
+	{
+		WaterRipples r;
+		WaterRipples::Desc d;
+		d.spongeCells = 0;
+		TEST_CHECK(r.Initialize(d));
+		r.AddImpulse(0.0f, 0.0f, 2.0f, 0.3f);
+		r.Update(r.StepSeconds());
+		const double e0 = r.Energy();
+		double window = e0 * 10.0;
+		int increased = 0;
+		for (int i = 0; i < 120; ++i) {
+			r.Update(r.StepSeconds());
+			if (i % 15 == 14) {
+				increased += r.Energy() > window;
+				window = r.Energy();
+			}
+		}
+		const double expected = std::exp(-2.0 * d.damping * 2.0);
+		TEST_CHECK_NEAR(r.Energy() / e0, expected, 0.1 * expected);
+		TEST_CHECK(increased == 0);
+		std::printf("damping %.1f, 2 s: energy %.4f of start (e^-%.1f = %.4f)\n", d.damping, r.Energy() / e0, 4.0 * d.damping, expected);
+	}
+
+	// 3) 既定（吸収層あり）：10 秒でほぼ消える
+	{
+		WaterRipples r;
+		TEST_CHECK(r.Initialize({}));
+		r.AddImpulse(0.0f, 0.0f, 2.0f, 0.3f);
+		r.Update(r.StepSeconds());
+		const double e0 = r.Energy();
+		for (int i = 0; i < 600; ++i) {
+			r.Update(r.StepSeconds());
+		}
+		TEST_CHECK(r.Energy() / e0 < 1e-4);
+	}
+
+	// 4) 中心のインパルスは x / z の鏡映と転置で対称のまま（スレッド数を変えても同じ）
+	for (uint32_t threads : {1u, 4u}) {
+		WaterRipples r;
+		WaterRipples::Desc d;
+		d.threads = threads;
+		TEST_CHECK(r.Initialize(d));
+		r.AddImpulse(0.0f, 0.0f, 3.0f, 0.5f); // セル (n/2, n/2) がワールドの原点
+		for (int i = 0; i < 90; ++i) {
+			r.Update(r.StepSeconds());
+		}
+		const auto& h = r.Heights();
+		const int n = int(r.Resolution()), c = n / 2;
+		double mirror = 0.0, maxH = 0.0;
+		for (int z = 1; z < n - 1; ++z) {
+			for (int x = 1; x < n - 1; ++x) {
+				const int mx = 2 * c - x, mz = 2 * c - z;
+				if (mx >= n || mz >= n)
+					continue;
+				const float v = h[size_t(z) * n + x];
+				maxH = (std::max)(maxH, double(std::fabs(v)));
+				mirror = (std::max)({mirror, double(std::fabs(v - h[size_t(z) * n + mx])), double(std::fabs(v - h[size_t(mz) * n + x])), double(std::fabs(v - h[size_t(x) * n + z]))});
+			}
+		}
+		TEST_CHECK(maxH > 1e-3);
+		TEST_CHECK(mirror == 0.0);
+	}
+
+	// 5) 大きな dt でも発散しない（1 回の Update は maxSteps まで）
+	{
+		WaterRipples r;
+		WaterRipples::Desc d;
+		TEST_CHECK(r.Initialize(d));
+		r.AddImpulse(1.0f, 1.0f, 2.0f, 0.5f);
+		const float dts[] = {0.5f, 5.0f, 0.1f, 1.0f, 0.033f};
+		float maxH = 0.0f;
+		bool finite = true;
+		for (int k = 0; k < 50; ++k) {
+			r.Update(dts[k % 5]);
+			TEST_CHECK(r.LastSteps() <= d.maxSteps);
+			for (float v : r.Heights()) {
+				maxH = (std::max)(maxH, std::fabs(v));
+				finite = finite && std::isfinite(v);
+			}
+		}
+		TEST_CHECK(finite);
+		TEST_CHECK(maxH <= 0.5f);
+	}
+
+	// 6) 格子をスクロールしてもワールドの同じ点の高さは変わらない
+	{
+		WaterRipples r;
+		TEST_CHECK(r.Initialize({}));
+		r.AddImpulse(2.0f, 3.0f, 3.0f, 0.5f);
+		for (int i = 0; i < 20; ++i) {
+			r.Update(1.0f / 60.0f);
+		}
+		const float before = r.HeightAt(2.3f, 3.7f);
+		r.SetCenter(5.1f, -3.4f);
+		TEST_CHECK(before != 0.0f);
+		TEST_CHECK(r.HeightAt(2.3f, 3.7f) == before);
+		TEST_CHECK(r.HeightAt(1000.0f, 0.0f) == 0.0f); // 格子の外
+	}
+
+	return Test::Result("WaterRipplesTest");
+}
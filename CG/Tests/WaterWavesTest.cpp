@@ -0,0 +1,115 @@
+// CG/Tests/WaterWavesTest.cpp
+// WaterWaves：gVSWater の heightAt をそのまま書き写したものと、CPU の 1 点版 / バッチ版がどれだけ合うか
+#include "TestCommon.h"
+#include "Water/WaterWaves.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+namespace {
+
+// HLSL の heightAt の書き写し（float2 / normalize / dot を 1 行ずつそのまま）
+struct F2 {
+	float x, y;
+};
+F2 Normalize(F2 a) {
+	const float l = 1.0f / std::sqrt(a.x * a.x + a.y * a.y);
+	return {a.x * l, a.y * l};
+}
+float Dot(F2 a, F2 b) { return a.x * b.x + a.y * b.y; }
+
+float HlslHeightAt(const WaterWaveParams& g, F2 xz) {
+	const float t = g.misc.x;
+	float h = g.misc.y;
+	const F2 d1 = Normalize({g.wave1.x, g.wave1.y});
+	const F2 d2 = Normalize({g.wave2.x, g.wave2.y});
+	h += std::sin(Dot(d1, xz) * g.wave1.w + t * g.wave1.w) * g.wave1.z;
+	h += std::sin(Dot(d2, xz) * g.wave2.w + t * g.wave2.w * 1.1f) * g.wave2.z;
+	{
+		const F2 d3 = Normalize({0.8f, 0.6f}), d4 = Normalize({-0.6f, 0.9f});
+		const float aMid = 0.18f, kMid = 0.35f, sMid = 0.9f;
+		h += std::sin(Dot(d3, xz) * kMid + t * sMid) * aMid;
+		h += std::sin(Dot(d4, xz) * kMid * 1.3f + t * (sMid * 1.2f)) * aMid;
+	}
+	{
+		const float aS = 0.06f, k1 = 0.90f, k2 = 1.30f;
+		const F2 r1{xz.x * k1 + t * 1.3f, xz.y * k1 + t * 0.9f}, r2{xz.x * k2 + -t * 1.0f, xz.y * k2 + t * 1.2f};
+		const float s1 = std::sin(r1.x) * std::cos(r1.y * 1.3f), s2 = std::cos(r2.x * 1.2f) * std::sin(r2.y);
+		h += (s1 + s2) * 0.5f * aS;
+	}
+	{
+		const float aT = 0.04f, k1 = 1.9f, k2 = 2.5f;
+		const F2 s1{xz.x * k1 + t * 1.4f, xz.y * k1 + t * 1.0f}, s2{xz.x * k2 + -t * 1.1f, xz.y * k2 + t * 1.6f};
+		const float w1 = std::sin(s1.x) * std::cos(s1.y * 1.1f), w2 = std::cos(s2.x * 1.3f) * std::sin(s2.y);
+		h += (w1 + w2) * 0.5f * aT;
+	}
+	return h;
+}
+
+XMFLOAT3 HlslNormalAt(const WaterWaveParams& g, F2 p) {
+	const float e = 0.4f;
+	const float hx = HlslHeightAt(g, {p.x + e, p.y}) - HlslHeightAt(g, {p.x - e, p.y});
+	const float hz = HlslHeightAt(g, {p.x, p.y + e}) - HlslHeightAt(g, {p.x, p.y - e});
+	const float nx = -hx, ny = 2.0f * e, nz = -hz;
+	const float l = 1.0f / std::sqrt(nx * nx + ny * ny + nz * nz);
+	return {nx * l, ny * l, nz * l};
+}
+
+double MaxDiff(const XMFLOAT3& a, const XMFLOAT3& b) { return (std::max)({std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z)}); }
+
+} // namespace
+
+int main() {
+	// 1 点版は同じ式・同じ順番なので丸めの差だけ。バッチ版は XMVectorSin/Cos（多項式近似 + 2pi での折り返し）の誤差が乗る
+	// 許容値は |x|,|z| <= 500, t <= 600 で測った最大（高さ 2.2e-5 m、法線 2.0e-5）に余裕を持たせたもの
+	constexpr double kScalarTol = 1e-5;
+	constexpr double kBatchTol = 1e-4;
+
+	WaterWaveParams g{};
+	g.wave1 = {1.0f, 0.3f, 0.45f, 0.08f};
+	g.wave2 = {-0.4f, 1.0f, 0.30f, 0.15f};
+	g.misc = {0.0f, -2.0f, 0.0f, 0.0f};
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+	constexpr size_t kPoints = 100003; // 4 で割り切れない（端数の 1 点版も通す）
+	std::vector<float> xs(kPoints), zs(kPoints), heights(kPoints);
+	std::vector<XMFLOAT3> normals(kPoints);
+
+	double scalarErr = 0.0, batchErr = 0.0, scalarNormalErr = 0.0, batchNormalErr = 0.0;
+	const float amp = WaterWaveAmplitude(g);
+	for (float t : {0.0f, 17.3f, 612.9f}) {
+		g.misc.x = t;
+		for (size_t i = 0; i < kPoints; ++i) {
+			xs[i] = pos(rng);
+			zs[i] = pos(rng);
+		}
+		WaterSampleBatch(g, xs.data(), zs.data(), kPoints, heights.data(), normals.data());
+		for (size_t i = 0; i < kPoints; ++i) {
+			const float ref = HlslHeightAt(g, {xs[i], zs[i]});
+			const XMFLOAT3 refN = HlslNormalAt(g, {xs[i], zs[i]});
+			scalarErr = (std::max)(scalarErr, double(std::fabs(WaterHeightAt(g, xs[i], zs[i]) - ref)));
+			batchErr = (std::max)(batchErr, double(std::fabs(heights[i] - ref)));
+			scalarNormalErr = (std::max)(scalarNormalErr, MaxDiff(WaterNormalAt(g, xs[i], zs[i]), refN));
+			batchNormalErr = (std::max)(batchNormalErr, MaxDiff(normals[i], refN));
+			// カリングの箱に使う振幅に収まる
+			TEST_CHECK(std::fabs(ref - g.misc.y) <= amp);
+		}
+	}
+	TEST_CHECK(scalarErr <= kScalarTol);
+	TEST_CHECK(scalarNormalErr <= kScalarTol);
+	TEST_CHECK(batchErr <= kBatchTol);
+	TEST_CHECK(batchNormalErr <= kBatchTol);
+
+	// 高さだけ（normals = null）でも同じ高さ
+	std::vector<float> heightsOnly(kPoints);
+	WaterSampleBatch(g, xs.data(), zs.data(), kPoints, heightsOnly.data());
+	TEST_CHECK(heightsOnly == heights);
+
+	std::printf("max |dh| vs HLSL: scalar %.2e, batch %.2e | max normal diff: scalar %.2e, batch %.2e\n", scalarErr, batchErr, scalarNormalErr, batchNormalErr);
+	return Test::Result("WaterWavesTest");
+}